@@ -0,0 +1,239 @@
+#include "aot/elf.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+#include <elf.h>
+
+namespace backend::aot {
+
+namespace {
+
+// Section header indices, fixed since every object has the same sections.
+enum : std::uint16_t {
+    TEXT_INDEX = 1,
+    RODATA_INDEX,
+    RELA_TEXT_INDEX,
+    SYMTAB_INDEX,
+    STRTAB_INDEX,
+    SHSTRTAB_INDEX,
+    // empty, marks the stack as not executable
+    NOTE_GNU_STACK_INDEX,
+    SECTION_COUNT,
+};
+
+// Symbol table indices: the null symbol and one per section with contents,
+// followed by the global symbols.
+enum : std::uint32_t {
+    TEXT_SYMBOL = 1,
+    RODATA_SYMBOL,
+    FIRST_GLOBAL_SYMBOL,
+};
+
+std::uint64_t align(std::uint64_t value, std::uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void pad(std::vector<std::uint8_t>& bytes, std::uint64_t alignment) {
+    bytes.resize(align(bytes.size(), alignment), 0);
+}
+
+template <typename T>
+void put(std::vector<std::uint8_t>& bytes, const T& value) {
+    const auto* data = reinterpret_cast<const std::uint8_t*>(&value);
+    bytes.insert(bytes.end(), data, data + sizeof(T));
+}
+
+// A string table: NUL-separated names starting with an empty one.
+class StringTable {
+public:
+    StringTable() : bytes_(1, 0) {}
+
+    std::uint32_t add(std::string_view name) {
+        const auto offset = static_cast<std::uint32_t>(bytes_.size());
+        bytes_.insert(bytes_.end(), name.begin(), name.end());
+        bytes_.push_back(0);
+        return offset;
+    }
+
+    const std::vector<std::uint8_t>& bytes() const {
+        return bytes_;
+    }
+
+private:
+    std::vector<std::uint8_t> bytes_;
+};
+
+} // namespace
+
+std::uint64_t ElfObject::append(Section section,
+                                std::span<const std::uint8_t> bytes,
+                                std::uint64_t alignment) {
+    auto& contents = section == Section::TEXT ? text_ : rodata_;
+    pad(contents, alignment);
+    const auto offset = contents.size();
+    contents.insert(contents.end(), bytes.begin(), bytes.end());
+    return offset;
+}
+
+std::uint64_t ElfObject::append_string(std::string_view string) {
+    const auto offset = rodata_.size();
+    rodata_.insert(rodata_.end(), string.begin(), string.end());
+    rodata_.push_back(0);
+    return offset;
+}
+
+void ElfObject::define_function(std::string_view name, std::uint64_t offset,
+                                std::uint64_t size) {
+    if (offset + size > text_.size()) {
+        throw std::logic_error("Function outside .text");
+    }
+    functions_.push_back({std::string(name), offset, size});
+}
+
+void ElfObject::relocate_call(std::uint64_t offset,
+                              std::string_view function) {
+    // rel32 is relative to the end of the field
+    relocations_.push_back(
+        {offset, R_X86_64_PLT32, std::string(function), -4});
+}
+
+void ElfObject::relocate_rodata(std::uint64_t offset, std::uint64_t target) {
+    relocations_.push_back(
+        {offset, R_X86_64_PC32, {}, static_cast<std::int64_t>(target) - 4});
+}
+
+std::vector<std::uint8_t> ElfObject::serialize() const {
+    // functions called but not defined here, in order of first use
+    std::vector<std::string_view> external;
+    for (const auto& relocation : relocations_) {
+        if (!relocation.function.empty() &&
+            std::ranges::find(functions_, relocation.function,
+                              &Function::name) == functions_.end() &&
+            std::ranges::find(external, relocation.function) ==
+                external.end()) {
+            external.push_back(relocation.function);
+        }
+    }
+    const auto symbol_index = [&](const Relocation& relocation) {
+        if (relocation.function.empty()) {
+            return static_cast<std::uint32_t>(RODATA_SYMBOL);
+        }
+        const auto defined = std::ranges::find(
+            functions_, relocation.function, &Function::name);
+        if (defined != functions_.end()) {
+            return static_cast<std::uint32_t>(FIRST_GLOBAL_SYMBOL +
+                                              (defined - functions_.begin()));
+        }
+        return static_cast<std::uint32_t>(
+            FIRST_GLOBAL_SYMBOL + functions_.size() +
+            static_cast<std::size_t>(std::ranges::find(external,
+                                                       relocation.function) -
+                                     external.begin()));
+    };
+
+    StringTable names;
+    std::vector<std::uint8_t> symbols;
+    put(symbols, Elf64_Sym{});
+    for (const auto section : {TEXT_INDEX, RODATA_INDEX}) {
+        Elf64_Sym symbol{};
+        symbol.st_info = ELF64_ST_INFO(STB_LOCAL, STT_SECTION);
+        symbol.st_shndx = section;
+        put(symbols, symbol);
+    }
+    for (const auto& function : functions_) {
+        Elf64_Sym symbol{};
+        symbol.st_name = names.add(function.name);
+        symbol.st_info = ELF64_ST_INFO(STB_GLOBAL, STT_FUNC);
+        symbol.st_shndx = TEXT_INDEX;
+        symbol.st_value = function.offset;
+        symbol.st_size = function.size;
+        put(symbols, symbol);
+    }
+    for (const auto name : external) {
+        Elf64_Sym symbol{};
+        symbol.st_name = names.add(name);
+        symbol.st_info = ELF64_ST_INFO(STB_GLOBAL, STT_NOTYPE);
+        symbol.st_shndx = SHN_UNDEF;
+        put(symbols, symbol);
+    }
+
+    std::vector<std::uint8_t> relocations;
+    for (const auto& relocation : relocations_) {
+        Elf64_Rela entry{};
+        entry.r_offset = relocation.offset;
+        entry.r_info =
+            ELF64_R_INFO(symbol_index(relocation), relocation.type);
+        entry.r_addend = relocation.addend;
+        put(relocations, entry);
+    }
+
+    StringTable section_names;
+    std::array<Elf64_Shdr, SECTION_COUNT> headers{};
+    const auto describe = [&](std::uint16_t index, std::string_view name,
+                              std::uint32_t type, std::uint64_t flags,
+                              std::uint64_t alignment) -> Elf64_Shdr& {
+        auto& header = headers[index];
+        header.sh_name = section_names.add(name);
+        header.sh_type = type;
+        header.sh_flags = flags;
+        header.sh_addralign = alignment;
+        return header;
+    };
+    describe(TEXT_INDEX, ".text", SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, 16);
+    describe(RODATA_INDEX, ".rodata", SHT_PROGBITS, SHF_ALLOC, 16);
+    auto& rela = describe(RELA_TEXT_INDEX, ".rela.text", SHT_RELA,
+                          SHF_INFO_LINK, 8);
+    rela.sh_link = SYMTAB_INDEX;
+    rela.sh_info = TEXT_INDEX;
+    rela.sh_entsize = sizeof(Elf64_Rela);
+    auto& symtab = describe(SYMTAB_INDEX, ".symtab", SHT_SYMTAB, 0, 8);
+    symtab.sh_link = STRTAB_INDEX;
+    symtab.sh_info = FIRST_GLOBAL_SYMBOL;
+    symtab.sh_entsize = sizeof(Elf64_Sym);
+    describe(STRTAB_INDEX, ".strtab", SHT_STRTAB, 0, 1);
+    describe(SHSTRTAB_INDEX, ".shstrtab", SHT_STRTAB, 0, 1);
+    describe(NOTE_GNU_STACK_INDEX, ".note.GNU-stack", SHT_PROGBITS, 0, 1);
+
+    std::vector<std::uint8_t> file(sizeof(Elf64_Ehdr), 0);
+    const auto place = [&](std::uint16_t index,
+                           const std::vector<std::uint8_t>& contents) {
+        auto& header = headers[index];
+        pad(file, header.sh_addralign);
+        header.sh_offset = file.size();
+        header.sh_size = contents.size();
+        file.insert(file.end(), contents.begin(), contents.end());
+    };
+    place(TEXT_INDEX, text_);
+    place(RODATA_INDEX, rodata_);
+    place(RELA_TEXT_INDEX, relocations);
+    place(SYMTAB_INDEX, symbols);
+    place(STRTAB_INDEX, names.bytes());
+    place(SHSTRTAB_INDEX, section_names.bytes());
+    headers[NOTE_GNU_STACK_INDEX].sh_offset = file.size();
+
+    pad(file, 8);
+    Elf64_Ehdr header{};
+    std::memcpy(header.e_ident, ELFMAG, SELFMAG);
+    header.e_ident[EI_CLASS] = ELFCLASS64;
+    header.e_ident[EI_DATA] = ELFDATA2LSB;
+    header.e_ident[EI_VERSION] = EV_CURRENT;
+    header.e_ident[EI_OSABI] = ELFOSABI_SYSV;
+    header.e_type = ET_REL;
+    header.e_machine = EM_X86_64;
+    header.e_version = EV_CURRENT;
+    header.e_shoff = file.size();
+    header.e_ehsize = sizeof(Elf64_Ehdr);
+    header.e_shentsize = sizeof(Elf64_Shdr);
+    header.e_shnum = SECTION_COUNT;
+    header.e_shstrndx = SHSTRTAB_INDEX;
+    std::memcpy(file.data(), &header, sizeof(header));
+    for (const auto& section : headers) {
+        put(file, section);
+    }
+    return file;
+}
+
+} // namespace backend::aot
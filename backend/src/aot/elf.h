@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace backend::aot {
+
+// Builds an ELF64 relocatable object for x86-64 holding code in .text and
+// constant data in .rodata, global function symbols and the relocations
+// that the linker applies to rel32 fields in the code.
+class ElfObject {
+public:
+    enum class Section {
+        TEXT,
+        RODATA,
+    };
+
+    // Appends `bytes` to `section` at the next multiple of `alignment` and
+    // returns their offset in the section.
+    std::uint64_t append(Section section, std::span<const std::uint8_t> bytes,
+                         std::uint64_t alignment = 1);
+
+    // Appends a NUL-terminated copy of `string` to .rodata.
+    std::uint64_t append_string(std::string_view string);
+
+    // Defines a global function symbol in .text.
+    void define_function(std::string_view name, std::uint64_t offset,
+                         std::uint64_t size);
+
+    // Makes the rel32 field at `offset` in .text call `function`, defined in
+    // this object or another one.
+    void relocate_call(std::uint64_t offset, std::string_view function);
+
+    // Makes the rel32 field at `offset` in .text point to `target` in
+    // .rodata.
+    void relocate_rodata(std::uint64_t offset, std::uint64_t target);
+
+    // The object file's contents.
+    std::vector<std::uint8_t> serialize() const;
+
+private:
+    struct Function {
+        std::string name;
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    struct Relocation {
+        std::uint64_t offset;
+        std::uint32_t type;
+        // empty for .rodata
+        std::string function;
+        std::int64_t addend;
+    };
+
+    std::vector<std::uint8_t> text_;
+    std::vector<std::uint8_t> rodata_;
+    std::vector<Function> functions_;
+    std::vector<Relocation> relocations_;
+};
+
+} // namespace backend::aot
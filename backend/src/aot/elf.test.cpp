@@ -0,0 +1,151 @@
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <elf.h>
+#include <gtest/gtest.h>
+
+#include "aot/elf.h"
+
+namespace {
+
+using backend::aot::ElfObject;
+
+// Read-only view of a serialised object.
+class ObjectReader {
+public:
+    explicit ObjectReader(std::vector<std::uint8_t> bytes)
+        : bytes_(std::move(bytes)) {}
+
+    Elf64_Ehdr header() const {
+        return read<Elf64_Ehdr>(0);
+    }
+
+    Elf64_Shdr section(std::size_t index) const {
+        return read<Elf64_Shdr>(header().e_shoff +
+                                index * sizeof(Elf64_Shdr));
+    }
+
+    std::string section_name(std::size_t index) const {
+        return string(header().e_shstrndx, section(index).sh_name);
+    }
+
+    // index of the section named `name`
+    std::size_t find(const std::string& name) const {
+        for (std::size_t i = 0; i < header().e_shnum; ++i) {
+            if (section_name(i) == name) {
+                return i;
+            }
+        }
+        return 0;
+    }
+
+    template <typename T>
+    std::vector<T> entries(const std::string& name) const {
+        const auto header = section(find(name));
+        std::vector<T> result(header.sh_size / sizeof(T));
+        for (std::size_t i = 0; i < result.size(); ++i) {
+            result[i] = read<T>(header.sh_offset + i * sizeof(T));
+        }
+        return result;
+    }
+
+    std::string symbol_name(const Elf64_Sym& symbol) const {
+        return string(find(".strtab"), symbol.st_name);
+    }
+
+    std::vector<std::uint8_t> contents(const std::string& name) const {
+        const auto header = section(find(name));
+        return {bytes_.begin() + static_cast<std::ptrdiff_t>(header.sh_offset),
+                bytes_.begin() + static_cast<std::ptrdiff_t>(
+                                     header.sh_offset + header.sh_size)};
+    }
+
+private:
+    template <typename T>
+    T read(std::size_t offset) const {
+        T value;
+        std::memcpy(&value, bytes_.data() + offset, sizeof(T));
+        return value;
+    }
+
+    std::string string(std::size_t table, std::size_t offset) const {
+        return reinterpret_cast<const char*>(bytes_.data() +
+                                             section(table).sh_offset +
+                                             offset);
+    }
+
+    std::vector<std::uint8_t> bytes_;
+};
+
+ObjectReader example() {
+    ElfObject object;
+    // f: call g; call f; lea rax, [rip + "hi"]
+    const std::vector<std::uint8_t> code = {0xe8, 0, 0, 0, 0, 0xe8, 0, 0,
+                                            0,    0, 0x48, 0x8d, 0x05, 0,
+                                            0,    0, 0};
+    const auto offset = object.append(ElfObject::Section::TEXT, code, 16);
+    object.define_function("f", offset, code.size());
+    object.relocate_call(offset + 1, "g");
+    object.relocate_call(offset + 6, "f");
+    object.append_string("x");
+    object.relocate_rodata(offset + 13, object.append_string("hi"));
+    return ObjectReader(object.serialize());
+}
+
+TEST(ElfObject, Header) {
+    const auto header = example().header();
+
+    EXPECT_EQ(std::memcmp(header.e_ident, ELFMAG, SELFMAG), 0);
+    EXPECT_EQ(header.e_ident[EI_CLASS], ELFCLASS64);
+    EXPECT_EQ(header.e_ident[EI_DATA], ELFDATA2LSB);
+    EXPECT_EQ(header.e_type, ET_REL);
+    EXPECT_EQ(header.e_machine, EM_X86_64);
+    EXPECT_EQ(header.e_shoff % 8, 0);
+}
+
+TEST(ElfObject, Sections) {
+    const auto object = example();
+
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < object.header().e_shnum; ++i) {
+        names.push_back(object.section_name(i));
+    }
+    EXPECT_EQ(names, (std::vector<std::string>{"", ".text", ".rodata",
+                                               ".rela.text", ".symtab",
+                                               ".strtab", ".shstrtab",
+                                               ".note.GNU-stack"}));
+    EXPECT_EQ(object.section(1).sh_flags, SHF_ALLOC | SHF_EXECINSTR);
+    EXPECT_EQ(object.section(1).sh_offset % 16, 0);
+    EXPECT_EQ(object.contents(".rodata"),
+              (std::vector<std::uint8_t>{'x', 0, 'h', 'i', 0}));
+}
+
+TEST(ElfObject, SymbolsAndRelocations) {
+    const auto object = example();
+    const auto symbols = object.entries<Elf64_Sym>(".symtab");
+    ASSERT_EQ(symbols.size(), 5);
+    EXPECT_EQ(ELF64_ST_TYPE(symbols[1].st_info), STT_SECTION);
+    EXPECT_EQ(object.symbol_name(symbols[3]), "f");
+    EXPECT_EQ(ELF64_ST_BIND(symbols[3].st_info), STB_GLOBAL);
+    EXPECT_EQ(ELF64_ST_TYPE(symbols[3].st_info), STT_FUNC);
+    EXPECT_EQ(symbols[3].st_size, 17);
+    EXPECT_EQ(object.symbol_name(symbols[4]), "g");
+    EXPECT_EQ(symbols[4].st_shndx, SHN_UNDEF);
+    EXPECT_EQ(object.section(object.find(".symtab")).sh_info, 3);
+
+    const auto relocations = object.entries<Elf64_Rela>(".rela.text");
+    ASSERT_EQ(relocations.size(), 3);
+    EXPECT_EQ(relocations[0].r_offset, 1);
+    EXPECT_EQ(ELF64_R_SYM(relocations[0].r_info), 4);
+    EXPECT_EQ(ELF64_R_TYPE(relocations[0].r_info), R_X86_64_PLT32);
+    EXPECT_EQ(relocations[0].r_addend, -4);
+    EXPECT_EQ(ELF64_R_SYM(relocations[1].r_info), 3);
+    // .rodata's section symbol, at "hi"
+    EXPECT_EQ(ELF64_R_SYM(relocations[2].r_info), 2);
+    EXPECT_EQ(ELF64_R_TYPE(relocations[2].r_info), R_X86_64_PC32);
+    EXPECT_EQ(relocations[2].r_addend, 2 - 4);
+}
+
+} // namespace
@@ -0,0 +1,152 @@
+#include "aot/object_file.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "aot/elf.h"
+#include "jit/assembler.h"
+#include "jit/code_generator.h"
+
+namespace backend::aot {
+
+namespace {
+
+using jit::Assembler;
+using jit::Condition;
+using jit::Register;
+
+constexpr std::int32_t STATUS_SIZE = sizeof(jit::RuntimeStatus);
+
+// Code of `main`, calling the program with a zeroed RuntimeStatus on the
+// stack. Calls to the C library and loads of .rodata strings are relocated
+// once the code's place in .text is known.
+class MainGenerator {
+public:
+    MainGenerator(ElfObject& object, std::string program,
+                  Value::Type result_type)
+        : object_(object),
+          program_(std::move(program)),
+          result_type_(result_type) {}
+
+    void generate() {
+        // rsp is 16-byte aligned again after these for the calls
+        assembler_.push(Register::RBX);
+        assembler_.sub(Register::RSP, STATUS_SIZE);
+        assembler_.mov(Register::RAX, std::int64_t{0});
+        assembler_.store(Register::RSP, offsetof(jit::RuntimeStatus, error),
+                         Register::RAX);
+        assembler_.store(Register::RSP,
+                         offsetof(jit::RuntimeStatus, operand),
+                         Register::RAX);
+        assembler_.mov(Register::RDI, Register::RSP);
+        call(program_);
+        assembler_.load(Register::RCX, Register::RSP,
+                        offsetof(jit::RuntimeStatus, error));
+        assembler_.test(Register::RCX, Register::RCX);
+        Assembler::Label error;
+        assembler_.jump_if(Condition::NOT_EQUAL, error);
+
+        if (result_type_ == Value::Type::BOOL) {
+            Assembler::Label print;
+            assembler_.test(Register::RAX, Register::RAX);
+            load_string(Register::RDI, "true");
+            assembler_.jump_if(Condition::NOT_EQUAL, print);
+            load_string(Register::RDI, "false");
+            assembler_.bind(print);
+            call("puts");
+        } else {
+            assembler_.mov(Register::RSI, Register::RAX);
+            load_string(Register::RDI, "%lld\n");
+            call_variadic("printf");
+        }
+        assembler_.mov(Register::RAX, std::int64_t{0});
+
+        Assembler::Label exit;
+        assembler_.bind(exit);
+        assembler_.add(Register::RSP, STATUS_SIZE);
+        assembler_.pop(Register::RBX);
+        assembler_.ret();
+
+        // dprintf(2, message, operand)
+        Assembler::Label shift_out_of_range;
+        assembler_.bind(error);
+        assembler_.mov(Register::RDI, std::int64_t{2});
+        assembler_.cmp(Register::RCX,
+                       static_cast<std::int8_t>(jit::DIVISION_BY_ZERO));
+        assembler_.jump_if(Condition::NOT_EQUAL, shift_out_of_range);
+        load_string(Register::RSI, "Division by zero\n");
+        call_variadic("dprintf");
+        assembler_.mov(Register::RAX, std::int64_t{1});
+        assembler_.jmp(exit);
+
+        assembler_.bind(shift_out_of_range);
+        load_string(Register::RSI, "Shift count out of range: %lld\n");
+        assembler_.load(Register::RDX, Register::RSP,
+                        offsetof(jit::RuntimeStatus, operand));
+        call_variadic("dprintf");
+        assembler_.mov(Register::RAX, std::int64_t{1});
+        assembler_.jmp(exit);
+    }
+
+    // Places the code in .text and applies its relocations.
+    void place() {
+        const auto offset =
+            object_.append(ElfObject::Section::TEXT, assembler_.code(), 16);
+        object_.define_function("main", offset, assembler_.size());
+        for (const auto& [field, function] : calls_) {
+            object_.relocate_call(offset + field, function);
+        }
+        for (const auto& [field, string] : strings_) {
+            object_.relocate_rodata(offset + field, string);
+        }
+    }
+
+private:
+    void call(std::string_view function) {
+        calls_.emplace_back(assembler_.call_external(), function);
+    }
+
+    void call_variadic(std::string_view function) {
+        // al holds the number of vector registers used for arguments
+        assembler_.mov(Register::RAX, std::int64_t{0});
+        call(function);
+    }
+
+    void load_string(Register destination, std::string_view string) {
+        strings_.emplace_back(assembler_.lea_rip(destination),
+                              object_.append_string(string));
+    }
+
+    ElfObject& object_;
+    const std::string program_;
+    const Value::Type result_type_;
+    Assembler assembler_;
+    std::vector<std::pair<std::size_t, std::string_view>> calls_;
+    std::vector<std::pair<std::size_t, std::uint64_t>> strings_;
+};
+
+} // namespace
+
+std::optional<std::vector<std::uint8_t>>
+compile_object(const ir::Function& function, const ObjectOptions& options) {
+    const auto code = jit::generate_code(function);
+    if (!code) {
+        return std::nullopt;
+    }
+
+    ElfObject object;
+    const auto offset =
+        object.append(ElfObject::Section::TEXT, code->bytes, 16);
+    object.define_function(options.symbol, offset, code->bytes.size());
+    if (options.main) {
+        MainGenerator generator(object, options.symbol, code->result_type);
+        generator.generate();
+        generator.place();
+    }
+    return object.serialize();
+}
+
+} // namespace backend::aot
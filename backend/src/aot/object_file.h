@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "ir/ir.h"
+
+namespace backend::aot {
+
+struct ObjectOptions {
+    // Name of the program's function, callable from C as
+    // `int64_t symbol(struct { int64_t error, operand; }*)` like JIT code.
+    std::string symbol = "program";
+    // Also define `int main(void)`, which prints the result as the driver's
+    // --run does, or the runtime error on stderr with exit status 1.
+    bool main = true;
+};
+
+// An ELF64 relocatable object with the x86-64 code of `function`, to be
+// linked by the system compiler driver. Returns nullopt for functions the
+// code generator does not support.
+std::optional<std::vector<std::uint8_t>>
+compile_object(const ir::Function& function,
+               const ObjectOptions& options = {});
+
+} // namespace backend::aot
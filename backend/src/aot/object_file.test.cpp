@@ -0,0 +1,188 @@
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "aot/object_file.h"
+#include "bench_programs.h"
+#include "interpreter/evaluator.h"
+#include "ir/lowering.h"
+#include "jit/jit.h"
+#include "optimizer/pass.h"
+#include "parser.h"
+#include "scanner.h"
+
+namespace {
+
+using backend::EvaluationError;
+using backend::aot::compile_object;
+using backend::optimizer::PassManager;
+
+backend::ir::Function lower(const std::string& source, int level) {
+    auto function = backend::ir::Lowering().lower(
+        frontend::Parser(frontend::Scanner(source).scan_tokens()).parse());
+    PassManager::for_level(level).run(function);
+    return function;
+}
+
+struct Outcome {
+    int status;
+    std::string output;
+    std::string errors;
+
+    bool operator==(const Outcome&) const = default;
+};
+
+std::ostream& operator<<(std::ostream& stream, const Outcome& outcome) {
+    return stream << "exit " << outcome.status << ", stdout \""
+                  << outcome.output << "\", stderr \"" << outcome.errors
+                  << '"';
+}
+
+// What a standalone binary for `source` should do.
+Outcome expected(const std::string& source) {
+    const auto ast =
+        frontend::Parser(frontend::Scanner(source).scan_tokens()).parse();
+    backend::interpreter::Evaluator evaluator;
+    try {
+        return {0, evaluator.evaluate(ast).to_string() + "\n", ""};
+    } catch (const EvaluationError& error) {
+        return {1, "", std::string(error.what()) + "\n"};
+    }
+}
+
+// Links objects with the system compiler driver and runs the results, in a
+// fresh directory per test.
+class ObjectFileTest : public testing::Test {
+protected:
+    ObjectFileTest()
+        : directory_(std::filesystem::temp_directory_path() /
+                     ("object-file-test-" + std::to_string(::getpid()) +
+                      "-" +
+                      testing::UnitTest::GetInstance()
+                          ->current_test_info()
+                          ->name())) {
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_);
+    }
+
+    ~ObjectFileTest() override {
+        std::filesystem::remove_all(directory_);
+    }
+
+    void SetUp() override {
+        if (!backend::jit::is_supported_platform()) {
+            GTEST_SKIP() << "native code is only generated for x86-64";
+        }
+        if (std::system("cc --version > /dev/null 2>&1") != 0) {
+            GTEST_SKIP() << "no system compiler to link with";
+        }
+    }
+
+    std::string path(const std::string& name) const {
+        return (directory_ / name).string();
+    }
+
+    void write(const std::string& name,
+               const std::vector<std::uint8_t>& bytes) const {
+        std::ofstream file(path(name), std::ios::binary);
+        file.write(reinterpret_cast<const char*>(bytes.data()),
+                   static_cast<std::streamsize>(bytes.size()));
+    }
+
+    std::string read(const std::string& name) const {
+        std::ifstream file(path(name));
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    // Links `inputs` into a binary, runs it and collects what it printed.
+    Outcome link_and_run(const std::string& inputs) const {
+        const auto binary = path("program");
+        const auto link = "cc -o " + binary + " " + inputs + " 2> " +
+                          path("link.log");
+        if (std::system(link.c_str()) != 0) {
+            ADD_FAILURE() << "linking failed: " << read("link.log");
+            return {};
+        }
+        const auto status = std::system((binary + " > " + path("stdout") +
+                                         " 2> " + path("stderr"))
+                                            .c_str());
+        return {WEXITSTATUS(status), read("stdout"), read("stderr")};
+    }
+
+    Outcome build_and_run(const std::string& source, int level) const {
+        const auto object = compile_object(lower(source, level));
+        if (!object) {
+            ADD_FAILURE() << "not compiled: " << source;
+            return {};
+        }
+        write("program.o", *object);
+        return link_and_run(path("program.o"));
+    }
+
+    std::filesystem::path directory_;
+};
+
+TEST_F(ObjectFileTest, StandaloneBinaries) {
+    for (const auto* source : {
+             "6 * 7;",
+             "9223372036854775807 + 1;",
+             "if (1 < 2) 10; else 20;",
+             "3 >= 4;",
+             "1 == 1;",
+         }) {
+        EXPECT_EQ(build_and_run(source, 0), expected(source)) << source;
+    }
+}
+
+TEST_F(ObjectFileTest, RuntimeErrors) {
+    for (const auto* source : {"1 / (2 - 2);", "1 << (70 - 1);"}) {
+        EXPECT_EQ(build_and_run(source, 0), expected(source)) << source;
+    }
+}
+
+TEST_F(ObjectFileTest, BenchmarkProgramsAtEveryLevel) {
+    const auto source = backend::bench::branchy_program(30) +
+                        backend::bench::arithmetic_program(30);
+    for (int level = 0; level <= PassManager::MAX_LEVEL; ++level) {
+        EXPECT_EQ(build_and_run(source, level), expected(source))
+            << "-O" << level;
+    }
+}
+
+TEST_F(ObjectFileTest, CallableFromC) {
+    const auto object = compile_object(lower("if (2 > 1) 5 * 5;", 1),
+                                       {.symbol = "answer", .main = false});
+    ASSERT_TRUE(object);
+    write("answer.o", *object);
+    std::ofstream(path("main.c"))
+        << "#include <stdint.h>\n"
+           "#include <stdio.h>\n"
+           "struct status { int64_t error, operand; };\n"
+           "int64_t answer(struct status*);\n"
+           "int main(void) {\n"
+           "    struct status status = {0, 0};\n"
+           "    int64_t result = answer(&status);\n"
+           "    printf(\"%lld %lld\\n\", (long long)result,\n"
+           "           (long long)status.error);\n"
+           "    return 0;\n"
+           "}\n";
+
+    EXPECT_EQ(link_and_run(path("main.c") + " " + path("answer.o")),
+              (Outcome{0, "25 0\n", ""}));
+}
+
+TEST(ObjectFile, UnsupportedPrograms) {
+    EXPECT_FALSE(compile_object(lower("1.5;", 0)));
+    EXPECT_FALSE(compile_object(lower("\"s\";", 0)));
+}
+
+} // namespace
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <format>
+#include <string>
+
+namespace backend::bench {
+
+// Arithmetic-heavy program of `statements` integer expression statements.
+inline std::string arithmetic_program(std::size_t statements) {
+    std::string source;
+    for (std::size_t i = 0; i < statements; ++i) {
+        source += std::vformat(
+            "((({} + 3) * 7 - ({} << 2)) % 11 + {} / 3) * (2 + {} % 5) - "
+            "(({} >> 1) + 17) * 3;\n",
+            std::make_format_args(i, i, i, i, i));
+    }
+    return source;
+}
+
+// Comparisons and nested if/else chains around small expressions.
+inline std::string branchy_program(std::size_t statements) {
+    std::string source;
+    for (std::size_t i = 0; i < statements; ++i) {
+        source += std::vformat(
+            "if ({} % 3 == 0) {{ {} * 2; }} else if ({} % 3 == 1) "
+            "{{ if ({} < 500) {} + 1; else {} - 1; }} else {{ {} << 1; }}\n",
+            std::make_format_args(i, i, i, i, i, i, i));
+    }
+    return source;
+}
+
+// Mixed double and integer arithmetic.
+inline std::string floating_point_program(std::size_t statements) {
+    std::string source;
+    for (std::size_t i = 0; i < statements; ++i) {
+        source += std::vformat("({}.5 * 1.25 + {}) / 3.75 - {}.125;\n",
+                               std::make_format_args(i, i, i));
+    }
+    return source;
+}
+
+} // namespace backend::bench
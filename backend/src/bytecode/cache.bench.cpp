@@ -0,0 +1,57 @@
+#include <unistd.h>
+
+#include <filesystem>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_programs.h"
+#include "bytecode/cache.h"
+#include "bytecode/compiler.h"
+#include "parser.h"
+#include "scanner.h"
+
+// Cold start of a script: scanning, parsing and compiling it from source
+// versus mapping its cached bytecode.
+
+namespace {
+
+std::filesystem::path cache_directory() {
+    return std::filesystem::temp_directory_path() /
+           ("bytecode-cache-bench-" + std::to_string(::getpid()));
+}
+
+void BM_ColdStartFromSource(benchmark::State& state) {
+    const auto source = backend::bench::arithmetic_program(
+        static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(backend::bytecode::Compiler().compile(
+            frontend::Parser(frontend::Scanner(source).scan_tokens())
+                .parse()));
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(source.size()));
+}
+
+void BM_ColdStartFromCache(benchmark::State& state) {
+    const auto source = backend::bench::arithmetic_program(
+        static_cast<std::size_t>(state.range(0)));
+    const backend::bytecode::BytecodeCache cache(cache_directory());
+    cache.load_or_compile(source);
+    for (auto _ : state) {
+        auto program = cache.load_or_compile(source);
+        if (!program.was_cached()) {
+            state.SkipWithError("cache miss");
+            break;
+        }
+        benchmark::DoNotOptimize(program.view());
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(source.size()));
+    std::filesystem::remove_all(cache_directory());
+}
+
+BENCHMARK(BM_ColdStartFromSource)->Range(64, 16384);
+BENCHMARK(BM_ColdStartFromCache)->Range(64, 16384);
+
+} // namespace
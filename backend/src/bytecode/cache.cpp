@@ -0,0 +1,329 @@
+#include "bytecode/cache.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include "bytecode/compiler.h"
+#include "parser.h"
+#include "resolver.h"
+#include "scanner.h"
+#include "version.h"
+
+namespace backend::bytecode {
+
+namespace {
+
+// All fields are in the byte order of the machine that wrote the file; a
+// reader with another byte order sees a mismatching mark and ignores it.
+//
+//   FileHeader
+//   Instruction[code_count], padded to 8 bytes
+//   ConstantRecord[constant_count]
+//   char[string_bytes]
+struct FileHeader {
+    std::array<char, 8> magic;
+    std::uint32_t format_version;
+    std::uint32_t byte_order;
+    std::uint64_t key;
+    std::uint64_t source_size;
+    std::uint32_t register_count;
+    std::uint32_t code_count;
+    std::uint32_t constant_count;
+    std::uint32_t reserved;
+    std::uint64_t string_bytes;
+};
+
+// The payload holds the bool, integer or double bits, or for strings the
+// offset of the bytes in the string section.
+struct ConstantRecord {
+    std::uint8_t type;
+    std::array<std::uint8_t, 3> reserved;
+    std::uint32_t length;
+    std::uint64_t payload;
+};
+
+static_assert(sizeof(FileHeader) == 56);
+static_assert(sizeof(ConstantRecord) == 16);
+
+constexpr std::array<char, 8> MAGIC = {'C', 'F', 'B', 'C', '\r', '\n', 0, 0};
+constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+constexpr std::size_t padded(std::size_t size) {
+    return (size + 7) & ~std::size_t{7};
+}
+
+std::uint64_t fnv1a(std::uint64_t hash, std::string_view bytes) {
+    for (const auto c : bytes) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+template <typename T>
+void append(std::string& buffer, const T& value) {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+} // namespace
+
+std::uint64_t cache_key(std::string_view source) {
+    auto hash = fnv1a(0xcbf29ce484222325, frontend::FRONTEND_VERSION);
+    const std::array<char, 5> separator = {
+        '\0',
+        static_cast<char>(CACHE_FORMAT_VERSION & 0xff),
+        static_cast<char>(CACHE_FORMAT_VERSION >> 8 & 0xff),
+        static_cast<char>(CACHE_FORMAT_VERSION >> 16 & 0xff),
+        static_cast<char>(CACHE_FORMAT_VERSION >> 24 & 0xff),
+    };
+    hash = fnv1a(hash, {separator.data(), separator.size()});
+    return fnv1a(hash, source);
+}
+
+MappedChunk::MappedChunk(MappedChunk&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)), code_(other.code_),
+      constants_(std::move(other.constants_)),
+      register_count_(other.register_count_) {}
+
+MappedChunk& MappedChunk::operator=(MappedChunk&& other) noexcept {
+    if (this != &other) {
+        if (data_ != nullptr) {
+            ::munmap(data_, size_);
+        }
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        code_ = other.code_;
+        constants_ = std::move(other.constants_);
+        register_count_ = other.register_count_;
+    }
+    return *this;
+}
+
+MappedChunk::~MappedChunk() {
+    if (data_ != nullptr) {
+        ::munmap(data_, size_);
+    }
+}
+
+std::optional<MappedChunk> MappedChunk::open(const std::filesystem::path& path,
+                                             std::uint64_t key,
+                                             std::size_t source_size) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    struct stat status {};
+    if (::fstat(fd, &status) != 0 ||
+        static_cast<std::size_t>(status.st_size) < sizeof(FileHeader)) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    const auto size = static_cast<std::size_t>(status.st_size);
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return std::nullopt;
+    }
+    // unmaps on every early return
+    MappedChunk chunk(data, size);
+    const auto* bytes = static_cast<const char*>(data);
+
+    FileHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+    if (header.magic != MAGIC ||
+        header.format_version != CACHE_FORMAT_VERSION ||
+        header.byte_order != BYTE_ORDER_MARK || header.key != key ||
+        header.source_size != source_size) {
+        return std::nullopt;
+    }
+
+    const auto code_offset = sizeof(FileHeader);
+    const auto constants_offset =
+        code_offset + padded(std::size_t{header.code_count} *
+                             sizeof(Instruction));
+    const auto strings_offset =
+        constants_offset +
+        std::size_t{header.constant_count} * sizeof(ConstantRecord);
+    if (header.string_bytes != size - std::min(size, strings_offset) ||
+        strings_offset > size) {
+        return std::nullopt;
+    }
+
+    chunk.code_ = {reinterpret_cast<const Instruction*>(bytes + code_offset),
+                   header.code_count};
+    chunk.register_count_ = header.register_count;
+    chunk.constants_.reserve(header.constant_count);
+    for (std::uint32_t i = 0; i < header.constant_count; ++i) {
+        ConstantRecord record;
+        std::memcpy(&record,
+                    bytes + constants_offset + i * sizeof(ConstantRecord),
+                    sizeof(record));
+        switch (static_cast<Value::Type>(record.type)) {
+            case Value::Type::NONE:
+                chunk.constants_.emplace_back();
+                break;
+            case Value::Type::BOOL:
+                chunk.constants_.emplace_back(record.payload != 0);
+                break;
+            case Value::Type::INT:
+                chunk.constants_.emplace_back(
+                    static_cast<std::int64_t>(record.payload));
+                break;
+            case Value::Type::DOUBLE:
+                chunk.constants_.emplace_back(
+                    std::bit_cast<double>(record.payload));
+                break;
+            case Value::Type::STRING:
+                if (record.payload > header.string_bytes ||
+                    record.length > header.string_bytes - record.payload) {
+                    return std::nullopt;
+                }
+                chunk.constants_.emplace_back(std::string_view(
+                    bytes + strings_offset + record.payload, record.length));
+                break;
+            default:
+                return std::nullopt;
+        }
+    }
+
+    try {
+        verify(chunk.view());
+    } catch (const std::runtime_error&) {
+        return std::nullopt;
+    }
+    return chunk;
+}
+
+void write_cache_file(const std::filesystem::path& path, const Chunk& chunk,
+                      std::uint64_t key, std::size_t source_size) {
+    std::string strings;
+    std::string records;
+    for (const auto& constant : chunk.constants()) {
+        ConstantRecord record{};
+        record.type = static_cast<std::uint8_t>(constant.type());
+        switch (constant.type()) {
+            case Value::Type::NONE:
+                break;
+            case Value::Type::BOOL:
+                record.payload = constant.as_bool();
+                break;
+            case Value::Type::INT:
+                record.payload = static_cast<std::uint64_t>(constant.as_int());
+                break;
+            case Value::Type::DOUBLE:
+                record.payload = std::bit_cast<std::uint64_t>(
+                    constant.as_double());
+                break;
+            case Value::Type::STRING:
+                record.length =
+                    static_cast<std::uint32_t>(constant.as_string().size());
+                record.payload = strings.size();
+                strings += constant.as_string();
+                break;
+        }
+        append(records, record);
+    }
+
+    FileHeader header{};
+    header.magic = MAGIC;
+    header.format_version = CACHE_FORMAT_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.key = key;
+    header.source_size = source_size;
+    header.register_count = static_cast<std::uint32_t>(chunk.register_count());
+    header.code_count = static_cast<std::uint32_t>(chunk.code().size());
+    header.constant_count =
+        static_cast<std::uint32_t>(chunk.constants().size());
+    header.string_bytes = strings.size();
+
+    std::string buffer;
+    append(buffer, header);
+    for (const auto instruction : chunk.code()) {
+        append(buffer, instruction.bits());
+    }
+    buffer.resize(padded(buffer.size()), '\0');
+    buffer += records;
+    buffer += strings;
+
+    // unique per process and call, so concurrent writers never share a file
+    static std::atomic<std::uint64_t> counter = 0;
+    auto temporary = path;
+    temporary += std::vformat(
+        ".{}.{}.tmp", std::make_format_args(static_cast<long>(::getpid()),
+                                            counter.fetch_add(1)));
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!file) {
+            std::filesystem::remove(temporary);
+            throw std::runtime_error(std::vformat(
+                "Failed to write {}",
+                std::make_format_args(temporary.native())));
+        }
+    }
+    std::filesystem::rename(temporary, path);
+}
+
+BytecodeCache::BytecodeCache(std::filesystem::path directory)
+    : directory_(std::move(directory)) {
+    std::filesystem::create_directories(directory_);
+}
+
+std::filesystem::path BytecodeCache::path_for(std::string_view source) const {
+    std::array<char, 16> hex;
+    hex.fill('0');
+    const auto key = cache_key(source);
+    // right-aligned, zero-padded to 16 digits
+    std::array<char, 16> digits{};
+    const auto end =
+        std::to_chars(digits.data(), digits.data() + digits.size(), key, 16)
+            .ptr;
+    const auto length = static_cast<std::size_t>(end - digits.data());
+    std::copy(digits.data(), end, hex.data() + hex.size() - length);
+    return directory_ / (std::string(hex.data(), hex.size()) + ".cfbc");
+}
+
+std::optional<MappedChunk>
+BytecodeCache::load(std::string_view source) const {
+    return MappedChunk::open(path_for(source), cache_key(source),
+                             source.size());
+}
+
+void BytecodeCache::store(std::string_view source, const Chunk& chunk) const {
+    try {
+        write_cache_file(path_for(source), chunk, cache_key(source),
+                         source.size());
+    } catch (const std::exception&) {
+        // the cache is an optimisation; running uncached is always correct
+    }
+}
+
+CachedProgram BytecodeCache::load_or_compile(std::string_view source) const {
+    if (auto mapped = load(source); mapped.has_value()) {
+        return CachedProgram(std::move(*mapped));
+    }
+    const auto tree =
+        frontend::Parser(frontend::Scanner(std::string(source)).scan_tokens())
+            .parse();
+    frontend::Resolver().resolve(tree);
+    auto chunk = Compiler().compile(tree);
+    store(source, chunk);
+    return CachedProgram(std::move(chunk));
+}
+
+} // namespace backend::bytecode
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "bytecode/chunk.h"
+#include "value.h"
+
+namespace backend::bytecode {
+
+// Version of the on-disk layout below; files with another version are
+// ignored.
+inline constexpr std::uint32_t CACHE_FORMAT_VERSION = 1;
+
+// Cache key of `source`: a 64-bit FNV-1a hash of the frontend version, the
+// bytecode format version and the source text.
+std::uint64_t cache_key(std::string_view source);
+
+// A chunk read from a cache file through a read-only memory mapping. Code is
+// used in place; only the constant table is rebuilt, with string constants
+// pointing into the mapping.
+class MappedChunk {
+public:
+    MappedChunk(MappedChunk&& other) noexcept;
+    MappedChunk& operator=(MappedChunk&& other) noexcept;
+    MappedChunk(const MappedChunk&) = delete;
+    MappedChunk& operator=(const MappedChunk&) = delete;
+    ~MappedChunk();
+
+    // Maps `path` and checks that it holds verified bytecode for a source with
+    // key `key` and size `source_size`. Returns std::nullopt for missing,
+    // stale or corrupt files.
+    static std::optional<MappedChunk> open(const std::filesystem::path& path,
+                                           std::uint64_t key,
+                                           std::size_t source_size);
+
+    ChunkView view() const {
+        return {code_, constants_, register_count_};
+    }
+
+private:
+    MappedChunk(void* data, std::size_t size) : data_(data), size_(size) {}
+
+    void* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::span<const Instruction> code_;
+    std::vector<Value> constants_;
+    std::size_t register_count_ = 0;
+};
+
+// Writes `chunk` in the cache format. The file is written next to `path` and
+// renamed into place, so concurrent readers never see a partial file.
+void write_cache_file(const std::filesystem::path& path, const Chunk& chunk,
+                      std::uint64_t key, std::size_t source_size);
+
+// Either compiled on the spot or mapped from the cache.
+class CachedProgram {
+public:
+    explicit CachedProgram(Chunk chunk) : chunk_(std::move(chunk)) {}
+    explicit CachedProgram(MappedChunk chunk) : chunk_(std::move(chunk)) {}
+
+    ChunkView view() const {
+        return std::visit([](const auto& chunk) { return chunk.view(); },
+                          chunk_);
+    }
+
+    bool was_cached() const {
+        return std::holds_alternative<MappedChunk>(chunk_);
+    }
+
+private:
+    std::variant<Chunk, MappedChunk> chunk_;
+};
+
+// Directory of compiled chunks, one file per source named after its cache
+// key. A hit maps the file and skips the Scanner, the Parser and the
+// Compiler entirely; a miss compiles the source and writes the file for next
+// time. Failing to write is not an error, the program just is not cached.
+class BytecodeCache {
+public:
+    explicit BytecodeCache(std::filesystem::path directory);
+
+    CachedProgram load_or_compile(std::string_view source) const;
+    std::optional<MappedChunk> load(std::string_view source) const;
+    void store(std::string_view source, const Chunk& chunk) const;
+
+    std::filesystem::path path_for(std::string_view source) const;
+
+private:
+    std::filesystem::path directory_;
+};
+
+} // namespace backend::bytecode
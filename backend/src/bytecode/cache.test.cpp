@@ -0,0 +1,131 @@
+#include <unistd.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "bytecode/cache.h"
+#include "bytecode/compiler.h"
+#include "bytecode/vm.h"
+#include "parser.h"
+#include "scanner.h"
+
+namespace {
+
+using backend::Value;
+using backend::bytecode::BytecodeCache;
+using backend::bytecode::cache_key;
+using backend::bytecode::Compiler;
+using backend::bytecode::MappedChunk;
+using backend::bytecode::VirtualMachine;
+
+// Fresh cache directory per test, removed afterwards.
+class BytecodeCacheTest : public testing::Test {
+protected:
+    BytecodeCacheTest()
+        : directory_(std::filesystem::temp_directory_path() /
+                     ("bytecode-cache-test-" + std::to_string(::getpid()) +
+                      "-" +
+                      testing::UnitTest::GetInstance()
+                          ->current_test_info()
+                          ->name())) {
+        std::filesystem::remove_all(directory_);
+    }
+
+    ~BytecodeCacheTest() override {
+        std::filesystem::remove_all(directory_);
+    }
+
+    // Overwrites `size` bytes at `offset` of the cache file for `source`.
+    void corrupt(const std::string& source, std::streamoff offset,
+                 const std::string& bytes) {
+        std::fstream file(BytecodeCache(directory_).path_for(source),
+                          std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(offset);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    std::filesystem::path directory_;
+};
+
+TEST_F(BytecodeCacheTest, MissCompilesAndWritesThenHitMaps) {
+    const std::string source = "if (1 < 2) 6 * 7; else 0;";
+    const BytecodeCache cache(directory_);
+
+    const auto compiled = cache.load_or_compile(source);
+    EXPECT_FALSE(compiled.was_cached());
+    EXPECT_TRUE(std::filesystem::exists(cache.path_for(source)));
+
+    const auto cached = cache.load_or_compile(source);
+    EXPECT_TRUE(cached.was_cached());
+    EXPECT_EQ(VirtualMachine().run(cached.view()), Value(std::int64_t{42}));
+
+    EXPECT_EQ(disassemble(cached.view()), disassemble(compiled.view()));
+}
+
+TEST_F(BytecodeCacheTest, ConstantsRoundTrip) {
+    const std::string source = "true; 2.5; 9223372036854775807; \"\"; "
+                               "\"text\" + \"more text\";";
+    const BytecodeCache cache(directory_);
+    const auto chunk = Compiler().compile(
+        frontend::Parser(frontend::Scanner(source).scan_tokens()).parse());
+    cache.store(source, chunk);
+
+    const auto mapped = cache.load(source);
+    ASSERT_TRUE(mapped.has_value());
+    const auto constants = mapped->view().constants;
+    ASSERT_EQ(constants.size(), chunk.constants().size());
+    for (std::size_t i = 0; i < constants.size(); ++i) {
+        EXPECT_EQ(constants[i].type(), chunk.constants()[i].type());
+        EXPECT_EQ(constants[i], chunk.constants()[i]);
+    }
+
+    VirtualMachine vm;
+    EXPECT_EQ(vm.run(mapped->view()).to_string(), "textmore text");
+}
+
+TEST_F(BytecodeCacheTest, KeyDependsOnSource) {
+    const BytecodeCache cache(directory_);
+
+    EXPECT_NE(cache_key("1;"), cache_key("2;"));
+    EXPECT_NE(cache.path_for("1;"), cache.path_for("2;"));
+
+    cache.load_or_compile("1;");
+    EXPECT_FALSE(cache.load("2;").has_value());
+}
+
+TEST_F(BytecodeCacheTest, StaleOrCorruptFilesAreMisses) {
+    const std::string source = "1 + 2;";
+    const BytecodeCache cache(directory_);
+    const auto path = cache.path_for(source);
+
+    cache.load_or_compile(source);
+    ASSERT_TRUE(cache.load(source).has_value());
+    // another key
+    EXPECT_FALSE(MappedChunk::open(path, cache_key(source) + 1, source.size())
+                     .has_value());
+
+    // bad magic
+    corrupt(source, 0, "X");
+    EXPECT_FALSE(cache.load(source).has_value());
+
+    // a miss rewrites the file
+    EXPECT_FALSE(cache.load_or_compile(source).was_cached());
+    ASSERT_TRUE(cache.load(source).has_value());
+
+    // unknown opcode in the first instruction, right after the header
+    corrupt(source, 56, std::string(1, '\xc8'));
+    EXPECT_FALSE(cache.load(source).has_value());
+
+    cache.load_or_compile(source);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    EXPECT_FALSE(cache.load(source).has_value());
+
+    std::filesystem::resize_file(path, 8);
+    EXPECT_FALSE(cache.load(source).has_value());
+}
+
+} // namespace
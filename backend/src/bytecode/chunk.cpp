@@ -0,0 +1,196 @@
+#include "bytecode/chunk.h"
+
+#include <bit>
+#include <format>
+#include <stdexcept>
+
+namespace backend::bytecode {
+
+namespace {
+
+enum class Format {
+    ABC,
+    AB,
+    A,
+    ABX,
+    SAX,
+};
+
+Format format_of(Opcode op) {
+    switch (op) {
+        case Opcode::LOAD_CONST:
+            return Format::ABX;
+        case Opcode::MOVE:
+        case Opcode::NEGATE:
+        case Opcode::PLUS:
+        case Opcode::NOT:
+        case Opcode::BITWISE_NOT:
+        case Opcode::TO_BOOL:
+            return Format::AB;
+        case Opcode::TEST:
+        case Opcode::RETURN:
+            return Format::A;
+        case Opcode::JUMP:
+            return Format::SAX;
+        default:
+            return Format::ABC;
+    }
+}
+
+[[noreturn]] void invalid(std::size_t index, std::string_view problem) {
+    throw std::runtime_error(
+        std::vformat("Invalid bytecode at instruction {}: {}",
+                     std::make_format_args(index, problem)));
+}
+
+} // namespace
+
+std::uint16_t Chunk::add_constant(const Value& value) {
+    if (value.type() == Value::Type::STRING) {
+        if (const auto it = string_constants_.find(value.as_string());
+            it != string_constants_.end()) {
+            return it->second;
+        }
+    } else {
+        std::uint64_t bits = 0;
+        switch (value.type()) {
+            case Value::Type::BOOL:
+                bits = value.as_bool();
+                break;
+            case Value::Type::INT:
+                bits = static_cast<std::uint64_t>(value.as_int());
+                break;
+            case Value::Type::DOUBLE:
+                bits = std::bit_cast<std::uint64_t>(value.as_double());
+                break;
+            default:
+                break;
+        }
+        if (const auto it = scalars_.find({value.type(), bits});
+            it != scalars_.end()) {
+            return it->second;
+        }
+        if (constants_.size() < MAX_CONSTANTS) {
+            scalars_.emplace(std::pair(value.type(), bits),
+                             static_cast<std::uint16_t>(constants_.size()));
+        }
+    }
+
+    if (constants_.size() == MAX_CONSTANTS) {
+        throw CompileError("Too many constants in one chunk");
+    }
+    const auto index = static_cast<std::uint16_t>(constants_.size());
+    if (value.type() == Value::Type::STRING) {
+        const auto stored = strings_.store(std::string(value.as_string()));
+        string_constants_.emplace(stored, index);
+        constants_.emplace_back(stored);
+    } else {
+        constants_.push_back(value);
+    }
+    return index;
+}
+
+void verify(const ChunkView& chunk) {
+    if (chunk.register_count > Chunk::MAX_REGISTERS) {
+        throw std::runtime_error("Invalid bytecode: too many registers");
+    }
+    if (chunk.code.empty() || chunk.code.back().op() != Opcode::RETURN) {
+        throw std::runtime_error("Invalid bytecode: missing final RETURN");
+    }
+
+    const auto size = static_cast<std::int64_t>(chunk.code.size());
+    for (std::size_t i = 0; i < chunk.code.size(); ++i) {
+        const auto instruction = chunk.code[i];
+        if (static_cast<std::size_t>(instruction.op()) >= OPCODE_COUNT) {
+            invalid(i, "unknown opcode");
+        }
+
+        const auto check_register = [&](std::uint8_t r) {
+            if (r >= chunk.register_count) {
+                invalid(i, "register out of range");
+            }
+        };
+        switch (format_of(instruction.op())) {
+            case Format::ABC:
+                check_register(instruction.c());
+                [[fallthrough]];
+            case Format::AB:
+                check_register(instruction.b());
+                [[fallthrough]];
+            case Format::A:
+                check_register(instruction.a());
+                break;
+            case Format::ABX:
+                check_register(instruction.a());
+                if (instruction.bx() >= chunk.constants.size()) {
+                    invalid(i, "constant out of range");
+                }
+                break;
+            case Format::SAX: {
+                const auto target =
+                    static_cast<std::int64_t>(i) + 1 + instruction.sax();
+                if (target < 0 || target >= size) {
+                    invalid(i, "jump out of range");
+                }
+                break;
+            }
+        }
+        // a skipping TEST steps over the next instruction, which must be a
+        // JUMP with something after it
+        if (instruction.op() == Opcode::TEST &&
+            (i + 2 >= chunk.code.size() ||
+             chunk.code[i + 1].op() != Opcode::JUMP)) {
+            invalid(i, "TEST not followed by a JUMP");
+        }
+    }
+}
+
+std::string disassemble(const ChunkView& chunk) {
+    std::string text;
+    for (std::size_t i = 0; i < chunk.code.size(); ++i) {
+        const auto instruction = chunk.code[i];
+        const auto op = instruction.op();
+        const int a = instruction.a();
+        const int b = instruction.b();
+        const int c = instruction.c();
+        switch (format_of(op)) {
+            case Format::ABC:
+                text += std::vformat("{}: {} r{} r{} r{}\n",
+                                     std::make_format_args(i, op, a, b, c));
+                break;
+            case Format::AB:
+                text += std::vformat("{}: {} r{} r{}\n",
+                                     std::make_format_args(i, op, a, b));
+                break;
+            case Format::A:
+                if (op == Opcode::TEST) {
+                    text += std::vformat("{}: {} r{} {}\n",
+                                         std::make_format_args(i, op, a, b));
+                } else {
+                    text += std::vformat("{}: {} r{}\n",
+                                         std::make_format_args(i, op, a));
+                }
+                break;
+            case Format::ABX: {
+                const std::size_t bx = instruction.bx();
+                const auto constant = bx < chunk.constants.size()
+                                          ? chunk.constants[bx].to_string()
+                                          : std::string("?");
+                text += std::vformat("{}: {} r{} k{} ({})\n",
+                                     std::make_format_args(i, op, a, bx,
+                                                           constant));
+                break;
+            }
+            case Format::SAX: {
+                const auto target =
+                    static_cast<std::int64_t>(i) + 1 + instruction.sax();
+                text += std::vformat("{}: {} {}\n",
+                                     std::make_format_args(i, op, target));
+                break;
+            }
+        }
+    }
+    return text;
+}
+
+} // namespace backend::bytecode
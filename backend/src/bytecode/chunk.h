@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "bytecode/instruction.h"
+#include "value.h"
+
+namespace backend::bytecode {
+
+// Non-owning view of everything the virtual machine needs to run a program.
+// Code and constants may live in a Chunk or in a memory-mapped file.
+struct ChunkView {
+    std::span<const Instruction> code;
+    std::span<const Value> constants;
+    std::size_t register_count = 0;
+};
+
+// A compiled program: register bytecode plus its constant pool. Constants are
+// deduplicated, and string constants own their bytes, so a chunk does not
+// depend on the AST it was compiled from. Moving a chunk keeps views into its
+// strings valid; copying is disabled for that reason.
+class Chunk {
+public:
+    static constexpr std::size_t MAX_CONSTANTS = 1 << 16;
+    static constexpr std::size_t MAX_REGISTERS = 1 << 8;
+
+    Chunk() = default;
+    Chunk(Chunk&&) = default;
+    Chunk& operator=(Chunk&&) = default;
+    Chunk(const Chunk&) = delete;
+    Chunk& operator=(const Chunk&) = delete;
+
+    std::span<const Instruction> code() const {
+        return code_;
+    }
+
+    std::span<const Value> constants() const {
+        return constants_;
+    }
+
+    std::size_t register_count() const {
+        return register_count_;
+    }
+
+    ChunkView view() const {
+        return {code_, constants_, register_count_};
+    }
+
+    // Appends `instruction` and returns its index.
+    std::size_t emit(Instruction instruction) {
+        code_.push_back(instruction);
+        return code_.size() - 1;
+    }
+
+    void patch(std::size_t index, Instruction instruction) {
+        code_.at(index) = instruction;
+    }
+
+    // Index of `value` in the constant pool, adding it if necessary. Throws a
+    // CompileError once the pool is full.
+    std::uint16_t add_constant(const Value& value);
+
+    void set_register_count(std::size_t count) {
+        register_count_ = count;
+    }
+
+private:
+    std::vector<Instruction> code_;
+    std::vector<Value> constants_;
+    std::size_t register_count_ = 0;
+
+    StringHeap strings_;
+    std::map<std::pair<Value::Type, std::uint64_t>, std::uint16_t> scalars_;
+    std::unordered_map<std::string_view, std::uint16_t> string_constants_;
+};
+
+class CompileError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Checks that every opcode exists, every register and constant index is in
+// range, every jump lands inside the code and the code ends with a RETURN,
+// so that the virtual machine can run it without bounds checks. Throws a
+// std::runtime_error describing the first problem found.
+void verify(const ChunkView& chunk);
+
+// One instruction per line: "<index>: <OPCODE> <operands>".
+std::string disassemble(const ChunkView& chunk);
+
+} // namespace backend::bytecode
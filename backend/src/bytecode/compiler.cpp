@@ -0,0 +1,253 @@
+#include "bytecode/compiler.h"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace backend::bytecode {
+
+namespace ast = frontend::ast;
+
+namespace {
+
+Opcode binary_opcode(ast::Operator::Type op) {
+    switch (op) {
+        case ast::Operator::Type::ADDITION:
+            return Opcode::ADD;
+        case ast::Operator::Type::SUBTRACTION:
+            return Opcode::SUBTRACT;
+        case ast::Operator::Type::MULTIPLICATION:
+            return Opcode::MULTIPLY;
+        case ast::Operator::Type::DIVISION:
+            return Opcode::DIVIDE;
+        case ast::Operator::Type::REMAINDER:
+            return Opcode::REMAINDER;
+        case ast::Operator::Type::BITWISE_AND:
+            return Opcode::BITWISE_AND;
+        case ast::Operator::Type::BITWISE_OR:
+            return Opcode::BITWISE_OR;
+        case ast::Operator::Type::BITWISE_XOR:
+            return Opcode::BITWISE_XOR;
+        case ast::Operator::Type::BITWISE_LEFT_SHIFT:
+            return Opcode::SHIFT_LEFT;
+        case ast::Operator::Type::BITWISE_RIGHT_SHIFT:
+            return Opcode::SHIFT_RIGHT;
+        case ast::Operator::Type::EQUAL_TO:
+            return Opcode::EQUAL;
+        case ast::Operator::Type::NOT_EQUAL_TO:
+            return Opcode::NOT_EQUAL;
+        case ast::Operator::Type::LESS_THAN:
+            return Opcode::LESS;
+        case ast::Operator::Type::LESS_THAN_OR_EQUAL_TO:
+            return Opcode::LESS_EQUAL;
+        case ast::Operator::Type::GREATER_THAN:
+            return Opcode::GREATER;
+        case ast::Operator::Type::GREATER_THAN_OR_EQUAL_TO:
+            return Opcode::GREATER_EQUAL;
+        default:
+            throw CompileError(std::vformat(
+                "Not a binary operator: {}", std::make_format_args(op)));
+    }
+}
+
+Opcode unary_opcode(ast::Operator::Type op) {
+    switch (op) {
+        case ast::Operator::Type::UNARY_MINUS:
+            return Opcode::NEGATE;
+        case ast::Operator::Type::UNARY_PLUS:
+            return Opcode::PLUS;
+        case ast::Operator::Type::LOGICAL_NOT:
+            return Opcode::NOT;
+        case ast::Operator::Type::BITWISE_NOT:
+            return Opcode::BITWISE_NOT;
+        default:
+            throw CompileError(std::vformat(
+                "Not a unary operator: {}", std::make_format_args(op)));
+    }
+}
+
+} // namespace
+
+Chunk Compiler::compile(const ast::AbstractSyntaxTree& ast) {
+    return compile(ast.root());
+}
+
+Chunk Compiler::compile(const ast::Node& node) {
+    chunk_ = Chunk();
+    target_ = RESULT_REGISTER;
+    next_register_ = RESULT_REGISTER + 1;
+    register_count_ = RESULT_REGISTER + 1;
+
+    node.accept(*this);
+    chunk_.emit(Instruction::abc(Opcode::RETURN, RESULT_REGISTER));
+    chunk_.set_register_count(register_count_);
+    return std::exchange(chunk_, Chunk());
+}
+
+void Compiler::compile_expression(const ast::Expression& expression,
+                                  std::uint8_t target) {
+    const auto saved = std::exchange(target_, target);
+    expression.accept(*this);
+    target_ = saved;
+}
+
+void Compiler::load_constant(const Value& value) {
+    chunk_.emit(Instruction::abx(Opcode::LOAD_CONST, target_,
+                                 chunk_.add_constant(value)));
+}
+
+std::uint8_t Compiler::allocate_register() {
+    if (next_register_ == Chunk::MAX_REGISTERS) {
+        throw CompileError("Expression too deeply nested");
+    }
+    const auto index = next_register_++;
+    register_count_ = std::max(register_count_, next_register_);
+    return static_cast<std::uint8_t>(index);
+}
+
+void Compiler::release_register() {
+    --next_register_;
+}
+
+std::size_t Compiler::emit_jump() {
+    return chunk_.emit(Instruction::sax(Opcode::JUMP, 0));
+}
+
+void Compiler::patch_jump(std::size_t index) {
+    const auto offset = static_cast<std::int64_t>(chunk_.code().size()) -
+                        static_cast<std::int64_t>(index) - 1;
+    if (offset > Instruction::MAX_JUMP) {
+        throw CompileError("Jump too long");
+    }
+    chunk_.patch(index, Instruction::sax(Opcode::JUMP,
+                                         static_cast<std::int32_t>(offset)));
+}
+
+void Compiler::visit(const ast::Literal<bool>& literal) {
+    load_constant(literal.value_);
+}
+
+void Compiler::visit(const ast::Literal<std::int64_t>& literal) {
+    load_constant(literal.value_);
+}
+
+void Compiler::visit(const ast::Literal<double>& literal) {
+    load_constant(literal.value_);
+}
+
+void Compiler::visit(const ast::Literal<std::string_view>& literal) {
+    load_constant(literal.value_);
+}
+
+void Compiler::visit(const ast::UnaryExpression& expression) {
+    const auto target = target_;
+    compile_expression(expression.operand(), target);
+    chunk_.emit(
+        Instruction::abc(unary_opcode(expression.op()), target, target));
+}
+
+void Compiler::visit(const ast::BinaryExpression& expression) {
+    if (expression.op() == ast::Operator::Type::LOGICAL_AND ||
+        expression.op() == ast::Operator::Type::LOGICAL_OR) {
+        compile_logical(expression);
+        return;
+    }
+
+    const auto target = target_;
+    compile_expression(expression.left(), target);
+    const auto right = allocate_register();
+    compile_expression(expression.right(), right);
+    release_register();
+    chunk_.emit(Instruction::abc(binary_opcode(expression.op()), target,
+                                 target, right));
+}
+
+// The left operand's truthiness decides whether the right one runs at all;
+// both paths leave a bool in the target:
+//
+//     <left>     -> t
+//     TO_BOOL    t t
+//     TEST       t (0 for &&, 1 for ||)
+//     JUMP       end
+//     <right>    -> t
+//     TO_BOOL    t t
+//   end:
+void Compiler::compile_logical(const ast::BinaryExpression& expression) {
+    const auto target = target_;
+    const bool is_or = expression.op() == ast::Operator::Type::LOGICAL_OR;
+
+    compile_expression(expression.left(), target);
+    chunk_.emit(Instruction::abc(Opcode::TO_BOOL, target, target));
+    chunk_.emit(Instruction::abc(Opcode::TEST, target, is_or));
+    const auto end = emit_jump();
+    compile_expression(expression.right(), target);
+    chunk_.emit(Instruction::abc(Opcode::TO_BOOL, target, target));
+    patch_jump(end);
+}
+
+void Compiler::visit(const ast::Identifier& identifier) {
+    if (identifier.slot() == ast::UNRESOLVED_SLOT) {
+        const auto name = identifier.name();
+        throw std::logic_error(std::vformat("Unresolved identifier {}",
+                                            std::make_format_args(name)));
+    }
+    chunk_.emit(Instruction::abc(
+        Opcode::MOVE, target_,
+        static_cast<std::uint8_t>(RESULT_REGISTER + 1 + identifier.slot())));
+}
+
+void Compiler::visit(const ast::ExpressionStatement& statement) {
+    if (statement.expression_ != nullptr) {
+        compile_expression(*statement.expression_, RESULT_REGISTER);
+    }
+}
+
+void Compiler::visit(const ast::CompoundStatement& statement) {
+    const auto registers = next_register_;
+    for (const auto& child : statement.statements()) {
+        child->accept(*this);
+    }
+    next_register_ = registers;
+}
+
+void Compiler::compile_scoped(const ast::Statement& statement) {
+    const auto registers = next_register_;
+    statement.accept(*this);
+    next_register_ = registers;
+}
+
+void Compiler::visit(const ast::IfStatement& statement) {
+    const auto condition = allocate_register();
+    compile_expression(statement.condition(), condition);
+    release_register();
+
+    chunk_.emit(Instruction::abc(Opcode::TEST, condition, 0));
+    const auto skip_then = emit_jump();
+    compile_scoped(statement.then());
+
+    if (const auto* else_statement = statement.else_statement();
+        else_statement != nullptr) {
+        const auto skip_else = emit_jump();
+        patch_jump(skip_then);
+        compile_scoped(*else_statement);
+        patch_jump(skip_else);
+    } else {
+        patch_jump(skip_then);
+    }
+}
+
+// The constants in scope fill the registers right above the result, so the
+// next free register is the one of the declaration's slot.
+void Compiler::visit(const ast::ConstDeclaration& declaration) {
+    if (declaration.slot() + std::size_t{RESULT_REGISTER + 1} !=
+        next_register_) {
+        const auto name = declaration.name();
+        throw std::logic_error(std::vformat(
+            "Unresolved declaration of {}", std::make_format_args(name)));
+    }
+    compile_expression(declaration.initializer(), allocate_register());
+}
+
+} // namespace backend::bytecode
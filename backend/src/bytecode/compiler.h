@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "ast/ast.h"
+#include "ast/node.h"
+#include "ast/operator.h"
+#include "ast/visitor.h"
+#include "bytecode/chunk.h"
+
+namespace backend::bytecode {
+
+// Compiles an AST to register bytecode with the semantics of the
+// tree-walking Evaluator.
+//
+// Register 0 holds the program result: every expression statement evaluates
+// straight into it and the chunk ends with `RETURN r0`. A constant lives in
+// register 1 + its frontend::Resolver slot, which must have been assigned,
+// from its declaration to the end of its block. Temporaries are allocated
+// stack-wise above the constants in scope, so an expression needs one
+// register per level of right-nesting; more than 255 live registers throw a
+// CompileError. `&&`, `||` and `if` compile to TEST + JUMP pairs.
+class Compiler final : private frontend::ast::Visitor {
+public:
+    Chunk compile(const frontend::ast::AbstractSyntaxTree& ast);
+    Chunk compile(const frontend::ast::Node& node);
+
+private:
+    static constexpr std::uint8_t RESULT_REGISTER = 0;
+
+    void visit(const frontend::ast::Literal<bool>& literal) override;
+    void visit(const frontend::ast::Literal<std::int64_t>& literal) override;
+    void visit(const frontend::ast::Literal<double>& literal) override;
+    void
+    visit(const frontend::ast::Literal<std::string_view>& literal) override;
+    void visit(const frontend::ast::UnaryExpression& expression) override;
+    void visit(const frontend::ast::BinaryExpression& expression) override;
+    void visit(const frontend::ast::Identifier& identifier) override;
+    void visit(const frontend::ast::ExpressionStatement& statement) override;
+    void visit(const frontend::ast::CompoundStatement& statement) override;
+    void visit(const frontend::ast::IfStatement& statement) override;
+    void
+    visit(const frontend::ast::ConstDeclaration& declaration) override;
+
+    // Emits code leaving the value of `expression` in `target`.
+    void compile_expression(const frontend::ast::Expression& expression,
+                            std::uint8_t target);
+    void compile_logical(const frontend::ast::BinaryExpression& expression);
+    // Compiles `statement`, then frees the registers of the constants it
+    // declared.
+    void compile_scoped(const frontend::ast::Statement& statement);
+    void load_constant(const Value& value);
+
+    std::uint8_t allocate_register();
+    void release_register();
+
+    // Emits a JUMP to be patched once its target is known.
+    std::size_t emit_jump();
+    // Points the JUMP at `index` to the next instruction to be emitted.
+    void patch_jump(std::size_t index);
+
+    Chunk chunk_;
+    // register the expression being visited evaluates into
+    std::uint8_t target_ = RESULT_REGISTER;
+    std::size_t next_register_ = RESULT_REGISTER + 1;
+    std::size_t register_count_ = RESULT_REGISTER + 1;
+};
+
+} // namespace backend::bytecode
@@ -0,0 +1,159 @@
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "bytecode/compiler.h"
+#include "parser.h"
+#include "resolver.h"
+#include "scanner.h"
+
+namespace {
+
+using backend::Value;
+using backend::bytecode::Chunk;
+using backend::bytecode::CompileError;
+using backend::bytecode::Compiler;
+using backend::bytecode::Instruction;
+using backend::bytecode::Opcode;
+using backend::bytecode::verify;
+
+Chunk compile(const std::string& source) {
+    const auto ast =
+        frontend::Parser(frontend::Scanner(source).scan_tokens()).parse();
+    frontend::Resolver().resolve(ast);
+    return Compiler().compile(ast);
+}
+
+TEST(Instruction, Operands) {
+    const auto abc = Instruction::abc(Opcode::ADD, 1, 2, 255);
+    EXPECT_EQ(abc.op(), Opcode::ADD);
+    EXPECT_EQ(abc.a(), 1);
+    EXPECT_EQ(abc.b(), 2);
+    EXPECT_EQ(abc.c(), 255);
+
+    EXPECT_EQ(Instruction::abx(Opcode::LOAD_CONST, 3, 65535).bx(), 65535);
+    EXPECT_EQ(Instruction::sax(Opcode::JUMP, -5).sax(), -5);
+    EXPECT_EQ(Instruction::sax(Opcode::JUMP, Instruction::MAX_JUMP).sax(),
+              Instruction::MAX_JUMP);
+    EXPECT_EQ(Instruction::sax(Opcode::JUMP, Instruction::MIN_JUMP).sax(),
+              Instruction::MIN_JUMP);
+}
+
+TEST(Compiler, EmptyProgramReturnsResultRegister) {
+    const auto chunk = compile("");
+
+    ASSERT_EQ(chunk.code().size(), 1);
+    EXPECT_EQ(chunk.code()[0], Instruction::abc(Opcode::RETURN, 0));
+    EXPECT_EQ(chunk.register_count(), 1);
+}
+
+TEST(Compiler, Disassembly) {
+    EXPECT_EQ(disassemble(compile("1 + 2 * 3;").view()),
+              "0: LOAD_CONST r0 k0 (1)\n"
+              "1: LOAD_CONST r1 k1 (2)\n"
+              "2: LOAD_CONST r2 k2 (3)\n"
+              "3: MULTIPLY r1 r1 r2\n"
+              "4: ADD r0 r0 r1\n"
+              "5: RETURN r0\n");
+}
+
+TEST(Compiler, ConstantsLiveInRegistersAboveTheResult) {
+    const auto chunk = compile("const a = 1; { const b = a + 2; b; } a * 3;");
+    EXPECT_EQ(disassemble(chunk.view()),
+              "0: LOAD_CONST r1 k0 (1)\n"
+              "1: MOVE r2 r1\n"
+              "2: LOAD_CONST r3 k1 (2)\n"
+              "3: ADD r2 r2 r3\n"
+              "4: MOVE r0 r2\n"
+              "5: MOVE r0 r1\n"
+              "6: LOAD_CONST r2 k2 (3)\n"
+              "7: MULTIPLY r0 r0 r2\n"
+              "8: RETURN r0\n");
+}
+
+TEST(Compiler, IfElseJumps) {
+    EXPECT_EQ(disassemble(compile("if (1) 2; else 3;").view()),
+              "0: LOAD_CONST r1 k0 (1)\n"
+              "1: TEST r1 0\n"
+              "2: JUMP 5\n"
+              "3: LOAD_CONST r0 k1 (2)\n"
+              "4: JUMP 6\n"
+              "5: LOAD_CONST r0 k2 (3)\n"
+              "6: RETURN r0\n");
+}
+
+TEST(Compiler, ConstantsArePooled) {
+    const auto chunk = compile("7 + 7; 7.0; \"s\"; \"s\" + \"t\"; true; 1;");
+
+    // 7 and 7.0 compare equal but are distinct constants
+    ASSERT_EQ(chunk.constants().size(), 6);
+    EXPECT_EQ(chunk.constants()[0].type(), Value::Type::INT);
+    EXPECT_EQ(chunk.constants()[1].type(), Value::Type::DOUBLE);
+    EXPECT_EQ(chunk.constants()[2].as_string(), "s");
+    EXPECT_EQ(chunk.constants()[3].as_string(), "t");
+    EXPECT_EQ(chunk.constants()[4], Value(true));
+    EXPECT_EQ(chunk.constants()[5], Value(std::int64_t{1}));
+}
+
+TEST(Compiler, LeftNestingReusesRegisters) {
+    std::string source = "0";
+    for (int i = 0; i < 1000; ++i) {
+        source += " + 1";
+    }
+    source += ";";
+
+    EXPECT_EQ(compile(source).register_count(), 2);
+}
+
+TEST(Compiler, TooDeeplyNested) {
+    std::string source;
+    for (int i = 0; i < 300; ++i) {
+        source += "1 + (";
+    }
+    source += "1";
+    source += std::string(300, ')');
+    source += ";";
+
+    EXPECT_THROW(compile(source), CompileError);
+}
+
+TEST(Compiler, OutputVerifies) {
+    EXPECT_NO_THROW(verify(
+        compile("if (1 < 2) { 1; } else if (2) 3; else 4 - 8;").view()));
+}
+
+TEST(Verify, RejectsInvalidCode) {
+    const std::vector<Value> constants = {Value(std::int64_t{1})};
+    const auto check = [&](std::vector<Instruction> code) {
+        EXPECT_THROW(verify({code, constants, 2}), std::runtime_error);
+    };
+
+    check({});
+    check({Instruction::abc(Opcode::MOVE, 0, 1)});
+    check({Instruction::abc(Opcode::RETURN, 2)});
+    check({Instruction::abx(Opcode::LOAD_CONST, 0, 1),
+           Instruction::abc(Opcode::RETURN, 0)});
+    check({Instruction::sax(Opcode::JUMP, 1),
+           Instruction::abc(Opcode::RETURN, 0)});
+    check({Instruction::sax(Opcode::JUMP, -2),
+           Instruction::abc(Opcode::RETURN, 0)});
+    check({Instruction::abc(static_cast<Opcode>(200), 0),
+           Instruction::abc(Opcode::RETURN, 0)});
+    // a skipping TEST would step past the final RETURN
+    check({Instruction::abc(Opcode::TEST, 0, 1),
+           Instruction::abc(Opcode::RETURN, 0)});
+    check({Instruction::abc(Opcode::TEST, 0, 1),
+           Instruction::abc(Opcode::MOVE, 0, 1),
+           Instruction::abc(Opcode::RETURN, 0)});
+    const std::vector<Instruction> test_and_jump = {
+        Instruction::abc(Opcode::TEST, 0, 1),
+        Instruction::sax(Opcode::JUMP, 0),
+        Instruction::abc(Opcode::RETURN, 0),
+    };
+    EXPECT_NO_THROW(verify({test_and_jump, constants, 2}));
+}
+
+} // namespace
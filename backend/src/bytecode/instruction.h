@@ -0,0 +1,192 @@
+#pragma once
+
+#include <cstdint>
+#include <format>
+#include <string_view>
+
+namespace backend::bytecode {
+
+// Fixed-width 32-bit instructions: an 8-bit opcode followed by either three
+// 8-bit operands A, B, C, an 8-bit A and a 16-bit Bx, or a signed 24-bit sAx.
+// Operands named R are register indices, K an index into the constant pool.
+enum class Opcode : std::uint8_t {
+    // clang-format off
+
+    LOAD_CONST,     // R[A] = K[Bx]
+    MOVE,           // R[A] = R[B]
+
+    // R[A] = R[B] op R[C]
+    ADD, SUBTRACT, MULTIPLY, DIVIDE, REMAINDER,
+    BITWISE_AND, BITWISE_OR, BITWISE_XOR, SHIFT_LEFT, SHIFT_RIGHT,
+    EQUAL, NOT_EQUAL, LESS, LESS_EQUAL, GREATER, GREATER_EQUAL,
+
+    // R[A] = op R[B]
+    NEGATE, PLUS, NOT, BITWISE_NOT, TO_BOOL,
+
+    TEST,           // skip the next instruction unless truthy(R[A]) == B
+    JUMP,           // pc += sAx, relative to the next instruction
+    RETURN,         // return R[A]
+
+    // clang-format on
+};
+
+inline constexpr std::size_t OPCODE_COUNT =
+    static_cast<std::size_t>(Opcode::RETURN) + 1;
+
+class Instruction {
+public:
+    static constexpr std::int32_t MAX_JUMP = (1 << 23) - 1;
+    static constexpr std::int32_t MIN_JUMP = -(1 << 23);
+
+    constexpr Instruction() = default;
+
+    static constexpr Instruction abc(Opcode op, std::uint8_t a,
+                                     std::uint8_t b = 0, std::uint8_t c = 0) {
+        return Instruction(static_cast<std::uint32_t>(op) |
+                           static_cast<std::uint32_t>(a) << 8 |
+                           static_cast<std::uint32_t>(b) << 16 |
+                           static_cast<std::uint32_t>(c) << 24);
+    }
+
+    static constexpr Instruction abx(Opcode op, std::uint8_t a,
+                                     std::uint16_t bx) {
+        return Instruction(static_cast<std::uint32_t>(op) |
+                           static_cast<std::uint32_t>(a) << 8 |
+                           static_cast<std::uint32_t>(bx) << 16);
+    }
+
+    static constexpr Instruction sax(Opcode op, std::int32_t sax) {
+        return Instruction(static_cast<std::uint32_t>(op) |
+                           static_cast<std::uint32_t>(sax) << 8);
+    }
+
+    constexpr Opcode op() const {
+        return static_cast<Opcode>(bits_ & 0xff);
+    }
+
+    constexpr std::uint8_t a() const {
+        return static_cast<std::uint8_t>(bits_ >> 8);
+    }
+
+    constexpr std::uint8_t b() const {
+        return static_cast<std::uint8_t>(bits_ >> 16);
+    }
+
+    constexpr std::uint8_t c() const {
+        return static_cast<std::uint8_t>(bits_ >> 24);
+    }
+
+    constexpr std::uint16_t bx() const {
+        return static_cast<std::uint16_t>(bits_ >> 16);
+    }
+
+    // arithmetic shift sign-extends the 24-bit field
+    constexpr std::int32_t sax() const {
+        return static_cast<std::int32_t>(bits_) >> 8;
+    }
+
+    constexpr std::uint32_t bits() const {
+        return bits_;
+    }
+
+    constexpr bool operator==(const Instruction& other) const = default;
+
+private:
+    constexpr explicit Instruction(std::uint32_t bits) : bits_(bits) {}
+
+    std::uint32_t bits_ = 0;
+};
+
+static_assert(sizeof(Instruction) == 4);
+
+} // namespace backend::bytecode
+
+template <>
+struct std::formatter<backend::bytecode::Opcode>
+    : std::formatter<std::string_view> {
+    auto format(backend::bytecode::Opcode op, std::format_context& ctx) const {
+        using Opcode = backend::bytecode::Opcode;
+        std::string_view name = "UNDEFINED";
+        switch (op) {
+            case Opcode::LOAD_CONST:
+                name = "LOAD_CONST";
+                break;
+            case Opcode::MOVE:
+                name = "MOVE";
+                break;
+            case Opcode::ADD:
+                name = "ADD";
+                break;
+            case Opcode::SUBTRACT:
+                name = "SUBTRACT";
+                break;
+            case Opcode::MULTIPLY:
+                name = "MULTIPLY";
+                break;
+            case Opcode::DIVIDE:
+                name = "DIVIDE";
+                break;
+            case Opcode::REMAINDER:
+                name = "REMAINDER";
+                break;
+            case Opcode::BITWISE_AND:
+                name = "BITWISE_AND";
+                break;
+            case Opcode::BITWISE_OR:
+                name = "BITWISE_OR";
+                break;
+            case Opcode::BITWISE_XOR:
+                name = "BITWISE_XOR";
+                break;
+            case Opcode::SHIFT_LEFT:
+                name = "SHIFT_LEFT";
+                break;
+            case Opcode::SHIFT_RIGHT:
+                name = "SHIFT_RIGHT";
+                break;
+            case Opcode::EQUAL:
+                name = "EQUAL";
+                break;
+            case Opcode::NOT_EQUAL:
+                name = "NOT_EQUAL";
+                break;
+            case Opcode::LESS:
+                name = "LESS";
+                break;
+            case Opcode::LESS_EQUAL:
+                name = "LESS_EQUAL";
+                break;
+            case Opcode::GREATER:
+                name = "GREATER";
+                break;
+            case Opcode::GREATER_EQUAL:
+                name = "GREATER_EQUAL";
+                break;
+            case Opcode::NEGATE:
+                name = "NEGATE";
+                break;
+            case Opcode::PLUS:
+                name = "PLUS";
+                break;
+            case Opcode::NOT:
+                name = "NOT";
+                break;
+            case Opcode::BITWISE_NOT:
+                name = "BITWISE_NOT";
+                break;
+            case Opcode::TO_BOOL:
+                name = "TO_BOOL";
+                break;
+            case Opcode::TEST:
+                name = "TEST";
+                break;
+            case Opcode::JUMP:
+                name = "JUMP";
+                break;
+            case Opcode::RETURN:
+                name = "RETURN";
+                break;
+        }
+        return std::formatter<std::string_view>::format(name, ctx);
+    }
+};
@@ -0,0 +1,67 @@
+#include <cstdint>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_programs.h"
+#include "bytecode/compiler.h"
+#include "bytecode/vm.h"
+#include "parser.h"
+#include "scanner.h"
+
+// Same programs and sizes as the tree-walking evaluator's benchmarks so that
+// the two engines can be compared directly.
+
+namespace {
+
+backend::bytecode::Chunk compile(const std::string& source) {
+    return backend::bytecode::Compiler().compile(
+        frontend::Parser(frontend::Scanner(source).scan_tokens()).parse());
+}
+
+void run(benchmark::State& state, const std::string& source) {
+    const auto chunk = compile(source);
+    backend::bytecode::VirtualMachine vm;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(vm.run(chunk));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel("items = statements");
+}
+
+void BM_InterpretArithmetic(benchmark::State& state) {
+    run(state, backend::bench::arithmetic_program(
+                   static_cast<std::size_t>(state.range(0))));
+}
+
+void BM_InterpretBranches(benchmark::State& state) {
+    run(state, backend::bench::branchy_program(
+                   static_cast<std::size_t>(state.range(0))));
+}
+
+void BM_InterpretFloatingPoint(benchmark::State& state) {
+    run(state, backend::bench::floating_point_program(
+                   static_cast<std::size_t>(state.range(0))));
+}
+
+void BM_CompileArithmetic(benchmark::State& state) {
+    const auto ast = frontend::Parser(
+                         frontend::Scanner(backend::bench::arithmetic_program(
+                                               static_cast<std::size_t>(
+                                                   state.range(0))))
+                             .scan_tokens())
+                         .parse();
+    backend::bytecode::Compiler compiler;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(compiler.compile(ast));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel("items = statements");
+}
+
+BENCHMARK(BM_InterpretArithmetic)->Range(64, 16384);
+BENCHMARK(BM_InterpretBranches)->Range(64, 16384);
+BENCHMARK(BM_InterpretFloatingPoint)->Range(64, 16384);
+BENCHMARK(BM_CompileArithmetic)->Range(64, 16384);
+
+} // namespace
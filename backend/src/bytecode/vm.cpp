@@ -0,0 +1,190 @@
+#include "bytecode/vm.h"
+
+#include <cstdint>
+
+#include "ast/operator.h"
+#include "operations.h"
+
+namespace backend::bytecode {
+
+namespace {
+
+using Operator = frontend::ast::Operator;
+
+std::uint64_t bits(std::int64_t value) {
+    return static_cast<std::uint64_t>(value);
+}
+
+std::int64_t wrap(std::uint64_t value) {
+    return static_cast<std::int64_t>(value);
+}
+
+bool both_int(const Value& left, const Value& right) {
+    return left.type() == Value::Type::INT && right.type() == Value::Type::INT;
+}
+
+} // namespace
+
+Value VirtualMachine::run(const Chunk& chunk) {
+    return run(chunk.view());
+}
+
+#if BACKEND_COMPUTED_GOTO
+// labels as values are a GNU extension
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+
+Value VirtualMachine::run(const ChunkView& chunk) {
+    registers_.assign(chunk.register_count, Value());
+    Value* const r = registers_.data();
+    const Value* const k = chunk.constants.data();
+    const Instruction* pc = chunk.code.data();
+    Instruction instruction;
+
+// R[A] = R[B] op R[C] with `expression` computed from the int64_t operands x
+// and y when both are integers.
+#define INT_BINARY(expression, op)                                             \
+    {                                                                          \
+        const auto& left = r[instruction.b()];                                 \
+        const auto& right = r[instruction.c()];                                \
+        if (both_int(left, right)) {                                           \
+            const auto x = left.as_int();                                      \
+            const auto y = right.as_int();                                     \
+            r[instruction.a()] = Value(expression);                            \
+        } else {                                                               \
+            r[instruction.a()] = apply_binary(op, left, right, strings_);      \
+        }                                                                      \
+    }
+
+#define SLOW_BINARY(op)                                                        \
+    r[instruction.a()] =                                                       \
+        apply_binary(op, r[instruction.b()], r[instruction.c()], strings_)
+
+#define SLOW_UNARY(op) r[instruction.a()] = apply_unary(op, r[instruction.b()])
+
+#if BACKEND_COMPUTED_GOTO
+    // in Opcode order
+    static void* const HANDLERS[OPCODE_COUNT] = {
+        &&LOAD_CONST,  &&MOVE,          &&ADD,         &&SUBTRACT,
+        &&MULTIPLY,    &&DIVIDE,        &&REMAINDER,   &&BITWISE_AND,
+        &&BITWISE_OR,  &&BITWISE_XOR,   &&SHIFT_LEFT,  &&SHIFT_RIGHT,
+        &&EQUAL,       &&NOT_EQUAL,     &&LESS,        &&LESS_EQUAL,
+        &&GREATER,     &&GREATER_EQUAL, &&NEGATE,      &&PLUS,
+        &&NOT,         &&BITWISE_NOT,   &&TO_BOOL,     &&TEST,
+        &&JUMP,        &&RETURN,
+    };
+#define HANDLER(name) name
+#define DISPATCH()                                                             \
+    instruction = *pc++;                                                       \
+    goto* HANDLERS[static_cast<std::uint8_t>(instruction.op())]
+
+    DISPATCH();
+#else
+#define HANDLER(name) case Opcode::name
+#define DISPATCH() continue
+
+    for (;;) {
+        instruction = *pc++;
+        switch (instruction.op()) {
+#endif
+
+    HANDLER(LOAD_CONST):
+        r[instruction.a()] = k[instruction.bx()];
+        DISPATCH();
+    HANDLER(MOVE):
+        r[instruction.a()] = r[instruction.b()];
+        DISPATCH();
+    HANDLER(ADD):
+        INT_BINARY(wrap(bits(x) + bits(y)), Operator::Type::ADDITION)
+        DISPATCH();
+    HANDLER(SUBTRACT):
+        INT_BINARY(wrap(bits(x) - bits(y)), Operator::Type::SUBTRACTION)
+        DISPATCH();
+    HANDLER(MULTIPLY):
+        INT_BINARY(wrap(bits(x) * bits(y)), Operator::Type::MULTIPLICATION)
+        DISPATCH();
+    HANDLER(DIVIDE):
+        SLOW_BINARY(Operator::Type::DIVISION);
+        DISPATCH();
+    HANDLER(REMAINDER):
+        SLOW_BINARY(Operator::Type::REMAINDER);
+        DISPATCH();
+    HANDLER(BITWISE_AND):
+        INT_BINARY(x & y, Operator::Type::BITWISE_AND)
+        DISPATCH();
+    HANDLER(BITWISE_OR):
+        INT_BINARY(x | y, Operator::Type::BITWISE_OR)
+        DISPATCH();
+    HANDLER(BITWISE_XOR):
+        INT_BINARY(x ^ y, Operator::Type::BITWISE_XOR)
+        DISPATCH();
+    HANDLER(SHIFT_LEFT):
+        SLOW_BINARY(Operator::Type::BITWISE_LEFT_SHIFT);
+        DISPATCH();
+    HANDLER(SHIFT_RIGHT):
+        SLOW_BINARY(Operator::Type::BITWISE_RIGHT_SHIFT);
+        DISPATCH();
+    HANDLER(EQUAL):
+        INT_BINARY(x == y, Operator::Type::EQUAL_TO)
+        DISPATCH();
+    HANDLER(NOT_EQUAL):
+        INT_BINARY(x != y, Operator::Type::NOT_EQUAL_TO)
+        DISPATCH();
+    HANDLER(LESS):
+        INT_BINARY(x < y, Operator::Type::LESS_THAN)
+        DISPATCH();
+    HANDLER(LESS_EQUAL):
+        INT_BINARY(x <= y, Operator::Type::LESS_THAN_OR_EQUAL_TO)
+        DISPATCH();
+    HANDLER(GREATER):
+        INT_BINARY(x > y, Operator::Type::GREATER_THAN)
+        DISPATCH();
+    HANDLER(GREATER_EQUAL):
+        INT_BINARY(x >= y, Operator::Type::GREATER_THAN_OR_EQUAL_TO)
+        DISPATCH();
+    HANDLER(NEGATE):
+        SLOW_UNARY(Operator::Type::UNARY_MINUS);
+        DISPATCH();
+    HANDLER(PLUS):
+        SLOW_UNARY(Operator::Type::UNARY_PLUS);
+        DISPATCH();
+    HANDLER(NOT):
+        r[instruction.a()] = !r[instruction.b()].is_truthy();
+        DISPATCH();
+    HANDLER(BITWISE_NOT):
+        SLOW_UNARY(Operator::Type::BITWISE_NOT);
+        DISPATCH();
+    HANDLER(TO_BOOL):
+        r[instruction.a()] = r[instruction.b()].is_truthy();
+        DISPATCH();
+    HANDLER(TEST):
+        if (r[instruction.a()].is_truthy() != (instruction.b() != 0)) {
+            ++pc;
+        }
+        DISPATCH();
+    HANDLER(JUMP):
+        pc += instruction.sax();
+        DISPATCH();
+    HANDLER(RETURN):
+        return r[instruction.a()];
+
+#if !BACKEND_COMPUTED_GOTO
+        }
+        // unknown opcodes cannot get past verify()
+        return Value();
+    }
+#endif
+
+#undef INT_BINARY
+#undef SLOW_BINARY
+#undef SLOW_UNARY
+#undef HANDLER
+#undef DISPATCH
+}
+
+#if BACKEND_COMPUTED_GOTO
+#pragma GCC diagnostic pop
+#endif
+
+} // namespace backend::bytecode
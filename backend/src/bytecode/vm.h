@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+
+#include "bytecode/chunk.h"
+#include "value.h"
+
+// GCC and Clang dispatch through a table of label addresses (computed goto),
+// giving every handler its own indirect branch; other compilers fall back to
+// a switch in a loop.
+#ifndef BACKEND_COMPUTED_GOTO
+#if defined(__GNUC__) || defined(__clang__)
+#define BACKEND_COMPUTED_GOTO 1
+#else
+#define BACKEND_COMPUTED_GOTO 0
+#endif
+#endif
+
+namespace backend::bytecode {
+
+// Register-based virtual machine running chunks produced by the Compiler.
+//
+// Integer operands take inline fast paths; everything else goes through
+// apply_binary() and apply_unary(), so results and errors match the
+// tree-walking Evaluator exactly. The chunk is trusted: code that did not
+// come from the Compiler must pass verify() first. String results point into
+// the chunk or the machine, so they must not outlive either.
+class VirtualMachine {
+public:
+    Value run(const Chunk& chunk);
+    Value run(const ChunkView& chunk);
+
+private:
+    std::vector<Value> registers_;
+    StringHeap strings_;
+};
+
+} // namespace backend::bytecode
@@ -0,0 +1,228 @@
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "ast/node.h"
+#include "bench_programs.h"
+#include "bytecode/compiler.h"
+#include "bytecode/vm.h"
+#include "interpreter/evaluator.h"
+#include "parser.h"
+#include "resolver.h"
+#include "scanner.h"
+
+namespace {
+
+using backend::EvaluationError;
+using backend::Value;
+using backend::bytecode::Compiler;
+using backend::bytecode::VirtualMachine;
+
+frontend::ast::AbstractSyntaxTree parse(const std::string& source) {
+    auto ast =
+        frontend::Parser(frontend::Scanner(source).scan_tokens()).parse();
+    frontend::Resolver().resolve(ast);
+    return ast;
+}
+
+Value run(const std::string& source) {
+    const auto chunk = Compiler().compile(parse(source));
+    return VirtualMachine().run(chunk);
+}
+
+// String results only live as long as the chunk and the machine.
+std::string run_to_string(const std::string& source) {
+    const auto chunk = Compiler().compile(parse(source));
+    VirtualMachine vm;
+    return vm.run(chunk).to_string();
+}
+
+// Runs `source` on both engines and expects the same result or error.
+void expect_same_as_evaluator(const std::string& source) {
+    const auto ast = parse(source);
+    const auto chunk = Compiler().compile(ast);
+    backend::interpreter::Evaluator evaluator;
+    VirtualMachine vm;
+
+    std::string expected;
+    std::string actual;
+    try {
+        const auto value = evaluator.evaluate(ast);
+        expected = std::vformat("{}: {}", std::make_format_args(
+                                              value.type(), value.to_string()));
+    } catch (const EvaluationError& error) {
+        expected = error.what();
+    }
+    try {
+        const auto value = vm.run(chunk);
+        actual = std::vformat("{}: {}", std::make_format_args(
+                                            value.type(), value.to_string()));
+    } catch (const EvaluationError& error) {
+        actual = error.what();
+    }
+    EXPECT_EQ(actual, expected) << source;
+}
+
+TEST(VirtualMachine, EmptyProgram) {
+    EXPECT_EQ(run("").type(), Value::Type::NONE);
+    EXPECT_EQ(run(";;").type(), Value::Type::NONE);
+}
+
+TEST(VirtualMachine, LastExpressionStatementIsTheResult) {
+    EXPECT_EQ(run("1; 2; 3; ;"), Value(std::int64_t{3}));
+}
+
+TEST(VirtualMachine, IntegerArithmetic) {
+    EXPECT_EQ(run("4 % 3 + 5 * 2;"), Value(std::int64_t{11}));
+    EXPECT_EQ(run("7 / 2 - 10;"), Value(std::int64_t{-7}));
+    EXPECT_EQ(run("1 - (2 - (3 - (4 - 5)));"), Value(std::int64_t{3}));
+    EXPECT_EQ(run("9223372036854775807 + 1;"),
+              Value(std::numeric_limits<std::int64_t>::min()));
+}
+
+TEST(VirtualMachine, Errors) {
+    EXPECT_THROW(run("1 / 0;"), EvaluationError);
+    EXPECT_THROW(run("1 << 64;"), EvaluationError);
+    EXPECT_THROW(run("\"a\" - 1;"), EvaluationError);
+}
+
+TEST(VirtualMachine, Strings) {
+    EXPECT_EQ(run_to_string("\"foo\" + \"bar\";"), "foobar");
+    EXPECT_EQ(run("\"abc\" < \"abd\";"), Value(true));
+}
+
+// The parser has no syntax for logical operators yet, so build them by hand.
+Value run_logical(frontend::ast::Operator::Type op,
+                  std::unique_ptr<frontend::ast::Expression> left,
+                  std::unique_ptr<frontend::ast::Expression> right) {
+    const frontend::ast::ExpressionStatement statement(
+        std::make_unique<frontend::ast::BinaryExpression>(
+            std::move(left), op, std::move(right)));
+    const auto chunk = Compiler().compile(statement);
+    return VirtualMachine().run(chunk);
+}
+
+std::unique_ptr<frontend::ast::Expression> literal(std::int64_t value) {
+    return std::make_unique<frontend::ast::Literal<std::int64_t>>(value);
+}
+
+std::unique_ptr<frontend::ast::Expression> division_by_zero() {
+    return std::make_unique<frontend::ast::BinaryExpression>(
+        literal(1), frontend::ast::Operator::Type::DIVISION, literal(0));
+}
+
+TEST(VirtualMachine, ShortCircuit) {
+    using Type = frontend::ast::Operator::Type;
+
+    EXPECT_EQ(run_logical(Type::LOGICAL_AND, literal(0), division_by_zero()),
+              Value(false));
+    EXPECT_EQ(run_logical(Type::LOGICAL_OR, literal(1), division_by_zero()),
+              Value(true));
+    EXPECT_EQ(run_logical(Type::LOGICAL_AND, literal(2), literal(3)),
+              Value(true));
+    EXPECT_EQ(run_logical(Type::LOGICAL_OR, literal(0), literal(0)),
+              Value(false));
+    EXPECT_THROW(
+        run_logical(Type::LOGICAL_AND, literal(1), division_by_zero()),
+        EvaluationError);
+}
+
+TEST(VirtualMachine, IfStatements) {
+    EXPECT_EQ(run("if (1 < 2) 10; else 20;"), Value(std::int64_t{10}));
+    EXPECT_EQ(run("if (1 > 2) 10; else 20;"), Value(std::int64_t{20}));
+    EXPECT_EQ(run("5; if (0) 10;"), Value(std::int64_t{5}));
+    EXPECT_EQ(run("if (0) 1; else if (\"\") 2; else { 3; 4; }"),
+              Value(std::int64_t{4}));
+}
+
+TEST(VirtualMachine, MachineIsReusable) {
+    const auto first = Compiler().compile(parse("1 + 2;"));
+    const auto second = Compiler().compile(parse("if (1) 2 * 3;"));
+    VirtualMachine vm;
+
+    EXPECT_EQ(vm.run(first), Value(std::int64_t{3}));
+    EXPECT_EQ(vm.run(second), Value(std::int64_t{6}));
+    EXPECT_EQ(vm.run(first), Value(std::int64_t{3}));
+}
+
+TEST(VirtualMachine, MatchesEvaluator) {
+    for (const auto* source : {
+             "(0 - 5) % 3; 5 % (0 - 3); (0 - 9223372036854775807) - 1;",
+             "((0 - 9223372036854775807) - 1) / (0 - 1);",
+             "((0 - 9223372036854775807) - 1) % (0 - 1);",
+             "1024 >> 3; 1 << 63; 1 >> (0 - 1);",
+             "1.5 * 2 + 1; 7.5 % 2; 1 / 0.0;",
+             "0.0 / 0.0 < 1; 0.0 / 0.0 == 0.0 / 0.0;",
+             "1 == 1.0; 2 != 2.5; 3 <= 3; 4 >= 5; 1 > 0.5;",
+             "true + 1;",
+             "\"a\" == \"a\"; \"a\" != \"b\"; \"a\" == 1; true == 1;",
+             "\"x\" + 1;",
+             "if (0) 1; else if (2) { 2; if (3) 4; else 5; }",
+             "if (\"s\") { \"then\"; } else { \"else\"; }",
+             "const a = 2; const b = a * a; { const a = b + 1; a * b; }",
+             "const x = 1; if (x) { const y = x + 1; } else { const z = 3; "
+             "z; } x;",
+             "const s = \"s\"; if (s) { const t = s + s; t + s; }",
+         }) {
+        expect_same_as_evaluator(source);
+    }
+}
+
+// Unary and bitwise operators have no syntax yet either.
+TEST(VirtualMachine, MatchesEvaluatorOnOperatorsWithoutSyntax) {
+    using frontend::ast::BinaryExpression;
+    using frontend::ast::Literal;
+    using frontend::ast::UnaryExpression;
+    using Type = frontend::ast::Operator::Type;
+
+    const auto check = [](std::unique_ptr<frontend::ast::Expression> e) {
+        const frontend::ast::ExpressionStatement statement(std::move(e));
+        const auto chunk = Compiler().compile(statement);
+        backend::interpreter::Evaluator evaluator;
+        VirtualMachine vm;
+        try {
+            const auto expected = evaluator.evaluate(statement);
+            EXPECT_EQ(vm.run(chunk), expected) << statement.to_string();
+        } catch (const EvaluationError&) {
+            EXPECT_THROW(vm.run(chunk), EvaluationError)
+                << statement.to_string();
+        }
+    };
+    const auto number = [](double value) {
+        return std::make_unique<Literal<double>>(value);
+    };
+    const auto string = [](const char* value) {
+        return std::make_unique<Literal<std::string_view>>(value);
+    };
+
+    for (const auto op : {Type::UNARY_MINUS, Type::UNARY_PLUS,
+                          Type::LOGICAL_NOT, Type::BITWISE_NOT}) {
+        check(std::make_unique<UnaryExpression>(op, literal(5)));
+        check(std::make_unique<UnaryExpression>(op, number(2.5)));
+        check(std::make_unique<UnaryExpression>(op, string("")));
+        check(std::make_unique<UnaryExpression>(
+            op, std::make_unique<Literal<bool>>(true)));
+    }
+    check(std::make_unique<UnaryExpression>(
+        Type::UNARY_MINUS,
+        std::make_unique<BinaryExpression>(
+            literal(std::numeric_limits<std::int64_t>::max()),
+            Type::ADDITION, literal(1))));
+    for (const auto op :
+         {Type::BITWISE_AND, Type::BITWISE_OR, Type::BITWISE_XOR}) {
+        check(std::make_unique<BinaryExpression>(literal(12), op, literal(10)));
+        check(
+            std::make_unique<BinaryExpression>(literal(12), op, number(1.0)));
+    }
+}
+
+TEST(VirtualMachine, MatchesEvaluatorOnBenchmarkPrograms) {
+    expect_same_as_evaluator(backend::bench::arithmetic_program(200));
+    expect_same_as_evaluator(backend::bench::branchy_program(200));
+    expect_same_as_evaluator(backend::bench::floating_point_program(200));
+}
+
+} // namespace
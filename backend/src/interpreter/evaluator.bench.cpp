@@ -0,0 +1,46 @@
+#include <cstdint>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_programs.h"
+#include "interpreter/evaluator.h"
+#include "parser.h"
+#include "scanner.h"
+
+namespace {
+
+frontend::ast::AbstractSyntaxTree parse(const std::string& source) {
+    return frontend::Parser(frontend::Scanner(source).scan_tokens()).parse();
+}
+
+void run(benchmark::State& state, const std::string& source) {
+    const auto ast = parse(source);
+    backend::interpreter::Evaluator evaluator;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(evaluator.evaluate(ast));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel("items = statements");
+}
+
+void BM_EvaluateArithmetic(benchmark::State& state) {
+    run(state, backend::bench::arithmetic_program(
+                   static_cast<std::size_t>(state.range(0))));
+}
+
+void BM_EvaluateBranches(benchmark::State& state) {
+    run(state, backend::bench::branchy_program(
+                   static_cast<std::size_t>(state.range(0))));
+}
+
+void BM_EvaluateFloatingPoint(benchmark::State& state) {
+    run(state, backend::bench::floating_point_program(
+                   static_cast<std::size_t>(state.range(0))));
+}
+
+BENCHMARK(BM_EvaluateArithmetic)->Range(64, 16384);
+BENCHMARK(BM_EvaluateBranches)->Range(64, 16384);
+BENCHMARK(BM_EvaluateFloatingPoint)->Range(64, 16384);
+
+} // namespace
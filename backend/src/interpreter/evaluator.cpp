@@ -0,0 +1,111 @@
+#include "interpreter/evaluator.h"
+
+#include <format>
+#include <stdexcept>
+
+#include "operations.h"
+
+namespace backend::interpreter {
+
+namespace ast = frontend::ast;
+
+Value Evaluator::evaluate(const ast::AbstractSyntaxTree& ast) {
+    return evaluate(ast.root());
+}
+
+Value Evaluator::evaluate(const ast::Node& node) {
+    result_ = Value();
+    frame_.clear();
+    node.accept(*this);
+    return result_;
+}
+
+Value Evaluator::evaluate_expression(const ast::Expression& expression) {
+    expression.accept(*this);
+    return value_;
+}
+
+void Evaluator::visit(const ast::Literal<bool>& literal) {
+    value_ = literal.value_;
+}
+
+void Evaluator::visit(const ast::Literal<std::int64_t>& literal) {
+    value_ = literal.value_;
+}
+
+void Evaluator::visit(const ast::Literal<double>& literal) {
+    value_ = literal.value_;
+}
+
+void Evaluator::visit(const ast::Literal<std::string_view>& literal) {
+    value_ = literal.value_;
+}
+
+void Evaluator::visit(const ast::UnaryExpression& expression) {
+    value_ = apply_unary(expression.op(),
+                         evaluate_expression(expression.operand()));
+}
+
+void Evaluator::visit(const ast::BinaryExpression& expression) {
+    const auto left = evaluate_expression(expression.left());
+
+    // short-circuit
+    if (expression.op() == ast::Operator::Type::LOGICAL_AND &&
+        !left.is_truthy()) {
+        value_ = false;
+        return;
+    }
+    if (expression.op() == ast::Operator::Type::LOGICAL_OR &&
+        left.is_truthy()) {
+        value_ = true;
+        return;
+    }
+
+    const auto right = evaluate_expression(expression.right());
+    value_ = apply_binary(expression.op(), left, right, strings_);
+}
+
+void Evaluator::visit(const ast::Identifier& identifier) {
+    if (identifier.slot() == ast::UNRESOLVED_SLOT) {
+        const auto name = identifier.name();
+        throw std::logic_error(std::vformat("Unresolved identifier {}",
+                                            std::make_format_args(name)));
+    }
+    value_ = frame_[identifier.slot()];
+}
+
+void Evaluator::visit(const ast::ExpressionStatement& statement) {
+    if (statement.expression_ != nullptr) {
+        result_ = evaluate_expression(*statement.expression_);
+    }
+}
+
+void Evaluator::visit(const ast::CompoundStatement& statement) {
+    for (const auto& child : statement.statements()) {
+        child->accept(*this);
+    }
+}
+
+void Evaluator::visit(const ast::IfStatement& statement) {
+    if (evaluate_expression(statement.condition()).is_truthy()) {
+        statement.then().accept(*this);
+    } else if (const auto* else_statement = statement.else_statement();
+               else_statement != nullptr) {
+        else_statement->accept(*this);
+    }
+}
+
+void Evaluator::visit(const ast::ConstDeclaration& declaration) {
+    const auto value = evaluate_expression(declaration.initializer());
+    if (declaration.slot() >= frame_.size()) {
+        if (declaration.slot() == ast::UNRESOLVED_SLOT) {
+            const auto name = declaration.name();
+            throw std::logic_error(std::vformat(
+                "Unresolved declaration of {}", std::make_format_args(name)));
+        }
+        frame_.resize(declaration.slot() + std::size_t{1});
+    }
+    frame_[declaration.slot()] = value;
+}
+
+} // namespace backend::interpreter
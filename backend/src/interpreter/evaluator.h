@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include "ast/ast.h"
+#include "ast/node.h"
+#include "ast/visitor.h"
+#include "value.h"
+
+namespace backend::interpreter {
+
+// Tree-walking evaluator running the AST directly.
+//
+// A program evaluates to the value of the last expression statement it
+// executed (NONE if there was none). Integer arithmetic stays integral and
+// wraps around, mixing in a double promotes to double, `+` also concatenates
+// strings and comparisons order numbers and strings. `if` branches on the
+// truthiness of its condition. Constants live in a frame indexed by the
+// slots frontend::Resolver assigns, which must have run over the tree. Type
+// errors, division by zero and shift counts outside [0, 63] throw an
+// EvaluationError. String results point into the tree or the evaluator, so
+// they must not outlive either.
+class Evaluator final : private frontend::ast::Visitor {
+public:
+    Value evaluate(const frontend::ast::AbstractSyntaxTree& ast);
+    Value evaluate(const frontend::ast::Node& node);
+
+private:
+    void visit(const frontend::ast::Literal<bool>& literal) override;
+    void visit(const frontend::ast::Literal<std::int64_t>& literal) override;
+    void visit(const frontend::ast::Literal<double>& literal) override;
+    void
+    visit(const frontend::ast::Literal<std::string_view>& literal) override;
+    void visit(const frontend::ast::UnaryExpression& expression) override;
+    void visit(const frontend::ast::BinaryExpression& expression) override;
+    void visit(const frontend::ast::Identifier& identifier) override;
+    void visit(const frontend::ast::ExpressionStatement& statement) override;
+    void visit(const frontend::ast::CompoundStatement& statement) override;
+    void visit(const frontend::ast::IfStatement& statement) override;
+    void
+    visit(const frontend::ast::ConstDeclaration& declaration) override;
+
+    Value evaluate_expression(const frontend::ast::Expression& expression);
+
+    // value of the expression visited last
+    Value value_;
+    // value of the expression statement executed last
+    Value result_;
+    // values of the declared constants by slot
+    std::vector<Value> frame_;
+    StringHeap strings_;
+};
+
+} // namespace backend::interpreter
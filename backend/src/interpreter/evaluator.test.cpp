@@ -0,0 +1,156 @@
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "interpreter/evaluator.h"
+#include "parser.h"
+#include "program_generator.h"
+#include "resolver.h"
+#include "scanner.h"
+#include "type_checker.h"
+
+namespace {
+
+using backend::EvaluationError;
+using backend::Value;
+
+Value run(const std::string& source) {
+    const auto ast =
+        frontend::Parser(frontend::Scanner(source).scan_tokens()).parse();
+    frontend::Resolver().resolve(ast);
+    return backend::interpreter::Evaluator().evaluate(ast);
+}
+
+// String results only live as long as the tree and the evaluator.
+std::string run_to_string(const std::string& source) {
+    const auto ast =
+        frontend::Parser(frontend::Scanner(source).scan_tokens()).parse();
+    frontend::Resolver().resolve(ast);
+    backend::interpreter::Evaluator evaluator;
+    return evaluator.evaluate(ast).to_string();
+}
+
+TEST(Evaluator, EmptyProgram) {
+    EXPECT_EQ(run("").type(), Value::Type::NONE);
+    EXPECT_EQ(run(";;").type(), Value::Type::NONE);
+}
+
+TEST(Evaluator, LastExpressionStatementIsTheResult) {
+    EXPECT_EQ(run("1; 2; 3; ;"), Value(std::int64_t{3}));
+}
+
+TEST(Evaluator, Constants) {
+    EXPECT_EQ(run("const a = 2; const b = a * 3; b - a;"),
+              Value(std::int64_t{4}));
+    EXPECT_EQ(run("const x = 1; { const x = 10; x; } x;"),
+              Value(std::int64_t{1}));
+    EXPECT_EQ(run("const x = 1; if (x) { const y = x + 1; y; }"),
+              Value(std::int64_t{2}));
+    EXPECT_EQ(run_to_string("const s = \"a\"; s + s;"), "aa");
+}
+
+TEST(Evaluator, UnresolvedNamesAreErrors) {
+    const auto ast =
+        frontend::Parser(frontend::Scanner("const x = 1; x;").scan_tokens())
+            .parse();
+    EXPECT_THROW(backend::interpreter::Evaluator().evaluate(ast),
+                 std::logic_error);
+}
+
+TEST(Evaluator, IntegerArithmetic) {
+    EXPECT_EQ(run("4 % 3 + 5 * 2;"), Value(std::int64_t{11}));
+    EXPECT_EQ(run("7 / 2 - 10;"), Value(std::int64_t{-7}));
+    EXPECT_EQ(run("(1 + 2) * 3;"), Value(std::int64_t{9}));
+    EXPECT_EQ(run("9223372036854775807 + 1;"),
+              Value(std::numeric_limits<std::int64_t>::min()));
+}
+
+TEST(Evaluator, Shifts) {
+    EXPECT_EQ(run("4 << 3 + 5;"), Value(std::int64_t{1024}));
+    EXPECT_EQ(run("1024 >> 3;"), Value(std::int64_t{128}));
+    EXPECT_THROW(run("1 << 64;"), EvaluationError);
+}
+
+TEST(Evaluator, DoublesAndPromotion) {
+    const auto value = run("1.5 * 2 + 1;");
+
+    EXPECT_EQ(value.type(), Value::Type::DOUBLE);
+    EXPECT_DOUBLE_EQ(value.as_double(), 4.0);
+    EXPECT_DOUBLE_EQ(run("7.5 % 2;").as_double(), 1.5);
+}
+
+TEST(Evaluator, Comparisons) {
+    EXPECT_EQ(run("4 - 4 < 3 + 5;"), Value(true));
+    EXPECT_EQ(run("4 - 1 == 3 + 1;"), Value(false));
+    EXPECT_EQ(run("2 <= 2.0;"), Value(true));
+    EXPECT_EQ(run("true == true;"), Value(true));
+    EXPECT_EQ(run("true != 1;"), Value(true));
+    EXPECT_EQ(run(R"("abc" < "abd";)"), Value(true));
+}
+
+TEST(Evaluator, Strings) {
+    EXPECT_EQ(run_to_string(R"("foo" + "bar";)"), "foobar");
+    EXPECT_EQ(run_to_string(R"("foo";)"), "foo");
+    EXPECT_EQ(run(R"("a" + "b" == "ab";)"), Value(true));
+    EXPECT_THROW(run(R"("a" + 1;)"), EvaluationError);
+}
+
+TEST(Evaluator, DivisionByZero) {
+    EXPECT_THROW(run("1 / 0;"), EvaluationError);
+    EXPECT_THROW(run("1 % 0;"), EvaluationError);
+    EXPECT_TRUE(std::isinf(run("1.0 / 0;").as_double()));
+}
+
+TEST(Evaluator, IfStatements) {
+    EXPECT_EQ(run("if (2 <= 5) 3; else 4;"), Value(std::int64_t{3}));
+    EXPECT_EQ(run("if (0) 3; else 4;"), Value(std::int64_t{4}));
+    EXPECT_EQ(run("1; if (false) 3;"), Value(std::int64_t{1}));
+    EXPECT_EQ(run(R"(
+        if (2 <= 5 == false) 3;
+        else if (0 == 1) 4;
+        else if ("") 5;
+        else { 43; { 44; } }
+    )"),
+              Value(std::int64_t{44}));
+}
+
+TEST(Evaluator, LazyBodiesAreEvaluated) {
+    const auto ast = frontend::Parser(
+                         frontend::Scanner("{ 1; { 2 + 3; } }").scan_tokens(),
+                         {.lazy_compound_statements = true})
+                         .parse();
+
+    EXPECT_EQ(backend::interpreter::Evaluator().evaluate(ast),
+              Value(std::int64_t{5}));
+}
+
+TEST(Evaluator, ErrorsMatchTheTypeChecker) {
+    for (const auto* source : {"true + 1;", "\"a\" < 1;", "1.5 << 2;",
+                               "const s = \"s\"; s - 2.5;"}) {
+        const auto ast =
+            frontend::Parser(frontend::Scanner(source).scan_tokens()).parse();
+        frontend::Resolver().resolve(ast);
+        const auto diagnostics = frontend::type_check(ast).diagnostics;
+        ASSERT_EQ(diagnostics.size(), 1) << source;
+        try {
+            backend::interpreter::Evaluator().evaluate(ast);
+            ADD_FAILURE() << source;
+        } catch (const EvaluationError& error) {
+            EXPECT_EQ(error.what(), diagnostics[0].message);
+        }
+    }
+}
+
+TEST(Evaluator, GeneratedProgramsRunWithoutErrors) {
+    for (std::uint64_t seed = 1; seed <= 10; ++seed) {
+        const auto source = frontend::generate_program(
+            {.seed = seed, .target_bytes = 8192, .string_ratio = 0.3});
+        EXPECT_NO_THROW(run_to_string(source)) << "seed " << seed;
+    }
+}
+
+} // namespace
@@ -0,0 +1,86 @@
+#include "ir/dominators.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace backend::ir {
+
+DominatorTree::DominatorTree(const Function& function)
+    : order_(function.blocks().size(), NO_ID),
+      idom_(function.blocks().size(), NO_ID) {
+    if (function.blocks().empty()) {
+        return;
+    }
+
+    // iterative depth-first search for the postorder
+    std::vector<bool> visited(function.blocks().size());
+    std::vector<std::pair<BlockId, std::vector<BlockId>>> stack;
+    visited[0] = true;
+    stack.emplace_back(0, function.successors(0));
+    while (!stack.empty()) {
+        auto& [block, successors] = stack.back();
+        if (successors.empty()) {
+            reverse_postorder_.push_back(block);
+            stack.pop_back();
+            continue;
+        }
+        const auto next = successors.back();
+        successors.pop_back();
+        if (!visited[next]) {
+            visited[next] = true;
+            stack.emplace_back(next, function.successors(next));
+        }
+    }
+    std::reverse(reverse_postorder_.begin(), reverse_postorder_.end());
+    for (std::uint32_t i = 0; i < reverse_postorder_.size(); ++i) {
+        order_[reverse_postorder_[i]] = i;
+    }
+
+    const auto intersect = [&](BlockId a, BlockId b) {
+        while (a != b) {
+            while (order_[a] > order_[b]) {
+                a = idom_[a];
+            }
+            while (order_[b] > order_[a]) {
+                b = idom_[b];
+            }
+        }
+        return a;
+    };
+
+    idom_[0] = 0;
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (const auto block : reverse_postorder_) {
+            if (block == 0) {
+                continue;
+            }
+            auto idom = NO_ID;
+            for (const auto predecessor :
+                 function.blocks()[block].predecessors) {
+                if (idom_[predecessor] == NO_ID) {
+                    continue;
+                }
+                idom = idom == NO_ID ? predecessor
+                                     : intersect(predecessor, idom);
+            }
+            if (idom_[block] != idom) {
+                idom_[block] = idom;
+                changed = true;
+            }
+        }
+    }
+}
+
+bool DominatorTree::dominates(BlockId dominator, BlockId block) const {
+    if (!is_reachable(dominator) || !is_reachable(block)) {
+        return false;
+    }
+    // dominators come earlier in reverse postorder
+    while (order_[block] > order_[dominator]) {
+        block = idom_[block];
+    }
+    return block == dominator;
+}
+
+} // namespace backend::ir
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "ir/ir.h"
+
+namespace backend::ir {
+
+// Immediate dominators of the blocks reachable from the entry, computed with
+// the iterative algorithm of Cooper, Harvey and Kennedy over reverse
+// postorder.
+class DominatorTree {
+public:
+    explicit DominatorTree(const Function& function);
+
+    bool is_reachable(BlockId block) const {
+        return order_[block] != NO_ID;
+    }
+
+    // NO_ID for the entry and for unreachable blocks.
+    BlockId immediate_dominator(BlockId block) const {
+        return idom_[block] == block ? NO_ID : idom_[block];
+    }
+
+    // Whether every path from the entry to `block` passes `dominator`. A
+    // block dominates itself.
+    bool dominates(BlockId dominator, BlockId block) const;
+
+    // Reachable blocks, each before its successors except along back edges.
+    std::span<const BlockId> reverse_postorder() const {
+        return reverse_postorder_;
+    }
+
+private:
+    std::vector<BlockId> reverse_postorder_;
+    // position in reverse_postorder_, NO_ID if unreachable
+    std::vector<std::uint32_t> order_;
+    std::vector<BlockId> idom_;
+};
+
+} // namespace backend::ir
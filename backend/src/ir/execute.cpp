@@ -0,0 +1,75 @@
+#include "ir/execute.h"
+
+#include <vector>
+
+#include "operations.h"
+
+namespace backend::ir {
+
+Value execute(const Function& function, StringHeap& strings) {
+    std::vector<Value> values(function.instruction_count());
+    std::vector<Value> incoming_values;
+    BlockId block = 0;
+    BlockId previous = NO_ID;
+
+    for (;;) {
+        const auto& instructions = function.blocks()[block].instructions;
+
+        // phis read their operands on the incoming edge, all at once
+        std::size_t first = 0;
+        incoming_values.clear();
+        for (; first < instructions.size(); ++first) {
+            const auto& phi = function.instruction(instructions[first]);
+            if (phi.opcode != Opcode::PHI) {
+                break;
+            }
+            for (const auto& incoming : function.phi_operands(phi)) {
+                if (incoming.block == previous) {
+                    incoming_values.push_back(values[incoming.value]);
+                    break;
+                }
+            }
+        }
+        for (std::size_t i = 0; i < first; ++i) {
+            values[instructions[i]] = incoming_values[i];
+        }
+
+        for (auto i = first; i < instructions.size(); ++i) {
+            const auto id = instructions[i];
+            const auto& instruction = function.instruction(id);
+            const auto& operands = instruction.operands;
+            switch (instruction.opcode) {
+                case Opcode::CONSTANT:
+                    values[id] = function.constants()[operands[0]];
+                    break;
+                case Opcode::UNARY:
+                    values[id] =
+                        apply_unary(instruction.op, values[operands[0]]);
+                    break;
+                case Opcode::BINARY:
+                    values[id] =
+                        apply_binary(instruction.op, values[operands[0]],
+                                     values[operands[1]], strings);
+                    break;
+                case Opcode::TO_BOOL:
+                    values[id] = values[operands[0]].is_truthy();
+                    break;
+                case Opcode::PHI:
+                    break;
+                case Opcode::JUMP:
+                    previous = block;
+                    block = operands[0];
+                    break;
+                case Opcode::BRANCH:
+                    previous = block;
+                    block = values[operands[0]].is_truthy() ? operands[1]
+                                                            : operands[2];
+                    break;
+                case Opcode::RETURN:
+                    return values[operands[0]];
+            }
+        }
+    }
+}
+
+} // namespace backend::ir
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "ir/ir.h"
+#include "value.h"
+
+namespace backend::ir {
+
+// Runs `function` directly with the semantics of the tree-walking Evaluator,
+// mainly to check that passes preserve behaviour. Strings created while
+// running are stored in `strings`.
+Value execute(const Function& function, StringHeap& strings);
+
+} // namespace backend::ir
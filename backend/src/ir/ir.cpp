@@ -0,0 +1,311 @@
+#include "ir/ir.h"
+
+#include <algorithm>
+#include <format>
+
+namespace backend::ir {
+
+std::size_t Instruction::value_operand_count() const {
+    switch (opcode) {
+        case Opcode::UNARY:
+        case Opcode::TO_BOOL:
+        case Opcode::BRANCH:
+        case Opcode::RETURN:
+            return 1;
+        case Opcode::BINARY:
+            return 2;
+        default:
+            // phi operands live in the function's phi arena
+            return 0;
+    }
+}
+
+BlockId Function::add_block() {
+    blocks_.emplace_back();
+    return static_cast<BlockId>(blocks_.size() - 1);
+}
+
+ValueId Function::append(BlockId block, Instruction instruction) {
+    instruction.block = block;
+    const auto id = static_cast<ValueId>(instructions_.size());
+    instructions_.push_back(instruction);
+    blocks_[block].instructions.push_back(id);
+
+    if (instruction.opcode == Opcode::JUMP) {
+        blocks_[instruction.operands[0]].predecessors.push_back(block);
+    } else if (instruction.opcode == Opcode::BRANCH) {
+        blocks_[instruction.operands[1]].predecessors.push_back(block);
+        blocks_[instruction.operands[2]].predecessors.push_back(block);
+    }
+    return id;
+}
+
+std::uint32_t Function::add_constant(const Value& value) {
+    if (value.type() == Value::Type::STRING) {
+        constants_.emplace_back(
+            strings_.store(std::string(value.as_string())));
+    } else {
+        constants_.push_back(value);
+    }
+    return static_cast<std::uint32_t>(constants_.size() - 1);
+}
+
+ValueId Function::constant(BlockId block, const Value& value) {
+    return append(block,
+                  {Opcode::CONSTANT, {}, block, {add_constant(value)}});
+}
+
+ValueId Function::unary(BlockId block, frontend::ast::Operator::Type op,
+                        ValueId operand) {
+    return append(block, {Opcode::UNARY, op, block, {operand}});
+}
+
+ValueId Function::binary(BlockId block, frontend::ast::Operator::Type op,
+                         ValueId left, ValueId right) {
+    return append(block, {Opcode::BINARY, op, block, {left, right}});
+}
+
+ValueId Function::to_bool(BlockId block, ValueId operand) {
+    return append(block, {Opcode::TO_BOOL, {}, block, {operand}});
+}
+
+ValueId Function::phi(BlockId block, std::span<const PhiOperand> incoming) {
+    const auto begin = static_cast<std::uint32_t>(phi_operands_.size());
+    phi_operands_.insert(phi_operands_.end(), incoming.begin(),
+                         incoming.end());
+    return append(block,
+                  {Opcode::PHI,
+                   {},
+                   block,
+                   {begin, static_cast<std::uint32_t>(incoming.size())}});
+}
+
+void Function::jump(BlockId block, BlockId target) {
+    append(block, {Opcode::JUMP, {}, block, {target}});
+}
+
+void Function::branch(BlockId block, ValueId condition, BlockId then_block,
+                      BlockId else_block) {
+    append(block,
+           {Opcode::BRANCH, {}, block, {condition, then_block, else_block}});
+}
+
+void Function::ret(BlockId block, ValueId value) {
+    append(block, {Opcode::RETURN, {}, block, {value}});
+}
+
+std::vector<BlockId> Function::successors(BlockId block) const {
+    const auto& instructions = blocks_[block].instructions;
+    if (instructions.empty()) {
+        return {};
+    }
+    const auto& terminator = instructions_[instructions.back()];
+    switch (terminator.opcode) {
+        case Opcode::JUMP:
+            return {terminator.operands[0]};
+        case Opcode::BRANCH:
+            return {terminator.operands[1], terminator.operands[2]};
+        default:
+            return {};
+    }
+}
+
+std::size_t Function::live_instruction_count() const {
+    std::size_t count = 0;
+    for (const auto& block : blocks_) {
+        count += block.instructions.size();
+    }
+    return count;
+}
+
+void Function::replace_uses(std::span<const ValueId> replacement) {
+    for (const auto& block : blocks_) {
+        for (const auto id : block.instructions) {
+            auto& instruction = instructions_[id];
+            if (instruction.opcode == Opcode::PHI) {
+                for (auto& incoming : phi_operands(instruction)) {
+                    incoming.value = replacement[incoming.value];
+                }
+                continue;
+            }
+            for (std::size_t i = 0; i < instruction.value_operand_count();
+                 ++i) {
+                instruction.operands[i] = replacement[instruction.operands[i]];
+            }
+        }
+    }
+}
+
+void Function::remove_phi_operand(ValueId phi, BlockId predecessor) {
+    auto& instruction = instructions_[phi];
+    auto incoming = phi_operands(instruction);
+    const auto it =
+        std::find_if(incoming.begin(), incoming.end(),
+                     [&](const auto& operand) {
+                         return operand.block == predecessor;
+                     });
+    if (it != incoming.end()) {
+        std::move(it + 1, incoming.end(), it);
+        --instruction.operands[1];
+    }
+}
+
+void Function::remove_unreachable_blocks() {
+    std::vector<BlockId> renumbered(blocks_.size(), NO_ID);
+    std::vector<BlockId> worklist = {0};
+    renumbered[0] = 0;
+    while (!worklist.empty()) {
+        const auto block = worklist.back();
+        worklist.pop_back();
+        for (const auto successor : successors(block)) {
+            if (renumbered[successor] == NO_ID) {
+                renumbered[successor] = 0;
+                worklist.push_back(successor);
+            }
+        }
+    }
+    BlockId next = 0;
+    for (auto& number : renumbered) {
+        if (number != NO_ID) {
+            number = next++;
+        }
+    }
+    if (next == blocks_.size()) {
+        return;
+    }
+
+    std::vector<BasicBlock> kept;
+    kept.reserve(next);
+    for (std::size_t b = 0; b < blocks_.size(); ++b) {
+        if (renumbered[b] == NO_ID) {
+            continue;
+        }
+        auto& block = kept.emplace_back(std::move(blocks_[b]));
+        std::erase_if(block.predecessors, [&](BlockId predecessor) {
+            return renumbered[predecessor] == NO_ID;
+        });
+        for (auto& predecessor : block.predecessors) {
+            predecessor = renumbered[predecessor];
+        }
+        for (const auto id : block.instructions) {
+            auto& instruction = instructions_[id];
+            instruction.block = renumbered[b];
+            switch (instruction.opcode) {
+                case Opcode::PHI: {
+                    const auto incoming = phi_operands(instruction);
+                    const auto end = std::remove_if(
+                        incoming.begin(), incoming.end(),
+                        [&](const PhiOperand& operand) {
+                            return renumbered[operand.block] == NO_ID;
+                        });
+                    instruction.operands[1] =
+                        static_cast<std::uint32_t>(end - incoming.begin());
+                    for (auto& operand : phi_operands(instruction)) {
+                        operand.block = renumbered[operand.block];
+                    }
+                    break;
+                }
+                case Opcode::JUMP:
+                    instruction.operands[0] =
+                        renumbered[instruction.operands[0]];
+                    break;
+                case Opcode::BRANCH:
+                    instruction.operands[1] =
+                        renumbered[instruction.operands[1]];
+                    instruction.operands[2] =
+                        renumbered[instruction.operands[2]];
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    blocks_ = std::move(kept);
+}
+
+std::size_t Function::memory_usage() const {
+    auto bytes = instructions_.capacity() * sizeof(Instruction) +
+                 blocks_.capacity() * sizeof(BasicBlock) +
+                 phi_operands_.capacity() * sizeof(PhiOperand) +
+                 constants_.capacity() * sizeof(Value);
+    for (const auto& block : blocks_) {
+        bytes += block.instructions.capacity() * sizeof(ValueId) +
+                 block.predecessors.capacity() * sizeof(BlockId);
+    }
+    return bytes;
+}
+
+std::string dump(const Function& function) {
+    std::string text;
+    for (std::size_t b = 0; b < function.blocks().size(); ++b) {
+        const auto& block = function.blocks()[b];
+        text += std::vformat("bb{}:", std::make_format_args(b));
+        for (std::size_t i = 0; i < block.predecessors.size(); ++i) {
+            text += i == 0 ? " ; preds " : ", ";
+            text += std::vformat("bb{}",
+                                 std::make_format_args(block.predecessors[i]));
+        }
+        text += '\n';
+
+        for (const auto id : block.instructions) {
+            const auto& instruction = function.instruction(id);
+            const auto& operands = instruction.operands;
+            text += "  ";
+            if (!instruction.is_terminator()) {
+                text += std::vformat("%{} = ", std::make_format_args(id));
+            }
+            text += std::vformat("{}", std::make_format_args(
+                                           instruction.opcode));
+            switch (instruction.opcode) {
+                case Opcode::CONSTANT: {
+                    const auto& constant = function.constants()[operands[0]];
+                    text += constant.type() == Value::Type::STRING
+                                ? " \"" + constant.to_string() + "\""
+                                : " " + constant.to_string();
+                    break;
+                }
+                case Opcode::UNARY:
+                case Opcode::TO_BOOL:
+                case Opcode::RETURN:
+                    if (instruction.opcode == Opcode::UNARY) {
+                        text += std::vformat(
+                            " {}", std::make_format_args(instruction.op));
+                    }
+                    text += std::vformat(" %{}",
+                                         std::make_format_args(operands[0]));
+                    break;
+                case Opcode::BINARY:
+                    text += std::vformat(
+                        " {} %{}, %{}",
+                        std::make_format_args(instruction.op, operands[0],
+                                              operands[1]));
+                    break;
+                case Opcode::PHI: {
+                    const auto incoming = function.phi_operands(instruction);
+                    for (std::size_t i = 0; i < incoming.size(); ++i) {
+                        text += std::vformat(
+                            "{} [bb{}: %{}]",
+                            std::make_format_args(i == 0 ? "" : ",",
+                                                  incoming[i].block,
+                                                  incoming[i].value));
+                    }
+                    break;
+                }
+                case Opcode::JUMP:
+                    text += std::vformat(" bb{}",
+                                         std::make_format_args(operands[0]));
+                    break;
+                case Opcode::BRANCH:
+                    text += std::vformat(
+                        " %{}, bb{}, bb{}",
+                        std::make_format_args(operands[0], operands[1],
+                                              operands[2]));
+                    break;
+            }
+            text += '\n';
+        }
+    }
+    return text;
+}
+
+} // namespace backend::ir
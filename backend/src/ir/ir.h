@@ -0,0 +1,211 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ast/operator.h"
+#include "value.h"
+
+namespace backend::ir {
+
+// An SSA value is named by the instruction defining it, a block by its index.
+using ValueId = std::uint32_t;
+using BlockId = std::uint32_t;
+
+inline constexpr std::uint32_t NO_ID =
+    std::numeric_limits<std::uint32_t>::max();
+
+enum class Opcode : std::uint8_t {
+    CONSTANT, // constants[operands[0]]
+    UNARY,    // op operands[0]
+    BINARY,   // operands[0] op operands[1]
+    TO_BOOL,  // truthiness of operands[0]
+    PHI,      // incoming (block, value) pairs phi_operands[operands[0]...]
+              // of which there are operands[1]
+
+    // terminators, last in their block
+    JUMP,   // to block operands[0]
+    BRANCH, // to block operands[1] if operands[0] is truthy, else operands[2]
+    RETURN, // operands[0]
+};
+
+// 24 bytes per instruction; every instruction of a function lives in one
+// contiguous arena and refers to others by index.
+struct Instruction {
+    Opcode opcode;
+    frontend::ast::Operator::Type op;
+    BlockId block;
+    std::array<std::uint32_t, 3> operands;
+
+    bool is_terminator() const {
+        return opcode == Opcode::JUMP || opcode == Opcode::BRANCH ||
+               opcode == Opcode::RETURN;
+    }
+
+    // Number of operands[] that name values.
+    std::size_t value_operand_count() const;
+};
+
+static_assert(sizeof(Instruction) == 24);
+
+struct PhiOperand {
+    BlockId block;
+    ValueId value;
+};
+
+struct BasicBlock {
+    // in execution order: phis first, the terminator last
+    std::vector<ValueId> instructions;
+    std::vector<BlockId> predecessors;
+};
+
+// A program in SSA form. Block 0 is the entry; execution ends at the RETURN
+// of the last expression statement's value. Move-only because string
+// constants point into the function's own string heap.
+class Function {
+public:
+    Function() = default;
+    Function(Function&&) = default;
+    Function& operator=(Function&&) = default;
+    Function(const Function&) = delete;
+    Function& operator=(const Function&) = delete;
+
+    BlockId add_block();
+
+    // Appends to `block` and returns the new value. Terminators also record
+    // `block` as a predecessor of their targets.
+    ValueId append(BlockId block, Instruction instruction);
+
+    // Adds `value` to the constant pool, copying string bytes into the
+    // function, and returns its index.
+    std::uint32_t add_constant(const Value& value);
+
+    ValueId constant(BlockId block, const Value& value);
+    ValueId unary(BlockId block, frontend::ast::Operator::Type op,
+                  ValueId operand);
+    ValueId binary(BlockId block, frontend::ast::Operator::Type op,
+                   ValueId left, ValueId right);
+    ValueId to_bool(BlockId block, ValueId operand);
+    ValueId phi(BlockId block, std::span<const PhiOperand> incoming);
+    void jump(BlockId block, BlockId target);
+    void branch(BlockId block, ValueId condition, BlockId then_block,
+                BlockId else_block);
+    void ret(BlockId block, ValueId value);
+
+    const Instruction& instruction(ValueId value) const {
+        return instructions_[value];
+    }
+
+    Instruction& instruction(ValueId value) {
+        return instructions_[value];
+    }
+
+    std::size_t instruction_count() const {
+        return instructions_.size();
+    }
+
+    std::span<const BasicBlock> blocks() const {
+        return blocks_;
+    }
+
+    std::span<BasicBlock> blocks() {
+        return blocks_;
+    }
+
+    std::span<const Value> constants() const {
+        return constants_;
+    }
+
+    std::span<const PhiOperand> phi_operands(const Instruction& phi) const {
+        return std::span(phi_operands_).subspan(phi.operands[0],
+                                                phi.operands[1]);
+    }
+
+    std::span<PhiOperand> phi_operands(const Instruction& phi) {
+        return std::span(phi_operands_).subspan(phi.operands[0],
+                                                phi.operands[1]);
+    }
+
+    // Successors of `block`, read from its terminator.
+    std::vector<BlockId> successors(BlockId block) const;
+
+    // Instructions still placed in some block; the arena keeps removed ones.
+    std::size_t live_instruction_count() const;
+
+    // Rewrites every operand and phi operand v to replacement[v]. The
+    // replacement must be idempotent: replacement[replacement[v]] ==
+    // replacement[v].
+    void replace_uses(std::span<const ValueId> replacement);
+
+    // Drops the incoming value for `predecessor` from `phi`.
+    void remove_phi_operand(ValueId phi, BlockId predecessor);
+
+    // Deletes blocks not reachable from the entry and renumbers the rest,
+    // keeping their order. Edges from deleted blocks disappear from
+    // predecessor lists and phis.
+    void remove_unreachable_blocks();
+
+    // Bytes reserved by the function's arenas.
+    std::size_t memory_usage() const;
+
+private:
+    std::vector<Instruction> instructions_;
+    std::vector<BasicBlock> blocks_;
+    std::vector<PhiOperand> phi_operands_;
+    std::vector<Value> constants_;
+    StringHeap strings_;
+};
+
+// Text form, one instruction per line:
+//
+//   bb0:
+//     %0 = const 1
+//     %1 = binary ADDITION %0, %0
+//     branch %1, bb1, bb2
+//   bb3: ; preds bb1, bb2
+//     %5 = phi [bb1: %3], [bb2: %4]
+//     return %5
+std::string dump(const Function& function);
+
+} // namespace backend::ir
+
+template <>
+struct std::formatter<backend::ir::Opcode> : std::formatter<std::string_view> {
+    auto format(backend::ir::Opcode opcode, std::format_context& ctx) const {
+        std::string_view name = "UNDEFINED";
+        switch (opcode) {
+            case backend::ir::Opcode::CONSTANT:
+                name = "const";
+                break;
+            case backend::ir::Opcode::UNARY:
+                name = "unary";
+                break;
+            case backend::ir::Opcode::BINARY:
+                name = "binary";
+                break;
+            case backend::ir::Opcode::TO_BOOL:
+                name = "to_bool";
+                break;
+            case backend::ir::Opcode::PHI:
+                name = "phi";
+                break;
+            case backend::ir::Opcode::JUMP:
+                name = "jump";
+                break;
+            case backend::ir::Opcode::BRANCH:
+                name = "branch";
+                break;
+            case backend::ir::Opcode::RETURN:
+                name = "return";
+                break;
+        }
+        return std::formatter<std::string_view>::format(name, ctx);
+    }
+};
@@ -0,0 +1,49 @@
+#include <cstddef>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_programs.h"
+#include "ir/lowering.h"
+#include "parser.h"
+#include "scanner.h"
+
+// IR build time and memory per source line; the benchmark programs have one
+// statement per line.
+
+namespace {
+
+void lower(benchmark::State& state, const std::string& source) {
+    const auto ast =
+        frontend::Parser(frontend::Scanner(source).scan_tokens()).parse();
+    backend::ir::Lowering lowering;
+    std::size_t bytes = 0;
+    std::size_t instructions = 0;
+    for (auto _ : state) {
+        const auto function = lowering.lower(ast);
+        bytes = function.memory_usage();
+        instructions = function.instruction_count();
+        benchmark::DoNotOptimize(bytes);
+    }
+    const auto lines = static_cast<double>(state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel("items = lines");
+    state.counters["bytes_per_line"] = static_cast<double>(bytes) / lines;
+    state.counters["instructions_per_line"] =
+        static_cast<double>(instructions) / lines;
+}
+
+void BM_LowerArithmetic(benchmark::State& state) {
+    lower(state, backend::bench::arithmetic_program(
+                     static_cast<std::size_t>(state.range(0))));
+}
+
+void BM_LowerBranches(benchmark::State& state) {
+    lower(state, backend::bench::branchy_program(
+                     static_cast<std::size_t>(state.range(0))));
+}
+
+BENCHMARK(BM_LowerArithmetic)->Range(64, 16384);
+BENCHMARK(BM_LowerBranches)->Range(64, 16384);
+
+} // namespace
@@ -0,0 +1,197 @@
+#include "ir/lowering.h"
+
+#include <array>
+#include <format>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "trace.h"
+
+namespace backend::ir {
+
+namespace ast = frontend::ast;
+
+Function Lowering::lower(const ast::AbstractSyntaxTree& ast) {
+    return lower(ast.root());
+}
+
+Function Lowering::lower(const ast::Node& node) {
+    frontend::trace::Span span("lower", "backend");
+    function_ = Function();
+    block_ = function_.add_block();
+    result_ = function_.constant(block_, Value());
+    frame_.clear();
+    forget_since(0);
+
+    node.accept(*this);
+    function_.ret(block_, result_);
+    return std::exchange(function_, Function());
+}
+
+ValueId Lowering::lower_expression(const ast::Expression& expression) {
+    expression.accept(*this);
+    return value_;
+}
+
+ValueId Lowering::merge(BlockId block, PhiOperand first, PhiOperand second) {
+    if (first.value == second.value) {
+        return first.value;
+    }
+    const std::array incoming = {first, second};
+    return function_.phi(block, incoming);
+}
+
+void Lowering::remember(const ast::Expression& expression) {
+    lowered_.emplace(&expression, value_);
+    lowered_order_.push_back(&expression);
+}
+
+void Lowering::forget_since(std::size_t mark) {
+    while (lowered_order_.size() > mark) {
+        lowered_.erase(lowered_order_.back());
+        lowered_order_.pop_back();
+    }
+}
+
+void Lowering::visit(const ast::Literal<bool>& literal) {
+    value_ = function_.constant(block_, literal.value_);
+}
+
+void Lowering::visit(const ast::Literal<std::int64_t>& literal) {
+    value_ = function_.constant(block_, literal.value_);
+}
+
+void Lowering::visit(const ast::Literal<double>& literal) {
+    value_ = function_.constant(block_, literal.value_);
+}
+
+void Lowering::visit(const ast::Literal<std::string_view>& literal) {
+    value_ = function_.constant(block_, literal.value_);
+}
+
+void Lowering::visit(const ast::UnaryExpression& expression) {
+    if (const auto it = lowered_.find(&expression); it != lowered_.end()) {
+        value_ = it->second;
+        return;
+    }
+    const auto operand = lower_expression(expression.operand());
+    value_ = function_.unary(block_, expression.op(), operand);
+    remember(expression);
+}
+
+void Lowering::visit(const ast::BinaryExpression& expression) {
+    if (const auto it = lowered_.find(&expression); it != lowered_.end()) {
+        value_ = it->second;
+        return;
+    }
+    if (expression.op() == ast::Operator::Type::LOGICAL_AND ||
+        expression.op() == ast::Operator::Type::LOGICAL_OR) {
+        lower_logical(expression);
+    } else {
+        const auto left = lower_expression(expression.left());
+        const auto right = lower_expression(expression.right());
+        value_ = function_.binary(block_, expression.op(), left, right);
+    }
+    remember(expression);
+}
+
+void Lowering::visit(const ast::Identifier& identifier) {
+    if (identifier.slot() == ast::UNRESOLVED_SLOT) {
+        const auto name = identifier.name();
+        throw std::logic_error(std::vformat("Unresolved identifier {}",
+                                            std::make_format_args(name)));
+    }
+    value_ = frame_[identifier.slot()];
+}
+
+//   left:  l = <left>; lb = to_bool l; branch lb, right, end  (&&)
+//                                      branch lb, end, right  (||)
+//   right: rb = to_bool <right>; jump end
+//   end:   phi [left: lb], [right: rb]
+void Lowering::lower_logical(const ast::BinaryExpression& expression) {
+    const auto left = function_.to_bool(
+        block_, lower_expression(expression.left()));
+    const auto left_block = block_;
+    const auto right_block = function_.add_block();
+    const auto end_block = function_.add_block();
+    if (expression.op() == ast::Operator::Type::LOGICAL_AND) {
+        function_.branch(left_block, left, right_block, end_block);
+    } else {
+        function_.branch(left_block, left, end_block, right_block);
+    }
+
+    block_ = right_block;
+    const auto mark = lowered_order_.size();
+    const auto right = function_.to_bool(
+        block_, lower_expression(expression.right()));
+    function_.jump(block_, end_block);
+    forget_since(mark);
+
+    value_ = merge(end_block, {left_block, left}, {block_, right});
+    block_ = end_block;
+}
+
+void Lowering::visit(const ast::ExpressionStatement& statement) {
+    if (statement.expression_ != nullptr) {
+        result_ = lower_expression(*statement.expression_);
+    }
+}
+
+void Lowering::visit(const ast::CompoundStatement& statement) {
+    for (const auto& child : statement.statements()) {
+        child->accept(*this);
+    }
+}
+
+void Lowering::visit(const ast::IfStatement& statement) {
+    const auto condition = lower_expression(statement.condition());
+    const auto condition_block = block_;
+    const auto result_before = result_;
+    const auto then_block = function_.add_block();
+    const auto* else_statement = statement.else_statement();
+    const auto else_block =
+        else_statement != nullptr ? function_.add_block() : NO_ID;
+    const auto end_block = function_.add_block();
+    function_.branch(condition_block, condition, then_block,
+                     else_statement != nullptr ? else_block : end_block);
+
+    const auto mark = lowered_order_.size();
+    block_ = then_block;
+    statement.then().accept(*this);
+    const PhiOperand then_end = {block_, result_};
+    function_.jump(block_, end_block);
+    forget_since(mark);
+
+    PhiOperand else_end = {condition_block, result_before};
+    if (else_statement != nullptr) {
+        block_ = else_block;
+        result_ = result_before;
+        else_statement->accept(*this);
+        else_end = {block_, result_};
+        function_.jump(block_, end_block);
+        forget_since(mark);
+    }
+
+    // predecessors of the end block were recorded in the same order
+    const auto& predecessors = function_.blocks()[end_block].predecessors;
+    result_ = predecessors.front() == then_end.block
+                  ? merge(end_block, then_end, else_end)
+                  : merge(end_block, else_end, then_end);
+    block_ = end_block;
+}
+
+void Lowering::visit(const ast::ConstDeclaration& declaration) {
+    const auto value = lower_expression(declaration.initializer());
+    if (declaration.slot() >= frame_.size()) {
+        if (declaration.slot() == ast::UNRESOLVED_SLOT) {
+            const auto name = declaration.name();
+            throw std::logic_error(std::vformat(
+                "Unresolved declaration of {}", std::make_format_args(name)));
+        }
+        frame_.resize(declaration.slot() + std::size_t{1});
+    }
+    frame_[declaration.slot()] = value;
+}
+
+} // namespace backend::ir
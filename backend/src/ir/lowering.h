@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "ast/ast.h"
+#include "ast/node.h"
+#include "ast/visitor.h"
+#include "ir/ir.h"
+
+namespace backend::ir {
+
+// Lowers an AST to SSA form with the semantics of the tree-walking Evaluator.
+//
+// The program's only state is the value of the last expression statement
+// executed; the lowering tracks it as the "current result" and merges it
+// with a phi wherever two paths with different results join. `if` and the
+// short-circuiting `&&` and `||` become BRANCHes, the latter producing bools
+// through TO_BOOL and a phi. Constants are immutable, so a use is simply the
+// value of the initializer in the frontend::Resolver slot it is bound to,
+// and needs no phi.
+//
+// Expressions are pure, so a subtree shared by several parents (see
+// frontend::ast::ExpressionInterner) is lowered once and its value reused
+// wherever that definition dominates, as a cheap global CSE.
+class Lowering final : private frontend::ast::Visitor {
+public:
+    Function lower(const frontend::ast::AbstractSyntaxTree& ast);
+    Function lower(const frontend::ast::Node& node);
+
+private:
+    void visit(const frontend::ast::Literal<bool>& literal) override;
+    void visit(const frontend::ast::Literal<std::int64_t>& literal) override;
+    void visit(const frontend::ast::Literal<double>& literal) override;
+    void
+    visit(const frontend::ast::Literal<std::string_view>& literal) override;
+    void visit(const frontend::ast::UnaryExpression& expression) override;
+    void visit(const frontend::ast::BinaryExpression& expression) override;
+    void visit(const frontend::ast::Identifier& identifier) override;
+    void visit(const frontend::ast::ExpressionStatement& statement) override;
+    void visit(const frontend::ast::CompoundStatement& statement) override;
+    void visit(const frontend::ast::IfStatement& statement) override;
+    void
+    visit(const frontend::ast::ConstDeclaration& declaration) override;
+
+    ValueId lower_expression(const frontend::ast::Expression& expression);
+    void lower_logical(const frontend::ast::BinaryExpression& expression);
+
+    // Joins two paths ending in `first` and `second`, which must both jump to
+    // `block`; returns the merged value.
+    ValueId merge(BlockId block, PhiOperand first, PhiOperand second);
+
+    void remember(const frontend::ast::Expression& expression);
+    // Forgets the values remembered after `mark`, a size of lowered_order_,
+    // on leaving a path that does not dominate what follows.
+    void forget_since(std::size_t mark);
+
+    Function function_;
+    // block new instructions are appended to
+    BlockId block_ = 0;
+    // value of the expression lowered last
+    ValueId value_ = 0;
+    // value of the expression statement executed last
+    ValueId result_ = 0;
+    // values of the constants in scope by slot
+    std::vector<ValueId> frame_;
+    // operator expressions lowered on every path to block_
+    std::unordered_map<const frontend::ast::Expression*, ValueId> lowered_;
+    std::vector<const frontend::ast::Expression*> lowered_order_;
+};
+
+} // namespace backend::ir
@@ -0,0 +1,185 @@
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "bench_programs.h"
+#include "ir/lowering.h"
+#include "ir/verifier.h"
+#include "parser.h"
+#include "resolver.h"
+#include "scanner.h"
+
+namespace {
+
+using backend::ir::Function;
+using backend::ir::Lowering;
+
+Function lower(const std::string& source) {
+    const auto ast =
+        frontend::Parser(frontend::Scanner(source).scan_tokens()).parse();
+    frontend::Resolver().resolve(ast);
+    auto function = Lowering().lower(ast);
+    backend::ir::verify(function);
+    return function;
+}
+
+TEST(Lowering, EmptyProgramReturnsNone) {
+    EXPECT_EQ(dump(lower("")), "bb0:\n"
+                               "  %0 = const none\n"
+                               "  return %0\n");
+}
+
+TEST(Lowering, StraightLine) {
+    EXPECT_EQ(dump(lower("1 + 2 * 3; \"s\";")),
+              "bb0:\n"
+              "  %0 = const none\n"
+              "  %1 = const 1\n"
+              "  %2 = const 2\n"
+              "  %3 = const 3\n"
+              "  %4 = binary MULTIPLICATION %2, %3\n"
+              "  %5 = binary ADDITION %1, %4\n"
+              "  %6 = const \"s\"\n"
+              "  return %6\n");
+}
+
+TEST(Lowering, ConstantsAreTheValuesOfTheirInitializers) {
+    EXPECT_EQ(dump(lower("const a = 1 + 2; { const b = a * a; b; } a;")),
+              "bb0:\n"
+              "  %0 = const none\n"
+              "  %1 = const 1\n"
+              "  %2 = const 2\n"
+              "  %3 = binary ADDITION %1, %2\n"
+              "  %4 = binary MULTIPLICATION %3, %3\n"
+              "  return %3\n");
+}
+
+TEST(Lowering, IfElseMergesResultWithPhi) {
+    EXPECT_EQ(dump(lower("if (1) 2; else 3;")),
+              "bb0:\n"
+              "  %0 = const none\n"
+              "  %1 = const 1\n"
+              "  branch %1, bb1, bb2\n"
+              "bb1: ; preds bb0\n"
+              "  %3 = const 2\n"
+              "  jump bb3\n"
+              "bb2: ; preds bb0\n"
+              "  %5 = const 3\n"
+              "  jump bb3\n"
+              "bb3: ; preds bb1, bb2\n"
+              "  %7 = phi [bb1: %3], [bb2: %5]\n"
+              "  return %7\n");
+}
+
+TEST(Lowering, IfWithoutElseMergesWithPreviousResult) {
+    EXPECT_EQ(dump(lower("5; if (0) 10;")),
+              "bb0:\n"
+              "  %0 = const none\n"
+              "  %1 = const 5\n"
+              "  %2 = const 0\n"
+              "  branch %2, bb1, bb2\n"
+              "bb1: ; preds bb0\n"
+              "  %4 = const 10\n"
+              "  jump bb2\n"
+              "bb2: ; preds bb0, bb1\n"
+              "  %6 = phi [bb0: %1], [bb1: %4]\n"
+              "  return %6\n");
+}
+
+TEST(Lowering, NoPhiWhenTheResultIsUnchanged) {
+    const auto text = dump(lower("7; if (1) { ; } else ;"));
+
+    EXPECT_EQ(text.find("phi"), std::string::npos);
+    EXPECT_NE(text.find("return %1"), std::string::npos);
+}
+
+TEST(Lowering, NestedIfs) {
+    const auto function = lower(
+        "if (1) { if (2) 3; else 4; } else if (5) { 6; } 7 + 8;");
+
+    EXPECT_EQ(function.blocks().size(), 9);
+}
+
+TEST(Lowering, ShortCircuitBecomesControlFlow) {
+    using namespace frontend::ast;
+    const ExpressionStatement statement(std::make_unique<BinaryExpression>(
+        std::make_unique<Literal<std::int64_t>>(0), Operator::Type::LOGICAL_OR,
+        std::make_unique<Literal<std::int64_t>>(1)));
+    const auto function = Lowering().lower(statement);
+
+    backend::ir::verify(function);
+    EXPECT_EQ(dump(function), "bb0:\n"
+                              "  %0 = const none\n"
+                              "  %1 = const 0\n"
+                              "  %2 = to_bool %1\n"
+                              "  branch %2, bb2, bb1\n"
+                              "bb1: ; preds bb0\n"
+                              "  %4 = const 1\n"
+                              "  %5 = to_bool %4\n"
+                              "  jump bb2\n"
+                              "bb2: ; preds bb0, bb1\n"
+                              "  %7 = phi [bb0: %2], [bb1: %5]\n"
+                              "  return %7\n");
+}
+
+Function lower_hash_consed(const std::string& source) {
+    frontend::ParserOptions options;
+    options.interner = std::make_shared<frontend::ast::ExpressionInterner>();
+    auto function = Lowering().lower(
+        frontend::Parser(frontend::Scanner(source).scan_tokens(), options)
+            .parse());
+    backend::ir::verify(function);
+    return function;
+}
+
+TEST(Lowering, SharedSubexpressionsAreLoweredOnce) {
+    EXPECT_EQ(dump(lower_hash_consed("1 + 2 * 3; 2 * 3;")),
+              "bb0:\n"
+              "  %0 = const none\n"
+              "  %1 = const 1\n"
+              "  %2 = const 2\n"
+              "  %3 = const 3\n"
+              "  %4 = binary MULTIPLICATION %2, %3\n"
+              "  %5 = binary ADDITION %1, %4\n"
+              "  return %4\n");
+}
+
+TEST(Lowering, BranchValuesAreNotReusedAfterTheBranch) {
+    EXPECT_EQ(dump(lower_hash_consed("1 << 2; if (0) { 1 << 2; 3 << 4; } "
+                                     "3 << 4;")),
+              "bb0:\n"
+              "  %0 = const none\n"
+              "  %1 = const 1\n"
+              "  %2 = const 2\n"
+              "  %3 = binary BITWISE_LEFT_SHIFT %1, %2\n"
+              "  %4 = const 0\n"
+              "  branch %4, bb1, bb2\n"
+              "bb1: ; preds bb0\n"
+              "  %6 = const 3\n"
+              "  %7 = const 4\n"
+              "  %8 = binary BITWISE_LEFT_SHIFT %6, %7\n"
+              "  jump bb2\n"
+              "bb2: ; preds bb0, bb1\n"
+              "  %10 = phi [bb0: %3], [bb1: %8]\n"
+              "  %11 = const 3\n"
+              "  %12 = const 4\n"
+              "  %13 = binary BITWISE_LEFT_SHIFT %11, %12\n"
+              "  return %13\n");
+}
+
+TEST(Lowering, BenchmarkProgramsVerify) {
+    lower(backend::bench::arithmetic_program(100));
+    lower(backend::bench::branchy_program(100));
+    lower(backend::bench::floating_point_program(100));
+}
+
+TEST(Lowering, MemoryUsageGrowsWithTheProgram) {
+    const auto small = lower(backend::bench::arithmetic_program(10));
+    const auto large = lower(backend::bench::arithmetic_program(1000));
+
+    EXPECT_GT(small.memory_usage(), 0);
+    EXPECT_GT(large.memory_usage(), 50 * small.memory_usage());
+}
+
+} // namespace
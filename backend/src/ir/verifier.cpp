@@ -0,0 +1,155 @@
+#include "ir/verifier.h"
+
+#include <algorithm>
+#include <format>
+#include <string>
+#include <vector>
+
+#include "ir/dominators.h"
+
+namespace backend::ir {
+
+namespace {
+
+[[noreturn]] void fail(std::string message) {
+    throw VerificationError(std::move(message));
+}
+
+[[noreturn]] void fail_at(ValueId id, std::string_view problem) {
+    fail(std::vformat("%{}: {}", std::make_format_args(id, problem)));
+}
+
+[[noreturn]] void fail_in(std::size_t block, std::string_view problem) {
+    fail(std::vformat("bb{}: {}", std::make_format_args(block, problem)));
+}
+
+} // namespace
+
+void verify(const Function& function) {
+    const auto blocks = function.blocks();
+    if (blocks.empty()) {
+        fail("no entry block");
+    }
+    if (!blocks[0].predecessors.empty()) {
+        fail_in(0, "the entry block has predecessors");
+    }
+
+    // structure
+    std::vector<std::uint32_t> position(function.instruction_count(), NO_ID);
+    std::vector<std::vector<BlockId>> expected_predecessors(blocks.size());
+    for (std::size_t b = 0; b < blocks.size(); ++b) {
+        const auto& instructions = blocks[b].instructions;
+        if (instructions.empty()) {
+            fail_in(b, "empty block");
+        }
+        bool phis_allowed = true;
+        for (std::size_t i = 0; i < instructions.size(); ++i) {
+            const auto id = instructions[i];
+            if (id >= function.instruction_count()) {
+                fail_in(b, "unknown instruction");
+            }
+            if (position[id] != NO_ID) {
+                fail_at(id, "in more than one place");
+            }
+            position[id] = static_cast<std::uint32_t>(i);
+
+            const auto& instruction = function.instruction(id);
+            if (instruction.block != b) {
+                fail_at(id, "records another block");
+            }
+            if (instruction.is_terminator() != (i + 1 == instructions.size())) {
+                fail_at(id, "terminators must end their block");
+            }
+            if (instruction.opcode == Opcode::PHI && !phis_allowed) {
+                fail_at(id, "phi after a non-phi instruction");
+            }
+            phis_allowed = instruction.opcode == Opcode::PHI;
+        }
+
+        for (const auto successor : function.successors(
+                 static_cast<BlockId>(b))) {
+            if (successor >= blocks.size()) {
+                fail_in(b, "jumps to an unknown block");
+            }
+            if (successor == 0) {
+                fail_in(b, "jumps to the entry block");
+            }
+            expected_predecessors[successor].push_back(
+                static_cast<BlockId>(b));
+        }
+    }
+    for (std::size_t b = 0; b < blocks.size(); ++b) {
+        auto actual = blocks[b].predecessors;
+        std::sort(actual.begin(), actual.end());
+        auto& expected = expected_predecessors[b];
+        std::sort(expected.begin(), expected.end());
+        if (actual != expected) {
+            fail_in(b, "predecessors do not match the terminators");
+        }
+    }
+
+    // operands and dominance
+    const DominatorTree dominators(function);
+    const auto available = [&](ValueId value, BlockId block,
+                               std::size_t index) {
+        const auto definition = function.instruction(value).block;
+        if (definition == block) {
+            return position[value] < index;
+        }
+        return dominators.dominates(definition, block);
+    };
+    const auto check_value = [&](ValueId id, ValueId value) {
+        if (value >= function.instruction_count() ||
+            position[value] == NO_ID) {
+            fail_at(id, "uses an unknown value");
+        }
+        if (function.instruction(value).is_terminator()) {
+            fail_at(id, "uses a terminator as a value");
+        }
+    };
+
+    for (std::size_t b = 0; b < blocks.size(); ++b) {
+        const auto block = static_cast<BlockId>(b);
+        for (const auto id : blocks[b].instructions) {
+            const auto& instruction = function.instruction(id);
+            if (instruction.opcode == Opcode::CONSTANT &&
+                instruction.operands[0] >= function.constants().size()) {
+                fail_at(id, "unknown constant");
+            }
+
+            if (instruction.opcode == Opcode::PHI) {
+                const auto incoming = function.phi_operands(instruction);
+                std::vector<BlockId> sources;
+                for (const auto& [source, value] : incoming) {
+                    check_value(id, value);
+                    if (source >= blocks.size()) {
+                        fail_at(id, "phi from an unknown block");
+                    }
+                    if (dominators.is_reachable(source) &&
+                        !available(value, source,
+                                   blocks[source].instructions.size())) {
+                        fail_at(id, "phi operand does not dominate its edge");
+                    }
+                    sources.push_back(source);
+                }
+                std::sort(sources.begin(), sources.end());
+                if (sources != expected_predecessors[b]) {
+                    fail_at(id, "phi does not match the predecessors");
+                }
+                continue;
+            }
+
+            for (std::size_t i = 0; i < instruction.value_operand_count();
+                 ++i) {
+                const auto value = instruction.operands[i];
+                check_value(id, value);
+                if (dominators.is_reachable(block) &&
+                    !available(value, block, position[id])) {
+                    fail_at(id, "use not dominated by its definition");
+                }
+            }
+        }
+    }
+}
+
+} // namespace backend::ir
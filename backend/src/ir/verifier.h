@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdexcept>
+
+#include "ir/ir.h"
+
+namespace backend::ir {
+
+class VerificationError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Checks the structural and SSA invariants every pass must preserve:
+//
+// - every block ends in exactly one terminator and starts with its phis,
+// - every instruction sits in exactly one block, the one it records,
+// - predecessor lists match the terminators' targets and the entry has none,
+// - phis have one incoming value per predecessor,
+// - operands name existing non-terminator instructions and constants, and
+// - in reachable blocks, every definition dominates its uses (for phis, the
+//   end of the incoming block).
+//
+// Throws a VerificationError describing the first violation.
+void verify(const Function& function);
+
+} // namespace backend::ir
@@ -0,0 +1,153 @@
+#include <array>
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include "ir/dominators.h"
+#include "ir/ir.h"
+#include "ir/verifier.h"
+
+namespace {
+
+using backend::Value;
+using backend::ir::BlockId;
+using backend::ir::DominatorTree;
+using backend::ir::Function;
+using backend::ir::Instruction;
+using backend::ir::NO_ID;
+using backend::ir::Opcode;
+using backend::ir::PhiOperand;
+using backend::ir::VerificationError;
+using backend::ir::verify;
+using Operator = frontend::ast::Operator;
+
+// bb0 branches to bb1 and bb2, which both jump to bb3.
+struct Diamond {
+    Diamond() {
+        for (auto& block : blocks) {
+            block = function.add_block();
+        }
+        condition = function.constant(blocks[0], Value(true));
+        function.branch(blocks[0], condition, blocks[1], blocks[2]);
+        left = function.constant(blocks[1], Value(std::int64_t{1}));
+        function.jump(blocks[1], blocks[3]);
+        right = function.constant(blocks[2], Value(std::int64_t{2}));
+        function.jump(blocks[2], blocks[3]);
+    }
+
+    Function function;
+    std::array<BlockId, 4> blocks{};
+    std::uint32_t condition = 0;
+    std::uint32_t left = 0;
+    std::uint32_t right = 0;
+};
+
+TEST(Verifier, AcceptsDiamondWithPhi) {
+    Diamond diamond;
+    const std::array incoming = {PhiOperand{1, diamond.left},
+                                 PhiOperand{2, diamond.right}};
+    diamond.function.ret(3, diamond.function.phi(3, incoming));
+
+    EXPECT_NO_THROW(verify(diamond.function));
+}
+
+TEST(Verifier, RejectsMissingTerminator) {
+    Diamond diamond;
+    diamond.function.constant(3, Value());
+
+    EXPECT_THROW(verify(diamond.function), VerificationError);
+}
+
+TEST(Verifier, RejectsInstructionsAfterTerminator) {
+    Diamond diamond;
+    diamond.function.ret(3, diamond.condition);
+    diamond.function.constant(3, Value());
+
+    EXPECT_THROW(verify(diamond.function), VerificationError);
+}
+
+TEST(Verifier, RejectsUseNotDominatedByDefinition) {
+    Diamond diamond;
+    // `left` is only defined on one path into bb3
+    diamond.function.ret(3, diamond.left);
+
+    EXPECT_THROW(verify(diamond.function), VerificationError);
+}
+
+TEST(Verifier, RejectsUseBeforeDefinitionInBlock) {
+    Function function;
+    const auto block = function.add_block();
+    const auto one = function.constant(block, Value(std::int64_t{1}));
+    const auto sum = function.binary(block, Operator::Type::ADDITION, one, one);
+    function.instruction(sum).operands[1] = sum;
+    function.ret(block, sum);
+
+    EXPECT_THROW(verify(function), VerificationError);
+}
+
+TEST(Verifier, RejectsPhiNotMatchingPredecessors) {
+    Diamond diamond;
+    const std::array incoming = {PhiOperand{1, diamond.left}};
+    diamond.function.ret(3, diamond.function.phi(3, incoming));
+
+    EXPECT_THROW(verify(diamond.function), VerificationError);
+}
+
+TEST(Verifier, RejectsPhiOperandNotAvailableOnItsEdge) {
+    Diamond diamond;
+    const std::array incoming = {PhiOperand{1, diamond.right},
+                                 PhiOperand{2, diamond.right}};
+    diamond.function.ret(3, diamond.function.phi(3, incoming));
+
+    EXPECT_THROW(verify(diamond.function), VerificationError);
+}
+
+TEST(Verifier, RejectsStalePredecessors) {
+    Diamond diamond;
+    diamond.function.ret(3, diamond.condition);
+    diamond.function.blocks()[3].predecessors.pop_back();
+
+    EXPECT_THROW(verify(diamond.function), VerificationError);
+}
+
+TEST(Verifier, RejectsTerminatorAsValue) {
+    Function function;
+    const auto entry = function.add_block();
+    const auto next = function.add_block();
+    function.jump(entry, next);
+    function.ret(next, 0);
+
+    EXPECT_THROW(verify(function), VerificationError);
+}
+
+TEST(DominatorTree, Diamond) {
+    Diamond diamond;
+    diamond.function.ret(3, diamond.condition);
+    const DominatorTree dominators(diamond.function);
+
+    EXPECT_EQ(dominators.immediate_dominator(0), NO_ID);
+    EXPECT_EQ(dominators.immediate_dominator(1), 0);
+    EXPECT_EQ(dominators.immediate_dominator(2), 0);
+    EXPECT_EQ(dominators.immediate_dominator(3), 0);
+    EXPECT_TRUE(dominators.dominates(0, 3));
+    EXPECT_TRUE(dominators.dominates(3, 3));
+    EXPECT_FALSE(dominators.dominates(1, 3));
+    EXPECT_EQ(dominators.reverse_postorder().front(), 0);
+    EXPECT_EQ(dominators.reverse_postorder().back(), 3);
+}
+
+TEST(DominatorTree, UnreachableBlocks) {
+    Function function;
+    const auto entry = function.add_block();
+    const auto dead = function.add_block();
+    function.ret(entry, function.constant(entry, Value()));
+    function.ret(dead, function.constant(dead, Value()));
+    const DominatorTree dominators(function);
+
+    EXPECT_TRUE(dominators.is_reachable(entry));
+    EXPECT_FALSE(dominators.is_reachable(dead));
+    EXPECT_FALSE(dominators.dominates(entry, dead));
+    EXPECT_NO_THROW(verify(function));
+}
+
+} // namespace
@@ -0,0 +1,281 @@
+#include "jit/assembler.h"
+
+#include <stdexcept>
+
+namespace backend::jit {
+
+namespace {
+
+std::uint8_t low(Register r) {
+    return static_cast<std::uint8_t>(r) & 7;
+}
+
+std::uint8_t high(Register r) {
+    return static_cast<std::uint8_t>(r) >> 3;
+}
+
+} // namespace
+
+void Assembler::emit32(std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        emit(static_cast<std::uint8_t>(value >> (8 * i)));
+    }
+}
+
+void Assembler::emit64(std::uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        emit(static_cast<std::uint8_t>(value >> (8 * i)));
+    }
+}
+
+void Assembler::rex_w(Register reg, Register rm) {
+    emit(static_cast<std::uint8_t>(0x48 | high(reg) << 2 | high(rm)));
+}
+
+void Assembler::modrm(Register reg, Register rm) {
+    emit(static_cast<std::uint8_t>(0xc0 | low(reg) << 3 | low(rm)));
+}
+
+void Assembler::modrm(std::uint8_t extension, Register rm) {
+    emit(static_cast<std::uint8_t>(0xc0 | extension << 3 | low(rm)));
+}
+
+void Assembler::memory(Register reg, Register base, std::int32_t offset) {
+    // mod 10: [base + disp32]
+    emit(static_cast<std::uint8_t>(0x80 | low(reg) << 3 | low(base)));
+    if (low(base) == low(Register::RSP)) {
+        // rsp and r12 as a base need a SIB byte
+        emit(0x24);
+    }
+    emit32(static_cast<std::uint32_t>(offset));
+}
+
+void Assembler::binary(std::uint8_t opcode, Register destination,
+                       Register source) {
+    // op r/m64, r64
+    rex_w(source, destination);
+    emit(opcode);
+    modrm(source, destination);
+}
+
+void Assembler::unary(std::uint8_t extension, Register operand) {
+    rex_w(Register::RAX, operand);
+    emit(0xf7);
+    modrm(extension, operand);
+}
+
+void Assembler::immediate(std::uint8_t extension, Register destination,
+                          std::int32_t value) {
+    rex_w(Register::RAX, destination);
+    emit(0x81);
+    modrm(extension, destination);
+    emit32(static_cast<std::uint32_t>(value));
+}
+
+void Assembler::bind(Label& label) {
+    if (label.position_ != Label::UNBOUND) {
+        throw std::logic_error("Label bound twice");
+    }
+    label.position_ = code_.size();
+    for (const auto fixup : label.fixups_) {
+        const auto rel = static_cast<std::uint32_t>(
+            static_cast<std::int64_t>(label.position_) -
+            static_cast<std::int64_t>(fixup + 4));
+        for (std::size_t i = 0; i < 4; ++i) {
+            code_[fixup + i] = static_cast<std::uint8_t>(rel >> (8 * i));
+        }
+    }
+    label.fixups_.clear();
+}
+
+void Assembler::rel32(Label& target) {
+    if (target.position_ != Label::UNBOUND) {
+        emit32(static_cast<std::uint32_t>(
+            static_cast<std::int64_t>(target.position_) -
+            static_cast<std::int64_t>(code_.size() + 4)));
+        return;
+    }
+    target.fixups_.push_back(code_.size());
+    emit32(0);
+}
+
+void Assembler::mov(Register destination, Register source) {
+    binary(0x89, destination, source);
+}
+
+void Assembler::mov(Register destination, std::int64_t immediate) {
+    if (immediate >= INT32_MIN && immediate <= INT32_MAX) {
+        // mov r/m64, imm32 sign-extends
+        rex_w(Register::RAX, destination);
+        emit(0xc7);
+        modrm(0, destination);
+        emit32(static_cast<std::uint32_t>(immediate));
+        return;
+    }
+    // movabs
+    rex_w(Register::RAX, destination);
+    emit(static_cast<std::uint8_t>(0xb8 | low(destination)));
+    emit64(static_cast<std::uint64_t>(immediate));
+}
+
+void Assembler::load(Register destination, Register base,
+                     std::int32_t offset) {
+    rex_w(destination, base);
+    emit(0x8b);
+    memory(destination, base, offset);
+}
+
+void Assembler::store(Register base, std::int32_t offset, Register source) {
+    rex_w(source, base);
+    emit(0x89);
+    memory(source, base, offset);
+}
+
+void Assembler::add(Register destination, Register source) {
+    binary(0x01, destination, source);
+}
+
+void Assembler::sub(Register destination, Register source) {
+    binary(0x29, destination, source);
+}
+
+void Assembler::imul(Register destination, Register source) {
+    // imul r64, r/m64
+    rex_w(destination, source);
+    emit(0x0f);
+    emit(0xaf);
+    modrm(destination, source);
+}
+
+void Assembler::and_(Register destination, Register source) {
+    binary(0x21, destination, source);
+}
+
+void Assembler::or_(Register destination, Register source) {
+    binary(0x09, destination, source);
+}
+
+void Assembler::xor_(Register destination, Register source) {
+    binary(0x31, destination, source);
+}
+
+void Assembler::cmp(Register left, Register right) {
+    binary(0x39, left, right);
+}
+
+void Assembler::cmp(Register left, std::int8_t immediate) {
+    rex_w(Register::RAX, left);
+    emit(0x83);
+    modrm(7, left);
+    emit(static_cast<std::uint8_t>(immediate));
+}
+
+void Assembler::test(Register left, Register right) {
+    binary(0x85, left, right);
+}
+
+void Assembler::neg(Register operand) {
+    unary(3, operand);
+}
+
+void Assembler::not_(Register operand) {
+    unary(2, operand);
+}
+
+void Assembler::cqo() {
+    emit(0x48);
+    emit(0x99);
+}
+
+void Assembler::idiv(Register operand) {
+    unary(7, operand);
+}
+
+void Assembler::shl(Register operand) {
+    rex_w(Register::RAX, operand);
+    emit(0xd3);
+    modrm(4, operand);
+}
+
+void Assembler::sar(Register operand) {
+    rex_w(Register::RAX, operand);
+    emit(0xd3);
+    modrm(7, operand);
+}
+
+void Assembler::set(Condition condition, Register destination) {
+    // setcc r/m8; the REX prefix selects sil/dil rather than dh/bh
+    emit(static_cast<std::uint8_t>(0x40 | high(destination)));
+    emit(0x0f);
+    emit(static_cast<std::uint8_t>(0x90 |
+                                   static_cast<std::uint8_t>(condition)));
+    modrm(0, destination);
+    // movzx r32, r/m8 zero-extends into all 64 bits
+    emit(static_cast<std::uint8_t>(0x40 | high(destination) << 2 |
+                                   high(destination)));
+    emit(0x0f);
+    emit(0xb6);
+    modrm(destination, destination);
+}
+
+void Assembler::add(Register destination, std::int32_t immediate) {
+    this->immediate(0, destination, immediate);
+}
+
+void Assembler::sub(Register destination, std::int32_t immediate) {
+    this->immediate(5, destination, immediate);
+}
+
+void Assembler::jmp(Label& target) {
+    emit(0xe9);
+    rel32(target);
+}
+
+void Assembler::jump_if(Condition condition, Label& target) {
+    emit(0x0f);
+    emit(static_cast<std::uint8_t>(0x80 |
+                                   static_cast<std::uint8_t>(condition)));
+    rel32(target);
+}
+
+void Assembler::call(Label& target) {
+    emit(0xe8);
+    rel32(target);
+}
+
+std::size_t Assembler::call_external() {
+    emit(0xe8);
+    const auto position = code_.size();
+    emit32(0);
+    return position;
+}
+
+std::size_t Assembler::lea_rip(Register destination) {
+    rex_w(destination, Register::RAX);
+    emit(0x8d);
+    // mod 00, rm 101: [rip + disp32]
+    emit(static_cast<std::uint8_t>(0x05 | low(destination) << 3));
+    const auto position = code_.size();
+    emit32(0);
+    return position;
+}
+
+void Assembler::push(Register source) {
+    if (high(source) != 0) {
+        emit(0x41);
+    }
+    emit(static_cast<std::uint8_t>(0x50 | low(source)));
+}
+
+void Assembler::pop(Register destination) {
+    if (high(destination) != 0) {
+        emit(0x41);
+    }
+    emit(static_cast<std::uint8_t>(0x58 | low(destination)));
+}
+
+void Assembler::ret() {
+    emit(0xc3);
+}
+
+} // namespace backend::jit
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace backend::jit {
+
+enum class Register : std::uint8_t {
+    RAX,
+    RCX,
+    RDX,
+    RBX,
+    RSP,
+    RBP,
+    RSI,
+    RDI,
+    R8,
+    R9,
+    R10,
+    R11,
+    R12,
+    R13,
+    R14,
+    R15,
+};
+
+// Condition codes, numbered as in the Jcc and SETcc opcodes.
+enum class Condition : std::uint8_t {
+    ABOVE = 0x7,
+    EQUAL = 0x4,
+    NOT_EQUAL = 0x5,
+    LESS = 0xc,
+    GREATER_EQUAL = 0xd,
+    LESS_EQUAL = 0xe,
+    GREATER = 0xf,
+};
+
+// Minimal x86-64 encoder for the instructions the JIT needs. All operations
+// are on 64-bit registers; memory operands are [base + 32-bit displacement].
+class Assembler {
+public:
+    // Position in the code that a jump can target once bound.
+    class Label {
+    public:
+        Label() = default;
+
+    private:
+        friend class Assembler;
+
+        static constexpr std::size_t UNBOUND = static_cast<std::size_t>(-1);
+
+        std::size_t position_ = UNBOUND;
+        // rel32 fields waiting for the position
+        std::vector<std::size_t> fixups_;
+    };
+
+    const std::vector<std::uint8_t>& code() const {
+        return code_;
+    }
+
+    std::size_t size() const {
+        return code_.size();
+    }
+
+    void bind(Label& label);
+
+    void mov(Register destination, Register source);
+    void mov(Register destination, std::int64_t immediate);
+    void load(Register destination, Register base, std::int32_t offset);
+    void store(Register base, std::int32_t offset, Register source);
+
+    void add(Register destination, Register source);
+    void sub(Register destination, Register source);
+    void imul(Register destination, Register source);
+    void and_(Register destination, Register source);
+    void or_(Register destination, Register source);
+    void xor_(Register destination, Register source);
+    void cmp(Register left, Register right);
+    void cmp(Register left, std::int8_t immediate);
+    void test(Register left, Register right);
+
+    void neg(Register operand);
+    void not_(Register operand);
+    // rdx:rax / operand, quotient in rax and remainder in rdx
+    void cqo();
+    void idiv(Register operand);
+    // by cl
+    void shl(Register operand);
+    void sar(Register operand);
+
+    // destination = condition ? 1 : 0
+    void set(Condition condition, Register destination);
+
+    void add(Register destination, std::int32_t immediate);
+    void sub(Register destination, std::int32_t immediate);
+
+    void jmp(Label& target);
+    void jump_if(Condition condition, Label& target);
+
+    void call(Label& target);
+
+    // Instructions whose rel32 is left zero for a linker relocation; they
+    // return the position of the field.
+    std::size_t call_external();
+    // lea destination, [rip + rel32]
+    std::size_t lea_rip(Register destination);
+
+    void push(Register source);
+    void pop(Register destination);
+    void ret();
+
+private:
+    void emit(std::uint8_t byte) {
+        code_.push_back(byte);
+    }
+
+    void emit32(std::uint32_t value);
+    void emit64(std::uint64_t value);
+    // REX.W prefix with the high bits of `reg` and `rm`
+    void rex_w(Register reg, Register rm);
+    // register-direct ModRM
+    void modrm(Register reg, Register rm);
+    void modrm(std::uint8_t extension, Register rm);
+    // ModRM, SIB and disp32 for [base + offset]
+    void memory(Register reg, Register base, std::int32_t offset);
+    void binary(std::uint8_t opcode, Register destination, Register source);
+    void unary(std::uint8_t extension, Register operand);
+    void immediate(std::uint8_t extension, Register destination,
+                   std::int32_t value);
+    void rel32(Label& target);
+
+    std::vector<std::uint8_t> code_;
+};
+
+} // namespace backend::jit
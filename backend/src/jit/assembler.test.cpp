@@ -0,0 +1,97 @@
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "jit/assembler.h"
+
+namespace {
+
+using backend::jit::Assembler;
+using backend::jit::Condition;
+using backend::jit::Register;
+using Bytes = std::vector<std::uint8_t>;
+
+TEST(Assembler, RegisterToRegister) {
+    Assembler a;
+    a.mov(Register::RAX, Register::RBX);
+    a.mov(Register::R9, Register::R12);
+    a.imul(Register::RAX, Register::R10);
+    a.sub(Register::RSI, Register::R8);
+
+    EXPECT_EQ(a.code(), (Bytes{0x48, 0x89, 0xd8, 0x4d, 0x89, 0xe1, 0x49, 0x0f,
+                               0xaf, 0xc2, 0x4c, 0x29, 0xc6}));
+}
+
+TEST(Assembler, Immediates) {
+    Assembler a;
+    a.mov(Register::RAX, std::int64_t{1});
+    a.mov(Register::RCX, std::int64_t{0x123456789});
+    a.cmp(Register::R11, std::int8_t{-1});
+
+    EXPECT_EQ(a.code(), (Bytes{0x48, 0xc7, 0xc0, 0x01, 0x00, 0x00, 0x00,
+                               0x48, 0xb9, 0x89, 0x67, 0x45, 0x23, 0x01,
+                               0x00, 0x00, 0x00, 0x49, 0x83, 0xfb, 0xff}));
+}
+
+TEST(Assembler, Memory) {
+    Assembler a;
+    a.load(Register::RAX, Register::RBP, -8);
+    // r12 as a base needs a SIB byte
+    a.store(Register::R12, 16, Register::RBX);
+
+    EXPECT_EQ(a.code(), (Bytes{0x48, 0x8b, 0x85, 0xf8, 0xff, 0xff, 0xff, 0x49,
+                               0x89, 0x9c, 0x24, 0x10, 0x00, 0x00, 0x00}));
+}
+
+TEST(Assembler, DivisionAndSetcc) {
+    Assembler a;
+    a.cqo();
+    a.idiv(Register::RCX);
+    a.set(Condition::NOT_EQUAL, Register::RSI);
+    a.set(Condition::LESS, Register::R8);
+
+    EXPECT_EQ(a.code(), (Bytes{0x48, 0x99, 0x48, 0xf7, 0xf9, 0x40, 0x0f, 0x95,
+                               0xc6, 0x40, 0x0f, 0xb6, 0xf6, 0x41, 0x0f, 0x9c,
+                               0xc0, 0x45, 0x0f, 0xb6, 0xc0}));
+}
+
+TEST(Assembler, StackAndReturn) {
+    Assembler a;
+    a.push(Register::R12);
+    a.pop(Register::RBX);
+    a.ret();
+
+    EXPECT_EQ(a.code(), (Bytes{0x41, 0x54, 0x5b, 0xc3}));
+}
+
+TEST(Assembler, Jumps) {
+    Assembler a;
+    Assembler::Label back;
+    Assembler::Label forward;
+    a.bind(back);
+    a.jump_if(Condition::EQUAL, forward);
+    a.ret();
+    a.bind(forward);
+    a.jmp(back);
+
+    EXPECT_EQ(a.code(), (Bytes{0x0f, 0x84, 0x01, 0x00, 0x00, 0x00, 0xc3, 0xe9,
+                               0xf4, 0xff, 0xff, 0xff}));
+    EXPECT_THROW(a.bind(back), std::logic_error);
+}
+
+TEST(Assembler, RelocatableFields) {
+    Assembler a;
+    Assembler::Label function;
+    a.bind(function);
+    a.ret();
+    a.call(function);
+
+    EXPECT_EQ(a.lea_rip(Register::RSI), 9);
+    EXPECT_EQ(a.call_external(), 14);
+    EXPECT_EQ(a.code(), (Bytes{0xc3, 0xe8, 0xfa, 0xff, 0xff, 0xff, 0x48, 0x8d,
+                               0x35, 0x00, 0x00, 0x00, 0x00, 0xe8, 0x00, 0x00,
+                               0x00, 0x00}));
+}
+
+} // namespace
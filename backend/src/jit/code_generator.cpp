@@ -0,0 +1,686 @@
+#include "jit/code_generator.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "ir/dominators.h"
+#include "jit/assembler.h"
+#include "jit/register_allocator.h"
+
+namespace backend::jit {
+
+namespace {
+
+using frontend::ast::Operator;
+using ir::BlockId;
+using ir::Opcode;
+using ir::ValueId;
+
+// rax, rcx and rdx are scratch registers since idiv and the shifts need them;
+// rdi holds the RuntimeStatus pointer and rbp the frame.
+constexpr std::array ALLOCATABLE = {
+    Register::RBX, Register::RSI, Register::R8,  Register::R9,
+    Register::R10, Register::R11, Register::R12, Register::R13,
+    Register::R14, Register::R15,
+};
+
+// saved below the frame pointer, followed by the spill slots
+constexpr std::array CALLEE_SAVED = {
+    Register::RBX, Register::R12, Register::R13, Register::R14, Register::R15,
+};
+
+// What a value holds at run time.
+enum class Kind : std::uint8_t {
+    INT,
+    BOOL,
+    // anything the JIT cannot keep in a register
+    OTHER,
+};
+
+bool is_comparison(Operator::Type op) {
+    switch (op) {
+        case Operator::Type::EQUAL_TO:
+        case Operator::Type::NOT_EQUAL_TO:
+        case Operator::Type::LESS_THAN:
+        case Operator::Type::LESS_THAN_OR_EQUAL_TO:
+        case Operator::Type::GREATER_THAN:
+        case Operator::Type::GREATER_THAN_OR_EQUAL_TO:
+            return true;
+        default:
+            return false;
+    }
+}
+
+Condition condition(Operator::Type op) {
+    switch (op) {
+        case Operator::Type::EQUAL_TO:
+            return Condition::EQUAL;
+        case Operator::Type::NOT_EQUAL_TO:
+            return Condition::NOT_EQUAL;
+        case Operator::Type::LESS_THAN:
+            return Condition::LESS;
+        case Operator::Type::LESS_THAN_OR_EQUAL_TO:
+            return Condition::LESS_EQUAL;
+        case Operator::Type::GREATER_THAN:
+            return Condition::GREATER;
+        default:
+            return Condition::GREATER_EQUAL;
+    }
+}
+
+// Translates a function in one pass over its blocks in reverse postorder,
+// which places every definition before its uses since the IR has no loops.
+// Phis are resolved by moves on each incoming edge.
+class CodeGenerator {
+public:
+    explicit CodeGenerator(const ir::Function& function)
+        : function_(function),
+          tree_(function),
+          kinds_(function.instruction_count(), Kind::OTHER),
+          needed_(function.instruction_count(), false),
+          positions_(function.instruction_count(), 0),
+          locations_(function.instruction_count()),
+          labels_(function.blocks().size()) {}
+
+    std::optional<MachineCode> generate() {
+        infer_kinds();
+        mark_needed();
+        std::optional<Value::Type> result_type;
+        for (const auto block : tree_.reverse_postorder()) {
+            for (const auto id : function_.blocks()[block].instructions) {
+                const auto& instruction = function_.instruction(id);
+                if (instruction.opcode == Opcode::RETURN) {
+                    const auto kind = kinds_[instruction.operands[0]];
+                    const auto type = kind == Kind::INT ? Value::Type::INT
+                                                        : Value::Type::BOOL;
+                    if (kind == Kind::OTHER ||
+                        (result_type && *result_type != type)) {
+                        return std::nullopt;
+                    }
+                    result_type = type;
+                } else if (needed_[id] && !instruction.is_terminator() &&
+                           kinds_[id] == Kind::OTHER) {
+                    return std::nullopt;
+                }
+            }
+        }
+        if (!result_type) {
+            return std::nullopt;
+        }
+
+        allocate();
+        emit();
+        return MachineCode{assembler_.code(), *result_type};
+    }
+
+private:
+    Kind infer(const ir::Instruction& instruction) const {
+        switch (instruction.opcode) {
+            case Opcode::CONSTANT: {
+                const auto& value =
+                    function_.constants()[instruction.operands[0]];
+                if (value.type() == Value::Type::INT) {
+                    return Kind::INT;
+                }
+                return value.type() == Value::Type::BOOL ? Kind::BOOL
+                                                         : Kind::OTHER;
+            }
+            case Opcode::UNARY: {
+                const auto operand = kinds_[instruction.operands[0]];
+                if (instruction.op == Operator::Type::LOGICAL_NOT) {
+                    return operand == Kind::OTHER ? Kind::OTHER : Kind::BOOL;
+                }
+                return operand == Kind::INT ? Kind::INT : Kind::OTHER;
+            }
+            case Opcode::BINARY: {
+                const auto left = kinds_[instruction.operands[0]];
+                const auto right = kinds_[instruction.operands[1]];
+                if (left == Kind::OTHER || right == Kind::OTHER) {
+                    return Kind::OTHER;
+                }
+                if (instruction.op == Operator::Type::LOGICAL_AND ||
+                    instruction.op == Operator::Type::LOGICAL_OR) {
+                    return Kind::BOOL;
+                }
+                if (left == Kind::BOOL && right == Kind::BOOL &&
+                    (instruction.op == Operator::Type::EQUAL_TO ||
+                     instruction.op == Operator::Type::NOT_EQUAL_TO)) {
+                    return Kind::BOOL;
+                }
+                if (left != Kind::INT || right != Kind::INT) {
+                    return Kind::OTHER;
+                }
+                return is_comparison(instruction.op) ? Kind::BOOL : Kind::INT;
+            }
+            case Opcode::TO_BOOL:
+                return kinds_[instruction.operands[0]] == Kind::OTHER
+                           ? Kind::OTHER
+                           : Kind::BOOL;
+            case Opcode::PHI: {
+                std::optional<Kind> kind;
+                for (const auto& incoming :
+                     function_.phi_operands(instruction)) {
+                    if (!tree_.is_reachable(incoming.block)) {
+                        continue;
+                    }
+                    const auto operand = kinds_[incoming.value];
+                    if (kind && *kind != operand) {
+                        return Kind::OTHER;
+                    }
+                    kind = operand;
+                }
+                return kind.value_or(Kind::OTHER);
+            }
+            default:
+                return Kind::OTHER;
+        }
+    }
+
+    void infer_kinds() {
+        for (const auto block : tree_.reverse_postorder()) {
+            for (const auto id : function_.blocks()[block].instructions) {
+                kinds_[id] = infer(function_.instruction(id));
+            }
+        }
+    }
+
+    // Every instruction that may throw or transfer control is emitted, with
+    // the values it depends on; unused constants and phis are dropped, which
+    // lets a function keep e.g. a dead `none` it could not represent.
+    void mark_needed() {
+        std::vector<ValueId> worklist;
+        const auto need = [&](ValueId id) {
+            if (!needed_[id]) {
+                needed_[id] = true;
+                worklist.push_back(id);
+            }
+        };
+        for (const auto block : tree_.reverse_postorder()) {
+            for (const auto id : function_.blocks()[block].instructions) {
+                const auto opcode = function_.instruction(id).opcode;
+                if (opcode != Opcode::CONSTANT && opcode != Opcode::PHI) {
+                    need(id);
+                }
+            }
+        }
+        while (!worklist.empty()) {
+            const auto& instruction = function_.instruction(worklist.back());
+            worklist.pop_back();
+            if (instruction.opcode == Opcode::PHI) {
+                for (const auto& incoming :
+                     function_.phi_operands(instruction)) {
+                    if (tree_.is_reachable(incoming.block)) {
+                        need(incoming.value);
+                    }
+                }
+                continue;
+            }
+            for (std::size_t i = 0; i < instruction.value_operand_count();
+                 ++i) {
+                need(instruction.operands[i]);
+            }
+        }
+    }
+
+    // Builds live intervals over the instructions numbered in emission
+    // order. A phi operand is used at the end of its incoming block, where
+    // the edge moves read it.
+    void allocate() {
+        const auto block_count = function_.blocks().size();
+        std::vector<std::uint32_t> block_ends(block_count, 0);
+        std::uint32_t position = 0;
+        for (const auto block : tree_.reverse_postorder()) {
+            for (const auto id : function_.blocks()[block].instructions) {
+                positions_[id] = position++;
+            }
+            block_ends[block] = position - 1;
+        }
+
+        std::vector<std::uint32_t> ends(function_.instruction_count(), 0);
+        std::vector<ValueId> values;
+        for (const auto block : tree_.reverse_postorder()) {
+            for (const auto id : function_.blocks()[block].instructions) {
+                if (!needed_[id]) {
+                    continue;
+                }
+                const auto& instruction = function_.instruction(id);
+                if (!instruction.is_terminator()) {
+                    values.push_back(id);
+                    ends[id] = std::max(ends[id], positions_[id]);
+                }
+                if (instruction.opcode == Opcode::PHI) {
+                    for (const auto& incoming :
+                         function_.phi_operands(instruction)) {
+                        if (tree_.is_reachable(incoming.block)) {
+                            ends[incoming.value] =
+                                std::max(ends[incoming.value],
+                                         block_ends[incoming.block]);
+                        }
+                    }
+                    continue;
+                }
+                for (std::size_t i = 0; i < instruction.value_operand_count();
+                     ++i) {
+                    const auto operand = instruction.operands[i];
+                    ends[operand] = std::max(ends[operand], positions_[id]);
+                }
+            }
+        }
+
+        std::vector<LiveInterval> intervals;
+        intervals.reserve(values.size());
+        for (const auto id : values) {
+            intervals.push_back({positions_[id], ends[id]});
+        }
+        const auto allocation = allocate_registers(intervals, ALLOCATABLE);
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            locations_[values[i]] = allocation.locations[i];
+        }
+        stack_slots_ = allocation.stack_slots;
+    }
+
+    static std::int32_t slot_offset(std::uint32_t slot) {
+        return -8 * static_cast<std::int32_t>(CALLEE_SAVED.size() + 1 + slot);
+    }
+
+    // The register holding `value`, loading it into `scratch` if spilled.
+    Register use(ValueId value, Register scratch) {
+        const auto& location = locations_[value];
+        if (location.in_register()) {
+            return location.reg;
+        }
+        assembler_.load(scratch, Register::RBP, slot_offset(location.slot));
+        return scratch;
+    }
+
+    void move_to(Register destination, ValueId value) {
+        const auto source = use(value, destination);
+        if (source != destination) {
+            assembler_.mov(destination, source);
+        }
+    }
+
+    // Where to compute `value`: its own register, or rax if spilled.
+    Register target(ValueId value) const {
+        const auto& location = locations_[value];
+        return location.in_register() ? location.reg : Register::RAX;
+    }
+
+    void define(ValueId value, Register source) {
+        const auto& location = locations_[value];
+        if (!location.in_register()) {
+            assembler_.store(Register::RBP, slot_offset(location.slot),
+                             source);
+        } else if (location.reg != source) {
+            assembler_.mov(location.reg, source);
+        }
+    }
+
+    struct Move {
+        ValueId phi;
+        ValueId source;
+    };
+
+    std::vector<Move> edge_moves(BlockId from, BlockId to) const {
+        std::vector<Move> moves;
+        for (const auto id : function_.blocks()[to].instructions) {
+            const auto& instruction = function_.instruction(id);
+            if (instruction.opcode != Opcode::PHI) {
+                break;
+            }
+            if (!needed_[id]) {
+                continue;
+            }
+            for (const auto& incoming : function_.phi_operands(instruction)) {
+                if (incoming.block == from &&
+                    locations_[incoming.value] != locations_[id]) {
+                    moves.push_back({id, incoming.value});
+                }
+            }
+        }
+        return moves;
+    }
+
+    // Performs the moves into the phis of `to` for the edge from `from`.
+    // They happen in parallel: if one overwrites the source of another, all
+    // sources go through the machine stack first.
+    void emit_edge(BlockId from, BlockId to) {
+        const auto moves = edge_moves(from, to);
+        const bool overlapping = std::ranges::any_of(moves, [&](auto& move) {
+            return std::ranges::any_of(moves, [&](auto& other) {
+                return locations_[move.phi] == locations_[other.source];
+            });
+        });
+        if (!overlapping) {
+            for (const auto& move : moves) {
+                define(move.phi, use(move.source, Register::RAX));
+            }
+            return;
+        }
+        for (const auto& move : moves) {
+            assembler_.push(use(move.source, Register::RAX));
+        }
+        for (auto it = moves.rbegin(); it != moves.rend(); ++it) {
+            assembler_.pop(Register::RAX);
+            define(it->phi, Register::RAX);
+        }
+    }
+
+    void emit_constant(ValueId id, const ir::Instruction& instruction) {
+        const auto& value = function_.constants()[instruction.operands[0]];
+        const auto destination = target(id);
+        assembler_.mov(destination, value.type() == Value::Type::BOOL
+                                        ? std::int64_t{value.as_bool()}
+                                        : value.as_int());
+        define(id, destination);
+    }
+
+    void emit_unary(ValueId id, const ir::Instruction& instruction) {
+        const auto operand = instruction.operands[0];
+        const auto destination = target(id);
+        switch (instruction.op) {
+            case Operator::Type::UNARY_MINUS:
+                move_to(destination, operand);
+                assembler_.neg(destination);
+                break;
+            case Operator::Type::BITWISE_NOT:
+                move_to(destination, operand);
+                assembler_.not_(destination);
+                break;
+            case Operator::Type::LOGICAL_NOT: {
+                const auto source = use(operand, Register::RAX);
+                assembler_.test(source, source);
+                assembler_.set(Condition::EQUAL, destination);
+                break;
+            }
+            default:
+                move_to(destination, operand);
+                break;
+        }
+        define(id, destination);
+    }
+
+    void emit_to_bool(ValueId id, const ir::Instruction& instruction) {
+        const auto source = use(instruction.operands[0], Register::RAX);
+        const auto destination = target(id);
+        assembler_.test(source, source);
+        assembler_.set(Condition::NOT_EQUAL, destination);
+        define(id, destination);
+    }
+
+    void emit_division(ValueId id, const ir::Instruction& instruction) {
+        const bool remainder = instruction.op == Operator::Type::REMAINDER;
+        move_to(Register::RCX, instruction.operands[1]);
+        move_to(Register::RAX, instruction.operands[0]);
+        assembler_.test(Register::RCX, Register::RCX);
+        assembler_.jump_if(Condition::EQUAL, division_by_zero_);
+        uses_division_ = true;
+
+        // idiv traps on INT64_MIN / -1, which wraps to INT64_MIN instead
+        Assembler::Label divide;
+        Assembler::Label done;
+        assembler_.cmp(Register::RCX, std::int8_t{-1});
+        assembler_.jump_if(Condition::NOT_EQUAL, divide);
+        if (remainder) {
+            assembler_.mov(Register::RDX, std::int64_t{0});
+        } else {
+            assembler_.neg(Register::RAX);
+        }
+        assembler_.jmp(done);
+        assembler_.bind(divide);
+        assembler_.cqo();
+        assembler_.idiv(Register::RCX);
+        assembler_.bind(done);
+        define(id, remainder ? Register::RDX : Register::RAX);
+    }
+
+    void emit_shift(ValueId id, const ir::Instruction& instruction) {
+        move_to(Register::RCX, instruction.operands[1]);
+        // unsigned, so that negative counts are out of range too
+        assembler_.cmp(Register::RCX, std::int8_t{63});
+        assembler_.jump_if(Condition::ABOVE, shift_out_of_range_);
+        uses_shift_ = true;
+
+        const auto destination = target(id);
+        move_to(destination, instruction.operands[0]);
+        if (instruction.op == Operator::Type::BITWISE_LEFT_SHIFT) {
+            assembler_.shl(destination);
+        } else {
+            assembler_.sar(destination);
+        }
+        define(id, destination);
+    }
+
+    void emit_logical(ValueId id, const ir::Instruction& instruction) {
+        const auto left = use(instruction.operands[0], Register::RAX);
+        assembler_.test(left, left);
+        assembler_.set(Condition::NOT_EQUAL, Register::RAX);
+        const auto right = use(instruction.operands[1], Register::RCX);
+        assembler_.test(right, right);
+        assembler_.set(Condition::NOT_EQUAL, Register::RCX);
+        if (instruction.op == Operator::Type::LOGICAL_AND) {
+            assembler_.and_(Register::RAX, Register::RCX);
+        } else {
+            assembler_.or_(Register::RAX, Register::RCX);
+        }
+        define(id, Register::RAX);
+    }
+
+    void emit_binary(ValueId id, const ir::Instruction& instruction) {
+        const auto op = instruction.op;
+        switch (op) {
+            case Operator::Type::DIVISION:
+            case Operator::Type::REMAINDER:
+                emit_division(id, instruction);
+                return;
+            case Operator::Type::BITWISE_LEFT_SHIFT:
+            case Operator::Type::BITWISE_RIGHT_SHIFT:
+                emit_shift(id, instruction);
+                return;
+            case Operator::Type::LOGICAL_AND:
+            case Operator::Type::LOGICAL_OR:
+                emit_logical(id, instruction);
+                return;
+            default:
+                break;
+        }
+
+        const auto destination = target(id);
+        if (is_comparison(op)) {
+            assembler_.cmp(use(instruction.operands[0], Register::RAX),
+                           use(instruction.operands[1], Register::RCX));
+            assembler_.set(condition(op), destination);
+            define(id, destination);
+            return;
+        }
+
+        // the destination's register is never an operand's: both operands
+        // are still live where it is defined
+        const auto right = use(instruction.operands[1], Register::RCX);
+        move_to(destination, instruction.operands[0]);
+        switch (op) {
+            case Operator::Type::ADDITION:
+                assembler_.add(destination, right);
+                break;
+            case Operator::Type::SUBTRACTION:
+                assembler_.sub(destination, right);
+                break;
+            case Operator::Type::MULTIPLICATION:
+                assembler_.imul(destination, right);
+                break;
+            case Operator::Type::BITWISE_AND:
+                assembler_.and_(destination, right);
+                break;
+            case Operator::Type::BITWISE_OR:
+                assembler_.or_(destination, right);
+                break;
+            case Operator::Type::BITWISE_XOR:
+                assembler_.xor_(destination, right);
+                break;
+            default:
+                throw std::logic_error(std::vformat(
+                    "Cannot compile operator {}", std::make_format_args(op)));
+        }
+        define(id, destination);
+    }
+
+    void emit_branch(BlockId block, const ir::Instruction& instruction,
+                     BlockId next) {
+        const auto then_block = instruction.operands[1];
+        const auto else_block = instruction.operands[2];
+        const auto condition = use(instruction.operands[0], Register::RAX);
+        assembler_.test(condition, condition);
+
+        if (edge_moves(block, then_block).empty()) {
+            assembler_.jump_if(Condition::NOT_EQUAL, labels_[then_block]);
+            emit_edge(block, else_block);
+            if (else_block != next) {
+                assembler_.jmp(labels_[else_block]);
+            }
+            return;
+        }
+        Assembler::Label else_edge;
+        assembler_.jump_if(Condition::EQUAL, else_edge);
+        emit_edge(block, then_block);
+        assembler_.jmp(labels_[then_block]);
+        assembler_.bind(else_edge);
+        emit_edge(block, else_block);
+        if (else_block != next) {
+            assembler_.jmp(labels_[else_block]);
+        }
+    }
+
+    void emit() {
+        assembler_.push(Register::RBP);
+        assembler_.mov(Register::RBP, Register::RSP);
+        for (const auto reg : CALLEE_SAVED) {
+            assembler_.push(reg);
+        }
+        const auto frame = static_cast<std::int32_t>(8 * stack_slots_);
+        if (frame != 0) {
+            assembler_.sub(Register::RSP, frame);
+        }
+
+        const auto order = tree_.reverse_postorder();
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            const auto block = order[i];
+            const auto next = i + 1 < order.size() ? order[i + 1] : ir::NO_ID;
+            assembler_.bind(labels_[block]);
+            for (const auto id : function_.blocks()[block].instructions) {
+                if (!needed_[id]) {
+                    continue;
+                }
+                const auto& instruction = function_.instruction(id);
+                switch (instruction.opcode) {
+                    case Opcode::CONSTANT:
+                        emit_constant(id, instruction);
+                        break;
+                    case Opcode::UNARY:
+                        emit_unary(id, instruction);
+                        break;
+                    case Opcode::BINARY:
+                        emit_binary(id, instruction);
+                        break;
+                    case Opcode::TO_BOOL:
+                        emit_to_bool(id, instruction);
+                        break;
+                    case Opcode::PHI:
+                        // written by the predecessors
+                        break;
+                    case Opcode::JUMP:
+                        emit_edge(block, instruction.operands[0]);
+                        if (instruction.operands[0] != next) {
+                            assembler_.jmp(labels_[instruction.operands[0]]);
+                        }
+                        break;
+                    case Opcode::BRANCH:
+                        emit_branch(block, instruction, next);
+                        break;
+                    case Opcode::RETURN:
+                        move_to(Register::RAX, instruction.operands[0]);
+                        if (next != ir::NO_ID) {
+                            assembler_.jmp(epilogue_);
+                        }
+                        break;
+                }
+            }
+        }
+
+        assembler_.bind(epilogue_);
+        if (frame != 0) {
+            assembler_.add(Register::RSP, frame);
+        }
+        for (auto it = CALLEE_SAVED.rbegin(); it != CALLEE_SAVED.rend();
+             ++it) {
+            assembler_.pop(*it);
+        }
+        assembler_.pop(Register::RBP);
+        assembler_.ret();
+
+        if (uses_division_) {
+            assembler_.bind(division_by_zero_);
+            assembler_.mov(Register::RAX, DIVISION_BY_ZERO);
+            assembler_.store(Register::RDI,
+                             offsetof(RuntimeStatus, error), Register::RAX);
+            assembler_.jmp(epilogue_);
+        }
+        if (uses_shift_) {
+            // the count is still in rcx
+            assembler_.bind(shift_out_of_range_);
+            assembler_.store(Register::RDI,
+                             offsetof(RuntimeStatus, operand), Register::RCX);
+            assembler_.mov(Register::RAX, SHIFT_OUT_OF_RANGE);
+            assembler_.store(Register::RDI,
+                             offsetof(RuntimeStatus, error), Register::RAX);
+            assembler_.jmp(epilogue_);
+        }
+    }
+
+    const ir::Function& function_;
+    const ir::DominatorTree tree_;
+    std::vector<Kind> kinds_;
+    std::vector<bool> needed_;
+    std::vector<std::uint32_t> positions_;
+    std::vector<Location> locations_;
+    std::uint32_t stack_slots_ = 0;
+
+    Assembler assembler_;
+    std::vector<Assembler::Label> labels_;
+    Assembler::Label epilogue_;
+    Assembler::Label division_by_zero_;
+    Assembler::Label shift_out_of_range_;
+    bool uses_division_ = false;
+    bool uses_shift_ = false;
+};
+
+} // namespace
+
+std::optional<MachineCode> generate_code(const ir::Function& function) {
+    return CodeGenerator(function).generate();
+}
+
+Value to_value(std::int64_t result, const RuntimeStatus& status,
+               Value::Type type) {
+    switch (status.error) {
+        case 0:
+            break;
+        case DIVISION_BY_ZERO:
+            throw EvaluationError("Division by zero");
+        default:
+            throw EvaluationError(
+                std::vformat("Shift count out of range: {}",
+                             std::make_format_args(status.operand)));
+    }
+    if (type == Value::Type::BOOL) {
+        return result != 0;
+    }
+    return result;
+}
+
+} // namespace backend::jit
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "ir/ir.h"
+#include "value.h"
+
+namespace backend::jit {
+
+inline constexpr std::int64_t DIVISION_BY_ZERO = 1;
+inline constexpr std::int64_t SHIFT_OUT_OF_RANGE = 2;
+
+// Filled in by generated code that stops at a runtime error.
+struct RuntimeStatus {
+    // 0, DIVISION_BY_ZERO or SHIFT_OUT_OF_RANGE
+    std::int64_t error = 0;
+    // the shift count for SHIFT_OUT_OF_RANGE
+    std::int64_t operand = 0;
+};
+
+// Position-independent x86-64 code for one function, callable as
+// `std::int64_t code(RuntimeStatus*)` under the System V ABI. It returns the
+// program's result as an integer of `result_type` (INT or BOOL).
+struct MachineCode {
+    std::vector<std::uint8_t> bytes;
+    Value::Type result_type;
+};
+
+// Translates `function` with every value in a 64-bit register or stack slot.
+// Returns nullopt if it computes with anything but integers and booleans.
+std::optional<MachineCode> generate_code(const ir::Function& function);
+
+// The program's result from what the code returned, throwing the
+// EvaluationError the interpreters would for a runtime error.
+Value to_value(std::int64_t result, const RuntimeStatus& status,
+               Value::Type type);
+
+} // namespace backend::jit
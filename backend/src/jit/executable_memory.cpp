@@ -0,0 +1,78 @@
+#include "jit/executable_memory.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace backend::jit {
+
+namespace {
+
+std::string hex(std::uintptr_t value) {
+    std::array<char, 16> digits{};
+    const auto result =
+        std::to_chars(digits.data(), digits.data() + digits.size(), value, 16);
+    return {digits.data(), result.ptr};
+}
+
+} // namespace
+
+ExecutableMemory::ExecutableMemory(std::span<const std::uint8_t> code)
+    : size_(code.size()) {
+    const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    mapped_ = (std::max<std::size_t>(code.size(), 1) + page - 1) / page * page;
+    void* data = ::mmap(nullptr, mapped_, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+        throw std::system_error(errno, std::generic_category(), "mmap");
+    }
+    std::memcpy(data, code.data(), code.size());
+    if (::mprotect(data, mapped_, PROT_READ | PROT_EXEC) != 0) {
+        const int error = errno;
+        ::munmap(data, mapped_);
+        throw std::system_error(error, std::generic_category(), "mprotect");
+    }
+    data_ = data;
+}
+
+ExecutableMemory::~ExecutableMemory() {
+    if (data_ != nullptr) {
+        ::munmap(data_, mapped_);
+    }
+}
+
+ExecutableMemory::ExecutableMemory(ExecutableMemory&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      mapped_(std::exchange(other.mapped_, 0)) {}
+
+ExecutableMemory& ExecutableMemory::operator=(
+    ExecutableMemory&& other) noexcept {
+    if (this != &other) {
+        if (data_ != nullptr) {
+            ::munmap(data_, mapped_);
+        }
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        mapped_ = std::exchange(other.mapped_, 0);
+    }
+    return *this;
+}
+
+void write_perf_map_entry(const void* code, std::size_t size,
+                          std::string_view symbol) {
+    std::ofstream map("/tmp/perf-" + std::to_string(::getpid()) + ".map",
+                      std::ios::app);
+    map << hex(reinterpret_cast<std::uintptr_t>(code)) << ' ' << hex(size)
+        << ' ' << symbol << '\n';
+}
+
+} // namespace backend::jit
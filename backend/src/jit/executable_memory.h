@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace backend::jit {
+
+// Page-aligned anonymous mapping holding machine code. The code is copied in
+// while the pages are writable, and they are then made read-only and
+// executable so that no page is ever writable and executable at once.
+class ExecutableMemory {
+public:
+    explicit ExecutableMemory(std::span<const std::uint8_t> code);
+    ~ExecutableMemory();
+
+    ExecutableMemory(ExecutableMemory&& other) noexcept;
+    ExecutableMemory& operator=(ExecutableMemory&& other) noexcept;
+    ExecutableMemory(const ExecutableMemory&) = delete;
+    ExecutableMemory& operator=(const ExecutableMemory&) = delete;
+
+    const void* data() const {
+        return data_;
+    }
+
+    // of the code; the mapping is rounded up to whole pages
+    std::size_t size() const {
+        return size_;
+    }
+
+private:
+    void* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t mapped_ = 0;
+};
+
+// Appends "<start> <size> <symbol>" in hex to /tmp/perf-<pid>.map, the file
+// perf reads to attribute samples in JIT code. Errors are ignored: the map
+// only helps profiling.
+void write_perf_map_entry(const void* code, std::size_t size,
+                          std::string_view symbol);
+
+} // namespace backend::jit
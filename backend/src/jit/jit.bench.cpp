@@ -0,0 +1,66 @@
+#include <cstdint>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_programs.h"
+#include "ir/lowering.h"
+#include "jit/jit.h"
+#include "parser.h"
+#include "scanner.h"
+
+// Same programs and sizes as the bytecode VM's BM_Interpret* benchmarks so
+// that native code can be compared with interpretation directly. The IR is
+// not optimised, so that constant folding does not do the work up front.
+
+namespace {
+
+backend::ir::Function lower(const std::string& source) {
+    return backend::ir::Lowering().lower(
+        frontend::Parser(frontend::Scanner(source).scan_tokens()).parse());
+}
+
+void run(benchmark::State& state, const std::string& source) {
+    if (!backend::jit::is_supported_platform()) {
+        state.SkipWithError("the JIT only targets x86-64");
+        return;
+    }
+    const auto compiled = backend::jit::compile(lower(source));
+    if (!compiled) {
+        state.SkipWithError("program not supported by the JIT");
+        return;
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(compiled->run());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel("items = statements");
+    state.counters["code_bytes"] = static_cast<double>(compiled->code_size());
+}
+
+void BM_JitArithmetic(benchmark::State& state) {
+    run(state, backend::bench::arithmetic_program(
+                   static_cast<std::size_t>(state.range(0))));
+}
+
+void BM_JitBranches(benchmark::State& state) {
+    run(state, backend::bench::branchy_program(
+                   static_cast<std::size_t>(state.range(0))));
+}
+
+// Code generation alone, from unoptimised IR.
+void BM_JitCompileArithmetic(benchmark::State& state) {
+    const auto function = lower(backend::bench::arithmetic_program(
+        static_cast<std::size_t>(state.range(0))));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(backend::jit::compile(function));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel("items = statements");
+}
+
+BENCHMARK(BM_JitArithmetic)->Range(64, 16384);
+BENCHMARK(BM_JitBranches)->Range(64, 16384);
+BENCHMARK(BM_JitCompileArithmetic)->Range(64, 16384);
+
+} // namespace
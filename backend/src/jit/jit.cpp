@@ -0,0 +1,49 @@
+#include "jit/jit.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include "jit/code_generator.h"
+#include "trace.h"
+
+namespace backend::jit {
+
+Value CompiledFunction::run() const {
+#if defined(__x86_64__)
+    using Entry = std::int64_t (*)(RuntimeStatus*);
+    RuntimeStatus status;
+    const auto entry = reinterpret_cast<Entry>(const_cast<void*>(code()));
+    const auto result = entry(&status);
+    return to_value(result, status, result_type_);
+#else
+    throw std::logic_error("JIT code cannot run on this platform");
+#endif
+}
+
+bool is_supported_platform() {
+#if defined(__x86_64__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::optional<CompiledFunction> compile(const ir::Function& function,
+                                        const JitOptions& options) {
+    if (!is_supported_platform()) {
+        return std::nullopt;
+    }
+    frontend::trace::Span span("jit", "backend");
+    auto code = generate_code(function);
+    if (!code) {
+        return std::nullopt;
+    }
+    ExecutableMemory memory(code->bytes);
+    if (options.perf_map) {
+        write_perf_map_entry(memory.data(), memory.size(), options.symbol);
+    }
+    return CompiledFunction(std::move(memory), code->result_type);
+}
+
+} // namespace backend::jit
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+#include "ir/ir.h"
+#include "jit/executable_memory.h"
+#include "value.h"
+
+namespace backend::jit {
+
+struct JitOptions {
+    // Register the code in /tmp/perf-<pid>.map under `symbol`.
+    bool perf_map = false;
+    std::string symbol = "jit_program";
+};
+
+// Native code for one function.
+class CompiledFunction {
+public:
+    // Runs the code with the semantics of the interpreters, throwing an
+    // EvaluationError for division by zero and out of range shift counts.
+    Value run() const;
+
+    const void* code() const {
+        return memory_.data();
+    }
+
+    std::size_t code_size() const {
+        return memory_.size();
+    }
+
+private:
+    friend std::optional<CompiledFunction> compile(const ir::Function&,
+                                                   const JitOptions&);
+
+    CompiledFunction(ExecutableMemory memory, Value::Type result_type)
+        : memory_(std::move(memory)), result_type_(result_type) {}
+
+    ExecutableMemory memory_;
+    Value::Type result_type_;
+};
+
+// Whether compile() can produce code on this machine (x86-64 only).
+bool is_supported_platform();
+
+// Compiles `function` to x86-64 machine code in executable memory. Every
+// value is kept in a 64-bit register or stack slot, so only functions
+// computing with integers and booleans are supported; for anything else,
+// and on other platforms, returns nullopt and the caller should interpret.
+std::optional<CompiledFunction> compile(const ir::Function& function,
+                                        const JitOptions& options = {});
+
+} // namespace backend::jit
@@ -0,0 +1,263 @@
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include "ast/node.h"
+#include "bench_programs.h"
+#include "interpreter/evaluator.h"
+#include "ir/lowering.h"
+#include "jit/jit.h"
+#include "optimizer/pass.h"
+#include "parser.h"
+#include "scanner.h"
+
+namespace {
+
+using backend::EvaluationError;
+using backend::Value;
+using backend::ir::Function;
+using backend::ir::Lowering;
+using backend::optimizer::PassManager;
+
+class Jit : public testing::Test {
+protected:
+    void SetUp() override {
+        if (!backend::jit::is_supported_platform()) {
+            GTEST_SKIP() << "the JIT only targets x86-64";
+        }
+    }
+};
+
+Function lower(const std::string& source, int level) {
+    auto function = Lowering().lower(
+        frontend::Parser(frontend::Scanner(source).scan_tokens()).parse());
+    PassManager::for_level(level).run(function);
+    return function;
+}
+
+template <typename Run>
+std::string describe(Run run) {
+    try {
+        const auto value = run();
+        return std::vformat("{}: {}", std::make_format_args(
+                                          value.type(), value.to_string()));
+    } catch (const EvaluationError& error) {
+        return error.what();
+    }
+}
+
+std::string evaluate(const frontend::ast::Node& node) {
+    backend::interpreter::Evaluator evaluator;
+    return describe([&]() { return evaluator.evaluate(node); });
+}
+
+std::string evaluate(const std::string& source) {
+    const auto ast =
+        frontend::Parser(frontend::Scanner(source).scan_tokens()).parse();
+    backend::interpreter::Evaluator evaluator;
+    return describe([&]() { return evaluator.evaluate(ast); });
+}
+
+std::string run(const Function& function) {
+    const auto compiled = backend::jit::compile(function);
+    if (!compiled) {
+        return "unsupported";
+    }
+    return describe([&]() { return compiled->run(); });
+}
+
+// Compiles `source` at every optimisation level and expects the evaluator's
+// result or error.
+void expect_same_as_evaluator(const std::string& source) {
+    const auto expected = evaluate(source);
+    for (int level = 0; level <= PassManager::MAX_LEVEL; ++level) {
+        EXPECT_EQ(run(lower(source, level)), expected)
+            << source << " at -O" << level;
+    }
+}
+
+TEST_F(Jit, IntegerArithmetic) {
+    for (const auto* source : {
+             "4 % 3 + 5 * 2;",
+             "7 / 2 - 10;",
+             "1 - (2 - (3 - (4 - 5)));",
+             "9223372036854775807 + 1;",
+             "(0 - 5) % 3; 5 % (0 - 3);",
+             "((0 - 9223372036854775807) - 1) / (0 - 1);",
+             "((0 - 9223372036854775807) - 1) % (0 - 1);",
+             "1024 >> 3; (0 - 1024) >> 3; 1 << 63;",
+             "3 * 4294967296 * 4294967296;",
+         }) {
+        expect_same_as_evaluator(source);
+    }
+}
+
+TEST_F(Jit, Comparisons) {
+    for (const auto* source : {
+             "1 < 2;", "2 <= 1;", "3 > 3;", "3 >= 3;", "4 == 4;", "4 != 4;",
+             "(1 < 2) == (3 < 4);", "(1 < 2) != (3 < 4);",
+             "true; false;", "true == false;",
+         }) {
+        expect_same_as_evaluator(source);
+    }
+}
+
+TEST_F(Jit, RuntimeErrors) {
+    for (const auto* source : {
+             "1 / 0;",
+             "1 % (2 - 2);",
+             "1 << 64;",
+             "1 >> (0 - 1);",
+             // an error in an unused statement still stops the program
+             "1 / 0; 2;",
+         }) {
+        expect_same_as_evaluator(source);
+    }
+}
+
+TEST_F(Jit, ControlFlow) {
+    for (const auto* source : {
+             "if (1 < 2) 10; else 20;",
+             "if (1 > 2) 10; else 20;",
+             "if (0) 1; else if (2) { 2; if (3) 4; else 5; } else 6;",
+             "1; if (2 > 1) { 3; }",
+             "if (true) 1 / 0; else 2;",
+             "if (false) 1 / 0; else 2;",
+         }) {
+        expect_same_as_evaluator(source);
+    }
+}
+
+TEST_F(Jit, BenchmarkPrograms) {
+    expect_same_as_evaluator(backend::bench::arithmetic_program(50));
+    expect_same_as_evaluator(backend::bench::branchy_program(50));
+}
+
+TEST_F(Jit, SpillsWhenValuesOutnumberRegisters) {
+    // unoptimised, every constant is live until the innermost subtraction
+    std::string source;
+    std::string closing;
+    for (int i = 1; i <= 40; ++i) {
+        source += std::to_string(i) + " - (";
+        closing += ")";
+    }
+    source += "41" + closing + ";";
+
+    expect_same_as_evaluator(source);
+}
+
+TEST_F(Jit, UnsupportedValues) {
+    for (const auto* source : {
+             "",
+             "1.5 * 2;",
+             "\"a\" + \"b\";",
+             "if (0) 1;",
+             "true + 1;",
+         }) {
+        EXPECT_EQ(run(lower(source, 0)), "unsupported") << source;
+    }
+    // a dead value of another type is dropped
+    EXPECT_EQ(run(lower("if (0) 1; 2;", 0)), "INT: 2");
+}
+
+// The parser has no syntax for unary and logical operators yet.
+TEST_F(Jit, OperatorsWithoutSyntax) {
+    using frontend::ast::BinaryExpression;
+    using frontend::ast::Literal;
+    using frontend::ast::UnaryExpression;
+    using Type = frontend::ast::Operator::Type;
+
+    const auto check = [](std::unique_ptr<frontend::ast::Expression> e) {
+        const frontend::ast::ExpressionStatement statement(std::move(e));
+        const auto expected = evaluate(statement);
+        for (int level = 0; level <= PassManager::MAX_LEVEL; ++level) {
+            auto function = Lowering().lower(statement);
+            PassManager::for_level(level).run(function);
+            EXPECT_EQ(run(function), expected) << statement.to_string();
+        }
+    };
+    const auto integer = [](std::int64_t value) {
+        return std::make_unique<Literal<std::int64_t>>(value);
+    };
+    const auto boolean = [](bool value) {
+        return std::make_unique<Literal<bool>>(value);
+    };
+    const auto division_by_zero = [&]() {
+        return std::make_unique<BinaryExpression>(integer(1), Type::DIVISION,
+                                                  integer(0));
+    };
+
+    for (const auto op :
+         {Type::UNARY_MINUS, Type::UNARY_PLUS, Type::BITWISE_NOT}) {
+        check(std::make_unique<UnaryExpression>(op, integer(5)));
+    }
+    check(std::make_unique<UnaryExpression>(Type::LOGICAL_NOT, integer(0)));
+    check(std::make_unique<UnaryExpression>(Type::LOGICAL_NOT, boolean(true)));
+    for (const auto op : {Type::BITWISE_AND, Type::BITWISE_OR,
+                          Type::BITWISE_XOR}) {
+        check(std::make_unique<BinaryExpression>(integer(12), op,
+                                                 integer(10)));
+    }
+    check(std::make_unique<BinaryExpression>(integer(0), Type::LOGICAL_AND,
+                                             division_by_zero()));
+    check(std::make_unique<BinaryExpression>(integer(2), Type::LOGICAL_OR,
+                                             division_by_zero()));
+    check(std::make_unique<BinaryExpression>(integer(2), Type::LOGICAL_AND,
+                                             integer(3)));
+    check(std::make_unique<BinaryExpression>(boolean(false), Type::LOGICAL_OR,
+                                             integer(0)));
+}
+
+// bb0 branches to bb1 or bb2, both jumping to bb3 whose two phis receive
+// the same values in opposite order, so the edge moves form a cycle.
+TEST_F(Jit, PhisAreAssignedInParallel) {
+    using Operator = frontend::ast::Operator;
+    for (const bool taken : {true, false}) {
+        Function function;
+        const auto entry = function.add_block();
+        const auto left = function.add_block();
+        const auto right = function.add_block();
+        const auto exit = function.add_block();
+        const auto a = function.constant(entry, Value(std::int64_t{1}));
+        const auto b = function.constant(entry, Value(std::int64_t{2}));
+        const auto condition = function.constant(entry, Value(taken));
+        function.branch(entry, condition, left, right);
+        function.jump(left, exit);
+        function.jump(right, exit);
+        const std::array<backend::ir::PhiOperand, 2> first = {
+            {{left, a}, {right, b}}};
+        const std::array<backend::ir::PhiOperand, 2> second = {
+            {{left, b}, {right, a}}};
+        const auto x = function.phi(exit, first);
+        const auto y = function.phi(exit, second);
+        const auto ten = function.constant(exit, Value(std::int64_t{10}));
+        const auto scaled =
+            function.binary(exit, Operator::Type::MULTIPLICATION, x, ten);
+        function.ret(exit, function.binary(exit, Operator::Type::ADDITION,
+                                           scaled, y));
+
+        EXPECT_EQ(run(function), taken ? "INT: 12" : "INT: 21");
+    }
+}
+
+TEST_F(Jit, PerfMap) {
+    const auto compiled = backend::jit::compile(
+        lower("1 + 2;", 0), {.perf_map = true, .symbol = "jit_perf_map_test"});
+    ASSERT_TRUE(compiled);
+
+    std::ifstream map("/tmp/perf-" + std::to_string(::getpid()) + ".map");
+    std::stringstream contents;
+    contents << map.rdbuf();
+    std::ostringstream expected;
+    expected << std::hex << reinterpret_cast<std::uintptr_t>(compiled->code())
+             << ' ' << compiled->code_size() << " jit_perf_map_test\n";
+    EXPECT_NE(contents.str().find(expected.str()), std::string::npos);
+}
+
+} // namespace
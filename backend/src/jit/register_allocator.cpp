@@ -0,0 +1,86 @@
+#include "jit/register_allocator.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace backend::jit {
+
+namespace {
+
+struct Active {
+    std::uint32_t end;
+    std::uint32_t interval;
+};
+
+// Removes the entries of `active` that end before `position` and returns
+// their registers to `free_registers`.
+void expire(std::vector<Active>& active, std::uint32_t position,
+            const std::vector<Location>& locations,
+            std::vector<Register>& free_registers) {
+    std::erase_if(active, [&](const Active& entry) {
+        if (entry.end >= position) {
+            return false;
+        }
+        free_registers.push_back(locations[entry.interval].reg);
+        return true;
+    });
+}
+
+} // namespace
+
+Allocation allocate_registers(std::span<const LiveInterval> intervals,
+                              std::span<const Register> registers) {
+    Allocation allocation;
+    allocation.locations.resize(intervals.size());
+
+    std::vector<std::uint32_t> order(intervals.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::ranges::stable_sort(order, {}, [&](std::uint32_t i) {
+        return intervals[i].start;
+    });
+
+    // popped from the back, so reversed to hand out registers in order
+    std::vector<Register> free_registers(registers.rbegin(), registers.rend());
+    std::vector<Active> active;
+    // end of the last interval given each slot
+    std::vector<std::uint32_t> slot_ends;
+
+    // A spilled interval lives in its slot from start to end, even if it
+    // was in a register until now, so the slot must be free for all of it.
+    const auto new_slot = [&](const LiveInterval& interval) {
+        for (std::uint32_t slot = 0; slot < slot_ends.size(); ++slot) {
+            if (slot_ends[slot] < interval.start) {
+                slot_ends[slot] = interval.end;
+                return slot;
+            }
+        }
+        slot_ends.push_back(interval.end);
+        return allocation.stack_slots++;
+    };
+
+    for (const auto i : order) {
+        const auto& interval = intervals[i];
+        expire(active, interval.start, allocation.locations, free_registers);
+
+        if (!free_registers.empty()) {
+            allocation.locations[i] = {.reg = free_registers.back()};
+            free_registers.pop_back();
+            active.push_back({interval.end, i});
+            continue;
+        }
+
+        // spill whichever of the active intervals and this one ends last
+        const auto last = std::ranges::max_element(active, {}, &Active::end);
+        if (last != active.end() && last->end > interval.end) {
+            allocation.locations[i] = allocation.locations[last->interval];
+            allocation.locations[last->interval] = {
+                .slot = new_slot(intervals[last->interval])};
+            *last = {interval.end, i};
+        } else {
+            allocation.locations[i] = {.slot = new_slot(interval)};
+        }
+    }
+    return allocation;
+}
+
+} // namespace backend::jit
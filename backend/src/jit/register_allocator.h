@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "jit/assembler.h"
+
+namespace backend::jit {
+
+// Positions, inclusive, from the definition of a value to its last use in a
+// linear order of the code.
+struct LiveInterval {
+    std::uint32_t start;
+    std::uint32_t end;
+};
+
+// A register, or a stack slot if every register was taken.
+struct Location {
+    static constexpr std::uint32_t NO_SLOT = static_cast<std::uint32_t>(-1);
+
+    Register reg = Register::RAX;
+    std::uint32_t slot = NO_SLOT;
+
+    bool in_register() const {
+        return slot == NO_SLOT;
+    }
+
+    bool operator==(const Location&) const = default;
+};
+
+struct Allocation {
+    // by interval index
+    std::vector<Location> locations;
+    std::uint32_t stack_slots = 0;
+};
+
+// Linear-scan allocation after Poletto and Sarkar: intervals are visited by
+// start, and when all `registers` are busy the interval ending last is
+// spilled. Intervals that overlap never share a location; a stack slot is
+// reused by intervals starting after its previous one ended.
+Allocation allocate_registers(std::span<const LiveInterval> intervals,
+                              std::span<const Register> registers);
+
+} // namespace backend::jit
@@ -0,0 +1,80 @@
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "jit/register_allocator.h"
+
+namespace {
+
+using backend::jit::allocate_registers;
+using backend::jit::LiveInterval;
+using backend::jit::Location;
+using backend::jit::Register;
+
+constexpr std::array TWO_REGISTERS = {Register::RBX, Register::RSI};
+
+TEST(RegisterAllocator, DisjointIntervalsShareRegisters) {
+    const std::vector<LiveInterval> intervals = {{0, 1}, {2, 3}, {4, 5}};
+    const auto allocation = allocate_registers(intervals, TWO_REGISTERS);
+
+    EXPECT_EQ(allocation.locations,
+              (std::vector<Location>{{.reg = Register::RBX},
+                                     {.reg = Register::RBX},
+                                     {.reg = Register::RBX}}));
+    EXPECT_EQ(allocation.stack_slots, 0);
+}
+
+TEST(RegisterAllocator, IntervalEndingWhereAnotherStartsOverlaps) {
+    const std::vector<LiveInterval> intervals = {{0, 2}, {2, 3}};
+    const auto allocation = allocate_registers(intervals, TWO_REGISTERS);
+
+    EXPECT_NE(allocation.locations[0], allocation.locations[1]);
+}
+
+TEST(RegisterAllocator, SpillsTheIntervalEndingLast) {
+    const std::vector<LiveInterval> intervals = {{0, 10}, {1, 3}, {2, 4}};
+    const auto allocation = allocate_registers(intervals, TWO_REGISTERS);
+
+    EXPECT_EQ(allocation.locations,
+              (std::vector<Location>{{.slot = 0},
+                                     {.reg = Register::RSI},
+                                     {.reg = Register::RBX}}));
+    EXPECT_EQ(allocation.stack_slots, 1);
+}
+
+TEST(RegisterAllocator, ReusesStackSlots) {
+    const std::vector<LiveInterval> intervals = {
+        {0, 2}, {0, 2}, {0, 2}, {3, 5}, {3, 5}, {3, 5}};
+    const auto allocation = allocate_registers(intervals, TWO_REGISTERS);
+
+    EXPECT_EQ(allocation.stack_slots, 1);
+}
+
+TEST(RegisterAllocator, OverlappingIntervalsNeverShareALocation) {
+    std::mt19937 random(7);
+    for (int round = 0; round < 50; ++round) {
+        std::vector<LiveInterval> intervals;
+        for (int i = 0; i < 40; ++i) {
+            const auto start = static_cast<std::uint32_t>(random() % 100);
+            intervals.push_back({start, start + static_cast<std::uint32_t>(
+                                                    random() % 20)});
+        }
+        const auto allocation = allocate_registers(intervals, TWO_REGISTERS);
+
+        for (std::size_t i = 0; i < intervals.size(); ++i) {
+            for (std::size_t j = i + 1; j < intervals.size(); ++j) {
+                const bool overlap = intervals[i].start <= intervals[j].end &&
+                                     intervals[j].start <= intervals[i].end;
+                if (overlap) {
+                    EXPECT_NE(allocation.locations[i],
+                              allocation.locations[j]);
+                }
+            }
+        }
+    }
+}
+
+} // namespace
@@ -0,0 +1,220 @@
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "aot/object_file.h"
+#include "ast/interner.h"
+#include "ir/execute.h"
+#include "ir/lowering.h"
+#include "jit/jit.h"
+#include "optimizer/pass.h"
+#include "parser.h"
+#include "resolver.h"
+#include "scanner.h"
+#include "string_pool.h"
+#include "trace.h"
+
+namespace {
+
+void print_usage() {
+    std::cerr << "Usage: compiler-backend-driver [-O0 | -O1 | -O2] "
+                 "[--ir | --run | --jit | --emit-obj [-o OUTPUT]]\n"
+                 "                              [--pass-stats] [--hash-cons] "
+                 "[--trace TRACE]\n"
+                 "                              [FILE...]\n"
+                 "\n"
+                 "Lowers each program to IR and optimises it at the given "
+                 "level (default -O1),\nthen prints the IR or runs it and "
+                 "prints the result. --jit runs it as native\ncode, listed "
+                 "in /tmp/perf-<pid>.map for perf, when the program only "
+                 "uses\nintegers and booleans, and interprets it otherwise. "
+                 "--emit-obj writes an ELF\nobject defining main() for such "
+                 "programs, to OUTPUT or FILE with a .o suffix\nin the "
+                 "current directory; link it with `cc -o program FILE.o`.\n"
+                 "--pass-stats reports per-pass timing and removed "
+                 "instructions on stderr.\n--hash-cons shares identical "
+                 "subexpressions across all files and reports\nthe "
+                 "expression node count before and after on stderr.\n"
+                 "--trace writes a Chrome trace of every phase and pass to "
+                 "TRACE, which Perfetto\nand chrome://tracing load.\n"
+                 "Without files the source is read "
+                 "from stdin.\n";
+}
+
+std::string read_source(const std::string& path) {
+    std::ostringstream contents;
+    if (path == "-") {
+        contents << std::cin.rdbuf();
+        return contents.str();
+    }
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+void write_file(const std::string& path,
+                const std::vector<std::uint8_t>& bytes) {
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(bytes.data()),
+               static_cast<std::streamsize>(bytes.size()));
+    if (!file) {
+        throw std::runtime_error("Cannot write " + path);
+    }
+}
+
+// FILE.o in the current directory, a.o for stdin.
+std::string object_path(const std::string& file) {
+    if (file == "-") {
+        return "a.o";
+    }
+    return std::filesystem::path(file)
+        .filename()
+        .replace_extension(".o")
+        .string();
+}
+
+enum class Mode {
+    IR,
+    RUN,
+    JIT,
+    OBJECT,
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int level = 1;
+    auto mode = Mode::IR;
+    std::string output;
+    bool pass_statistics = false;
+    std::string trace_path;
+    // string literals are deduplicated across all files
+    frontend::ParserOptions parser_options{
+        .strings = std::make_shared<frontend::StringPool>()};
+    std::vector<std::string> files;
+
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        const auto arg = args[i];
+        if (arg.size() == 3 && arg.starts_with("-O") && arg[2] >= '0' &&
+            arg[2] <= '0' + backend::optimizer::PassManager::MAX_LEVEL) {
+            level = arg[2] - '0';
+        } else if (arg == "--ir") {
+            mode = Mode::IR;
+        } else if (arg == "--run") {
+            mode = Mode::RUN;
+        } else if (arg == "--jit") {
+            mode = Mode::JIT;
+        } else if (arg == "--emit-obj") {
+            mode = Mode::OBJECT;
+        } else if (arg == "-o" && i + 1 < args.size()) {
+            output = args[++i];
+        } else if (arg == "--pass-stats") {
+            pass_statistics = true;
+        } else if (arg == "--trace" && i + 1 < args.size()) {
+            trace_path = args[++i];
+        } else if (arg == "--hash-cons") {
+            parser_options.interner =
+                std::make_shared<frontend::ast::ExpressionInterner>(
+                    parser_options.strings);
+        } else if (arg == "--help" || (arg.starts_with("-") && arg != "-")) {
+            print_usage();
+            return arg == "--help" ? 0 : 2;
+        } else {
+            files.emplace_back(arg);
+        }
+    }
+    if (files.empty()) {
+        files.emplace_back("-");
+    }
+    if (!output.empty() && (mode != Mode::OBJECT || files.size() > 1)) {
+        print_usage();
+        return 2;
+    }
+
+    const auto passes = backend::optimizer::PassManager::for_level(level);
+    frontend::Resolver resolver;
+    if (!trace_path.empty()) {
+        frontend::trace::start();
+    }
+    int status = 0;
+    for (const auto& file : files) {
+        frontend::trace::FileScope file_scope(file);
+        frontend::trace::Span span("file", "driver");
+        try {
+            auto tokens =
+                frontend::Scanner(read_source(file),
+                                  {.strings = parser_options.strings.get()})
+                    .scan_tokens();
+            const auto tree =
+                frontend::Parser(std::move(tokens), parser_options).parse();
+            resolver.resolve(tree);
+            auto function = backend::ir::Lowering().lower(tree);
+            const auto statistics = passes.run(function);
+            if (pass_statistics) {
+                std::cerr << file << ":\n"
+                          << backend::optimizer::format_statistics(statistics);
+            }
+
+            if (mode == Mode::OBJECT) {
+                frontend::trace::Span object_span("emit-obj", "backend");
+                const auto object = backend::aot::compile_object(function);
+                if (!object) {
+                    throw std::runtime_error(
+                        "Native code supports only integers and booleans");
+                }
+                write_file(output.empty() ? object_path(file) : output,
+                           *object);
+                continue;
+            }
+
+            frontend::trace::Span run_span(
+                mode == Mode::IR ? "output" : "run", "backend");
+            const auto compiled =
+                mode == Mode::JIT
+                    ? backend::jit::compile(function, {.perf_map = true,
+                                                       .symbol = "jit:" + file})
+                    : std::nullopt;
+            if (compiled) {
+                std::cout << compiled->run().to_string() << '\n';
+            } else if (mode != Mode::IR) {
+                backend::StringHeap strings;
+                std::cout << backend::ir::execute(function, strings).to_string()
+                          << '\n';
+            } else {
+                std::cout << dump(function);
+            }
+        } catch (const std::exception& error) {
+            std::cerr << file << ": " << error.what() << '\n';
+            status = 1;
+        }
+    }
+    if (!trace_path.empty()) {
+        frontend::trace::stop();
+        try {
+            frontend::trace::write_chrome_json(trace_path);
+        } catch (const std::exception& error) {
+            std::cerr << error.what() << '\n';
+            status = 1;
+        }
+    }
+    if (const auto& interner = parser_options.interner; interner != nullptr) {
+        std::cerr << "expression nodes: " << interner->requested()
+                  << " parsed, " << interner->created()
+                  << " after hash-consing\n";
+    }
+    return status;
+}
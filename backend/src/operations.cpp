@@ -0,0 +1,200 @@
+#include "operations.h"
+
+#include <cmath>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace backend {
+
+namespace {
+
+using Operator = frontend::ast::Operator;
+
+[[noreturn]] void unsupported(Operator::Type op, const Value& left,
+                              const Value& right) {
+    throw EvaluationError(
+        std::vformat("Unsupported operand types for {}: {} and {}",
+                     std::make_format_args(op, left.type(), right.type())));
+}
+
+// Two's complement wrap-around instead of signed overflow.
+std::int64_t wrap(std::uint64_t value) {
+    return static_cast<std::int64_t>(value);
+}
+
+std::uint64_t bits(std::int64_t value) {
+    return static_cast<std::uint64_t>(value);
+}
+
+} // namespace
+
+Value apply_int(Operator::Type op, std::int64_t left, std::int64_t right) {
+    constexpr auto MIN = std::numeric_limits<std::int64_t>::min();
+    switch (op) {
+        case Operator::Type::ADDITION:
+            return wrap(bits(left) + bits(right));
+        case Operator::Type::SUBTRACTION:
+            return wrap(bits(left) - bits(right));
+        case Operator::Type::MULTIPLICATION:
+            return wrap(bits(left) * bits(right));
+        case Operator::Type::DIVISION:
+            if (right == 0) {
+                throw EvaluationError("Division by zero");
+            }
+            return left == MIN && right == -1 ? MIN : left / right;
+        case Operator::Type::REMAINDER:
+            if (right == 0) {
+                throw EvaluationError("Division by zero");
+            }
+            return left == MIN && right == -1 ? 0 : left % right;
+        case Operator::Type::BITWISE_AND:
+            return left & right;
+        case Operator::Type::BITWISE_OR:
+            return left | right;
+        case Operator::Type::BITWISE_XOR:
+            return left ^ right;
+        case Operator::Type::BITWISE_LEFT_SHIFT:
+        case Operator::Type::BITWISE_RIGHT_SHIFT:
+            if (right < 0 || right > 63) {
+                throw EvaluationError(std::vformat(
+                    "Shift count out of range: {}", std::make_format_args(right)));
+            }
+            return op == Operator::Type::BITWISE_LEFT_SHIFT
+                       ? wrap(bits(left) << right)
+                       : left >> right;
+        case Operator::Type::LOGICAL_AND:
+            return left != 0 && right != 0;
+        case Operator::Type::LOGICAL_OR:
+            return left != 0 || right != 0;
+        case Operator::Type::EQUAL_TO:
+            return left == right;
+        case Operator::Type::NOT_EQUAL_TO:
+            return left != right;
+        case Operator::Type::LESS_THAN:
+            return left < right;
+        case Operator::Type::LESS_THAN_OR_EQUAL_TO:
+            return left <= right;
+        case Operator::Type::GREATER_THAN:
+            return left > right;
+        case Operator::Type::GREATER_THAN_OR_EQUAL_TO:
+            return left >= right;
+        default:
+            unsupported(op, Value(left), Value(right));
+    }
+}
+
+Value apply_binary(Operator::Type op, const Value& left, const Value& right,
+                   StringHeap& strings) {
+    if (left.type() == Value::Type::INT && right.type() == Value::Type::INT) {
+        return apply_int(op, left.as_int(), right.as_int());
+    }
+
+    const bool numbers = left.is_number() && right.is_number();
+    const bool strings_only = left.type() == Value::Type::STRING &&
+                              right.type() == Value::Type::STRING;
+    switch (op) {
+        case Operator::Type::ADDITION:
+            if (strings_only) {
+                std::string concatenated(left.as_string());
+                concatenated += right.as_string();
+                return strings.store(std::move(concatenated));
+            }
+            if (numbers) {
+                return left.as_number() + right.as_number();
+            }
+            break;
+        case Operator::Type::SUBTRACTION:
+            if (numbers) {
+                return left.as_number() - right.as_number();
+            }
+            break;
+        case Operator::Type::MULTIPLICATION:
+            if (numbers) {
+                return left.as_number() * right.as_number();
+            }
+            break;
+        case Operator::Type::DIVISION:
+            if (numbers) {
+                return left.as_number() / right.as_number();
+            }
+            break;
+        case Operator::Type::REMAINDER:
+            if (numbers) {
+                return std::fmod(left.as_number(), right.as_number());
+            }
+            break;
+        case Operator::Type::LOGICAL_AND:
+            return left.is_truthy() && right.is_truthy();
+        case Operator::Type::LOGICAL_OR:
+            return left.is_truthy() || right.is_truthy();
+        case Operator::Type::EQUAL_TO:
+            return left == right;
+        case Operator::Type::NOT_EQUAL_TO:
+            return !(left == right);
+        case Operator::Type::LESS_THAN:
+        case Operator::Type::LESS_THAN_OR_EQUAL_TO:
+        case Operator::Type::GREATER_THAN:
+        case Operator::Type::GREATER_THAN_OR_EQUAL_TO: {
+            int order = 0;
+            if (numbers) {
+                const auto l = left.as_number();
+                const auto r = right.as_number();
+                // NaN compares false to everything
+                if (std::isnan(l) || std::isnan(r)) {
+                    return false;
+                }
+                order = l < r ? -1 : (l > r ? 1 : 0);
+            } else if (strings_only) {
+                order = left.as_string().compare(right.as_string());
+            } else {
+                break;
+            }
+            switch (op) {
+                case Operator::Type::LESS_THAN:
+                    return order < 0;
+                case Operator::Type::LESS_THAN_OR_EQUAL_TO:
+                    return order <= 0;
+                case Operator::Type::GREATER_THAN:
+                    return order > 0;
+                default:
+                    return order >= 0;
+            }
+        }
+        default:
+            break;
+    }
+    unsupported(op, left, right);
+}
+
+Value apply_unary(Operator::Type op, const Value& operand) {
+    switch (op) {
+        case Operator::Type::UNARY_PLUS:
+            if (operand.is_number()) {
+                return operand;
+            }
+            break;
+        case Operator::Type::UNARY_MINUS:
+            if (operand.type() == Value::Type::INT) {
+                return wrap(0 - bits(operand.as_int()));
+            }
+            if (operand.type() == Value::Type::DOUBLE) {
+                return -operand.as_double();
+            }
+            break;
+        case Operator::Type::BITWISE_NOT:
+            if (operand.type() == Value::Type::INT) {
+                return ~operand.as_int();
+            }
+            break;
+        case Operator::Type::LOGICAL_NOT:
+            return !operand.is_truthy();
+        default:
+            break;
+    }
+    unsupported(op, operand, Value());
+}
+
+} // namespace backend
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "ast/operator.h"
+#include "value.h"
+
+namespace backend {
+
+// Semantics of the operators, shared by every execution engine and by
+// constant folding so that they all agree. Strings created by `+` are stored
+// in `strings`. Throw an EvaluationError for unsupported operand types,
+// division by zero and shift counts outside [0, 63].
+Value apply_binary(frontend::ast::Operator::Type op, const Value& left,
+                   const Value& right, StringHeap& strings);
+Value apply_unary(frontend::ast::Operator::Type op, const Value& operand);
+
+// Integer-only fast path of apply_binary().
+Value apply_int(frontend::ast::Operator::Type op, std::int64_t left,
+                std::int64_t right);
+
+} // namespace backend
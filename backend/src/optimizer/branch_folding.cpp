@@ -0,0 +1,162 @@
+#include "optimizer/branch_folding.h"
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace backend::optimizer {
+
+namespace {
+
+using ir::BlockId;
+using ir::Opcode;
+using ir::ValueId;
+
+void remove_predecessor(ir::Function& function, BlockId block,
+                        BlockId predecessor) {
+    auto& predecessors = function.blocks()[block].predecessors;
+    predecessors.erase(
+        std::find(predecessors.begin(), predecessors.end(), predecessor));
+    for (const auto id : function.blocks()[block].instructions) {
+        if (function.instruction(id).opcode != Opcode::PHI) {
+            break;
+        }
+        function.remove_phi_operand(id, predecessor);
+    }
+}
+
+std::size_t fold_branches(ir::Function& function) {
+    std::size_t folded = 0;
+    for (BlockId b = 0; b < function.blocks().size(); ++b) {
+        auto& terminator =
+            function.instruction(function.blocks()[b].instructions.back());
+        if (terminator.opcode != Opcode::BRANCH) {
+            continue;
+        }
+        const auto& condition = function.instruction(terminator.operands[0]);
+        BlockId taken = 0;
+        if (terminator.operands[1] == terminator.operands[2]) {
+            taken = terminator.operands[1];
+        } else if (condition.opcode == Opcode::CONSTANT) {
+            taken = function.constants()[condition.operands[0]].is_truthy()
+                        ? terminator.operands[1]
+                        : terminator.operands[2];
+        } else {
+            continue;
+        }
+        const auto not_taken = terminator.operands[1] == taken
+                                   ? terminator.operands[2]
+                                   : terminator.operands[1];
+        terminator.opcode = Opcode::JUMP;
+        terminator.operands = {taken, 0, 0};
+        remove_predecessor(function, not_taken, b);
+        ++folded;
+    }
+    return folded;
+}
+
+// Replaces phis whose incoming values are all the same, until none is left.
+void remove_trivial_phis(ir::Function& function) {
+    std::vector<ValueId> replacement(function.instruction_count());
+    for (bool changed = true; changed;) {
+        changed = false;
+        std::iota(replacement.begin(), replacement.end(), ValueId{0});
+        for (auto& block : function.blocks()) {
+            std::erase_if(block.instructions, [&](ValueId id) {
+                const auto& phi = function.instruction(id);
+                if (phi.opcode != Opcode::PHI) {
+                    return false;
+                }
+                const auto incoming = function.phi_operands(phi);
+                const auto first = incoming.front().value;
+                if (!std::all_of(incoming.begin(), incoming.end(),
+                                 [&](const auto& operand) {
+                                     return operand.value == first;
+                                 })) {
+                    return false;
+                }
+                replacement[id] = first;
+                changed = true;
+                return true;
+            });
+        }
+        if (changed) {
+            // a replaced phi may feed another
+            for (auto& value : replacement) {
+                while (replacement[value] != value) {
+                    value = replacement[value];
+                }
+            }
+            function.replace_uses(replacement);
+        }
+    }
+}
+
+std::size_t merge_blocks(ir::Function& function) {
+    std::size_t merged = 0;
+    for (BlockId b = 0; b < function.blocks().size(); ++b) {
+        for (;;) {
+            auto& instructions = function.blocks()[b].instructions;
+            // blocks absorbed earlier are empty until removed
+            if (instructions.empty()) {
+                break;
+            }
+            const auto& terminator = function.instruction(instructions.back());
+            if (terminator.opcode != Opcode::JUMP) {
+                break;
+            }
+            const auto target = terminator.operands[0];
+            if (target == b ||
+                function.blocks()[target].predecessors.size() != 1) {
+                break;
+            }
+
+            // trivial phis are gone, so the target starts with a non-phi
+            auto moved = std::move(function.blocks()[target].instructions);
+            function.blocks()[target].instructions.clear();
+            function.blocks()[target].predecessors.clear();
+            instructions.pop_back();
+            for (const auto id : moved) {
+                function.instruction(id).block = b;
+            }
+            instructions.insert(instructions.end(), moved.begin(),
+                                moved.end());
+
+            for (const auto successor : function.successors(b)) {
+                for (auto& predecessor :
+                     function.blocks()[successor].predecessors) {
+                    if (predecessor == target) {
+                        predecessor = b;
+                    }
+                }
+                for (const auto id :
+                     function.blocks()[successor].instructions) {
+                    auto& phi = function.instruction(id);
+                    if (phi.opcode != Opcode::PHI) {
+                        break;
+                    }
+                    for (auto& incoming : function.phi_operands(phi)) {
+                        if (incoming.block == target) {
+                            incoming.block = b;
+                        }
+                    }
+                }
+            }
+            ++merged;
+        }
+    }
+    return merged;
+}
+
+} // namespace
+
+std::size_t BranchFolding::run(ir::Function& function) {
+    const auto folded = fold_branches(function);
+    function.remove_unreachable_blocks();
+    remove_trivial_phis(function);
+    const auto merged = merge_blocks(function);
+    function.remove_unreachable_blocks();
+    return folded + merged;
+}
+
+} // namespace backend::optimizer
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "optimizer/pass.h"
+
+namespace backend::optimizer {
+
+// Simplifies the control flow graph:
+//
+// - a BRANCH on a CONSTANT, or to the same block twice, becomes a JUMP,
+// - blocks no longer reachable are deleted,
+// - phis whose incoming values are all the same are replaced by that value,
+// - a block jumping to a block with no other predecessor absorbs it.
+class BranchFolding final : public Pass {
+public:
+    std::string_view name() const override {
+        return "branch-folding";
+    }
+
+    std::size_t run(ir::Function& function) override;
+};
+
+} // namespace backend::optimizer
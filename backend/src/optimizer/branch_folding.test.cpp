@@ -0,0 +1,75 @@
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "ir/lowering.h"
+#include "ir/verifier.h"
+#include "optimizer/branch_folding.h"
+#include "optimizer/dce.h"
+#include "optimizer/sccp.h"
+#include "parser.h"
+#include "scanner.h"
+
+namespace {
+
+using backend::Value;
+using backend::ir::Function;
+using backend::optimizer::BranchFolding;
+
+Function lower(const std::string& source) {
+    return backend::ir::Lowering().lower(
+        frontend::Parser(frontend::Scanner(source).scan_tokens()).parse());
+}
+
+TEST(BranchFolding, FoldsConstantConditionsAndMergesBlocks) {
+    auto function = lower("if (0) 2; else 3;");
+    const auto changed = BranchFolding().run(function);
+    backend::ir::verify(function);
+
+    // one branch folded, two blocks merged
+    EXPECT_EQ(changed, 3);
+    EXPECT_EQ(dump(function), "bb0:\n"
+                              "  %0 = const none\n"
+                              "  %1 = const 0\n"
+                              "  %5 = const 3\n"
+                              "  return %5\n");
+}
+
+TEST(BranchFolding, AfterSccp) {
+    auto function = lower("if (1 < 2) { if (3 > 4) 5; else 6; } else 7;");
+    backend::optimizer::Sccp().run(function);
+    BranchFolding().run(function);
+    backend::optimizer::DeadCodeElimination().run(function);
+    backend::ir::verify(function);
+
+    EXPECT_EQ(function.blocks().size(), 1);
+    EXPECT_EQ(function.live_instruction_count(), 2);
+    EXPECT_NE(dump(function).find("const 6"), std::string::npos);
+}
+
+TEST(BranchFolding, KeepsBranchesOnUnknownConditions) {
+    auto function = lower("if (1 / 0) 2; else 3;");
+    EXPECT_EQ(BranchFolding().run(function), 0);
+    backend::ir::verify(function);
+
+    EXPECT_EQ(function.blocks().size(), 4);
+}
+
+TEST(BranchFolding, BranchToTheSameBlockTwice) {
+    Function function;
+    const auto entry = function.add_block();
+    const auto next = function.add_block();
+    const auto condition =
+        function.binary(entry, frontend::ast::Operator::Type::DIVISION,
+                        function.constant(entry, Value(std::int64_t{1})),
+                        function.constant(entry, Value(std::int64_t{0})));
+    function.branch(entry, condition, next, next);
+    function.ret(next, condition);
+    backend::ir::verify(function);
+
+    EXPECT_EQ(BranchFolding().run(function), 2);
+    backend::ir::verify(function);
+    EXPECT_EQ(function.blocks().size(), 1);
+}
+
+} // namespace
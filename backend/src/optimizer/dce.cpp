@@ -0,0 +1,225 @@
+#include "optimizer/dce.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "ir/dominators.h"
+
+namespace backend::optimizer {
+
+namespace {
+
+using ir::Opcode;
+using ir::ValueId;
+using Operator = frontend::ast::Operator;
+
+// Set of the Value::Types a value may have at runtime.
+using Types = std::uint8_t;
+
+constexpr Types type_bit(Value::Type type) {
+    return static_cast<Types>(1u << static_cast<unsigned>(type));
+}
+
+constexpr Types INT = type_bit(Value::Type::INT);
+constexpr Types DOUBLE = type_bit(Value::Type::DOUBLE);
+constexpr Types BOOL = type_bit(Value::Type::BOOL);
+constexpr Types STRING = type_bit(Value::Type::STRING);
+constexpr Types NUMBER = INT | DOUBLE;
+constexpr Types ANY = 0x1f;
+
+constexpr bool within(Types types, Types allowed) {
+    return (types & ~allowed) == 0;
+}
+
+bool is_comparison(Operator::Type op) {
+    switch (op) {
+        case Operator::Type::EQUAL_TO:
+        case Operator::Type::NOT_EQUAL_TO:
+        case Operator::Type::LESS_THAN:
+        case Operator::Type::LESS_THAN_OR_EQUAL_TO:
+        case Operator::Type::GREATER_THAN:
+        case Operator::Type::GREATER_THAN_OR_EQUAL_TO:
+        case Operator::Type::LOGICAL_AND:
+        case Operator::Type::LOGICAL_OR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+class Analysis {
+public:
+    explicit Analysis(const ir::Function& function)
+        : function_(function), types_(function.instruction_count(), ANY) {
+        // without loops, operands come earlier in reverse postorder
+        const ir::DominatorTree dominators(function);
+        for (const auto block : dominators.reverse_postorder()) {
+            for (const auto id : function.blocks()[block].instructions) {
+                types_[id] = infer(function.instruction(id));
+            }
+        }
+    }
+
+    bool may_throw(const ir::Instruction& instruction) const {
+        const auto& operands = instruction.operands;
+        switch (instruction.opcode) {
+            case Opcode::UNARY: {
+                const auto operand = types_[operands[0]];
+                switch (instruction.op) {
+                    case Operator::Type::LOGICAL_NOT:
+                        return false;
+                    case Operator::Type::BITWISE_NOT:
+                        return !within(operand, INT);
+                    default:
+                        return !within(operand, NUMBER);
+                }
+            }
+            case Opcode::BINARY:
+                return binary_may_throw(instruction);
+            default:
+                return false;
+        }
+    }
+
+private:
+    Types infer(const ir::Instruction& instruction) const {
+        const auto& operands = instruction.operands;
+        switch (instruction.opcode) {
+            case Opcode::CONSTANT:
+                return type_bit(function_.constants()[operands[0]].type());
+            case Opcode::TO_BOOL:
+                return BOOL;
+            case Opcode::PHI: {
+                Types types = 0;
+                for (const auto& incoming :
+                     function_.phi_operands(instruction)) {
+                    types |= types_[incoming.value];
+                }
+                return types;
+            }
+            case Opcode::UNARY:
+                switch (instruction.op) {
+                    case Operator::Type::LOGICAL_NOT:
+                        return BOOL;
+                    case Operator::Type::BITWISE_NOT:
+                        return INT;
+                    default:
+                        return types_[operands[0]] & NUMBER;
+                }
+            case Opcode::BINARY: {
+                if (is_comparison(instruction.op)) {
+                    return BOOL;
+                }
+                const auto left = types_[operands[0]];
+                const auto right = types_[operands[1]];
+                if (within(left, INT) && within(right, INT)) {
+                    return INT;
+                }
+                if (within(left, NUMBER) && within(right, NUMBER)) {
+                    return NUMBER;
+                }
+                return ANY;
+            }
+            default:
+                return ANY;
+        }
+    }
+
+    // The value of `id` if it is a CONSTANT.
+    const Value* constant(ValueId id) const {
+        const auto& instruction = function_.instruction(id);
+        return instruction.opcode == Opcode::CONSTANT
+                   ? &function_.constants()[instruction.operands[0]]
+                   : nullptr;
+    }
+
+    bool binary_may_throw(const ir::Instruction& instruction) const {
+        const auto left = types_[instruction.operands[0]];
+        const auto right = types_[instruction.operands[1]];
+        const auto* divisor = constant(instruction.operands[1]);
+        switch (instruction.op) {
+            case Operator::Type::EQUAL_TO:
+            case Operator::Type::NOT_EQUAL_TO:
+            case Operator::Type::LOGICAL_AND:
+            case Operator::Type::LOGICAL_OR:
+                return false;
+            case Operator::Type::ADDITION:
+                return !(within(left, NUMBER) && within(right, NUMBER)) &&
+                       !(within(left, STRING) && within(right, STRING));
+            case Operator::Type::SUBTRACTION:
+            case Operator::Type::MULTIPLICATION:
+                return !(within(left, NUMBER) && within(right, NUMBER));
+            case Operator::Type::DIVISION:
+            case Operator::Type::REMAINDER:
+                // integer division by zero throws, floating point does not
+                return !(within(left, NUMBER) && within(right, NUMBER)) ||
+                       ((right & INT) != 0 &&
+                        (divisor == nullptr || divisor->as_int() == 0));
+            case Operator::Type::LESS_THAN:
+            case Operator::Type::LESS_THAN_OR_EQUAL_TO:
+            case Operator::Type::GREATER_THAN:
+            case Operator::Type::GREATER_THAN_OR_EQUAL_TO:
+                return !(within(left, NUMBER) && within(right, NUMBER)) &&
+                       !(within(left, STRING) && within(right, STRING));
+            case Operator::Type::BITWISE_AND:
+            case Operator::Type::BITWISE_OR:
+            case Operator::Type::BITWISE_XOR:
+                return !(within(left, INT) && within(right, INT));
+            case Operator::Type::BITWISE_LEFT_SHIFT:
+            case Operator::Type::BITWISE_RIGHT_SHIFT:
+                return !(within(left, INT) && within(right, INT)) ||
+                       divisor == nullptr || divisor->as_int() < 0 ||
+                       divisor->as_int() > 63;
+            default:
+                return true;
+        }
+    }
+
+    const ir::Function& function_;
+    std::vector<Types> types_;
+};
+
+} // namespace
+
+std::size_t DeadCodeElimination::run(ir::Function& function) {
+    const Analysis analysis(function);
+    std::vector<bool> live(function.instruction_count());
+    std::vector<ValueId> worklist;
+    const auto mark = [&](ValueId id) {
+        if (!live[id]) {
+            live[id] = true;
+            worklist.push_back(id);
+        }
+    };
+
+    for (const auto& block : function.blocks()) {
+        for (const auto id : block.instructions) {
+            const auto& instruction = function.instruction(id);
+            if (instruction.is_terminator() ||
+                analysis.may_throw(instruction)) {
+                mark(id);
+            }
+        }
+    }
+    while (!worklist.empty()) {
+        const auto& instruction = function.instruction(worklist.back());
+        worklist.pop_back();
+        if (instruction.opcode == Opcode::PHI) {
+            for (const auto& incoming : function.phi_operands(instruction)) {
+                mark(incoming.value);
+            }
+        }
+        for (std::size_t i = 0; i < instruction.value_operand_count(); ++i) {
+            mark(instruction.operands[i]);
+        }
+    }
+
+    for (auto& block : function.blocks()) {
+        std::erase_if(block.instructions,
+                      [&](ValueId id) { return !live[id]; });
+    }
+    // removals are counted by the pass manager
+    return 0;
+}
+
+} // namespace backend::optimizer
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "optimizer/pass.h"
+
+namespace backend::optimizer {
+
+// Dead-code elimination: removes instructions whose values are never used,
+// directly or indirectly, by a terminator. Instructions that might raise an
+// EvaluationError stay, since the error is observable; a small type
+// inference over the SSA graph proves most integer and floating point
+// arithmetic safe to remove.
+class DeadCodeElimination final : public Pass {
+public:
+    std::string_view name() const override {
+        return "dce";
+    }
+
+    std::size_t run(ir::Function& function) override;
+};
+
+} // namespace backend::optimizer
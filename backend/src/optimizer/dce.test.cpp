@@ -0,0 +1,57 @@
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "ir/lowering.h"
+#include "ir/verifier.h"
+#include "optimizer/dce.h"
+#include "parser.h"
+#include "scanner.h"
+
+namespace {
+
+using backend::optimizer::DeadCodeElimination;
+
+std::string eliminate(const std::string& source) {
+    auto function = backend::ir::Lowering().lower(
+        frontend::Parser(frontend::Scanner(source).scan_tokens()).parse());
+    DeadCodeElimination().run(function);
+    backend::ir::verify(function);
+    return dump(function);
+}
+
+TEST(DeadCodeElimination, RemovesUnusedValues) {
+    EXPECT_EQ(eliminate("1 + 2; 3;"), "bb0:\n"
+                                      "  %4 = const 3\n"
+                                      "  return %4\n");
+}
+
+TEST(DeadCodeElimination, RemovesArithmeticThatCannotThrow) {
+    const auto text = eliminate(
+        "(1 + 2.5) * 3 / 4 % 5; 7 << 1 >> 2; 1 < 2.0; 1 == \"a\"; 3;");
+
+    EXPECT_EQ(text.find("binary"), std::string::npos);
+}
+
+TEST(DeadCodeElimination, KeepsOperationsThatMayThrow) {
+    for (const auto* source : {
+             "1 / 0; 3;",
+             "1 % 0; 3;",
+             "1 << 64; 3;",
+             "\"a\" - 1; 3;",
+             "\"a\" < 1; 3;",
+         }) {
+        EXPECT_NE(eliminate(source).find("binary"), std::string::npos)
+            << source;
+    }
+}
+
+TEST(DeadCodeElimination, KeepsWhatTheResultNeeds) {
+    const auto text = eliminate("if (1) 2; else 3;");
+
+    EXPECT_NE(text.find("phi"), std::string::npos);
+    EXPECT_NE(text.find("const 2"), std::string::npos);
+    EXPECT_EQ(text.find("const none"), std::string::npos);
+}
+
+} // namespace
@@ -0,0 +1,169 @@
+#include "optimizer/gvn.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "ir/dominators.h"
+
+namespace backend::optimizer {
+
+namespace {
+
+using ir::Opcode;
+using ir::ValueId;
+
+// What an instruction computes; phis are keyed by their block and incoming
+// values in `words` and `phi`.
+struct Key {
+    Opcode opcode;
+    frontend::ast::Operator::Type op;
+    std::array<std::uint64_t, 3> words;
+    std::string_view text;
+    std::vector<ir::PhiOperand> phi;
+
+    bool operator==(const Key& other) const {
+        return opcode == other.opcode && op == other.op &&
+               words == other.words && text == other.text &&
+               std::equal(phi.begin(), phi.end(), other.phi.begin(),
+                          other.phi.end(), [](const auto& a, const auto& b) {
+                              return a.block == b.block && a.value == b.value;
+                          });
+    }
+};
+
+struct KeyHash {
+    std::size_t operator()(const Key& key) const {
+        auto hash = std::hash<std::uint64_t>()(
+            static_cast<std::uint64_t>(key.opcode) << 8 |
+            static_cast<std::uint64_t>(key.op));
+        const auto combine = [&](std::uint64_t word) {
+            hash ^= std::hash<std::uint64_t>()(word) + 0x9e3779b97f4a7c15 +
+                    (hash << 6) + (hash >> 2);
+        };
+        for (const auto word : key.words) {
+            combine(word);
+        }
+        combine(std::hash<std::string_view>()(key.text));
+        for (const auto& incoming : key.phi) {
+            combine(std::uint64_t{incoming.block} << 32 | incoming.value);
+        }
+        return hash;
+    }
+};
+
+// Operators whose result and errors do not depend on the operand order.
+bool is_commutative(frontend::ast::Operator::Type op) {
+    return op == frontend::ast::Operator::Type::EQUAL_TO ||
+           op == frontend::ast::Operator::Type::NOT_EQUAL_TO;
+}
+
+Key key_of(const ir::Function& function, const ir::Instruction& instruction) {
+    Key key{instruction.opcode, {}, {}, {}, {}};
+    switch (instruction.opcode) {
+        case Opcode::CONSTANT: {
+            const auto& value = function.constants()[instruction.operands[0]];
+            key.words[0] = static_cast<std::uint64_t>(value.type());
+            switch (value.type()) {
+                case Value::Type::BOOL:
+                    key.words[1] = value.as_bool();
+                    break;
+                case Value::Type::INT:
+                    key.words[1] = static_cast<std::uint64_t>(value.as_int());
+                    break;
+                case Value::Type::DOUBLE:
+                    key.words[1] =
+                        std::bit_cast<std::uint64_t>(value.as_double());
+                    break;
+                case Value::Type::STRING:
+                    key.text = value.as_string();
+                    break;
+                case Value::Type::NONE:
+                    break;
+            }
+            break;
+        }
+        case Opcode::PHI: {
+            key.words[0] = instruction.block;
+            const auto incoming = function.phi_operands(instruction);
+            key.phi.assign(incoming.begin(), incoming.end());
+            std::sort(key.phi.begin(), key.phi.end(),
+                      [](const auto& a, const auto& b) {
+                          return a.block < b.block;
+                      });
+            break;
+        }
+        default:
+            key.op = instruction.op;
+            for (std::size_t i = 0; i < instruction.value_operand_count();
+                 ++i) {
+                key.words[i] = instruction.operands[i];
+            }
+            if (instruction.opcode == Opcode::BINARY &&
+                is_commutative(instruction.op) &&
+                key.words[0] > key.words[1]) {
+                std::swap(key.words[0], key.words[1]);
+            }
+            break;
+    }
+    return key;
+}
+
+} // namespace
+
+std::size_t GlobalValueNumbering::run(ir::Function& function) {
+    const ir::DominatorTree dominators(function);
+    std::vector<ValueId> replacement(function.instruction_count());
+    std::iota(replacement.begin(), replacement.end(), ValueId{0});
+    std::unordered_map<Key, std::vector<ValueId>, KeyHash> available;
+    std::size_t removed = 0;
+
+    // dominators first, so operands are already numbered
+    for (const auto block : dominators.reverse_postorder()) {
+        std::erase_if(
+            function.blocks()[block].instructions, [&](ValueId id) {
+                auto& instruction = function.instruction(id);
+                if (instruction.is_terminator()) {
+                    return false;
+                }
+                if (instruction.opcode == Opcode::PHI) {
+                    for (auto& incoming : function.phi_operands(instruction)) {
+                        incoming.value = replacement[incoming.value];
+                    }
+                } else {
+                    for (std::size_t i = 0;
+                         i < instruction.value_operand_count(); ++i) {
+                        instruction.operands[i] =
+                            replacement[instruction.operands[i]];
+                    }
+                }
+
+                auto& candidates = available[key_of(function, instruction)];
+                for (const auto candidate : candidates) {
+                    // earlier in the same block, or in a dominating one
+                    if (dominators.dominates(
+                            function.instruction(candidate).block, block)) {
+                        replacement[id] = candidate;
+                        ++removed;
+                        return true;
+                    }
+                }
+                candidates.push_back(id);
+                return false;
+            });
+    }
+
+    if (removed != 0) {
+        function.replace_uses(replacement);
+    }
+    // removals are counted by the pass manager
+    return 0;
+}
+
+} // namespace backend::optimizer
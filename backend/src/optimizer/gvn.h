@@ -0,0 +1,21 @@
+#pragma once
+
+#include "optimizer/pass.h"
+
+namespace backend::optimizer {
+
+// Global value numbering: an instruction computing the same operator over
+// the same operands as one that dominates it is removed and its uses
+// redirected to the dominating one. Equal constants are shared too. The
+// removed instruction cannot raise an error the kept one would not have
+// raised first.
+class GlobalValueNumbering final : public Pass {
+public:
+    std::string_view name() const override {
+        return "gvn";
+    }
+
+    std::size_t run(ir::Function& function) override;
+};
+
+} // namespace backend::optimizer
@@ -0,0 +1,75 @@
+#include <cstddef>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "ir/lowering.h"
+#include "ir/verifier.h"
+#include "optimizer/gvn.h"
+#include "parser.h"
+#include "scanner.h"
+
+namespace {
+
+using backend::ir::Function;
+using backend::optimizer::GlobalValueNumbering;
+
+Function number(const std::string& source) {
+    auto function = backend::ir::Lowering().lower(
+        frontend::Parser(frontend::Scanner(source).scan_tokens()).parse());
+    GlobalValueNumbering().run(function);
+    backend::ir::verify(function);
+    return function;
+}
+
+std::size_t count(const std::string& text, const std::string& needle) {
+    std::size_t count = 0;
+    for (auto i = text.find(needle); i != std::string::npos;
+         i = text.find(needle, i + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+TEST(GlobalValueNumbering, RemovesRedundantExpressions) {
+    EXPECT_EQ(dump(number("(1 + 2) * (1 + 2);")),
+              "bb0:\n"
+              "  %0 = const none\n"
+              "  %1 = const 1\n"
+              "  %2 = const 2\n"
+              "  %3 = binary ADDITION %1, %2\n"
+              "  %7 = binary MULTIPLICATION %3, %3\n"
+              "  return %7\n");
+}
+
+TEST(GlobalValueNumbering, KeepsDistinctConstantTypes) {
+    const auto text = dump(number("1; 1.0; true; \"1\";"));
+
+    EXPECT_EQ(count(text, "const"), 5);
+}
+
+TEST(GlobalValueNumbering, ReusesDominatingValues) {
+    const auto text = dump(number("2 + 3; if (1) 2 + 3;"));
+
+    EXPECT_EQ(count(text, "binary ADDITION"), 1);
+}
+
+TEST(GlobalValueNumbering, DoesNotReuseAcrossSiblingBranches) {
+    const auto text = dump(number("if (1) 2 + 3; else 2 + 3;"));
+
+    EXPECT_EQ(count(text, "binary ADDITION"), 2);
+}
+
+TEST(GlobalValueNumbering, EqualityIsCommutative) {
+    const auto text = dump(number("(1 == 2) == (2 == 1);"));
+
+    EXPECT_EQ(count(text, "binary EQUAL_TO"), 2);
+}
+
+TEST(GlobalValueNumbering, OperandOrderMattersForOtherOperators) {
+    const auto text = dump(number("(1 - 2) - (2 - 1);"));
+
+    EXPECT_EQ(count(text, "binary SUBTRACTION"), 3);
+}
+
+} // namespace
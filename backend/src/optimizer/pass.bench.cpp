@@ -0,0 +1,59 @@
+#include <cstddef>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_programs.h"
+#include "ir/lowering.h"
+#include "optimizer/pass.h"
+#include "parser.h"
+#include "scanner.h"
+
+namespace {
+
+void optimize(benchmark::State& state, const std::string& source,
+              int level) {
+    const auto ast =
+        frontend::Parser(frontend::Scanner(source).scan_tokens()).parse();
+    const auto manager = backend::optimizer::PassManager::for_level(level);
+    backend::ir::Lowering lowering;
+    std::size_t before = 0;
+    std::size_t after = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto function = lowering.lower(ast);
+        before = function.live_instruction_count();
+        state.ResumeTiming();
+        manager.run(function);
+        after = function.live_instruction_count();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel("items = statements");
+    state.counters["removed_percent"] =
+        100.0 * static_cast<double>(before - after) /
+        static_cast<double>(before);
+}
+
+void BM_OptimizeArithmeticO1(benchmark::State& state) {
+    optimize(state, backend::bench::arithmetic_program(
+                        static_cast<std::size_t>(state.range(0))),
+             1);
+}
+
+void BM_OptimizeArithmeticO2(benchmark::State& state) {
+    optimize(state, backend::bench::arithmetic_program(
+                        static_cast<std::size_t>(state.range(0))),
+             2);
+}
+
+void BM_OptimizeBranchesO2(benchmark::State& state) {
+    optimize(state, backend::bench::branchy_program(
+                        static_cast<std::size_t>(state.range(0))),
+             2);
+}
+
+BENCHMARK(BM_OptimizeArithmeticO1)->Range(64, 4096);
+BENCHMARK(BM_OptimizeArithmeticO2)->Range(64, 4096);
+BENCHMARK(BM_OptimizeBranchesO2)->Range(64, 4096);
+
+} // namespace
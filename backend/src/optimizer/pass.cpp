@@ -0,0 +1,84 @@
+#include "optimizer/pass.h"
+
+#include <format>
+#include <stdexcept>
+
+#include "ir/verifier.h"
+#include "optimizer/branch_folding.h"
+#include "optimizer/dce.h"
+#include "optimizer/gvn.h"
+#include "optimizer/sccp.h"
+#include "trace.h"
+
+namespace backend::optimizer {
+
+PassManager PassManager::for_level(int level, PassManagerOptions options) {
+    PassManager manager(options);
+    switch (level) {
+        case 0:
+            break;
+        case 1:
+            manager.add(std::make_unique<Sccp>());
+            manager.add(std::make_unique<BranchFolding>());
+            manager.add(std::make_unique<DeadCodeElimination>());
+            break;
+        case 2:
+            manager.add(std::make_unique<GlobalValueNumbering>());
+            manager.add(std::make_unique<Sccp>());
+            manager.add(std::make_unique<BranchFolding>());
+            manager.add(std::make_unique<GlobalValueNumbering>());
+            manager.add(std::make_unique<DeadCodeElimination>());
+            break;
+        default:
+            throw std::invalid_argument(std::vformat(
+                "Unsupported optimisation level: {}",
+                std::make_format_args(level)));
+    }
+    return manager;
+}
+
+std::vector<PassStatistics> PassManager::run(ir::Function& function) const {
+    std::vector<PassStatistics> statistics;
+    statistics.reserve(passes_.size());
+    for (const auto& pass : passes_) {
+        auto& entry = statistics.emplace_back();
+        entry.name = pass->name();
+        entry.instructions_before = function.live_instruction_count();
+
+        const auto start = std::chrono::steady_clock::now();
+        {
+            frontend::trace::Span span(entry.name, "pass");
+            entry.changed = pass->run(function);
+        }
+        entry.duration = std::chrono::steady_clock::now() - start;
+        entry.instructions_after = function.live_instruction_count();
+
+        if (options_.verify) {
+            try {
+                ir::verify(function);
+            } catch (const ir::VerificationError& error) {
+                throw ir::VerificationError(
+                    std::vformat("After {}: {}",
+                                 std::make_format_args(entry.name,
+                                                       error.what())));
+            }
+        }
+    }
+    return statistics;
+}
+
+std::string format_statistics(std::span<const PassStatistics> statistics) {
+    std::string text;
+    for (const auto& entry : statistics) {
+        const auto nanoseconds = entry.duration.count();
+        const auto removed = entry.removed();
+        text += std::vformat(
+            "{}: {} ns, {} removed, {} changed ({} -> {} instructions)\n",
+            std::make_format_args(entry.name, nanoseconds, removed,
+                                  entry.changed, entry.instructions_before,
+                                  entry.instructions_after));
+    }
+    return text;
+}
+
+} // namespace backend::optimizer
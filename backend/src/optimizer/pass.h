@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ir/ir.h"
+
+namespace backend::optimizer {
+
+// A transformation of an ir::Function that keeps it valid and behaving the
+// same, including which runtime errors it raises.
+class Pass {
+public:
+    virtual ~Pass() = default;
+
+    virtual std::string_view name() const = 0;
+
+    // Returns the number of instructions or edges rewritten in place; removed
+    // instructions are counted by the PassManager.
+    virtual std::size_t run(ir::Function& function) = 0;
+};
+
+struct PassStatistics {
+    std::string_view name;
+    std::chrono::nanoseconds duration;
+    std::size_t instructions_before = 0;
+    std::size_t instructions_after = 0;
+    std::size_t changed = 0;
+
+    std::size_t removed() const {
+        return instructions_before > instructions_after
+                   ? instructions_before - instructions_after
+                   : 0;
+    }
+};
+
+struct PassManagerOptions {
+    // run ir::verify() after every pass; a failure names the pass
+    bool verify = false;
+};
+
+class PassManager {
+public:
+    static constexpr int MAX_LEVEL = 2;
+
+    explicit PassManager(PassManagerOptions options = {})
+        : options_(options) {}
+
+    // The pipeline for an -O level:
+    //   0: nothing
+    //   1: sccp, branch-folding, dce
+    //   2: gvn, sccp, branch-folding, gvn, dce
+    // Throws std::invalid_argument for other levels.
+    static PassManager for_level(int level, PassManagerOptions options = {});
+
+    void add(std::unique_ptr<Pass> pass) {
+        passes_.push_back(std::move(pass));
+    }
+
+    std::size_t size() const {
+        return passes_.size();
+    }
+
+    std::vector<PassStatistics> run(ir::Function& function) const;
+
+private:
+    PassManagerOptions options_;
+    std::vector<std::unique_ptr<Pass>> passes_;
+};
+
+// One line per pass: "<name>: <ns> ns, <removed> removed, <changed> changed
+// (<before> -> <after> instructions)".
+std::string format_statistics(std::span<const PassStatistics> statistics);
+
+} // namespace backend::optimizer
@@ -0,0 +1,109 @@
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "bench_programs.h"
+#include "interpreter/evaluator.h"
+#include "ir/execute.h"
+#include "ir/lowering.h"
+#include "optimizer/pass.h"
+#include "parser.h"
+#include "scanner.h"
+
+namespace {
+
+using backend::EvaluationError;
+using backend::optimizer::PassManager;
+
+frontend::ast::AbstractSyntaxTree parse(const std::string& source) {
+    return frontend::Parser(frontend::Scanner(source).scan_tokens()).parse();
+}
+
+// Result of the program as text, or the error it raises.
+std::string evaluate(const std::string& source) {
+    const auto ast = parse(source);
+    backend::interpreter::Evaluator evaluator;
+    try {
+        return evaluator.evaluate(ast).to_string();
+    } catch (const EvaluationError& error) {
+        return error.what();
+    }
+}
+
+std::string optimize_and_execute(const std::string& source, int level) {
+    auto function = backend::ir::Lowering().lower(parse(source));
+    PassManager::for_level(level, {.verify = true}).run(function);
+    backend::StringHeap strings;
+    try {
+        return backend::ir::execute(function, strings).to_string();
+    } catch (const EvaluationError& error) {
+        return error.what();
+    }
+}
+
+TEST(PassManager, Levels) {
+    EXPECT_EQ(PassManager::for_level(0).size(), 0);
+    EXPECT_EQ(PassManager::for_level(1).size(), 3);
+    EXPECT_EQ(PassManager::for_level(2).size(), 5);
+    EXPECT_THROW(PassManager::for_level(3), std::invalid_argument);
+    EXPECT_THROW(PassManager::for_level(-1), std::invalid_argument);
+}
+
+TEST(PassManager, Statistics) {
+    auto function = backend::ir::Lowering().lower(
+        parse("(1 + 2) * (1 + 2); if (1 < 2) 3; else 4;"));
+    const auto before = function.live_instruction_count();
+    const auto statistics = PassManager::for_level(2).run(function);
+
+    ASSERT_EQ(statistics.size(), 5);
+    EXPECT_EQ(statistics[0].name, "gvn");
+    EXPECT_EQ(statistics[0].instructions_before, before);
+    EXPECT_GT(statistics[0].removed(), 0);
+    std::size_t removed = 0;
+    for (const auto& entry : statistics) {
+        removed += entry.removed();
+    }
+    EXPECT_EQ(before - removed, function.live_instruction_count());
+    EXPECT_EQ(function.live_instruction_count(), 2);
+
+    const auto text = backend::optimizer::format_statistics(statistics);
+    EXPECT_NE(text.find("gvn: "), std::string::npos);
+    EXPECT_NE(text.find("branch-folding: "), std::string::npos);
+}
+
+TEST(PassManager, PreservesBehaviour) {
+    for (const auto* source : {
+             "",
+             "1 + 2 * 3; (1 + 2) * (1 + 2);",
+             "1 / 0; 3;",
+             "3; 1 << 64;",
+             "\"a\" + \"b\"; \"a\" - 1;",
+             "if (1 < 2) 3; else 4;",
+             "5; if (0) 6;",
+             "if (1 / 0) 1; else 2;",
+             "if (0) 1 / 0; else 2;",
+             "if (\"\") { 1; } else if (2.5) { if (3 > 4) 5; 6; } 7 == 7.0;",
+             "(9223372036854775807 + 1) / (0 - 1);",
+             "0.0 / 0.0 == 0.0 / 0.0; 1.5 % 0;",
+         }) {
+        const auto expected = evaluate(source);
+        for (int level = 0; level <= PassManager::MAX_LEVEL; ++level) {
+            EXPECT_EQ(optimize_and_execute(source, level), expected)
+                << source << " at -O" << level;
+        }
+    }
+}
+
+TEST(PassManager, PreservesBehaviourOfBenchmarkPrograms) {
+    for (const auto& source : {backend::bench::arithmetic_program(50),
+                               backend::bench::branchy_program(50),
+                               backend::bench::floating_point_program(50)}) {
+        const auto expected = evaluate(source);
+        for (int level = 0; level <= PassManager::MAX_LEVEL; ++level) {
+            EXPECT_EQ(optimize_and_execute(source, level), expected);
+        }
+    }
+}
+
+} // namespace
@@ -0,0 +1,257 @@
+#include "optimizer/sccp.h"
+
+#include <algorithm>
+#include <bit>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "operations.h"
+
+namespace backend::optimizer {
+
+namespace {
+
+using ir::BlockId;
+using ir::Opcode;
+using ir::ValueId;
+
+// Same type and same bits: 1 and 1.0 compare equal but are not the same
+// constant.
+bool identical(const Value& a, const Value& b) {
+    if (a.type() != b.type()) {
+        return false;
+    }
+    switch (a.type()) {
+        case Value::Type::DOUBLE:
+            return std::bit_cast<std::uint64_t>(a.as_double()) ==
+                   std::bit_cast<std::uint64_t>(b.as_double());
+        default:
+            return a == b;
+    }
+}
+
+struct Cell {
+    enum class State : std::uint8_t {
+        UNDEFINED,
+        CONSTANT,
+        OVERDEFINED,
+    };
+
+    State state = State::UNDEFINED;
+    Value value;
+};
+
+class Propagation {
+public:
+    explicit Propagation(const ir::Function& function)
+        : function_(function), cells_(function.instruction_count()),
+          users_(function.instruction_count()),
+          executable_(function.blocks().size()) {
+        for (const auto& block : function.blocks()) {
+            for (const auto id : block.instructions) {
+                const auto& instruction = function.instruction(id);
+                if (instruction.opcode == Opcode::PHI) {
+                    for (const auto& incoming :
+                         function.phi_operands(instruction)) {
+                        users_[incoming.value].push_back(id);
+                    }
+                }
+                for (std::size_t i = 0;
+                     i < instruction.value_operand_count(); ++i) {
+                    users_[instruction.operands[i]].push_back(id);
+                }
+            }
+        }
+    }
+
+    void solve() {
+        flow_.emplace_back(ir::NO_ID, 0);
+        while (!flow_.empty() || !ssa_.empty()) {
+            while (!flow_.empty()) {
+                const auto [from, to] = flow_.back();
+                flow_.pop_back();
+                visit_edge(from, to);
+            }
+            while (!ssa_.empty()) {
+                const auto value = ssa_.back();
+                ssa_.pop_back();
+                for (const auto user : users_[value]) {
+                    if (executable_[function_.instruction(user).block]) {
+                        visit(user);
+                    }
+                }
+            }
+        }
+    }
+
+    const Cell& cell(ValueId value) const {
+        return cells_[value];
+    }
+
+private:
+    void visit_edge(BlockId from, BlockId to) {
+        if (!edges_.emplace(from, to).second) {
+            return;
+        }
+        const auto& instructions = function_.blocks()[to].instructions;
+        const bool first_visit = !executable_[to];
+        executable_[to] = true;
+        for (const auto id : instructions) {
+            if (function_.instruction(id).opcode == Opcode::PHI ||
+                first_visit) {
+                visit(id);
+            }
+        }
+    }
+
+    void visit(ValueId id) {
+        const auto& instruction = function_.instruction(id);
+        const auto& operands = instruction.operands;
+        switch (instruction.opcode) {
+            case Opcode::CONSTANT:
+                set_constant(id, function_.constants()[operands[0]]);
+                break;
+            case Opcode::UNARY:
+            case Opcode::BINARY:
+            case Opcode::TO_BOOL:
+                fold(id);
+                break;
+            case Opcode::PHI:
+                for (const auto& incoming :
+                     function_.phi_operands(instruction)) {
+                    if (edges_.contains({incoming.block, instruction.block})) {
+                        meet(id, cells_[incoming.value]);
+                    }
+                }
+                break;
+            case Opcode::JUMP:
+                flow_.emplace_back(instruction.block, operands[0]);
+                break;
+            case Opcode::BRANCH: {
+                const auto& condition = cells_[operands[0]];
+                if (condition.state == Cell::State::CONSTANT) {
+                    flow_.emplace_back(instruction.block,
+                                       condition.value.is_truthy()
+                                           ? operands[1]
+                                           : operands[2]);
+                } else if (condition.state == Cell::State::OVERDEFINED) {
+                    flow_.emplace_back(instruction.block, operands[1]);
+                    flow_.emplace_back(instruction.block, operands[2]);
+                }
+                break;
+            }
+            case Opcode::RETURN:
+                break;
+        }
+    }
+
+    void fold(ValueId id) {
+        const auto& instruction = function_.instruction(id);
+        const auto& operands = instruction.operands;
+        for (std::size_t i = 0; i < instruction.value_operand_count(); ++i) {
+            switch (cells_[operands[i]].state) {
+                case Cell::State::UNDEFINED:
+                    return;
+                case Cell::State::OVERDEFINED:
+                    set_overdefined(id);
+                    return;
+                case Cell::State::CONSTANT:
+                    break;
+            }
+        }
+
+        try {
+            switch (instruction.opcode) {
+                case Opcode::UNARY:
+                    set_constant(id, apply_unary(instruction.op,
+                                                 cells_[operands[0]].value));
+                    break;
+                case Opcode::BINARY:
+                    set_constant(id, apply_binary(instruction.op,
+                                                  cells_[operands[0]].value,
+                                                  cells_[operands[1]].value,
+                                                  strings_));
+                    break;
+                default:
+                    set_constant(id, cells_[operands[0]].value.is_truthy());
+                    break;
+            }
+        } catch (const EvaluationError&) {
+            // must still fail at runtime
+            set_overdefined(id);
+        }
+    }
+
+    void meet(ValueId id, const Cell& other) {
+        if (other.state == Cell::State::CONSTANT) {
+            set_constant(id, other.value);
+        } else if (other.state == Cell::State::OVERDEFINED) {
+            set_overdefined(id);
+        }
+    }
+
+    void set_constant(ValueId id, const Value& value) {
+        auto& cell = cells_[id];
+        if (cell.state == Cell::State::UNDEFINED) {
+            cell = {Cell::State::CONSTANT, value};
+            ssa_.push_back(id);
+        } else if (cell.state == Cell::State::CONSTANT &&
+                   !identical(cell.value, value)) {
+            set_overdefined(id);
+        }
+    }
+
+    void set_overdefined(ValueId id) {
+        if (cells_[id].state != Cell::State::OVERDEFINED) {
+            cells_[id].state = Cell::State::OVERDEFINED;
+            ssa_.push_back(id);
+        }
+    }
+
+    const ir::Function& function_;
+    std::vector<Cell> cells_;
+    std::vector<std::vector<ValueId>> users_;
+    std::vector<bool> executable_;
+    std::set<std::pair<BlockId, BlockId>> edges_;
+    std::vector<std::pair<BlockId, BlockId>> flow_;
+    std::vector<ValueId> ssa_;
+    // strings created by folding `+`, copied into the function when used
+    StringHeap strings_;
+};
+
+} // namespace
+
+std::size_t Sccp::run(ir::Function& function) {
+    Propagation propagation(function);
+    propagation.solve();
+
+    std::size_t changed = 0;
+    for (auto& block : function.blocks()) {
+        bool rewrote_phi = false;
+        for (const auto id : block.instructions) {
+            auto& instruction = function.instruction(id);
+            const auto& cell = propagation.cell(id);
+            if (instruction.opcode == Opcode::CONSTANT ||
+                instruction.is_terminator() ||
+                cell.state != Cell::State::CONSTANT) {
+                continue;
+            }
+            rewrote_phi |= instruction.opcode == Opcode::PHI;
+            instruction.opcode = Opcode::CONSTANT;
+            instruction.operands = {function.add_constant(cell.value), 0, 0};
+            ++changed;
+        }
+        if (rewrote_phi) {
+            // the remaining phis must stay in front
+            std::stable_partition(
+                block.instructions.begin(), block.instructions.end(),
+                [&](ValueId id) {
+                    return function.instruction(id).opcode == Opcode::PHI;
+                });
+        }
+    }
+    return changed;
+}
+
+} // namespace backend::optimizer
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "optimizer/pass.h"
+
+namespace backend::optimizer {
+
+// Sparse conditional constant propagation (Wegman and Zadeck): propagates
+// constants along the edges that can actually execute, folding operators
+// with the shared operations.h semantics. Every value found constant is
+// rewritten into a CONSTANT in place, including branch conditions, which
+// BranchFolding then turns into jumps. Operations that would raise an
+// error at runtime are left alone so the error still happens.
+class Sccp final : public Pass {
+public:
+    std::string_view name() const override {
+        return "sccp";
+    }
+
+    std::size_t run(ir::Function& function) override;
+};
+
+} // namespace backend::optimizer
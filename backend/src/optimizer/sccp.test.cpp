@@ -0,0 +1,67 @@
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "ir/lowering.h"
+#include "ir/verifier.h"
+#include "optimizer/dce.h"
+#include "optimizer/sccp.h"
+#include "parser.h"
+#include "scanner.h"
+
+namespace {
+
+using backend::ir::Function;
+using backend::optimizer::DeadCodeElimination;
+using backend::optimizer::Sccp;
+
+Function lower(const std::string& source) {
+    return backend::ir::Lowering().lower(
+        frontend::Parser(frontend::Scanner(source).scan_tokens()).parse());
+}
+
+// SCCP followed by DCE, so that only what SCCP could not fold is left.
+std::string propagate(const std::string& source) {
+    auto function = lower(source);
+    Sccp().run(function);
+    backend::ir::verify(function);
+    DeadCodeElimination().run(function);
+    backend::ir::verify(function);
+    return dump(function);
+}
+
+TEST(Sccp, FoldsArithmetic) {
+    EXPECT_EQ(propagate("1 + 2 * 3;"), "bb0:\n"
+                                       "  %5 = const 7\n"
+                                       "  return %5\n");
+}
+
+TEST(Sccp, FoldsStrings) {
+    EXPECT_EQ(propagate("\"a\" + \"b\";"), "bb0:\n"
+                                           "  %3 = const \"ab\"\n"
+                                           "  return %3\n");
+}
+
+TEST(Sccp, KeepsOperationsThatThrow) {
+    const auto text = propagate("1 / 0;");
+
+    EXPECT_NE(text.find("binary DIVISION"), std::string::npos);
+}
+
+TEST(Sccp, IgnoresPhiOperandsOnDeadEdges) {
+    auto function = lower("if (1 < 2) 3; else 4;");
+    const auto changed = Sccp().run(function);
+    backend::ir::verify(function);
+
+    // the comparison and the phi
+    EXPECT_EQ(changed, 2);
+    EXPECT_NE(dump(function).find("%9 = const 3"), std::string::npos);
+}
+
+TEST(Sccp, ReportsNothingForConstantsAlready) {
+    auto function = lower("1; 2;");
+
+    EXPECT_EQ(Sccp().run(function), 0);
+}
+
+} // namespace
@@ -0,0 +1,47 @@
+#include "value.h"
+
+#include <format>
+
+#include "ast/number.h"
+
+namespace backend {
+
+bool Value::operator==(const Value& other) const {
+    if (is_number() && other.is_number()) {
+        if (type_ == Type::INT && other.type_ == Type::INT) {
+            return int_ == other.int_;
+        }
+        return as_number() == other.as_number();
+    }
+    if (type_ != other.type_) {
+        return false;
+    }
+    switch (type_) {
+        case Type::NONE:
+            return true;
+        case Type::BOOL:
+            return bool_ == other.bool_;
+        case Type::STRING:
+            return as_string() == other.as_string();
+        default:
+            return false;
+    }
+}
+
+std::string Value::to_string() const {
+    switch (type_) {
+        case Type::NONE:
+            return "none";
+        case Type::BOOL:
+            return std::vformat("{}", std::make_format_args(bool_));
+        case Type::INT:
+            return std::vformat("{}", std::make_format_args(int_));
+        case Type::DOUBLE:
+            return frontend::ast::format_double(double_);
+        case Type::STRING:
+            return std::string(as_string());
+    }
+    return "none";
+}
+
+} // namespace backend
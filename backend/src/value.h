@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace backend {
+
+// Compact tagged value shared by the execution engines: 16 bytes and
+// trivially copyable, so registers and stacks can hold it by value. Strings
+// are views; their bytes are owned by the AST, a bytecode constant pool or a
+// StringHeap that outlives the value.
+class Value {
+public:
+    enum class Type : std::uint8_t {
+        NONE,
+        BOOL,
+        INT,
+        DOUBLE,
+        STRING,
+    };
+
+    constexpr Value() : type_(Type::NONE), int_(0) {}
+    constexpr Value(bool value) : type_(Type::BOOL), bool_(value) {}
+    constexpr Value(std::int64_t value) : type_(Type::INT), int_(value) {}
+    constexpr Value(double value) : type_(Type::DOUBLE), double_(value) {}
+    // strings are limited to 4 GiB
+    constexpr Value(std::string_view value)
+        : type_(Type::STRING),
+          length_(static_cast<std::uint32_t>(value.size())),
+          string_(value.data()) {}
+    // would otherwise convert to bool
+    constexpr Value(const char* value) : Value(std::string_view(value)) {}
+
+    constexpr Type type() const {
+        return type_;
+    }
+
+    constexpr bool is_number() const {
+        return type_ == Type::INT || type_ == Type::DOUBLE;
+    }
+
+    constexpr bool as_bool() const {
+        return bool_;
+    }
+
+    constexpr std::int64_t as_int() const {
+        return int_;
+    }
+
+    constexpr double as_double() const {
+        return double_;
+    }
+
+    constexpr std::string_view as_string() const {
+        return {string_, length_};
+    }
+
+    // INT or DOUBLE widened to double.
+    constexpr double as_number() const {
+        return type_ == Type::INT ? static_cast<double>(int_) : double_;
+    }
+
+    // false for NONE, false, zero and the empty string.
+    constexpr bool is_truthy() const {
+        switch (type_) {
+            case Type::NONE:
+                return false;
+            case Type::BOOL:
+                return bool_;
+            case Type::INT:
+                return int_ != 0;
+            case Type::DOUBLE:
+                return double_ != 0.0;
+            case Type::STRING:
+                return length_ != 0;
+        }
+        return false;
+    }
+
+    bool operator==(const Value& other) const;
+
+    std::string to_string() const;
+
+private:
+    Type type_;
+    std::uint32_t length_ = 0;
+    union {
+        bool bool_;
+        std::int64_t int_;
+        double double_;
+        const char* string_;
+    };
+};
+
+static_assert(sizeof(Value) == 16);
+
+// Owns the strings created while running a program, e.g. by concatenation.
+// Views into it stay valid for its whole lifetime.
+class StringHeap {
+public:
+    std::string_view store(std::string string) {
+        return strings_.emplace_back(std::move(string));
+    }
+
+private:
+    std::deque<std::string> strings_;
+};
+
+class EvaluationError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+} // namespace backend
+
+template <>
+struct std::formatter<backend::Value::Type> : std::formatter<std::string_view> {
+    auto format(backend::Value::Type type, std::format_context& ctx) const {
+        std::string_view name = "UNDEFINED";
+        switch (type) {
+            case backend::Value::Type::NONE:
+                name = "NONE";
+                break;
+            case backend::Value::Type::BOOL:
+                name = "BOOL";
+                break;
+            case backend::Value::Type::INT:
+                name = "INT";
+                break;
+            case backend::Value::Type::DOUBLE:
+                name = "DOUBLE";
+                break;
+            case backend::Value::Type::STRING:
+                name = "STRING";
+                break;
+        }
+        return std::formatter<std::string_view>::format(name, ctx);
+    }
+};
@@ -0,0 +1,71 @@
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "ast/operator.h"
+#include "operations.h"
+#include "value.h"
+
+namespace {
+
+using backend::Value;
+using Operator = frontend::ast::Operator;
+
+TEST(Value, Types) {
+    EXPECT_EQ(Value().type(), Value::Type::NONE);
+    EXPECT_EQ(Value(true).type(), Value::Type::BOOL);
+    EXPECT_EQ(Value(std::int64_t{1}).type(), Value::Type::INT);
+    EXPECT_EQ(Value(1.0).type(), Value::Type::DOUBLE);
+    EXPECT_EQ(Value("text").type(), Value::Type::STRING);
+}
+
+TEST(Value, Equality) {
+    EXPECT_EQ(Value(std::int64_t{2}), Value(2.0));
+    EXPECT_NE(Value(true), Value(std::int64_t{1}));
+    EXPECT_EQ(Value("ab"), Value(std::string_view("ab")));
+    EXPECT_EQ(Value(), Value());
+}
+
+TEST(Value, Truthiness) {
+    EXPECT_FALSE(Value().is_truthy());
+    EXPECT_FALSE(Value(std::int64_t{0}).is_truthy());
+    EXPECT_FALSE(Value("").is_truthy());
+    EXPECT_TRUE(Value(0.5).is_truthy());
+}
+
+TEST(Value, ToString) {
+    EXPECT_EQ(Value().to_string(), "none");
+    EXPECT_EQ(Value(false).to_string(), "false");
+    EXPECT_EQ(Value(std::int64_t{-3}).to_string(), "-3");
+    EXPECT_EQ(Value(2.5).to_string(), "2.5");
+    // doubles never print like integers
+    EXPECT_EQ(Value(1.0).to_string(), "1.0");
+    EXPECT_EQ(Value(-0.0).to_string(), "-0.0");
+    EXPECT_EQ(Value(1e100).to_string(), "1e+100");
+    EXPECT_EQ(Value("text").to_string(), "text");
+}
+
+TEST(Operations, IntegerEdgeCases) {
+    constexpr auto MIN = std::numeric_limits<std::int64_t>::min();
+
+    EXPECT_EQ(backend::apply_int(Operator::Type::DIVISION, MIN, -1),
+              Value(MIN));
+    EXPECT_EQ(backend::apply_int(Operator::Type::REMAINDER, MIN, -1),
+              Value(std::int64_t{0}));
+    EXPECT_EQ(backend::apply_int(Operator::Type::BITWISE_RIGHT_SHIFT, -8, 1),
+              Value(std::int64_t{-4}));
+}
+
+TEST(Operations, Unary) {
+    EXPECT_EQ(backend::apply_unary(Operator::Type::UNARY_MINUS,
+                                   Value(std::int64_t{3})),
+              Value(std::int64_t{-3}));
+    EXPECT_EQ(backend::apply_unary(Operator::Type::LOGICAL_NOT, Value("")),
+              Value(true));
+    EXPECT_THROW(backend::apply_unary(Operator::Type::BITWISE_NOT, Value(1.0)),
+                 backend::EvaluationError);
+}
+
+} // namespace
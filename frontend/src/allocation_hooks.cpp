@@ -0,0 +1,133 @@
+// Replacement global allocation functions feeding AllocationScope. Linking
+// this file into a program is what turns allocation counting on; outside of
+// a scope the only cost is one atomic load per call.
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#include "allocation_stats.h"
+
+namespace {
+
+void* allocate(std::size_t size) noexcept {
+    void* block = std::malloc(size == 0 ? 1 : size);
+    frontend::detail::record_allocation(block);
+    return block;
+}
+
+void* allocate(std::size_t size, std::align_val_t alignment) noexcept {
+    void* block = nullptr;
+    const auto bytes = static_cast<std::size_t>(alignment);
+    if (posix_memalign(&block, std::max(bytes, sizeof(void*)),
+                       size == 0 ? 1 : size) != 0) {
+        return nullptr;
+    }
+    frontend::detail::record_allocation(block);
+    return block;
+}
+
+template <typename... Alignment>
+void* allocate_or_throw(std::size_t size, Alignment... alignment) {
+    while (true) {
+        if (void* block = allocate(size, alignment...)) {
+            return block;
+        }
+        const auto handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void deallocate(void* block) noexcept {
+    frontend::detail::record_deallocation(block);
+    std::free(block);
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    return allocate_or_throw(size);
+}
+
+void* operator new[](std::size_t size) {
+    return allocate_or_throw(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocate_or_throw(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocate_or_throw(size, alignment);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment,
+                   const std::nothrow_t&) noexcept {
+    return allocate(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment,
+                     const std::nothrow_t&) noexcept {
+    return allocate(size, alignment);
+}
+
+void operator delete(void* block) noexcept {
+    deallocate(block);
+}
+
+void operator delete[](void* block) noexcept {
+    deallocate(block);
+}
+
+void operator delete(void* block, std::size_t) noexcept {
+    deallocate(block);
+}
+
+void operator delete[](void* block, std::size_t) noexcept {
+    deallocate(block);
+}
+
+void operator delete(void* block, std::align_val_t) noexcept {
+    deallocate(block);
+}
+
+void operator delete[](void* block, std::align_val_t) noexcept {
+    deallocate(block);
+}
+
+void operator delete(void* block, std::size_t, std::align_val_t) noexcept {
+    deallocate(block);
+}
+
+void operator delete[](void* block, std::size_t, std::align_val_t) noexcept {
+    deallocate(block);
+}
+
+void operator delete(void* block, const std::nothrow_t&) noexcept {
+    deallocate(block);
+}
+
+void operator delete[](void* block, const std::nothrow_t&) noexcept {
+    deallocate(block);
+}
+
+void operator delete(void* block, std::align_val_t,
+                     const std::nothrow_t&) noexcept {
+    deallocate(block);
+}
+
+void operator delete[](void* block, std::align_val_t,
+                       const std::nothrow_t&) noexcept {
+    deallocate(block);
+}
@@ -0,0 +1,131 @@
+#include "allocation_stats.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <format>
+#include <stdexcept>
+
+#include <malloc.h>
+
+namespace frontend {
+
+namespace {
+
+constexpr std::size_t MAX_DEPTH = 16;
+
+struct Counters {
+    std::atomic<std::size_t> allocations{0};
+    std::atomic<std::size_t> deallocations{0};
+    std::atomic<std::size_t> allocated_bytes{0};
+    // signed, blocks from before the scope may be freed within it
+    std::atomic<std::int64_t> live_bytes{0};
+    std::atomic<std::int64_t> peak_live_bytes{0};
+};
+
+void raise_to(std::atomic<std::int64_t>& peak, std::int64_t value) {
+    auto current = peak.load(std::memory_order_relaxed);
+    while (value > current &&
+           !peak.compare_exchange_weak(current, value,
+                                       std::memory_order_relaxed)) {
+    }
+}
+
+// Statically allocated, so that no counter is ever freed under a thread
+// that is still recording into it; zero-initialised before any allocation.
+std::array<Counters, MAX_DEPTH> counters;
+std::atomic<Counters*> active{nullptr};
+std::size_t depth = 0;
+
+std::int64_t block_size(void* block) {
+    return static_cast<std::int64_t>(malloc_usable_size(block));
+}
+
+} // namespace
+
+AllocationScope::AllocationScope() : depth_(depth) {
+    if (depth_ == MAX_DEPTH) {
+        throw std::logic_error(
+            std::vformat("Allocation scopes nest deeper than {}",
+                         std::make_format_args(MAX_DEPTH)));
+    }
+    auto& own = counters[depth_];
+    own.allocations.store(0, std::memory_order_relaxed);
+    own.deallocations.store(0, std::memory_order_relaxed);
+    own.allocated_bytes.store(0, std::memory_order_relaxed);
+    own.live_bytes.store(0, std::memory_order_relaxed);
+    own.peak_live_bytes.store(0, std::memory_order_relaxed);
+    ++depth;
+    active.store(&own, std::memory_order_release);
+}
+
+AllocationScope::~AllocationScope() {
+    --depth;
+    if (depth_ == 0) {
+        active.store(nullptr, std::memory_order_release);
+        return;
+    }
+    auto& parent = counters[depth_ - 1];
+    active.store(&parent, std::memory_order_release);
+
+    const auto& own = counters[depth_];
+    parent.allocations.fetch_add(own.allocations.load(),
+                                 std::memory_order_relaxed);
+    parent.deallocations.fetch_add(own.deallocations.load(),
+                                   std::memory_order_relaxed);
+    parent.allocated_bytes.fetch_add(own.allocated_bytes.load(),
+                                     std::memory_order_relaxed);
+    // the inner peak was reached on top of what the parent had live then
+    raise_to(parent.peak_live_bytes,
+             parent.live_bytes.load() + own.peak_live_bytes.load());
+    parent.live_bytes.fetch_add(own.live_bytes.load(),
+                                std::memory_order_relaxed);
+}
+
+AllocationStats AllocationScope::stats() const {
+    const auto& own = counters[depth_];
+    return {
+        .allocations = own.allocations.load(),
+        .deallocations = own.deallocations.load(),
+        .allocated_bytes = own.allocated_bytes.load(),
+        .peak_live_bytes = static_cast<std::size_t>(
+            std::max<std::int64_t>(own.peak_live_bytes.load(), 0)),
+    };
+}
+
+std::string to_string(std::string_view phase, const AllocationStats& stats) {
+    return std::vformat("{}: {} allocations, {} bytes, peak {} bytes",
+                        std::make_format_args(phase, stats.allocations,
+                                              stats.allocated_bytes,
+                                              stats.peak_live_bytes));
+}
+
+namespace detail {
+
+void record_allocation(void* block) {
+    auto* scope = active.load(std::memory_order_acquire);
+    if (scope == nullptr || block == nullptr) {
+        return;
+    }
+    const auto size = block_size(block);
+    scope->allocations.fetch_add(1, std::memory_order_relaxed);
+    scope->allocated_bytes.fetch_add(static_cast<std::size_t>(size),
+                                     std::memory_order_relaxed);
+    raise_to(scope->peak_live_bytes,
+             scope->live_bytes.fetch_add(size, std::memory_order_relaxed) +
+                 size);
+}
+
+void record_deallocation(void* block) {
+    auto* scope = active.load(std::memory_order_acquire);
+    if (scope == nullptr || block == nullptr) {
+        return;
+    }
+    scope->deallocations.fetch_add(1, std::memory_order_relaxed);
+    scope->live_bytes.fetch_sub(block_size(block), std::memory_order_relaxed);
+}
+
+} // namespace detail
+
+} // namespace frontend
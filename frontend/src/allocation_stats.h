@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace frontend {
+
+struct AllocationStats {
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+    std::size_t allocated_bytes = 0;
+    // most bytes allocated within the scope and alive at the same time
+    std::size_t peak_live_bytes = 0;
+};
+
+// Counts the allocations made through the global operator new, by any
+// thread, for as long as it lives. Scopes nest: an inner scope, e.g. for one
+// phase, adds its counts to the enclosing one, e.g. for the whole file, when
+// it ends. Scopes are meant to be opened and closed by a single thread.
+//
+// Counting needs the replacement operators of allocation_hooks.cpp, which
+// only programs that ask for it link in; everywhere else the stats stay zero.
+class AllocationScope {
+public:
+    AllocationScope();
+    ~AllocationScope();
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+    // counts so far
+    AllocationStats stats() const;
+
+private:
+    std::size_t depth_;
+};
+
+// One line such as "parse: 12 allocations, 1024 bytes, peak 768 bytes".
+std::string to_string(std::string_view phase, const AllocationStats& stats);
+
+namespace detail {
+
+// Called by the replacement operators for each block, which must come from
+// malloc.
+void record_allocation(void* block);
+void record_deallocation(void* block);
+
+} // namespace detail
+
+} // namespace frontend
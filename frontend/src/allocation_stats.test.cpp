@@ -0,0 +1,97 @@
+#include <cstddef>
+#include <memory>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "allocation_stats.h"
+
+namespace {
+
+using frontend::AllocationScope;
+
+// keeps the compiler from eliding allocations nobody looks at
+void* volatile sink = nullptr;
+
+std::unique_ptr<char[]> buffer(std::size_t size) {
+    auto block = std::make_unique<char[]>(size);
+    sink = block.get();
+    return block;
+}
+
+TEST(AllocationScope, CountsAllocationsAndBytes) {
+    AllocationScope scope;
+    buffer(1000);
+
+    const auto stats = scope.stats();
+    EXPECT_EQ(stats.allocations, 1);
+    EXPECT_EQ(stats.deallocations, 1);
+    EXPECT_GE(stats.allocated_bytes, 1000);
+    EXPECT_GE(stats.peak_live_bytes, 1000);
+}
+
+TEST(AllocationScope, PeakCountsOnlyLiveBytes) {
+    AllocationScope scope;
+    for (int i = 0; i < 10; ++i) {
+        buffer(1000);
+    }
+    const auto kept = buffer(4000);
+
+    const auto stats = scope.stats();
+    EXPECT_EQ(stats.allocations, 11);
+    EXPECT_GE(stats.allocated_bytes, 14000);
+    EXPECT_GE(stats.peak_live_bytes, 4000);
+    EXPECT_LT(stats.peak_live_bytes, 6000);
+}
+
+TEST(AllocationScope, InnerScopesAddUpInOuterOnes) {
+    AllocationScope outer;
+    const auto kept = buffer(3000);
+    {
+        AllocationScope inner;
+        buffer(2000);
+        EXPECT_EQ(inner.stats().allocations, 1);
+        EXPECT_EQ(outer.stats().allocations, 1);
+    }
+
+    const auto stats = outer.stats();
+    EXPECT_EQ(stats.allocations, 2);
+    EXPECT_EQ(stats.deallocations, 1);
+    EXPECT_GE(stats.allocated_bytes, 5000);
+    // both buffers were alive while the inner scope was open
+    EXPECT_GE(stats.peak_live_bytes, 5000);
+}
+
+TEST(AllocationScope, FreeingOlderBlocksDoesNotLowerThePeakBelowZero) {
+    auto old = buffer(1000);
+    AllocationScope scope;
+    old.reset();
+
+    EXPECT_EQ(scope.stats().deallocations, 1);
+    EXPECT_EQ(scope.stats().peak_live_bytes, 0);
+}
+
+TEST(AllocationScope, CountsOtherThreadsAndAlignedAllocations) {
+    struct alignas(64) Line {
+        char bytes[64];
+    };
+    AllocationScope scope;
+    std::jthread([]() {
+        const auto line = std::make_unique<Line>();
+        sink = line.get();
+    }).join();
+
+    const auto stats = scope.stats();
+    EXPECT_GE(stats.allocations, 1);
+    EXPECT_GE(stats.allocated_bytes, sizeof(Line));
+}
+
+TEST(AllocationScope, ToString) {
+    EXPECT_EQ(frontend::to_string("parse", {.allocations = 3,
+                                            .deallocations = 1,
+                                            .allocated_bytes = 96,
+                                            .peak_live_bytes = 64}),
+              "parse: 3 allocations, 96 bytes, peak 64 bytes");
+}
+
+} // namespace
@@ -1,23 +1,41 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <utility>
 
 #include "ast/node.h"
+#include "string_pool.h"
+#include "trace.h"
 
 namespace frontend::ast {
 
 class AbstractSyntaxTree {
 public:
-    AbstractSyntaxTree(std::unique_ptr<Node> root) : root_(std::move(root)) {}
+    // `strings` holds the string literals of the tree, if any.
+    AbstractSyntaxTree(std::unique_ptr<Node> root,
+                       std::shared_ptr<const StringPool> strings = nullptr)
+        : root_(std::move(root)), strings_(std::move(strings)) {}
+
+    const Node& root() const {
+        return *root_;
+    }
+
+    Node& root() {
+        return *root_;
+    }
 
     std::string to_string() const {
-        return std::vformat("AST(root: {})",
-                            std::make_format_args(root_.get()));
+        trace::Span span("to_string");
+        std::string out = "AST(root: ";
+        print(root_.get(), out);
+        out += ')';
+        return out;
     }
 
 private:
     std::unique_ptr<Node> root_;
+    std::shared_ptr<const StringPool> strings_;
 };
 
 } // namespace frontend::ast
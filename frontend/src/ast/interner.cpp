@@ -0,0 +1,89 @@
+#include "ast/interner.h"
+
+#include <bit>
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace frontend::ast {
+
+namespace {
+
+std::uint64_t address(const ExpressionPtr& expression) {
+    return reinterpret_cast<std::uintptr_t>(expression.get());
+}
+
+} // namespace
+
+std::size_t ExpressionInterner::KeyHash::operator()(const Key& key) const {
+    // boost::hash_combine
+    std::size_t hash = std::hash<std::string_view>()(key.text);
+    for (const auto part :
+         {static_cast<std::uint64_t>(key.kind),
+          static_cast<std::uint64_t>(key.op), key.first, key.second}) {
+        hash ^= std::hash<std::uint64_t>()(part) + 0x9e3779b97f4a7c15 +
+                (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+template <typename Make>
+ExpressionPtr ExpressionInterner::intern(Key key, Make make) {
+    requested_.fetch_add(1, std::memory_order_relaxed);
+    const auto hash = KeyHash()(key);
+    auto& shard = shards_[hash % SHARD_COUNT];
+    std::lock_guard lock(shard.mutex);
+    if (const auto it = shard.nodes.find(key); it != shard.nodes.end()) {
+        return it->second;
+    }
+    auto node = make();
+    shard.nodes.emplace(std::move(key), node);
+    created_.fetch_add(1, std::memory_order_relaxed);
+    return node;
+}
+
+ExpressionPtr ExpressionInterner::literal(bool value) {
+    return intern({.kind = Kind::BOOL, .first = value},
+                  [&]() { return std::make_shared<Literal<bool>>(value); });
+}
+
+ExpressionPtr ExpressionInterner::literal(std::int64_t value) {
+    return intern(
+        {.kind = Kind::INT, .first = static_cast<std::uint64_t>(value)},
+        [&]() { return std::make_shared<Literal<std::int64_t>>(value); });
+}
+
+ExpressionPtr ExpressionInterner::literal(double value) {
+    return intern(
+        {.kind = Kind::DOUBLE, .first = std::bit_cast<std::uint64_t>(value)},
+        [&]() { return std::make_shared<Literal<double>>(value); });
+}
+
+ExpressionPtr ExpressionInterner::literal(std::string_view value) {
+    const auto pooled = strings_->intern(value);
+    return intern({.kind = Kind::STRING, .text = pooled}, [&]() {
+        return std::make_shared<Literal<std::string_view>>(pooled);
+    });
+}
+
+ExpressionPtr ExpressionInterner::unary(Operator::Type op,
+                                        ExpressionPtr operand) {
+    return intern(
+        {.kind = Kind::UNARY, .op = op, .first = address(operand)}, [&]() {
+            return std::make_shared<UnaryExpression>(op, std::move(operand));
+        });
+}
+
+ExpressionPtr ExpressionInterner::binary(ExpressionPtr left, Operator::Type op,
+                                         ExpressionPtr right) {
+    return intern({.kind = Kind::BINARY,
+                   .op = op,
+                   .first = address(left),
+                   .second = address(right)},
+                  [&]() {
+                      return std::make_shared<BinaryExpression>(
+                          std::move(left), op, std::move(right));
+                  });
+}
+
+} // namespace frontend::ast
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <utility>
+#include <unordered_map>
+
+#include "ast/node.h"
+#include "ast/operator.h"
+#include "string_pool.h"
+
+namespace frontend::ast {
+
+// Hash-consing factory for expressions: structurally identical subtrees are
+// created once and shared, turning the parsed expressions into a DAG. Children
+// are compared by identity, which is structural equality as long as they came
+// from the same interner. Doubles are compared bitwise, so 0.0 and -0.0 stay
+// apart. String literals point into `strings()`, which must outlive the
+// expressions. Safe to use from several parser threads at once.
+class ExpressionInterner {
+public:
+    explicit ExpressionInterner(
+        std::shared_ptr<StringPool> strings = std::make_shared<StringPool>())
+        : strings_(std::move(strings)) {}
+
+    const std::shared_ptr<StringPool>& strings() const {
+        return strings_;
+    }
+
+    ExpressionPtr literal(bool value);
+    ExpressionPtr literal(std::int64_t value);
+    ExpressionPtr literal(double value);
+    ExpressionPtr literal(std::string_view value);
+    ExpressionPtr unary(Operator::Type op, ExpressionPtr operand);
+    ExpressionPtr binary(ExpressionPtr left, Operator::Type op,
+                         ExpressionPtr right);
+
+    // Nodes asked for, i.e. the size of the expression trees without sharing.
+    std::size_t requested() const {
+        return requested_.load(std::memory_order_relaxed);
+    }
+
+    // Distinct nodes actually allocated.
+    std::size_t created() const {
+        return created_.load(std::memory_order_relaxed);
+    }
+
+private:
+    enum class Kind : std::uint8_t {
+        BOOL,
+        INT,
+        DOUBLE,
+        STRING,
+        UNARY,
+        BINARY,
+    };
+
+    struct Key {
+        Kind kind;
+        Operator::Type op{};
+        // literal bits or child addresses
+        std::uint64_t first = 0;
+        std::uint64_t second = 0;
+        // pooled, so it lives as long as the node
+        std::string_view text{};
+
+        bool operator==(const Key& other) const = default;
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<Key, ExpressionPtr, KeyHash> nodes;
+    };
+
+    template <typename Make>
+    ExpressionPtr intern(Key key, Make make);
+
+    // independent locks so that parallel chunks rarely contend
+    static constexpr std::size_t SHARD_COUNT = 16;
+
+    std::shared_ptr<StringPool> strings_;
+    std::array<Shard, SHARD_COUNT> shards_;
+    std::atomic<std::size_t> requested_ = 0;
+    std::atomic<std::size_t> created_ = 0;
+};
+
+} // namespace frontend::ast
@@ -0,0 +1,95 @@
+#include <cstdint>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ast/interner.h"
+#include "ast/operator.h"
+
+namespace {
+
+using frontend::ast::ExpressionInterner;
+using frontend::ast::Operator;
+
+TEST(ExpressionInterner, EqualLiteralsAreShared) {
+    ExpressionInterner interner;
+
+    EXPECT_EQ(interner.literal(std::int64_t{2}),
+              interner.literal(std::int64_t{2}));
+    EXPECT_EQ(interner.literal(true), interner.literal(true));
+    EXPECT_EQ(interner.literal(std::string_view("a")),
+              interner.literal(std::string_view("a")));
+    EXPECT_NE(interner.literal(std::int64_t{2}),
+              interner.literal(std::int64_t{3}));
+    // same bits, different types
+    EXPECT_NE(interner.literal(std::int64_t{1}), interner.literal(true));
+    EXPECT_NE(interner.literal(0.0), interner.literal(-0.0));
+    EXPECT_EQ(interner.requested(), 12);
+    EXPECT_EQ(interner.created(), 7);
+}
+
+TEST(ExpressionInterner, EqualSubtreesAreShared) {
+    ExpressionInterner interner;
+    // a * 2 + 1, with `a` standing in as a string literal
+    const auto build = [&]() {
+        return interner.binary(
+            interner.binary(interner.literal(std::string_view("a")),
+                            Operator::Type::MULTIPLICATION,
+                            interner.literal(std::int64_t{2})),
+            Operator::Type::ADDITION, interner.literal(std::int64_t{1}));
+    };
+
+    const auto first = build();
+    const auto second = build();
+
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(first->to_string(),
+              "BinaryExpression(left: BinaryExpression(left: Literal(value: "
+              "a), operation: MULTIPLICATION, right: Literal(value: 2)), "
+              "operation: ADDITION, right: Literal(value: 1))");
+    EXPECT_EQ(interner.requested(), 10);
+    EXPECT_EQ(interner.created(), 5);
+}
+
+TEST(ExpressionInterner, OperatorsAndOperandOrderMatter) {
+    ExpressionInterner interner;
+    const auto one = interner.literal(std::int64_t{1});
+    const auto two = interner.literal(std::int64_t{2});
+
+    EXPECT_NE(interner.binary(one, Operator::Type::SUBTRACTION, two),
+              interner.binary(two, Operator::Type::SUBTRACTION, one));
+    EXPECT_NE(interner.binary(one, Operator::Type::ADDITION, two),
+              interner.binary(one, Operator::Type::MULTIPLICATION, two));
+    EXPECT_NE(interner.unary(Operator::Type::UNARY_MINUS, one),
+              interner.unary(Operator::Type::BITWISE_NOT, one));
+    EXPECT_EQ(interner.unary(Operator::Type::UNARY_MINUS, one),
+              interner.unary(Operator::Type::UNARY_MINUS, one));
+}
+
+TEST(ExpressionInterner, ConcurrentRequestsAgree) {
+    ExpressionInterner interner;
+    std::vector<frontend::ast::ExpressionPtr> results(8);
+
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            threads.emplace_back([&, i]() {
+                for (std::int64_t value = 0; value < 1000; ++value) {
+                    results[i] = interner.binary(
+                        interner.literal(value), Operator::Type::ADDITION,
+                        interner.literal(value % 7));
+                }
+            });
+        }
+    }
+
+    for (const auto& result : results) {
+        EXPECT_EQ(result, results.front());
+    }
+    EXPECT_EQ(interner.requested(), 8 * 1000 * 3);
+    EXPECT_EQ(interner.created(), 2000);
+}
+
+} // namespace
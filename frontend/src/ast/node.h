@@ -1,33 +1,67 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <format>
+#include <limits>
+#include <functional>
+#include <iterator>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include <gsl/pointers>
 
+#include "ast/number.h"
 #include "ast/operator.h"
+#include "ast/visitor.h"
 
 namespace frontend::ast {
 
 class Node {
 public:
-    virtual std::string to_string() const = 0;
+    std::string to_string() const {
+        std::string out;
+        print(out);
+        return out;
+    }
+
+    // Appends to_string() to `out`. Printing into one buffer keeps deep
+    // trees linear, where formatting every subtree into a string of its own
+    // copies each level again in its parent.
+    virtual void print(std::string& out) const = 0;
+    virtual void accept(Visitor& visitor) const = 0;
     virtual ~Node() = default;
 };
 
 class Expression : public Node {};
 
+// Expressions are immutable once built, so one subtree may have several
+// parents, e.g. when the parser hash-conses them.
+using ExpressionPtr = std::shared_ptr<const Expression>;
+
 template <typename T>
 struct Literal final : public Expression {
 public:
     constexpr Literal(T value) : value_(value) {}
 
-    std::string to_string() const override {
-        return std::vformat("Literal(value: {})",
-                            std::make_format_args(value_));
+    void print(std::string& out) const override {
+        if constexpr (std::is_same_v<T, double>) {
+            out += "Literal(value: ";
+            out += format_double(value_);
+            out += ')';
+        } else {
+            out += std::vformat("Literal(value: {})",
+                                std::make_format_args(value_));
+        }
+    }
+
+    void accept(Visitor& visitor) const override {
+        visitor.visit(*this);
     }
 
     T value_;
@@ -35,100 +69,288 @@ public:
 
 class UnaryExpression final : public Expression {
 public:
-    UnaryExpression(Operator::Type op, std::unique_ptr<Expression> operand)
+    UnaryExpression(Operator::Type op, ExpressionPtr operand)
         : operator_(op), operand_(gsl::make_not_null(std::move(operand))) {}
 
-    std::string to_string() const override {
-        return std::vformat(
-            "UnaryExpression(operator: {}, operand: {})",
-            std::make_format_args(operator_, operand_->to_string()));
+    void print(std::string& out) const override {
+        out += std::vformat("UnaryExpression(operator: {}, operand: ",
+                            std::make_format_args(operator_));
+        operand_->print(out);
+        out += ')';
+    }
+
+    void accept(Visitor& visitor) const override {
+        visitor.visit(*this);
+    }
+
+    Operator::Type op() const {
+        return operator_;
+    }
+
+    const Expression& operand() const {
+        return *operand_;
     }
 
 private:
     Operator::Type operator_;
-    gsl::not_null<std::unique_ptr<Expression>> operand_;
+    gsl::not_null<ExpressionPtr> operand_;
 };
 
 class BinaryExpression final : public Expression {
 public:
-    BinaryExpression(std::unique_ptr<Expression> left, Operator::Type op,
-                     std::unique_ptr<Expression> right)
+    BinaryExpression(ExpressionPtr left, Operator::Type op, ExpressionPtr right)
         : left_(gsl::make_not_null(std::move(left))), operator_(op),
           right_(gsl::make_not_null(std::move(right))) {}
 
-    std::string to_string() const override {
-        return std::vformat(
-            "BinaryExpression(left: {}, operation: {}, right: {})",
-            std::make_format_args(left_->to_string(), operator_,
-                                  right_->to_string()));
+    void print(std::string& out) const override {
+        out += "BinaryExpression(left: ";
+        left_->print(out);
+        out += std::vformat(", operation: {}, right: ",
+                            std::make_format_args(operator_));
+        right_->print(out);
+        out += ')';
+    }
+
+    void accept(Visitor& visitor) const override {
+        visitor.visit(*this);
+    }
+
+    const Expression& left() const {
+        return *left_;
+    }
+
+    Operator::Type op() const {
+        return operator_;
+    }
+
+    const Expression& right() const {
+        return *right_;
     }
 
 private:
-    gsl::not_null<std::unique_ptr<Expression>> left_;
+    gsl::not_null<ExpressionPtr> left_;
     Operator::Type operator_;
-    gsl::not_null<std::unique_ptr<Expression>> right_;
+    gsl::not_null<ExpressionPtr> right_;
+};
+
+// Slot of a name not bound by the resolver yet.
+inline constexpr std::uint32_t UNRESOLVED_SLOT =
+    std::numeric_limits<std::uint32_t>::max();
+
+// A use of a name. The resolver binds it to the slot of the declaration it
+// names, so that backends index a frame instead of looking names up. Never
+// hash-consed, as equal names may denote different declarations.
+class Identifier final : public Expression {
+public:
+    explicit Identifier(std::string_view name) : name_(name) {}
+
+    void print(std::string& out) const override {
+        out += "Identifier(name: ";
+        out += name_;
+        out += ')';
+    }
+
+    void accept(Visitor& visitor) const override {
+        visitor.visit(*this);
+    }
+
+    std::string_view name() const {
+        return name_;
+    }
+
+    // UNRESOLVED_SLOT until resolved
+    std::uint32_t slot() const {
+        return slot_;
+    }
+
+    // Set by the resolver, the only state of an expression that changes
+    // after it is built.
+    void bind(std::uint32_t slot) const {
+        slot_ = slot;
+    }
+
+private:
+    std::string_view name_;
+    mutable std::uint32_t slot_ = UNRESOLVED_SLOT;
 };
 
 struct Statement : public Node {};
 
+// Prints "None" for a missing node.
+inline void print(const Node* node, std::string& out) {
+    if (node != nullptr) {
+        node->print(out);
+    } else {
+        out += "None";
+    }
+}
+
 struct ExpressionStatement final : public Statement {
-    ExpressionStatement(std::unique_ptr<Expression> expression)
+    ExpressionStatement(ExpressionPtr expression)
         : expression_(std::move(expression)) {}
 
-    std::string to_string() const override {
-        return std::vformat("ExpressionStatement(expression: {})",
-                            std::make_format_args(expression_.get()));
+    void print(std::string& out) const override {
+        out += "ExpressionStatement(expression: ";
+        ast::print(expression_.get(), out);
+        out += ')';
+    }
+
+    void accept(Visitor& visitor) const override {
+        visitor.visit(*this);
     }
 
-    std::unique_ptr<Expression> expression_;
+    ExpressionPtr expression_;
 };
 
 class CompoundStatement final : public Statement {
 public:
-    CompoundStatement(std::vector<std::unique_ptr<Statement>>&& statements)
-        : statements_(std::move(statements)) {}
-
-    std::string to_string() const override {
-        std::string str;
-        if (!statements_.empty()) {
-            str = std::vformat(
-                "{}", std::make_format_args(statements_.front()->to_string()));
-            for (std::size_t i = 1; i < statements_.size(); ++i) {
-                str += std::vformat(
-                    ", {}", std::make_format_args(statements_[i]->to_string()));
+    using Statements = std::vector<std::unique_ptr<Statement>>;
+    using Loader = std::function<Statements()>;
+
+    CompoundStatement(Statements&& statements)
+        : loaded_(true), statements_(std::move(statements)) {}
+
+    // Lazy body: `loader` builds the statements the first time they are
+    // visited. A loader that throws is retried on the next visit.
+    explicit CompoundStatement(Loader loader) : loader_(std::move(loader)) {}
+
+    const Statements& statements() const {
+        if (!is_loaded()) {
+            std::call_once(load_once_, [this]() {
+                statements_ = loader_();
+                loader_ = nullptr;
+                loaded_.store(true, std::memory_order_release);
+            });
+        }
+        return statements_;
+    }
+
+    bool is_loaded() const {
+        return loaded_.load(std::memory_order_acquire);
+    }
+
+    // Replaces statements [first, first + count) with `replacement`.
+    void splice(std::size_t first, std::size_t count,
+                Statements&& replacement) {
+        // a lazy body has to be loaded before it can be edited
+        statements();
+        const auto begin =
+            statements_.begin() + static_cast<std::ptrdiff_t>(first);
+        const auto end = begin + static_cast<std::ptrdiff_t>(count);
+        const auto position = statements_.erase(begin, end);
+        statements_.insert(position,
+                           std::make_move_iterator(replacement.begin()),
+                           std::make_move_iterator(replacement.end()));
+    }
+
+    void print(std::string& out) const override {
+        const auto& statements = this->statements();
+        out += "CompoundStatement(statements: [";
+        for (std::size_t i = 0; i < statements.size(); ++i) {
+            if (i > 0) {
+                out += ", ";
             }
+            statements[i]->print(out);
         }
+        out += "])";
+    }
 
-        return std::vformat("CompoundStatement(statements: [{}])",
-                            std::make_format_args(str));
+    void accept(Visitor& visitor) const override {
+        visitor.visit(*this);
     }
 
+private:
+    mutable std::once_flag load_once_;
+    mutable std::atomic<bool> loaded_ = false;
+    mutable Loader loader_;
     // TODO: should be wrapped within gsl::not_null
-    std::vector<std::unique_ptr<Statement>> statements_;
+    mutable Statements statements_;
 };
 
 class IfStatement final : public Statement {
 public:
-    IfStatement(std::unique_ptr<Expression> condition,
-                std::unique_ptr<Statement> then,
+    IfStatement(ExpressionPtr condition, std::unique_ptr<Statement> then,
                 std::unique_ptr<Statement> else_stmt)
         : condition_(gsl::make_not_null(std::move(condition))),
           then_(gsl::make_not_null(std::move(then))),
           else_(std::move(else_stmt)) {}
 
-    std::string to_string() const override {
-        return std::vformat("IfStatement(condition: {}, then: {}, else: {})",
-                            std::make_format_args(condition_->to_string(),
-                                                  then_->to_string(),
-                                                  else_.get()));
+    void print(std::string& out) const override {
+        out += "IfStatement(condition: ";
+        condition_->print(out);
+        out += ", then: ";
+        then_->print(out);
+        out += ", else: ";
+        ast::print(else_.get(), out);
+        out += ')';
+    }
+
+    void accept(Visitor& visitor) const override {
+        visitor.visit(*this);
+    }
+
+    const Expression& condition() const {
+        return *condition_;
+    }
+
+    const Statement& then() const {
+        return *then_;
+    }
+
+    // nullptr without an else branch
+    const Statement* else_statement() const {
+        return else_.get();
     }
 
 private:
-    gsl::not_null<std::unique_ptr<Expression>> condition_;
+    gsl::not_null<ExpressionPtr> condition_;
     gsl::not_null<std::unique_ptr<Statement>> then_;
     std::unique_ptr<Statement> else_;
 };
 
+// `const name = initializer;`, binding the name in the rest of the
+// enclosing block.
+class ConstDeclaration final : public Statement {
+public:
+    ConstDeclaration(std::string_view name, ExpressionPtr initializer)
+        : name_(name),
+          initializer_(gsl::make_not_null(std::move(initializer))) {}
+
+    void print(std::string& out) const override {
+        out += "ConstDeclaration(name: ";
+        out += name_;
+        out += ", initializer: ";
+        initializer_->print(out);
+        out += ')';
+    }
+
+    void accept(Visitor& visitor) const override {
+        visitor.visit(*this);
+    }
+
+    std::string_view name() const {
+        return name_;
+    }
+
+    const Expression& initializer() const {
+        return *initializer_;
+    }
+
+    // UNRESOLVED_SLOT until resolved
+    std::uint32_t slot() const {
+        return slot_;
+    }
+
+    void bind(std::uint32_t slot) const {
+        slot_ = slot;
+    }
+
+private:
+    std::string_view name_;
+    gsl::not_null<ExpressionPtr> initializer_;
+    mutable std::uint32_t slot_ = UNRESOLVED_SLOT;
+};
+
 } // namespace frontend::ast
 
 template <>
@@ -148,6 +370,16 @@ struct std::formatter<frontend::ast::Expression*>
     }
 };
 
+template <>
+struct std::formatter<const frontend::ast::Expression*>
+    : std::formatter<std::string> {
+    auto format(const frontend::ast::Expression* expr,
+                std::format_context& ctx) const {
+        return std::formatter<std::string>::format(
+            expr ? expr->to_string() : "None", ctx);
+    }
+};
+
 template <>
 struct std::formatter<frontend::ast::Statement*>
     : std::formatter<frontend::ast::Node*> {
@@ -1,3 +1,4 @@
+#include <cstdint>
 #include <memory>
 
 #include <gsl/pointers>
@@ -21,6 +22,13 @@ TEST(Node, CreateLiteral) {
     EXPECT_DOUBLE_EQ(num->value_, 3.14);
 }
 
+TEST(Node, DoubleLiteralsPrintApartFromIntegers) {
+    EXPECT_EQ(Double(1.0).to_string(), "Literal(value: 1.0)");
+    EXPECT_EQ(Double(2.5).to_string(), "Literal(value: 2.5)");
+    EXPECT_EQ(frontend::ast::Literal<std::int64_t>(1).to_string(),
+              "Literal(value: 1)");
+}
+
 TEST(Node, CreateUnaryExpression) {
     auto op = frontend::ast::Operator::Type::UNARY_PLUS;
     auto operand = std::make_unique<Double>(3.15);
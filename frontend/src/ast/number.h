@@ -0,0 +1,19 @@
+#pragma once
+
+#include <format>
+#include <string>
+
+namespace frontend::ast {
+
+// The shortest text that reads back as `value`, with a fractional part where
+// it would otherwise look like an integer: 1.0 prints as "1.0", not "1".
+inline std::string format_double(double value) {
+    auto text = std::vformat("{}", std::make_format_args(value));
+    // an exponent, inf and nan are never read as integers either
+    if (text.find_first_of(".en") == std::string::npos) {
+        text += ".0";
+    }
+    return text;
+}
+
+} // namespace frontend::ast
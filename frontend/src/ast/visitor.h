@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace frontend::ast {
+
+template <typename T>
+struct Literal;
+class UnaryExpression;
+class BinaryExpression;
+class Identifier;
+struct ExpressionStatement;
+class CompoundStatement;
+class IfStatement;
+class ConstDeclaration;
+
+// Double dispatch over the concrete node types, see Node::accept().
+class Visitor {
+public:
+    virtual void visit(const Literal<bool>& literal) = 0;
+    virtual void visit(const Literal<std::int64_t>& literal) = 0;
+    virtual void visit(const Literal<double>& literal) = 0;
+    virtual void visit(const Literal<std::string_view>& literal) = 0;
+    virtual void visit(const UnaryExpression& expression) = 0;
+    virtual void visit(const BinaryExpression& expression) = 0;
+    virtual void visit(const Identifier& identifier) = 0;
+    virtual void visit(const ExpressionStatement& statement) = 0;
+    virtual void visit(const CompoundStatement& statement) = 0;
+    virtual void visit(const IfStatement& statement) = 0;
+    virtual void visit(const ConstDeclaration& declaration) = 0;
+    virtual ~Visitor() = default;
+};
+
+} // namespace frontend::ast
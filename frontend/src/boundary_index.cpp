@@ -0,0 +1,73 @@
+#include "boundary_index.h"
+
+namespace frontend {
+
+std::vector<TokenRange>
+find_statement_boundaries(const std::vector<Token>& tokens,
+                          std::size_t begin) {
+    std::vector<TokenRange> ranges;
+    std::size_t end = tokens.size();
+    if (end > begin && tokens.back().type_ == Token::Type::END_OF_FILE) {
+        --end;
+    }
+
+    std::size_t statement_begin = begin;
+    std::size_t brace_depth = 0;
+    std::size_t paren_depth = 0;
+    for (std::size_t i = begin; i < end; ++i) {
+        bool terminates = false;
+        switch (tokens[i].type_) {
+            case Token::Type::LEFT_BRACE:
+                ++brace_depth;
+                break;
+            case Token::Type::RIGHT_BRACE:
+                if (brace_depth > 0) {
+                    --brace_depth;
+                }
+                terminates = brace_depth == 0 && paren_depth == 0;
+                break;
+            case Token::Type::LEFT_PAREN:
+                ++paren_depth;
+                break;
+            case Token::Type::RIGHT_PAREN:
+                if (paren_depth > 0) {
+                    --paren_depth;
+                }
+                break;
+            case Token::Type::SEMICOLON:
+                terminates = brace_depth == 0 && paren_depth == 0;
+                break;
+            default:
+                break;
+        }
+
+        if (terminates &&
+            (i + 1 == end || tokens[i + 1].type_ != Token::Type::ELSE)) {
+            ranges.push_back({statement_begin, i + 1});
+            statement_begin = i + 1;
+        }
+    }
+
+    if (statement_begin < end) {
+        ranges.push_back({statement_begin, end});
+    }
+    return ranges;
+}
+
+std::vector<std::size_t> match_braces(const std::vector<Token>& tokens) {
+    std::vector<std::size_t> matches(tokens.size(), NO_MATCHING_BRACE);
+    std::vector<std::size_t> open_braces;
+    for (std::size_t i = 0; i < tokens.size(); ++i) {
+        if (tokens[i].type_ == Token::Type::LEFT_BRACE) {
+            open_braces.push_back(i);
+        } else if (tokens[i].type_ == Token::Type::RIGHT_BRACE &&
+                   !open_braces.empty()) {
+            matches[i] = open_braces.back();
+            matches[open_braces.back()] = i;
+            open_braces.pop_back();
+        }
+    }
+    return matches;
+}
+
+} // namespace frontend
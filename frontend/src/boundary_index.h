@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "token.h"
+
+namespace frontend {
+
+// Half-open range of token indices.
+struct TokenRange {
+    std::size_t begin;
+    std::size_t end;
+
+    bool operator==(const TokenRange& other) const = default;
+};
+
+// Splits `tokens` into the ranges of its top-level statements without parsing
+// them: a statement ends at a `;` or a closing `}` at brace and paren depth 0,
+// unless the next token is an `else` continuing an if-statement. Trailing
+// tokens without a terminator form a final, incomplete range. The END_OF_FILE
+// marker is never part of a range.
+std::vector<TokenRange>
+find_statement_boundaries(const std::vector<Token>& tokens,
+                          std::size_t begin = 0);
+
+inline constexpr std::size_t NO_MATCHING_BRACE =
+    std::numeric_limits<std::size_t>::max();
+
+// For every LEFT_BRACE/RIGHT_BRACE token, the index of its partner;
+// NO_MATCHING_BRACE for unbalanced braces and all other tokens.
+std::vector<std::size_t> match_braces(const std::vector<Token>& tokens);
+
+} // namespace frontend
@@ -0,0 +1,56 @@
+#include <cstddef>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "boundary_index.h"
+#include "scanner.h"
+
+namespace {
+
+using frontend::TokenRange;
+
+std::vector<TokenRange> boundaries_of(const char* source) {
+    return frontend::find_statement_boundaries(
+        frontend::Scanner(source).scan_tokens());
+}
+
+TEST(BoundaryIndex, EmptyInput) {
+    EXPECT_TRUE(boundaries_of("").empty());
+}
+
+TEST(BoundaryIndex, ExpressionStatements) {
+    const std::vector<TokenRange> expected{{0, 4}, {4, 5}, {5, 7}};
+
+    EXPECT_EQ(boundaries_of("1 + 2; ; 3;"), expected);
+}
+
+TEST(BoundaryIndex, CompoundStatementsEndAtMatchingBrace) {
+    const std::vector<TokenRange> expected{{0, 2}, {2, 10}, {10, 12}};
+
+    EXPECT_EQ(boundaries_of("{} { 1; { 2; } } 3;"), expected);
+}
+
+TEST(BoundaryIndex, ElseContinuesIfStatement) {
+    const std::vector<TokenRange> expected{{0, 18}, {18, 20}};
+
+    EXPECT_EQ(boundaries_of("if (1) 2; else if (3) { 4; } else 5; 6;"),
+              expected);
+}
+
+TEST(BoundaryIndex, UnterminatedTrailingStatement) {
+    const std::vector<TokenRange> expected{{0, 2}, {2, 5}};
+
+    EXPECT_EQ(boundaries_of("1; { 2;"), expected);
+}
+
+TEST(BoundaryIndex, MatchBraces) {
+    constexpr auto NONE = frontend::NO_MATCHING_BRACE;
+    const std::vector<std::size_t> expected{5, NONE, NONE, 4, 3, 0, NONE, NONE};
+
+    EXPECT_EQ(frontend::match_braces(
+                  frontend::Scanner("{ 1; { } } {").scan_tokens()),
+              expected);
+}
+
+} // namespace
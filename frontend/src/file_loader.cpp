@@ -0,0 +1,595 @@
+#include "file_loader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <future>
+#include <initializer_list>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+#include "thread_pool.h"
+
+namespace frontend {
+
+class FileLoader::Backend {
+public:
+    virtual ~Backend() = default;
+
+    // Starts reading `path`, which outlives the backend.
+    virtual void start(std::size_t index, const std::string& path) = 0;
+    // Hands the started work over without blocking.
+    virtual void submit() = 0;
+    // Blocks until the file started as `index` is read.
+    virtual LoadedFile finish(std::size_t index) = 0;
+
+    virtual std::string_view name() const = 0;
+};
+
+namespace {
+
+constexpr int CLOSED = -1;
+constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+
+std::string describe_error(std::string_view action, const std::string& path,
+                           int error) {
+    const std::string reason = std::strerror(error);
+    return std::vformat("Cannot {} {}: {}",
+                        std::make_format_args(action, path, reason));
+}
+
+// Appends everything up to the end of `fd`, for pipes and other files
+// without a size. Returns 0 or the errno of the failed read.
+int read_all(int fd, std::string& out) {
+    for (;;) {
+        const auto size = out.size();
+        out.resize(size + CHUNK_SIZE);
+        const auto count = read(fd, out.data() + size, CHUNK_SIZE);
+        if (count < 0 && errno == EINTR) {
+            out.resize(size);
+            continue;
+        }
+        out.resize(size +
+                   static_cast<std::size_t>(std::max(count, ssize_t{0})));
+        if (count <= 0) {
+            return count < 0 ? errno : 0;
+        }
+    }
+}
+
+// Reads `size` bytes from the start of `fd` into `out`, fewer if the file
+// shrank meanwhile. Returns 0 or the errno of the failed read.
+int read_sized(int fd, std::size_t size, std::string& out) {
+    out.resize(size);
+    std::size_t done = 0;
+    while (done < size) {
+        const auto count = pread(fd, out.data() + done, size - done,
+                                 static_cast<off_t>(done));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            out.resize(done);
+            return count < 0 ? errno : 0;
+        }
+        done += static_cast<std::size_t>(count);
+    }
+    return 0;
+}
+
+LoadedFile load_blocking(const std::string& path) {
+    LoadedFile file{.path = path};
+    const auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        file.error = describe_error("open", path, errno);
+        return file;
+    }
+    struct stat status {};
+    const auto error =
+        fstat(fd, &status) == 0 && S_ISREG(status.st_mode)
+            ? read_sized(fd, static_cast<std::size_t>(status.st_size),
+                         file.contents)
+            : read_all(fd, file.contents);
+    if (error != 0) {
+        file.contents.clear();
+        file.error = describe_error("read", path, error);
+    }
+    close(fd);
+    return file;
+}
+
+// Blocking open, fstat and pread of every file on a thread of a pool.
+class PreadBackend final : public FileLoader::Backend {
+public:
+    explicit PreadBackend(std::size_t threads) : pool_(threads) {}
+
+    void start(std::size_t index, const std::string& path) override {
+        reads_.emplace(index,
+                       pool_.submit([&path]() { return load_blocking(path); }));
+    }
+
+    void submit() override {}
+
+    LoadedFile finish(std::size_t index) override {
+        auto read = reads_.extract(index);
+        return read.mapped().get();
+    }
+
+    std::string_view name() const override {
+        return "pread";
+    }
+
+private:
+    // declared before the pool, whose workers are joined first
+    std::unordered_map<std::size_t, std::future<LoadedFile>> reads_;
+    ThreadPool pool_;
+};
+
+#if defined(__linux__)
+
+// A raw io_uring instance. Every file goes through an OPENAT and a STATX
+// submitted together, one READ of the whole file, sized by the STATX, and a
+// CLOSE nobody waits for.
+class IoUringBackend final : public FileLoader::Backend {
+public:
+    // nullptr if the kernel lacks io_uring or one of the operations, or if
+    // it is forbidden, as seccomp profiles of containers often do
+    static std::unique_ptr<IoUringBackend> create(std::size_t queue_depth) {
+        // two operations in flight per file, and room for the closes
+        auto entries = std::bit_ceil(std::clamp<std::size_t>(
+            queue_depth * RING_ENTRIES_PER_FILE, 8, MAX_RING_ENTRIES));
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        const auto fd = static_cast<int>(
+            syscall(__NR_io_uring_setup, static_cast<unsigned>(entries),
+                    &params));
+        if (fd < 0) {
+            return nullptr;
+        }
+        std::unique_ptr<IoUringBackend> backend(
+            new IoUringBackend(fd, params));
+        if (!backend->map() || !backend->supports_operations()) {
+            return nullptr;
+        }
+        return backend;
+    }
+
+    ~IoUringBackend() override {
+        // the kernel may still write into the buffers of abandoned files
+        while (in_flight_ > 0) {
+            if (!enter(unsubmitted_, 1)) {
+                break;
+            }
+            reap();
+        }
+        for (const auto& [index, file] : files_) {
+            if (file.fd != CLOSED) {
+                close(file.fd);
+            }
+        }
+        if (sqes_ != MAP_FAILED) {
+            munmap(sqes_, sqes_size_);
+        }
+        if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+            munmap(cq_ring_, cq_ring_size_);
+        }
+        if (sq_ring_ != MAP_FAILED) {
+            munmap(sq_ring_, sq_ring_size_);
+        }
+        close(ring_fd_);
+    }
+
+    void start(std::size_t index, const std::string& path) override {
+        auto& file = files_[index];
+        file.path = &path;
+
+        auto& open_sqe = next_sqe();
+        open_sqe.opcode = IORING_OP_OPENAT;
+        open_sqe.fd = AT_FDCWD;
+        open_sqe.addr = address(path.c_str());
+        open_sqe.open_flags = static_cast<std::uint32_t>(O_RDONLY | O_CLOEXEC);
+        open_sqe.user_data = user_data(index, OPEN);
+
+        auto& stat_sqe = next_sqe();
+        stat_sqe.opcode = IORING_OP_STATX;
+        stat_sqe.fd = AT_FDCWD;
+        stat_sqe.addr = address(path.c_str());
+        stat_sqe.len = STATX_TYPE | STATX_SIZE;
+        stat_sqe.off = address(&file.status);
+        stat_sqe.user_data = user_data(index, STAT);
+
+        file.pending = 2;
+    }
+
+    void submit() override {
+        reap();
+        if (unsubmitted_ > 0) {
+            enter(unsubmitted_, 0);
+        }
+    }
+
+    LoadedFile finish(std::size_t index) override {
+        const auto found = files_.find(index);
+        auto& file = found->second;
+        reap();
+        while (!file.is_complete()) {
+            if (!enter(unsubmitted_, 1)) {
+                const std::string reason = std::strerror(errno);
+                throw std::runtime_error(
+                    std::vformat("io_uring_enter failed: {}",
+                                 std::make_format_args(reason)));
+            }
+            reap();
+        }
+
+        LoadedFile loaded{.path = *file.path};
+        if (file.error != 0) {
+            loaded.error = describe_error(action_name(file.failed),
+                                          *file.path, file.error);
+        } else if (file.is_irregular()) {
+            if (const auto error = read_all(file.fd, file.contents);
+                error != 0) {
+                loaded.error = describe_error("read", *file.path, error);
+            }
+        }
+        if (loaded.error.empty()) {
+            loaded.contents = std::move(file.contents);
+        }
+        if (file.fd != CLOSED) {
+            // only still open for files read here
+            close(file.fd);
+        }
+        files_.erase(found);
+        return loaded;
+    }
+
+    std::string_view name() const override {
+        return "io_uring";
+    }
+
+private:
+    enum Operation : std::uint64_t { OPEN, STAT, READ, CLOSE };
+
+    static std::string_view action_name(Operation operation) {
+        switch (operation) {
+            case OPEN:
+                return "open";
+            case STAT:
+                return "stat";
+            default:
+                return "read";
+        }
+    }
+
+    struct File {
+        const std::string* path = nullptr;
+        int fd = CLOSED;
+        // operations in flight
+        int pending = 0;
+        bool opened = false;
+        bool stated = false;
+        bool read = false;
+        struct statx status {};
+        std::string contents;
+        std::size_t size = 0;
+        std::size_t done = 0;
+        int error = 0;
+        // the operation `error` is from
+        Operation failed = OPEN;
+
+        bool is_irregular() const {
+            return stated && !S_ISREG(status.stx_mode);
+        }
+
+        bool is_complete() const {
+            return pending == 0 &&
+                   (error != 0 || read || (opened && is_irregular()));
+        }
+    };
+
+    IoUringBackend(int fd, const io_uring_params& params)
+        : ring_fd_(fd), params_(params) {}
+
+    bool map() {
+        sq_ring_size_ = params_.sq_off.array +
+                        params_.sq_entries * sizeof(std::uint32_t);
+        cq_ring_size_ =
+            params_.cq_off.cqes + params_.cq_entries * sizeof(io_uring_cqe);
+        const bool single_mmap =
+            (params_.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) {
+            sq_ring_size_ = cq_ring_size_ =
+                std::max(sq_ring_size_, cq_ring_size_);
+        }
+        sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ring_fd_,
+                        static_cast<off_t>(IORING_OFF_SQ_RING));
+        if (sq_ring_ == MAP_FAILED) {
+            return false;
+        }
+        cq_ring_ = single_mmap
+                       ? sq_ring_
+                       : mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE, ring_fd_,
+                              static_cast<off_t>(IORING_OFF_CQ_RING));
+        sqes_size_ = params_.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, ring_fd_,
+                     static_cast<off_t>(IORING_OFF_SQES));
+        if (cq_ring_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+            return false;
+        }
+
+        const auto sq = [&](std::uint32_t offset) {
+            return reinterpret_cast<std::uint32_t*>(
+                static_cast<char*>(sq_ring_) + offset);
+        };
+        const auto cq = [&](std::uint32_t offset) {
+            return reinterpret_cast<std::uint32_t*>(
+                static_cast<char*>(cq_ring_) + offset);
+        };
+        sq_head_ = sq(params_.sq_off.head);
+        sq_tail_ = sq(params_.sq_off.tail);
+        sq_mask_ = *sq(params_.sq_off.ring_mask);
+        sq_array_ = sq(params_.sq_off.array);
+        cq_head_ = cq(params_.cq_off.head);
+        cq_tail_ = cq(params_.cq_off.tail);
+        cq_mask_ = *cq(params_.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(static_cast<char*>(cq_ring_) +
+                                                params_.cq_off.cqes);
+        return true;
+    }
+
+    bool supports_operations() const {
+        constexpr std::size_t OPERATIONS = 256;
+        std::vector<char> buffer(sizeof(io_uring_probe) +
+                                 OPERATIONS * sizeof(io_uring_probe_op));
+        auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+        if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_PROBE,
+                    probe, OPERATIONS) < 0) {
+            return false;
+        }
+        return std::ranges::all_of(
+            std::initializer_list<int>{IORING_OP_OPENAT, IORING_OP_STATX,
+                                       IORING_OP_READ, IORING_OP_CLOSE},
+            [&](int operation) {
+                return operation <= probe->last_op &&
+                       (probe->ops[operation].flags & IO_URING_OP_SUPPORTED);
+            });
+    }
+
+    static std::uint64_t address(const void* pointer) {
+        return reinterpret_cast<std::uintptr_t>(pointer);
+    }
+
+    static std::uint64_t user_data(std::size_t index, Operation operation) {
+        return std::uint64_t{index} << 2 | operation;
+    }
+
+    io_uring_sqe& next_sqe() {
+        auto tail = *sq_tail_;
+        const auto head = std::atomic_ref(*sq_head_).load(
+            std::memory_order_acquire);
+        if (tail - head == params_.sq_entries) {
+            // full, the kernel copies the entries out when they are submitted
+            enter(unsubmitted_, 0);
+        }
+        const auto slot = tail & sq_mask_;
+        auto& sqe = static_cast<io_uring_sqe*>(sqes_)[slot];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sq_array_[slot] = slot;
+        std::atomic_ref(*sq_tail_).store(++tail, std::memory_order_release);
+        ++unsubmitted_;
+        ++in_flight_;
+        return sqe;
+    }
+
+    // Submits `count` entries and waits for `wait` completions. False on
+    // errors other than interruptions.
+    bool enter(std::uint32_t count, std::uint32_t wait) {
+        for (;;) {
+            const auto submitted =
+                syscall(__NR_io_uring_enter, ring_fd_, count, wait,
+                        wait > 0 ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+            if (submitted >= 0) {
+                unsubmitted_ -= static_cast<std::uint32_t>(submitted);
+                return true;
+            }
+            if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                return false;
+            }
+        }
+    }
+
+    void reap() {
+        auto head = *cq_head_;
+        const auto tail =
+            std::atomic_ref(*cq_tail_).load(std::memory_order_acquire);
+        for (; head != tail; ++head) {
+            const auto& cqe = cqes_[head & cq_mask_];
+            --in_flight_;
+            complete(cqe.user_data >> 2,
+                     static_cast<Operation>(cqe.user_data & 3), cqe.res);
+        }
+        std::atomic_ref(*cq_head_).store(head, std::memory_order_release);
+    }
+
+    void complete(std::size_t index, Operation operation, int result) {
+        if (operation == CLOSE) {
+            return;
+        }
+        auto& file = files_.at(index);
+        --file.pending;
+        // the STATX of a missing file fails too, possibly first, but the
+        // failed open is what explains it
+        if (result < 0 &&
+            (file.error == 0 || (operation == OPEN && file.failed == STAT))) {
+            file.error = -result;
+            file.failed = operation;
+        }
+        if (result >= 0) {
+            switch (operation) {
+                case OPEN:
+                    file.fd = result;
+                    file.opened = true;
+                    break;
+                case STAT:
+                    file.stated = true;
+                    break;
+                default:
+                    file.done += static_cast<std::size_t>(result);
+                    // a short read continues, an empty one means the file
+                    // shrank since the STATX
+                    if (result == 0 || file.done == file.size) {
+                        file.contents.resize(file.done);
+                        file.read = true;
+                    }
+                    break;
+            }
+        }
+
+        if (file.pending > 0) {
+            return;
+        }
+        if (file.error == 0 && file.opened && file.stated &&
+            !file.is_irregular() && !file.read) {
+            if (operation != READ) {
+                file.size = static_cast<std::size_t>(file.status.stx_size);
+                file.contents.resize(file.size);
+                file.read = file.size == 0;
+            }
+            if (!file.read) {
+                submit_read(index, file);
+                return;
+            }
+        }
+        if (file.fd != CLOSED && (file.error != 0 || file.read)) {
+            auto& sqe = next_sqe();
+            sqe.opcode = IORING_OP_CLOSE;
+            sqe.fd = file.fd;
+            sqe.user_data = user_data(index, CLOSE);
+            file.fd = CLOSED;
+        }
+    }
+
+    void submit_read(std::size_t index, File& file) {
+        auto& sqe = next_sqe();
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = file.fd;
+        sqe.addr = address(file.contents.data() + file.done);
+        sqe.len = static_cast<std::uint32_t>(
+            std::min<std::size_t>(file.size - file.done, 1u << 30));
+        sqe.off = file.done;
+        sqe.user_data = user_data(index, READ);
+        ++file.pending;
+    }
+
+    int ring_fd_;
+    io_uring_params params_;
+    void* sq_ring_ = MAP_FAILED;
+    void* cq_ring_ = MAP_FAILED;
+    void* sqes_ = MAP_FAILED;
+    std::size_t sq_ring_size_ = 0;
+    std::size_t cq_ring_size_ = 0;
+    std::size_t sqes_size_ = 0;
+    std::uint32_t* sq_head_ = nullptr;
+    std::uint32_t* sq_tail_ = nullptr;
+    std::uint32_t sq_mask_ = 0;
+    std::uint32_t* sq_array_ = nullptr;
+    std::uint32_t* cq_head_ = nullptr;
+    std::uint32_t* cq_tail_ = nullptr;
+    std::uint32_t cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+    // entries written but not yet passed to io_uring_enter
+    std::uint32_t unsubmitted_ = 0;
+    // submitted or unsubmitted entries whose completion was not reaped
+    std::size_t in_flight_ = 0;
+    // node-based, the kernel writes into the status and contents of files
+    std::unordered_map<std::size_t, File> files_;
+};
+
+#endif
+
+} // namespace
+
+FileLoader::FileLoader(std::vector<std::string> paths,
+                       FileLoaderOptions options)
+    : paths_(std::move(paths)), options_(options) {
+    if (options_.queue_depth == 0) {
+        throw std::invalid_argument("The queue depth must be positive");
+    }
+    options_.queue_depth = std::min(options_.queue_depth, MAX_QUEUE_DEPTH);
+#if defined(__linux__)
+    if (options_.use_io_uring) {
+        backend_ = IoUringBackend::create(options_.queue_depth);
+    }
+#endif
+    if (backend_ == nullptr) {
+        constexpr std::size_t MAX_THREADS = 8;
+        backend_ = std::make_unique<PreadBackend>(
+            std::min(options_.queue_depth, MAX_THREADS));
+    }
+}
+
+FileLoader::~FileLoader() = default;
+
+std::optional<LoadedFile> FileLoader::next() {
+    if (next_ == paths_.size()) {
+        return std::nullopt;
+    }
+    fill_window();
+    const auto index = next_++;
+    LoadedFile file;
+    if (paths_[index] == "-") {
+        file.path = paths_[index];
+        if (const auto error = read_all(STDIN_FILENO, file.contents);
+            error != 0) {
+            file.error = describe_error("read", file.path, error);
+        }
+    } else {
+        file = backend_->finish(index);
+    }
+    // the following reads run while the caller works on this file
+    fill_window();
+    return file;
+}
+
+std::string_view FileLoader::backend() const {
+    return backend_->name();
+}
+
+void FileLoader::fill_window() {
+    // topped up once half of the window is used, so that files are started
+    // in batches rather than with a system call each; reads that follow the
+    // opens are submitted along with the next wait
+    if (started_ > next_ && started_ - next_ > options_.queue_depth / 2) {
+        return;
+    }
+    for (; started_ < paths_.size() &&
+           started_ < next_ + options_.queue_depth;
+         ++started_) {
+        if (paths_[started_] != "-") {
+            backend_->start(started_, paths_[started_]);
+        }
+    }
+    backend_->submit();
+}
+
+} // namespace frontend
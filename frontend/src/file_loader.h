@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace frontend {
+
+struct LoadedFile {
+    std::string path{};
+    std::string contents{};
+    // set instead of the contents when the file could not be read
+    std::string error{};
+};
+
+// An io_uring ring holds at most MAX_RING_ENTRIES submissions, and each file
+// in flight takes up to RING_ENTRIES_PER_FILE of them.
+inline constexpr std::size_t MAX_RING_ENTRIES = 4096;
+inline constexpr std::size_t RING_ENTRIES_PER_FILE = 4;
+inline constexpr std::size_t MAX_QUEUE_DEPTH =
+    MAX_RING_ENTRIES / RING_ENTRIES_PER_FILE;
+
+struct FileLoaderOptions {
+    // files read ahead of the one being processed, at most MAX_QUEUE_DEPTH;
+    // larger depths are clamped
+    std::size_t queue_depth = 64;
+    // io_uring where the kernel offers it, blocking reads on a small thread
+    // pool otherwise
+    bool use_io_uring = true;
+};
+
+// Reads a list of files ahead of the caller, keeping up to queue_depth of
+// them in flight, so that loading the next files overlaps with scanning and
+// parsing the current one. With io_uring the opens, stats and reads of a
+// window of files are submitted in batches with one system call and no
+// threads. Every file is read straight into the string that is handed out,
+// ready to be moved into a Scanner. "-" reads stdin when its turn comes.
+class FileLoader {
+public:
+    explicit FileLoader(std::vector<std::string> paths,
+                        FileLoaderOptions options = {});
+    ~FileLoader();
+
+    FileLoader(const FileLoader&) = delete;
+    FileLoader& operator=(const FileLoader&) = delete;
+
+    // The next file in the order of the paths, blocking until it is read;
+    // nullopt after the last one.
+    std::optional<LoadedFile> next();
+
+    // "io_uring" or "pread"
+    std::string_view backend() const;
+
+    class Backend;
+
+private:
+    void fill_window();
+
+    std::vector<std::string> paths_;
+    FileLoaderOptions options_;
+    std::unique_ptr<Backend> backend_;
+    // paths_[next_] is returned next, paths_[started_] is started next
+    std::size_t next_ = 0;
+    std::size_t started_ = 0;
+};
+
+} // namespace frontend
@@ -0,0 +1,157 @@
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "file_loader.h"
+
+namespace {
+
+using frontend::FileLoader;
+using frontend::FileLoaderOptions;
+
+// Fresh directory of sources per test.
+class FileLoaderTest : public testing::Test {
+protected:
+    FileLoaderTest()
+        : directory_(std::filesystem::temp_directory_path() /
+                     ("file-loader-test-" + std::to_string(::getpid()))) {
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_);
+    }
+
+    ~FileLoaderTest() override {
+        std::filesystem::remove_all(directory_);
+    }
+
+    std::string write(const std::string& name, const std::string& contents) {
+        const auto path = (directory_ / name).string();
+        std::ofstream(path, std::ios::binary) << contents;
+        return path;
+    }
+
+    std::filesystem::path directory_;
+};
+
+// Both backends, the io_uring one only where the kernel allows it.
+constexpr bool BACKENDS[] = {false, true};
+
+TEST_F(FileLoaderTest, ReadsFilesInOrder) {
+    std::vector<std::string> paths;
+    std::vector<std::string> sources;
+    for (int i = 0; i < 100; ++i) {
+        // empty, small and a few larger than a single read chunk
+        std::string source;
+        const auto statements = i % 10 == 0 ? 20000 : i;
+        for (int j = 0; j < statements; ++j) {
+            source += std::to_string(i) + " + " + std::to_string(j) + ";\n";
+        }
+        paths.push_back(write(std::to_string(i) + ".src", source));
+        sources.push_back(source);
+    }
+
+    for (const auto use_io_uring : BACKENDS) {
+        FileLoader loader(paths,
+                          {.queue_depth = 8, .use_io_uring = use_io_uring});
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            const auto file = loader.next();
+            ASSERT_TRUE(file.has_value());
+            EXPECT_EQ(file->path, paths[i]);
+            EXPECT_EQ(file->error, "");
+            EXPECT_EQ(file->contents, sources[i])
+                << loader.backend() << ": " << paths[i];
+        }
+        EXPECT_FALSE(loader.next().has_value());
+    }
+}
+
+TEST_F(FileLoaderTest, ReportsFilesThatCannotBeReadAndGoesOn) {
+    const auto missing = (directory_ / "missing.src").string();
+    const auto present = write("present.src", "1;");
+
+    for (const auto use_io_uring : BACKENDS) {
+        FileLoader loader({missing, present, directory_.string()},
+                          {.queue_depth = 4, .use_io_uring = use_io_uring});
+
+        const auto first = loader.next();
+        EXPECT_EQ(first->contents, "");
+        EXPECT_TRUE(first->error.starts_with("Cannot open " + missing))
+            << loader.backend() << ": " << first->error;
+        EXPECT_EQ(loader.next()->contents, "1;");
+        const auto directory = loader.next();
+        EXPECT_TRUE(directory->error.starts_with("Cannot read"))
+            << loader.backend() << ": " << directory->error;
+    }
+}
+
+TEST_F(FileLoaderTest, ReadsFilesWithoutASize) {
+    const auto source = write("a.src", "1;");
+
+    for (const auto use_io_uring : BACKENDS) {
+        FileLoader loader({"/dev/null", source},
+                          {.queue_depth = 2, .use_io_uring = use_io_uring});
+
+        const auto device = loader.next();
+        EXPECT_EQ(device->error, "");
+        EXPECT_EQ(device->contents, "");
+        EXPECT_EQ(loader.next()->contents, "1;");
+    }
+}
+
+TEST_F(FileLoaderTest, CanBeDestroyedWithReadsInFlight) {
+    std::vector<std::string> paths;
+    for (int i = 0; i < 50; ++i) {
+        const auto letter = static_cast<char>('a' + i % 26);
+        paths.push_back(
+            write(std::to_string(i) + ".src", std::string(10000, letter)));
+    }
+
+    for (const auto use_io_uring : BACKENDS) {
+        FileLoader loader(paths,
+                          {.queue_depth = 16, .use_io_uring = use_io_uring});
+        EXPECT_EQ(loader.next()->contents, std::string(10000, 'a'));
+    }
+}
+
+TEST_F(FileLoaderTest, ClampsTheQueueDepthToTheRing) {
+    std::vector<std::string> paths;
+    for (int i = 0; i < 50; ++i) {
+        paths.push_back(write(std::to_string(i) + ".src", std::to_string(i)));
+    }
+
+    // would overflow the ring, or the entry count computed from it
+    for (const auto depth :
+         {frontend::MAX_QUEUE_DEPTH + 1, std::size_t{1} << 62,
+          std::numeric_limits<std::size_t>::max()}) {
+        for (const auto use_io_uring : BACKENDS) {
+            FileLoader loader(
+                paths, {.queue_depth = depth, .use_io_uring = use_io_uring});
+            for (std::size_t i = 0; i < paths.size(); ++i) {
+                EXPECT_EQ(loader.next()->contents, std::to_string(i))
+                    << loader.backend() << ": " << depth;
+            }
+        }
+    }
+}
+
+TEST(FileLoader, FallsBackToPread) {
+    const FileLoader pread({}, {.use_io_uring = false});
+    EXPECT_EQ(pread.backend(), "pread");
+
+    // whichever the kernel allows
+    const FileLoader preferred({});
+    EXPECT_TRUE(preferred.backend() == "io_uring" ||
+                preferred.backend() == "pread");
+}
+
+TEST(FileLoader, RejectsAnEmptyQueue) {
+    EXPECT_THROW(FileLoader({}, {.queue_depth = 0}), std::invalid_argument);
+}
+
+} // namespace
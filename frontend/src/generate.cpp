@@ -0,0 +1,162 @@
+// Writes a seeded synthetic program of a given size, for stress tests and
+// benchmark corpora that need no checked-in data.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "program_generator.h"
+
+namespace {
+
+void print_usage() {
+    std::cerr
+        << "Usage: compiler-frontend-generate [--seed N] [--size BYTES[K|M|G]] "
+           "[-o OUTPUT]\n"
+           "           [--expression-depth N] [--nesting-depth N] "
+           "[--operators ADD,MUL,SHIFT,CMP]\n"
+           "           [--if-ratio R] [--else-ratio R] [--block-ratio R] "
+           "[--string-ratio R]\n"
+           "           [--float-ratio R] [--comment-ratio R] "
+           "[--declaration-ratio R]\n"
+           "           [--identifier-ratio R]\n"
+           "\n"
+           "The same options always produce the same program. Without "
+           "OUTPUT it is written\nto stdout.\n";
+}
+
+std::size_t parse_size(const std::string& text) {
+    std::size_t end = 0;
+    auto size = std::stoull(text, &end);
+    const auto suffix = std::string_view(text).substr(end);
+    if (suffix == "K") {
+        size <<= 10;
+    } else if (suffix == "M") {
+        size <<= 20;
+    } else if (suffix == "G") {
+        size <<= 30;
+    } else if (!suffix.empty()) {
+        throw std::invalid_argument(
+            std::vformat("Invalid size: {}", std::make_format_args(text)));
+    }
+    return size;
+}
+
+frontend::OperatorMix parse_operators(const std::string& text) {
+    std::vector<double> weights;
+    std::size_t begin = 0;
+    while (begin <= text.size()) {
+        const auto comma = std::min(text.find(',', begin), text.size());
+        weights.push_back(std::stod(text.substr(begin, comma - begin)));
+        begin = comma + 1;
+    }
+    if (weights.size() != 4) {
+        throw std::invalid_argument(std::vformat(
+            "Expected four operator weights: {}", std::make_format_args(text)));
+    }
+    return {.additive = weights[0],
+            .multiplicative = weights[1],
+            .shift = weights[2],
+            .comparison = weights[3]};
+}
+
+struct Options {
+    frontend::GeneratorOptions generator;
+    std::string output;
+};
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    auto& generator = options.generator;
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        const auto value = [&]() {
+            if (i + 1 >= args.size()) {
+                throw std::invalid_argument(std::vformat(
+                    "Missing value for {}", std::make_format_args(args[i])));
+            }
+            return std::string(args[++i]);
+        };
+        if (args[i] == "--help") {
+            print_usage();
+            std::exit(0);
+        } else if (args[i] == "--seed") {
+            generator.seed = std::stoull(value());
+        } else if (args[i] == "--size") {
+            generator.target_bytes = parse_size(value());
+        } else if (args[i] == "-o") {
+            options.output = value();
+        } else if (args[i] == "--expression-depth") {
+            generator.max_expression_depth = std::stoul(value());
+        } else if (args[i] == "--nesting-depth") {
+            generator.max_nesting_depth = std::stoul(value());
+        } else if (args[i] == "--operators") {
+            generator.operators = parse_operators(value());
+        } else if (args[i] == "--if-ratio") {
+            generator.if_ratio = std::stod(value());
+        } else if (args[i] == "--else-ratio") {
+            generator.else_ratio = std::stod(value());
+        } else if (args[i] == "--block-ratio") {
+            generator.block_ratio = std::stod(value());
+        } else if (args[i] == "--string-ratio") {
+            generator.string_ratio = std::stod(value());
+        } else if (args[i] == "--float-ratio") {
+            generator.float_ratio = std::stod(value());
+        } else if (args[i] == "--comment-ratio") {
+            generator.comment_ratio = std::stod(value());
+        } else if (args[i] == "--declaration-ratio") {
+            generator.declaration_ratio = std::stod(value());
+        } else if (args[i] == "--identifier-ratio") {
+            generator.identifier_ratio = std::stod(value());
+        } else {
+            throw std::invalid_argument(std::vformat(
+                "Unknown argument: {}", std::make_format_args(args[i])));
+        }
+    }
+    return options;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const auto options = parse_options(argc, argv);
+        std::ofstream file;
+        if (!options.output.empty()) {
+            file.open(options.output, std::ios::binary);
+            if (!file) {
+                throw std::runtime_error("Cannot write " + options.output);
+            }
+        }
+        auto& out = options.output.empty() ? std::cout : file;
+
+        // streamed a statement at a time, so that gigabytes need no memory
+        frontend::ProgramGenerator generator(options.generator);
+        std::size_t written = 0;
+        while (written < options.generator.target_bytes) {
+            const auto statement = generator.next_statement();
+            out << statement;
+            written += statement.size();
+        }
+        out.flush();
+        if (!out) {
+            throw std::runtime_error("Write failed");
+        }
+        return 0;
+    } catch (const std::invalid_argument& error) {
+        std::cerr << error.what() << '\n';
+        print_usage();
+        return 2;
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,263 @@
+#include "incremental_parser.h"
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <utility>
+
+#include "boundary_index.h"
+#include "lexicon.h"
+#include "parser.h"
+#include "scanner.h"
+
+namespace frontend {
+
+namespace {
+
+bool is_space(char c) {
+    return c == ' ' || c == '\r' || c == '\t' || c == '\n';
+}
+
+std::size_t shift(std::size_t offset, std::ptrdiff_t delta) {
+    return static_cast<std::size_t>(static_cast<std::ptrdiff_t>(offset) +
+                                    delta);
+}
+
+// Whether `tokens` consists of whole statements: braces and parens balance
+// and the last token is a statement terminator.
+bool ends_on_statement_boundary(const std::vector<Token>& tokens) {
+    // only END_OF_FILE
+    if (tokens.size() < 2) {
+        return true;
+    }
+
+    std::ptrdiff_t braces = 0;
+    std::ptrdiff_t parens = 0;
+    for (const auto& token : tokens) {
+        switch (token.type_) {
+            case Token::Type::LEFT_BRACE:
+                ++braces;
+                break;
+            case Token::Type::RIGHT_BRACE:
+                --braces;
+                break;
+            case Token::Type::LEFT_PAREN:
+                ++parens;
+                break;
+            case Token::Type::RIGHT_PAREN:
+                --parens;
+                break;
+            default:
+                break;
+        }
+    }
+
+    const auto last = tokens[tokens.size() - 2].type_;
+    return braces <= 0 && parens <= 0 &&
+           (last == Token::Type::SEMICOLON || last == Token::Type::RIGHT_BRACE);
+}
+
+// Whether the first token at or after `offset` is the `else` keyword.
+bool continues_with_else(const std::string& source, std::size_t offset) {
+    while (offset < source.size()) {
+        if (is_space(source[offset])) {
+            ++offset;
+        } else if (source.compare(offset, 2, "//") == 0) {
+            offset = std::min(source.find('\n', offset), source.size());
+        } else {
+            break;
+        }
+    }
+    return source.compare(offset, 4, "else") == 0 &&
+           (offset + 4 == source.size() ||
+            !is_alpha_numeric(source[offset + 4]));
+}
+
+} // namespace
+
+IncrementalParser::IncrementalParser(std::string source_code)
+    : source_code_(std::move(source_code)),
+      ast_(std::make_unique<ast::CompoundStatement>(
+               ast::CompoundStatement::Statements{}),
+           strings_) {
+    reparse({0, 0, 0, source_code_.size()}, 0, 0);
+}
+
+void IncrementalParser::apply(const Edit& edit) {
+    if (edit.offset > source_code_.size() ||
+        edit.removed_length > source_code_.size() - edit.offset) {
+        throw std::out_of_range("Edit is outside of the buffer");
+    }
+
+    const auto edit_end = edit.offset + edit.removed_length;
+    const auto delta = static_cast<std::ptrdiff_t>(edit.inserted_text.size()) -
+                       static_cast<std::ptrdiff_t>(edit.removed_length);
+    const auto count = statement_ends_.size();
+
+    // Statements whose bytes overlap the edit, including the ones ending or
+    // starting right at it: text inserted there may extend them.
+    Window window{0, count, 0, 0};
+    if (count != 0) {
+        // the first statement ending after `offset`, or at it if `inclusive`
+        const auto first_ending_after = [&](std::size_t offset,
+                                            bool inclusive) {
+            const auto indices = std::views::iota(std::size_t{0}, count);
+            return static_cast<std::size_t>(
+                std::ranges::partition_point(
+                    indices,
+                    [&](std::size_t i) {
+                        const auto end = statement_end(i).offset;
+                        return inclusive ? end < offset : end <= offset;
+                    }) -
+                indices.begin());
+        };
+        window.first =
+            std::min<std::size_t>(first_ending_after(edit.offset, true),
+                                  count - 1);
+        window.last = std::min<std::size_t>(
+            first_ending_after(edit_end, false) + 1, count);
+        window.begin =
+            window.first == 0 ? 0 : statement_end(window.first - 1).offset;
+    }
+
+    const auto removed_text =
+        source_code_.substr(edit.offset, edit.removed_length);
+    const auto line_delta =
+        std::ranges::count(edit.inserted_text, '\n') -
+        std::ranges::count(removed_text, '\n');
+    source_code_.replace(edit.offset, edit.removed_length, edit.inserted_text);
+    window.end = window.last == count
+                     ? source_code_.size()
+                     : shift(statement_end(window.last - 1).offset, delta);
+
+    try {
+        reparse(window, delta, line_delta);
+    } catch (...) {
+        source_code_.replace(edit.offset, edit.inserted_text.size(),
+                             removed_text);
+        throw;
+    }
+}
+
+void IncrementalParser::reparse(Window window, std::ptrdiff_t delta,
+                                std::ptrdiff_t line_delta) {
+    const auto count = statement_ends_.size();
+    while (true) {
+        const auto first_line =
+            window.first == 0 ? 1 : statement_end(window.first - 1).line;
+        std::vector<std::size_t> token_ends;
+        Scanner scanner(
+            source_code_.substr(window.begin, window.end - window.begin),
+            {.first_line = first_line});
+        auto tokens = scanner.scan_tokens(token_ends);
+
+        // An `else` at the start of the window continues the if-statement
+        // before it.
+        if (tokens.front().type_ == Token::Type::ELSE && window.first > 0) {
+            --window.first;
+            window.begin =
+                window.first == 0 ? 0 : statement_end(window.first - 1).offset;
+            continue;
+        }
+
+        // Anything but whitespace after the last token (a comment, an
+        // unterminated string) may swallow the text after the window.
+        const auto last_token_end =
+            window.begin +
+            (tokens.size() > 1 ? token_ends[tokens.size() - 2] : 0);
+        const bool clean =
+            std::all_of(source_code_.begin() +
+                            static_cast<std::ptrdiff_t>(last_token_end),
+                        source_code_.begin() +
+                            static_cast<std::ptrdiff_t>(window.end),
+                        is_space) &&
+            ends_on_statement_boundary(tokens) &&
+            !continues_with_else(source_code_, window.end);
+
+        if (!clean && window.last < count) {
+            ++window.last;
+            window.end = window.last == count
+                             ? source_code_.size()
+                             : shift(statement_end(window.last - 1).offset,
+                                     delta);
+            continue;
+        }
+
+        const auto boundaries = find_statement_boundaries(tokens);
+        std::vector<StatementEnd> new_ends;
+        new_ends.reserve(boundaries.size());
+        for (const auto& boundary : boundaries) {
+            // the scanner puts a token on the line it ends on
+            new_ends.push_back({
+                .offset = window.begin + token_ends[boundary.end - 1],
+                .line = tokens[boundary.end - 1].line_,
+            });
+        }
+        auto statements =
+            Parser(std::move(tokens), {.strings = strings_}).parse_statements();
+        if (statements.size() != boundaries.size()) {
+            throw std::logic_error(
+                "Statement boundaries do not match the parsed statements");
+        }
+
+        root().splice(window.first, window.last - window.first,
+                      std::move(statements));
+        // the statements after the window move by the edit, lazily
+        auto& ends = statement_ends_;
+        move_shift(window.last);
+        shift_ += delta;
+        line_shift_ += line_delta;
+        const auto position =
+            ends.erase(ends.begin() + static_cast<std::ptrdiff_t>(window.first),
+                       ends.begin() + static_cast<std::ptrdiff_t>(window.last));
+        ends.insert(position, new_ends.begin(), new_ends.end());
+        shifted_from_ = window.first + new_ends.size();
+
+        last_reparse_ = {
+            .relexed_bytes = window.end - window.begin,
+            .reparsed_statements = new_ends.size(),
+            .reused_statements = ends.size() - new_ends.size(),
+        };
+        return;
+    }
+}
+
+IncrementalParser::StatementEnd
+IncrementalParser::statement_end(std::size_t index) const {
+    auto end = statement_ends_[index];
+    if (index >= shifted_from_) {
+        end.offset = shift(end.offset, shift_);
+        end.line = shift(end.line, line_shift_);
+    }
+    return end;
+}
+
+void IncrementalParser::move_shift(std::size_t index) {
+    auto& ends = statement_ends_;
+    if (shifted_from_ >= ends.size()) {
+        // no end is pending
+        shift_ = 0;
+        line_shift_ = 0;
+        shifted_from_ = index;
+        return;
+    }
+    for (; shifted_from_ < index && shifted_from_ < ends.size();
+         ++shifted_from_) {
+        ends[shifted_from_].offset = shift(ends[shifted_from_].offset, shift_);
+        ends[shifted_from_].line = shift(ends[shifted_from_].line, line_shift_);
+    }
+    for (; shifted_from_ > index; --shifted_from_) {
+        auto& end = ends[shifted_from_ - 1];
+        end.offset = shift(end.offset, -shift_);
+        end.line = shift(end.line, -line_shift_);
+    }
+    shifted_from_ = index;
+}
+
+ast::CompoundStatement& IncrementalParser::root() {
+    return static_cast<ast::CompoundStatement&>(ast_.root());
+}
+
+} // namespace frontend
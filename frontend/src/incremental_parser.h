@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ast/ast.h"
+#include "ast/node.h"
+#include "string_pool.h"
+
+namespace frontend {
+
+// Replaces `removed_length` bytes at `offset` with `inserted_text`.
+struct Edit {
+    std::size_t offset;
+    std::size_t removed_length;
+    std::string inserted_text;
+};
+
+struct ReparseStats {
+    std::size_t relexed_bytes = 0;
+    std::size_t reparsed_statements = 0;
+    std::size_t reused_statements = 0;
+};
+
+// Keeps the tree of a buffer up to date across edits. Each top-level
+// statement remembers where it ends in the source; an edit relexes and
+// reparses only the statements it overlaps, widening the window while the
+// new text does not end cleanly on a statement boundary, and every other
+// statement subtree is reused as is. The ends after an edit are shifted
+// lazily, so the work per edit is proportional to the statements it touches
+// and the distance from the previous edit, not to the size of the buffer.
+class IncrementalParser {
+public:
+    explicit IncrementalParser(std::string source_code);
+
+    // Throws like Parser::parse() if the edited buffer does not parse, in
+    // which case the buffer and the tree are left unchanged.
+    void apply(const Edit& edit);
+
+    const std::string& source_code() const {
+        return source_code_;
+    }
+
+    const ast::AbstractSyntaxTree& ast() const {
+        return ast_;
+    }
+
+    const ReparseStats& last_reparse() const {
+        return last_reparse_;
+    }
+
+private:
+    // Statements [first, last) and the source bytes [begin, end) they span,
+    // leading whitespace and comments included.
+    struct Window {
+        std::size_t first;
+        std::size_t last;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    // Where a statement ends: offset one past its last token, and the line
+    // that offset is on.
+    struct StatementEnd {
+        std::size_t offset;
+        std::size_t line;
+    };
+
+    void reparse(Window window, std::ptrdiff_t delta,
+                 std::ptrdiff_t line_delta);
+    StatementEnd statement_end(std::size_t index) const;
+    // Moves the start of the pending shift to `index`, applying or undoing
+    // it for the ends in between.
+    void move_shift(std::size_t index);
+    ast::CompoundStatement& root();
+
+    std::string source_code_;
+    // string literals of every version of the tree
+    std::shared_ptr<StringPool> strings_ = std::make_shared<StringPool>();
+    ast::AbstractSyntaxTree ast_;
+    // of each top-level statement; the ones from shifted_from_ on are still
+    // to be moved by shift_ and line_shift_
+    std::vector<StatementEnd> statement_ends_;
+    std::size_t shifted_from_ = 0;
+    std::ptrdiff_t shift_ = 0;
+    std::ptrdiff_t line_shift_ = 0;
+    ReparseStats last_reparse_;
+};
+
+} // namespace frontend
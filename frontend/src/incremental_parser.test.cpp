@@ -0,0 +1,182 @@
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "incremental_parser.h"
+#include "parser.h"
+#include "scanner.h"
+
+namespace {
+
+using frontend::Edit;
+using frontend::IncrementalParser;
+
+std::string parse_from_scratch(const std::string& source) {
+    return frontend::Parser(frontend::Scanner(source).scan_tokens())
+        .parse()
+        .to_string();
+}
+
+void expect_matches_full_parse(const IncrementalParser& parser) {
+    EXPECT_EQ(parser.ast().to_string(),
+              parse_from_scratch(parser.source_code()));
+}
+
+std::string program(int statements) {
+    std::string source;
+    for (int i = 0; i < statements; ++i) {
+        source += "1 + 2;\nif (3) { 4; } else 5;\n";
+    }
+    return source;
+}
+
+TEST(IncrementalParser, InitialParse) {
+    IncrementalParser parser(program(3));
+
+    expect_matches_full_parse(parser);
+    EXPECT_EQ(parser.last_reparse().reparsed_statements, 6);
+}
+
+TEST(IncrementalParser, EditInsideStatementReusesTheRest) {
+    IncrementalParser parser(program(100));
+    const auto offset = parser.source_code().find("4;", 1000);
+
+    parser.apply({offset, 1, "40 * 2"});
+
+    expect_matches_full_parse(parser);
+    EXPECT_EQ(parser.last_reparse().reparsed_statements, 1);
+    EXPECT_EQ(parser.last_reparse().reused_statements, 199);
+}
+
+TEST(IncrementalParser, InsertNewStatements) {
+    IncrementalParser parser(program(2));
+
+    parser.apply({0, 0, "7; 8;\n"});
+
+    EXPECT_EQ(parser.source_code(), "7; 8;\n" + program(2));
+    expect_matches_full_parse(parser);
+}
+
+TEST(IncrementalParser, DeleteStatements) {
+    IncrementalParser parser(program(3));
+    const auto length = program(1).size();
+
+    parser.apply({length, length, ""});
+
+    EXPECT_EQ(parser.source_code(), program(2));
+    expect_matches_full_parse(parser);
+}
+
+TEST(IncrementalParser, ElseJoinsPrecedingIfStatement) {
+    IncrementalParser parser("if (1) 2; 3; 4;");
+
+    parser.apply({9, 0, " else"});
+
+    expect_matches_full_parse(parser);
+    EXPECT_EQ(parser.source_code(), "if (1) 2; else 3; 4;");
+}
+
+TEST(IncrementalParser, CommentSwallowsFollowingStatement) {
+    IncrementalParser parser("1; 2; 3;\n4;");
+
+    parser.apply({2, 0, "//"});
+
+    expect_matches_full_parse(parser);
+    EXPECT_EQ(parser.last_reparse().reused_statements, 0);
+}
+
+TEST(IncrementalParser, ElseAfterWhitespaceJoinsPrecedingIfStatement) {
+    IncrementalParser parser("if (1) { 2; } 3;\n4;");
+
+    parser.apply({14, 0, "else "});
+
+    expect_matches_full_parse(parser);
+    EXPECT_EQ(parser.last_reparse().reparsed_statements, 1);
+    EXPECT_EQ(parser.last_reparse().reused_statements, 1);
+}
+
+TEST(IncrementalParser, FailedEditLeavesBufferUnchanged) {
+    IncrementalParser parser(program(2));
+    const auto before = parser.ast().to_string();
+
+    EXPECT_THROW(parser.apply({4, 0, "("}), std::logic_error);
+
+    EXPECT_EQ(parser.source_code(), program(2));
+    EXPECT_EQ(parser.ast().to_string(), before);
+    parser.apply({0, 1, "9"});
+    expect_matches_full_parse(parser);
+}
+
+TEST(IncrementalParser, EditOutsideOfBuffer) {
+    IncrementalParser parser("1;");
+
+    EXPECT_THROW(parser.apply({3, 0, "2;"}), std::out_of_range);
+    EXPECT_THROW(parser.apply({1, 2, ""}), std::out_of_range);
+}
+
+TEST(IncrementalParser, EditsAllOverTheBufferKeepLineNumbers) {
+    IncrementalParser parser(program(20));
+
+    const auto statement_start = [&](int n) {
+        auto offset = parser.source_code().find("1 + 2;");
+        for (int i = 0; i < n; ++i) {
+            offset = parser.source_code().find("1 + 2;", offset + 1);
+        }
+        return offset;
+    };
+
+    // back and forth, so the pending shift of the later statements moves in
+    // both directions
+    for (const auto n : {12, 3, 8, 0, 19}) {
+        parser.apply({statement_start(n), 0, "\n7;\n\n"});
+        expect_matches_full_parse(parser);
+    }
+    parser.apply({statement_start(5), 0, "\n"});
+    parser.apply({parser.source_code().find("\n7;"), 3, ""});
+    expect_matches_full_parse(parser);
+
+    // the error names the line a full parse of the edited buffer would
+    auto edited = parser.source_code();
+    const auto offset = edited.rfind("1 + 2;");
+    edited.insert(offset, "(");
+    std::string expected;
+    try {
+        parse_from_scratch(edited);
+    } catch (const std::logic_error& error) {
+        expected = error.what();
+    }
+    ASSERT_FALSE(expected.empty());
+    try {
+        parser.apply({offset, 0, "("});
+        FAIL();
+    } catch (const std::logic_error& error) {
+        EXPECT_EQ(error.what(), expected);
+    }
+}
+
+TEST(IncrementalParser, SequenceOfKeystrokes) {
+    IncrementalParser parser(program(5));
+    const std::string typed = "if (6 << 1) { 7; } else { 8 == 9; }\n";
+    auto offset = program(2).size();
+
+    // intermediate states that do not parse are retried together with the
+    // next keystroke
+    std::string pending;
+    for (const char c : typed) {
+        pending += c;
+        try {
+            parser.apply({offset, 0, pending});
+        } catch (const std::logic_error&) {
+            continue;
+        }
+        offset += pending.size();
+        pending.clear();
+    }
+
+    EXPECT_TRUE(pending.empty());
+    EXPECT_EQ(parser.source_code(), program(2) + typed + program(3));
+    expect_matches_full_parse(parser);
+}
+
+} // namespace
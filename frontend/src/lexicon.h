@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include "token.h"
+
+namespace frontend {
+
+// Character classes and reserved words, shared by Scanner and the
+// compile-time scanner of static_program.h so that both read the same
+// language.
+
+constexpr bool is_alpha(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+constexpr bool is_digit(char c) {
+    return (c >= '0' && c <= '9');
+}
+
+constexpr bool is_alpha_numeric(char c) {
+    return is_alpha(c) || is_digit(c);
+}
+
+constexpr bool is_non_ascii(char c) {
+    return static_cast<unsigned char>(c) >= 0x80;
+}
+
+inline constexpr std::array<std::pair<std::string_view, Token::Type>, 12>
+    RESERVED_WORDS{{
+        {"const", Token::Type::CONST},   {"class", Token::Type::CLASS},
+        {"else", Token::Type::ELSE},     {"false", Token::Type::FALSE},
+        {"fun", Token::Type::FUN},       {"for", Token::Type::FOR},
+        {"if", Token::Type::IF},         {"or", Token::Type::OR},
+        {"return", Token::Type::RETURN}, {"this", Token::Type::THIS},
+        {"true", Token::Type::TRUE},     {"while", Token::Type::WHILE},
+    }};
+
+// The keyword `lexeme` spells, nullopt for identifiers.
+constexpr std::optional<Token::Type> reserved_word(std::string_view lexeme) {
+    for (const auto& [word, type] : RESERVED_WORDS) {
+        if (word == lexeme) {
+            return type;
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace frontend
@@ -1,3 +1,235 @@
-int main() {
-    return 0;
+#include <csignal>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "allocation_stats.h"
+#include "file_loader.h"
+#include "parser.h"
+#include "perf_counters.h"
+#include "scanner.h"
+#include "server/server.h"
+#include "statistics.h"
+#include "trace.h"
+
+namespace {
+
+void print_usage() {
+    std::cerr << "Usage: compiler-frontend-driver [--tokens | --ast | --check "
+                 "| --statistics]\n"
+                 "                                [--alloc-stats] "
+                 "[--perf-counters] [--trace OUTPUT]\n"
+                 "                                [--queue-depth N] [--pread] "
+                 "[FILE...]\n"
+                 "       compiler-frontend-driver --server [--socket PATH]\n"
+                 "\n"
+                 "Without files the source is read from stdin. In server mode "
+                 "framed requests are\nread from stdin, or from connections "
+                 "to the Unix domain socket at PATH, one per hardware thread "
+                 "at a time;\nfurther connections wait for one of those to "
+                 "be closed.\n"
+                 "--statistics prints one JSON object per file with token, "
+                 "node and operator\nhistograms and the depth of the "
+                 "tree.\n"
+                 "--alloc-stats reports the allocations of scanning, parsing "
+                 "and printing each\nfile on stderr, --perf-counters their "
+                 "IPC and branch and cache misses per\ntoken or AST node where "
+                 "hardware counters can be read. --trace writes a\nChrome "
+                 "trace of the frontend phases to OUTPUT, which Perfetto and "
+                 "chrome://tracing\nload.\n"
+                 "Files are read up to --queue-depth ahead, 64 by default and "
+                 "at most 1024, with\nio_uring where the kernel allows it or "
+                 "with blocking reads on a few threads with\n--pread.\n";
+}
+
+// Runs the frontend phases over `source` on their own and reports what each
+// of them allocates.
+void report_allocations(const std::string& file, std::string source) {
+    frontend::AllocationScope total;
+    const auto report = [&](std::string_view phase,
+                            const frontend::AllocationScope& scope) {
+        std::cerr << file << ": " << frontend::to_string(phase, scope.stats())
+                  << '\n';
+    };
+    try {
+        std::vector<frontend::Token> tokens;
+        {
+            frontend::AllocationScope scope;
+            tokens = frontend::Scanner(std::move(source)).scan_tokens();
+            report("scan", scope);
+        }
+        std::optional<frontend::ast::AbstractSyntaxTree> tree;
+        {
+            frontend::AllocationScope scope;
+            tree = frontend::Parser(std::move(tokens)).parse();
+            report("parse", scope);
+        }
+        {
+            frontend::AllocationScope scope;
+            const auto text = tree->to_string();
+            report("to_string", scope);
+        }
+    } catch (const std::exception&) {
+        // reported by the request that follows
+    }
+    report("total", total);
+}
+
+// Runs the frontend phases over `source` on their own and reports hardware
+// counters for each of them, normalised per token or AST node.
+void report_counters(const std::string& file, std::string source,
+                     frontend::PerfCounters& counters) {
+    try {
+        counters.start();
+        auto tokens = frontend::Scanner(std::move(source)).scan_tokens();
+        const auto scan = counters.stop();
+        const auto token_count = tokens.size();
+
+        counters.start();
+        const auto tree = frontend::Parser(std::move(tokens)).parse();
+        const auto parse = counters.stop();
+
+        counters.start();
+        const auto text = tree.to_string();
+        const auto print = counters.stop();
+
+        const auto node_count =
+            frontend::collect_statistics({}, {}, tree).node_count();
+        std::cerr << file << ": "
+                  << frontend::to_string("scan", scan, token_count, "token")
+                  << '\n'
+                  << file << ": "
+                  << frontend::to_string("parse", parse, node_count, "node")
+                  << '\n'
+                  << file << ": "
+                  << frontend::to_string("to_string", print, node_count,
+                                         "node")
+                  << '\n';
+    } catch (const std::exception&) {
+        // reported by the request that follows
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string command = "ast";
+    bool server_mode = false;
+    bool allocation_stats = false;
+    bool perf_counters = false;
+    std::string trace_path;
+    std::string socket_path;
+    frontend::FileLoaderOptions loader_options;
+    std::string queue_depth;
+    std::vector<std::string> files;
+
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        if (args[i] == "--tokens" || args[i] == "--ast" ||
+            args[i] == "--check" || args[i] == "--statistics") {
+            command = args[i].substr(2);
+        } else if (args[i] == "--alloc-stats") {
+            allocation_stats = true;
+        } else if (args[i] == "--perf-counters") {
+            perf_counters = true;
+        } else if (args[i] == "--trace" && i + 1 < args.size()) {
+            trace_path = args[++i];
+        } else if (args[i] == "--queue-depth" && i + 1 < args.size()) {
+            queue_depth = args[++i];
+        } else if (args[i] == "--pread") {
+            loader_options.use_io_uring = false;
+        } else if (args[i] == "--server") {
+            server_mode = true;
+        } else if (args[i] == "--socket" && i + 1 < args.size()) {
+            socket_path = args[++i];
+        } else if (args[i] == "--help" || args[i].starts_with("--")) {
+            print_usage();
+            return args[i] == "--help" ? 0 : 2;
+        } else {
+            files.emplace_back(args[i]);
+        }
+    }
+
+    frontend::server::CompileServer server;
+    try {
+        if (server_mode) {
+            // a client hanging up must not take the server down
+            std::signal(SIGPIPE, SIG_IGN);
+            if (socket_path.empty()) {
+                server.serve(STDIN_FILENO, STDOUT_FILENO);
+            } else {
+                server.serve_unix_socket(socket_path);
+            }
+            return 0;
+        }
+
+        if (files.empty()) {
+            files.emplace_back("-");
+        }
+        if (!trace_path.empty()) {
+            frontend::trace::start();
+        }
+        std::optional<frontend::PerfCounters> counters;
+        if (perf_counters) {
+            counters.emplace();
+            if (!counters->available()) {
+                std::cerr << "Hardware performance counters are unavailable\n";
+                counters.reset();
+            }
+        }
+        if (!queue_depth.empty()) {
+            loader_options.queue_depth = std::stoul(queue_depth);
+        }
+        int status = 0;
+        frontend::FileLoader loader(std::move(files), loader_options);
+        for (;;) {
+            std::optional<frontend::LoadedFile> loaded;
+            {
+                frontend::trace::Span load_span("load", "driver");
+                loaded = loader.next();
+            }
+            if (!loaded) {
+                break;
+            }
+            if (!loaded->error.empty()) {
+                throw std::runtime_error(loaded->error);
+            }
+            const auto& file = loaded->path;
+            frontend::trace::FileScope file_scope(file);
+            frontend::trace::Span span("file", "driver");
+            auto source = std::move(loaded->contents);
+            if (allocation_stats) {
+                report_allocations(file, source);
+            }
+            if (counters) {
+                report_counters(file, source, *counters);
+            }
+            const auto response = server.handle({command, std::move(source)});
+            if (response.kind != "ok") {
+                std::cerr << file << ": " << response.payload << '\n';
+                status = 1;
+                continue;
+            }
+            frontend::trace::Span output_span("output", "driver");
+            std::cout << response.payload;
+            if (!response.payload.empty() && response.payload.back() != '\n') {
+                std::cout << '\n';
+            }
+        }
+        if (!trace_path.empty()) {
+            frontend::trace::stop();
+            frontend::trace::write_chrome_json(trace_path);
+        }
+        return status;
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
 }
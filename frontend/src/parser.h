@@ -1,54 +1,217 @@
 #pragma once
 
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
 #include <format>
+#include <future>
 #include <initializer_list>
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <stdexcept>
+#include <string_view>
+#include <system_error>
 #include <utility>
 #include <vector>
 
 #include "ast/ast.h"
+#include "ast/interner.h"
 #include "ast/node.h"
 #include "ast/operator.h"
+#include "boundary_index.h"
+#include "scanner.h"
+#include "string_pool.h"
+#include "thread_pool.h"
 #include "token.h"
+#include "trace.h"
 
 namespace frontend {
 
+struct ParserOptions {
+    // When set, large inputs are split at top-level statement boundaries and
+    // the pieces are parsed concurrently on this pool.
+    ThreadPool* thread_pool = nullptr;
+    std::size_t min_parallel_tokens = 4096;
+    // Skip over `{ ... }` bodies and only parse them when first visited. The
+    // token vector is kept alive until every lazy body has been parsed, and
+    // syntax errors inside a body surface when it is visited.
+    bool lazy_compound_statements = false;
+    // When set, structurally identical expressions are created once through
+    // this interner and shared, across all files parsed with it.
+    std::shared_ptr<ast::ExpressionInterner> interner = nullptr;
+    // Storage for the string literals, deduplicating them across every file
+    // parsed with it; a fresh pool when unset. Must be the interner's pool
+    // if both are set.
+    std::shared_ptr<StringPool> strings = nullptr;
+};
+
 class Parser {
 public:
-    Parser(std::vector<Token> tokens) : tokens_(std::move(tokens)) {
-        if (tokens_.empty()) {
+    Parser(std::vector<Token> tokens, ParserOptions options = {})
+        : tokens_(std::make_shared<std::vector<Token>>(std::move(tokens))),
+          options_(std::move(options)) {
+        use_string_pool();
+        if (tokens_->empty()) {
             throw std::logic_error("Tokens were supplied");
         }
-        if (tokens_.back().type_ != Token::Type::END_OF_FILE) {
+        if (tokens_->back().type_ != Token::Type::END_OF_FILE) {
             throw std::logic_error("No final EOF marker");
         }
+        if (options_.lazy_compound_statements) {
+            brace_matches_ = std::make_shared<const std::vector<std::size_t>>(
+                match_braces(*tokens_));
+        }
+    }
+
+    // Consumes token batches from `ring` as they are produced, so parsing
+    // can start before the scanner has finished. Tokens are discarded once
+    // parsed, keeping the buffer bounded by the ring capacity.
+    Parser(TokenBatchRing& ring)
+        : tokens_(std::make_shared<std::vector<Token>>()), ring_(&ring) {
+        use_string_pool();
     }
 
     ast::AbstractSyntaxTree parse() {
+        trace::Span span("parse");
+        auto block = std::make_unique<ast::CompoundStatement>(
+            parse_statements());
+        return ast::AbstractSyntaxTree(std::move(block), options_.strings);
+    }
+
+    // The pool holding the string literals of the parsed statements.
+    const std::shared_ptr<StringPool>& strings() const {
+        return options_.strings;
+    }
+
+    // The top-level statements, without wrapping them into a tree. Their
+    // string literals live in strings().
+    std::vector<std::unique_ptr<ast::Statement>> parse_statements() {
+        const bool parallel = options_.thread_pool != nullptr &&
+                              ring_ == nullptr &&
+                              tokens_->size() >= options_.min_parallel_tokens;
+        return parallel ? parallel_statement_list(*options_.thread_pool)
+                        : statement_list();
+    }
+
+private:
+    using BraceMatches = std::shared_ptr<const std::vector<std::size_t>>;
+
+    // Parses only the tokens in [begin, end), sharing the token storage.
+    Parser(std::shared_ptr<std::vector<Token>> tokens,
+           BraceMatches brace_matches, TokenRange range, ParserOptions options)
+        : tokens_(std::move(tokens)), brace_matches_(std::move(brace_matches)),
+          options_(std::move(options)), current_(range.begin),
+          end_(range.end) {}
+
+    void use_string_pool() {
+        if (options_.interner != nullptr) {
+            if (options_.strings != nullptr &&
+                options_.strings != options_.interner->strings()) {
+                throw std::logic_error(
+                    "The parser and the interner must share a string pool");
+            }
+            options_.strings = options_.interner->strings();
+        } else if (options_.strings == nullptr) {
+            options_.strings = std::make_shared<StringPool>();
+        }
+    }
+
+    std::vector<std::unique_ptr<ast::Statement>> statement_list() {
         std::vector<std::unique_ptr<ast::Statement>> statements;
         while (!is_at_end()) {
             if (auto node = statement(); node != nullptr) {
                 statements.emplace_back(std::move(node));
             }
         }
-        auto block =
-            std::make_unique<ast::CompoundStatement>(std::move(statements));
-        return ast::AbstractSyntaxTree(std::move(block));
+        return statements;
     }
 
-private:
-    Token peek() const {
-        return tokens_.at(current_);
+    std::vector<std::unique_ptr<ast::Statement>>
+    parallel_statement_list(ThreadPool& pool) {
+        const auto boundaries = find_statement_boundaries(*tokens_);
+        if (boundaries.size() < 2) {
+            return statement_list();
+        }
+
+        // a few chunks per worker keeps the load balanced without paying for
+        // a task per statement
+        const auto chunk_count =
+            std::min(boundaries.size(), pool.size() * CHUNKS_PER_WORKER);
+        const auto tokens_per_chunk = boundaries.back().end / chunk_count;
+
+        using Statements = std::vector<std::unique_ptr<ast::Statement>>;
+        std::vector<std::future<Statements>> chunks;
+        std::size_t chunk_begin = 0;
+        for (const auto& boundary : boundaries) {
+            if (boundary.end - chunk_begin < tokens_per_chunk &&
+                boundary.end != boundaries.back().end) {
+                continue;
+            }
+            chunks.push_back(
+                pool.submit([tokens = tokens_, brace_matches = brace_matches_,
+                             range = TokenRange{chunk_begin, boundary.end},
+                             options = options_,
+                             file = trace::current_file()]() {
+                    trace::FileScope file_scope(file);
+                    trace::Span span("parse-chunk");
+                    return Parser(tokens, brace_matches, range, options)
+                        .statement_list();
+                }));
+            chunk_begin = boundary.end;
+        }
+
+        // joining in source order keeps the statement order and reports the
+        // first error a sequential parse would have hit
+        Statements statements;
+        for (auto& chunk : chunks) {
+            auto chunk_statements = chunk.get();
+            statements.insert(
+                statements.end(),
+                std::make_move_iterator(chunk_statements.begin()),
+                std::make_move_iterator(chunk_statements.end()));
+        }
+        return statements;
+    }
+
+    const Token& token_at(std::size_t index) {
+        while (index - base_ >= tokens_->size()) {
+            fetch_batch();
+        }
+        return (*tokens_)[index - base_];
+    }
+
+    void fetch_batch() {
+        std::vector<Token> batch;
+        if (ring_ == nullptr || !ring_->pop(batch)) {
+            throw std::logic_error("No final EOF marker");
+        }
+        // only the previous token may still be referenced
+        if (const auto keep_from = current_ > 0 ? current_ - 1 : 0;
+            keep_from > base_) {
+            const auto drop = std::min(keep_from - base_, tokens_->size());
+            tokens_->erase(tokens_->begin(),
+                           tokens_->begin() +
+                               static_cast<std::ptrdiff_t>(drop));
+            base_ += drop;
+        }
+        tokens_->insert(tokens_->end(),
+                        std::make_move_iterator(batch.begin()),
+                        std::make_move_iterator(batch.end()));
     }
 
-    Token previous() const {
-        return tokens_.at(current_ - 1);
+    const Token& peek() {
+        return token_at(current_);
     }
 
-    bool is_at_end() const {
-        return peek().type_ == Token::Type::END_OF_FILE;
+    const Token& previous() {
+        return token_at(current_ - 1);
+    }
+
+    bool is_at_end() {
+        return current_ >= end_ || peek().type_ == Token::Type::END_OF_FILE;
     }
 
     void advance() {
@@ -81,6 +244,10 @@ private:
     }
 
     std::unique_ptr<ast::Statement> statement() {
+        if (check(Token::Type::CONST)) {
+            return const_declaration();
+        }
+
         // selection-statement
         if (check(Token::Type::IF)) {
             return selection_statement();
@@ -94,24 +261,46 @@ private:
         return expression_statement();
     }
 
+    // const-declaration: `const` identifier `=` expression `;`
+    std::unique_ptr<ast::Statement> const_declaration() {
+        consume(Token::Type::CONST);
+        consume(Token::Type::IDENTIFIER);
+        const auto name = options_.strings->intern(previous().text());
+        consume(Token::Type::EQUAL);
+        auto initializer = expression();
+        if (initializer == nullptr) {
+            throw std::logic_error(std::vformat(
+                "Missing initializer of {}", std::make_format_args(name)));
+        }
+        consume(Token::Type::SEMICOLON);
+        return std::make_unique<ast::ConstDeclaration>(name,
+                                                       std::move(initializer));
+    }
+
     std::unique_ptr<ast::Statement> selection_statement() {
         consume(Token::Type::IF);
         consume(Token::Type::LEFT_PAREN);
         auto condition = expression();
+        if (condition == nullptr) {
+            throw std::logic_error("Missing condition of if statement");
+        }
         consume(Token::Type::RIGHT_PAREN);
         auto then = statement();
         std::unique_ptr<ast::Statement> else_stmt = nullptr;
         if (match({Token::Type::ELSE})) {
             else_stmt = statement();
-            if (else_stmt == nullptr) {
-                // TODO: error
-            }
         }
         return std::make_unique<ast::IfStatement>(
             std::move(condition), std::move(then), std::move(else_stmt));
     }
 
     std::unique_ptr<ast::Statement> compound_statement() {
+        if (brace_matches_ != nullptr) {
+            if (auto lazy = lazy_compound_statement(); lazy != nullptr) {
+                return lazy;
+            }
+        }
+
         std::vector<std::unique_ptr<ast::Statement>> statements;
         consume(Token::Type::LEFT_BRACE);
         while (!is_at_end() && !check(Token::Type::RIGHT_BRACE)) {
@@ -123,6 +312,22 @@ private:
         return std::make_unique<ast::CompoundStatement>(std::move(statements));
     }
 
+    std::unique_ptr<ast::Statement> lazy_compound_statement() {
+        const auto open = current_;
+        const auto close = (*brace_matches_)[open];
+        if (close == NO_MATCHING_BRACE || close >= end_) {
+            // let the eager path report the error
+            return nullptr;
+        }
+        current_ = close + 1;
+        return std::make_unique<ast::CompoundStatement>(
+            [tokens = tokens_, brace_matches = brace_matches_,
+             range = TokenRange{open + 1, close}, options = options_]() {
+                return Parser(tokens, brace_matches, range, options)
+                    .statement_list();
+            });
+    }
+
     std::unique_ptr<ast::Statement> expression_statement() {
         auto expr = expression();
         if (expr == nullptr) {
@@ -132,27 +337,27 @@ private:
         return std::make_unique<ast::ExpressionStatement>(std::move(expr));
     }
 
-    std::unique_ptr<ast::Expression> expression() {
+    ast::ExpressionPtr expression() {
         // TODO
         return equality_expression();
     }
 
-    std::unique_ptr<ast::Expression> bitwise_or_expression() {
+    ast::ExpressionPtr bitwise_or_expression() {
         // TODO
         return nullptr;
     }
 
-    std::unique_ptr<ast::Expression> bitwise_xor_expression() {
+    ast::ExpressionPtr bitwise_xor_expression() {
         // TODO
         return nullptr;
     }
 
-    std::unique_ptr<ast::Expression> bitwise_and_expression() {
+    ast::ExpressionPtr bitwise_and_expression() {
         // TODO
         return nullptr;
     }
 
-    std::unique_ptr<ast::Expression> equality_expression() {
+    ast::ExpressionPtr equality_expression() {
         auto expr = relational_expression();
         while (match({Token::Type::EQUAL_EQUAL, Token::Type::BANG_EQUAL})) {
             auto op = [&]() {
@@ -166,13 +371,12 @@ private:
                 }
             }();
             auto rhs = relational_expression();
-            expr = std::make_unique<ast::BinaryExpression>(std::move(expr), op,
-                                                           std::move(rhs));
+            expr = binary(std::move(expr), op, std::move(rhs));
         }
         return expr;
     }
 
-    std::unique_ptr<ast::Expression> relational_expression() {
+    ast::ExpressionPtr relational_expression() {
         auto expr = shift_expression();
         while (match({Token::Type::LESS, Token::Type::LESS_EQUAL,
                       Token::Type::GREATER, Token::Type::GREATER_EQUAL})) {
@@ -191,39 +395,36 @@ private:
                 }
             }();
             auto rhs = shift_expression();
-            expr = std::make_unique<ast::BinaryExpression>(std::move(expr), op,
-                                                           std::move(rhs));
+            expr = binary(std::move(expr), op, std::move(rhs));
         }
         return expr;
     }
 
-    std::unique_ptr<ast::Expression> shift_expression() {
+    ast::ExpressionPtr shift_expression() {
         auto expr = additive_expression();
         while (match({Token::Type::GREATER_GREATER, Token::Type::LESS_LESS})) {
             auto op = previous().type_ == Token::Type::GREATER_GREATER
                           ? ast::Operator::Type::BITWISE_RIGHT_SHIFT
                           : ast::Operator::Type::BITWISE_LEFT_SHIFT;
             auto rhs = additive_expression();
-            expr = std::make_unique<ast::BinaryExpression>(std::move(expr), op,
-                                                           std::move(rhs));
+            expr = binary(std::move(expr), op, std::move(rhs));
         }
         return expr;
     }
 
-    std::unique_ptr<ast::Expression> additive_expression() {
+    ast::ExpressionPtr additive_expression() {
         auto expr = multiplicative_expression();
         while (match({Token::Type::PLUS, Token::Type::MINUS})) {
             auto op = previous().type_ == Token::Type::PLUS
                           ? ast::Operator::Type::ADDITION
                           : ast::Operator::Type::SUBTRACTION;
             auto rhs = multiplicative_expression();
-            expr = std::make_unique<ast::BinaryExpression>(std::move(expr), op,
-                                                           std::move(rhs));
+            expr = binary(std::move(expr), op, std::move(rhs));
         }
         return expr;
     }
 
-    std::unique_ptr<ast::Expression> multiplicative_expression() {
+    ast::ExpressionPtr multiplicative_expression() {
         auto expr = primary_expression();
         while (match(
             {Token::Type::STAR, Token::Type::SLASH, Token::Type::PERCENT})) {
@@ -240,31 +441,36 @@ private:
                 }
             }();
             auto rhs = primary_expression();
-            expr = std::make_unique<ast::BinaryExpression>(std::move(expr), op,
-                                                           std::move(rhs));
+            expr = binary(std::move(expr), op, std::move(rhs));
         }
         return expr;
     }
 
-    std::unique_ptr<ast::Expression> primary_expression() {
-        using Bool = ast::Literal<bool>;
-        using String = ast::Literal<std::string>;
-
+    ast::ExpressionPtr primary_expression() {
         if (match({Token::Type::TRUE})) {
-            return std::make_unique<Bool>(true);
+            return literal(true);
         }
         if (match({Token::Type::FALSE})) {
-            return std::make_unique<Bool>(false);
+            return literal(false);
         }
 
-        if (match({Token::Type::STRING, Token::Type::NUMBER})) {
-            if (auto token = previous(); token.lexeme_.has_value()) {
-                return std::make_unique<String>(token.lexeme_.value());
+        if (match({Token::Type::NUMBER})) {
+            if (const auto& token = previous(); token.lexeme_.has_value()) {
+                return number_literal(*token.lexeme_);
             } else {
                 // TODO: error
             }
         }
 
+        if (match({Token::Type::STRING})) {
+            return string_literal(previous().text());
+        }
+
+        if (match({Token::Type::IDENTIFIER})) {
+            return std::make_shared<ast::Identifier>(
+                options_.strings->intern(previous().text()));
+        }
+
         if (match({Token::Type::LEFT_PAREN})) {
             auto inner_expression = expression();
             if (inner_expression == nullptr) {
@@ -277,9 +483,67 @@ private:
         return nullptr;
     }
 
+    // Integers without a fractional part, doubles otherwise or when they do
+    // not fit into 64 bits.
+    ast::ExpressionPtr number_literal(std::string_view lexeme) {
+        const auto* first = lexeme.data();
+        const auto* last = lexeme.data() + lexeme.size();
+        if (lexeme.find('.') == std::string_view::npos) {
+            std::int64_t value = 0;
+            if (const auto result = std::from_chars(first, last, value);
+                result.ec == std::errc() && result.ptr == last) {
+                return literal(value);
+            }
+        }
+        double value = 0;
+        std::from_chars(first, last, value);
+        return literal(value);
+    }
+
+    template <typename T>
+    ast::ExpressionPtr literal(T value) {
+        if (options_.interner != nullptr) {
+            return options_.interner->literal(std::move(value));
+        }
+        return std::make_shared<ast::Literal<T>>(std::move(value));
+    }
+
+    ast::ExpressionPtr string_literal(std::string_view text) {
+        if (options_.interner != nullptr) {
+            return options_.interner->literal(text);
+        }
+        return std::make_shared<ast::Literal<std::string_view>>(
+            options_.strings->intern(text));
+    }
+
+    ast::ExpressionPtr binary(ast::ExpressionPtr left, ast::Operator::Type op,
+                              ast::ExpressionPtr right) {
+        if (left == nullptr || right == nullptr) {
+            throw std::logic_error(std::vformat(
+                "Missing operand of {}", std::make_format_args(op)));
+        }
+        if (options_.interner != nullptr) {
+            return options_.interner->binary(std::move(left), op,
+                                             std::move(right));
+        }
+        return std::make_shared<ast::BinaryExpression>(std::move(left), op,
+                                                       std::move(right));
+    }
+
+    static constexpr std::size_t CHUNKS_PER_WORKER = 4;
+
+    // shared with sub-parsers working on ranges of the same tokens
+    std::shared_ptr<std::vector<Token>> tokens_;
+    // only present in lazy mode
+    BraceMatches brace_matches_;
+    ParserOptions options_;
+
     std::size_t current_ = 0;
-    std::vector<Token> tokens_;
-    // TODO: might need a symbol table? or hold it in the AST instead
+    // one past the last token this parser may consume
+    std::size_t end_ = std::numeric_limits<std::size_t>::max();
+    // index of tokens_->front() in the whole token stream
+    std::size_t base_ = 0;
+    TokenBatchRing* ring_ = nullptr;
 };
 
 } // namespace frontend
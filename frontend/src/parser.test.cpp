@@ -1,9 +1,14 @@
+#include <cstdint>
 #include <format>
+#include <memory>
+#include <stdexcept>
+#include <string>
 
 #include <gtest/gtest.h>
 
 #include "parser.h"
 #include "scanner.h"
+#include "thread_pool.h"
 
 namespace {
 
@@ -287,4 +292,199 @@ TEST(Parser, ParseDifferentTypesOfStatements) {
     );
 }
 
+TEST(Parser, ParallelParseMatchesSequentialParse) {
+    std::string source;
+    for (int i = 0; i < 300; ++i) {
+        source += "1 + 2 * 3; { 4; if (5) 6; else { 7 << 8; } } ;\n";
+        source += "if (1 == 2) 3; else if (4) { 5; }\n";
+    }
+    frontend::ThreadPool pool(3);
+    frontend::Parser sequential(frontend::Scanner(source).scan_tokens());
+    frontend::Parser parallel(
+        frontend::Scanner(source).scan_tokens(),
+        {.thread_pool = &pool, .min_parallel_tokens = 0});
+
+    EXPECT_EQ(parallel.parse().to_string(), sequential.parse().to_string());
+}
+
+TEST(Parser, ParallelParseReportsErrors) {
+    std::string source;
+    for (int i = 0; i < 100; ++i) {
+        source += "1; 2; 3;";
+    }
+    source += "(4;";
+    frontend::ThreadPool pool(2);
+    frontend::Parser parser(frontend::Scanner(source).scan_tokens(),
+                            {.thread_pool = &pool, .min_parallel_tokens = 0});
+
+    EXPECT_THROW(parser.parse(), std::logic_error);
+}
+
+TEST(Parser, MissingOperandsAreErrors) {
+    for (const char* source : {"1 +;", "* 2;", "(1 <<);"}) {
+        frontend::Parser parser(frontend::Scanner(source).scan_tokens());
+
+        EXPECT_THROW(parser.parse(), std::logic_error) << source;
+    }
+}
+
+TEST(Parser, MalformedIfStatementsAreErrors) {
+    // a missing condition must not reach IfStatement, whose not_null
+    // condition would terminate; the other forms fail to consume a token
+    for (const char* source :
+         {"if ()", "if () 1;", "if (1)", "if (1) 1; else", "if"}) {
+        frontend::Parser parser(frontend::Scanner(source).scan_tokens());
+
+        EXPECT_THROW(parser.parse(), std::logic_error) << source;
+    }
+}
+
+TEST(Parser, LazyParseMatchesEagerParse) {
+    const char* source = R"(
+        { 1; { 2 + 3; {} } }
+        if (4) { 5; } else { if (6) { 7; } }
+        8;
+    )";
+    frontend::Parser eager(frontend::Scanner(source).scan_tokens());
+    frontend::Parser lazy(frontend::Scanner(source).scan_tokens(),
+                          {.lazy_compound_statements = true});
+
+    EXPECT_EQ(lazy.parse().to_string(), eager.parse().to_string());
+}
+
+TEST(Parser, LazyBodiesAreParsedOnFirstVisit) {
+    frontend::Parser parser(frontend::Scanner("{ 1; { 2; } } 3;").scan_tokens(),
+                            {.lazy_compound_statements = true});
+    auto ast = parser.parse();
+    const auto& root =
+        dynamic_cast<const frontend::ast::CompoundStatement&>(ast.root());
+    ASSERT_EQ(root.statements().size(), 2);
+    const auto& body = dynamic_cast<const frontend::ast::CompoundStatement&>(
+        *root.statements().front());
+
+    EXPECT_FALSE(body.is_loaded());
+    ASSERT_EQ(body.statements().size(), 2);
+    EXPECT_TRUE(body.is_loaded());
+    const auto& inner = dynamic_cast<const frontend::ast::CompoundStatement&>(
+        *body.statements().back());
+    EXPECT_FALSE(inner.is_loaded());
+}
+
+TEST(Parser, LazyBodyErrorsSurfaceOnVisit) {
+    frontend::Parser parser(frontend::Scanner("{ (1; } 2;").scan_tokens(),
+                            {.lazy_compound_statements = true});
+
+    auto ast = parser.parse();
+
+    EXPECT_THROW(ast.to_string(), std::logic_error);
+}
+
+TEST(Parser, NumberLiteralTypes) {
+    frontend::Parser parser(
+        frontend::Scanner("42; 4.5; 99999999999999999999;").scan_tokens());
+    auto ast = parser.parse();
+    const auto& statements =
+        dynamic_cast<const frontend::ast::CompoundStatement&>(ast.root())
+            .statements();
+    const auto literal = [&](std::size_t index) {
+        return dynamic_cast<const frontend::ast::ExpressionStatement&>(
+                   *statements.at(index))
+            .expression_.get();
+    };
+
+    using Integer = const frontend::ast::Literal<std::int64_t>;
+    using Double = const frontend::ast::Literal<double>;
+
+    EXPECT_NE(dynamic_cast<Integer*>(literal(0)), nullptr);
+    EXPECT_NE(dynamic_cast<Double*>(literal(1)), nullptr);
+    // too large for 64 bits
+    EXPECT_NE(dynamic_cast<Double*>(literal(2)), nullptr);
+}
+
+TEST(Parser, ParseConstDeclarations) {
+    frontend::Scanner scanner("const x = 1 + 2; x * y;");
+    frontend::Parser parser(scanner.scan_tokens());
+
+    auto ast = parser.parse();
+
+    EXPECT_STREQ(ast.to_string().c_str(),
+                 // clang-format off
+        "AST(root: CompoundStatement(statements: ["
+            "ConstDeclaration(name: x, initializer: BinaryExpression("
+                "left: Literal(value: 1), "
+                "operation: ADDITION, "
+                "right: Literal(value: 2))), "
+            "ExpressionStatement(expression: BinaryExpression("
+                "left: Identifier(name: x), "
+                "operation: MULTIPLICATION, "
+                "right: Identifier(name: y)))]))"
+                 // clang-format on
+    );
+}
+
+TEST(Parser, MalformedDeclarationsAreErrors) {
+    for (const auto* source : {"const = 1;", "const x 1;", "const x = ;",
+                               "const x = 1", "const 1;"}) {
+        frontend::Parser parser(frontend::Scanner(source).scan_tokens());
+        EXPECT_THROW(parser.parse(), std::logic_error) << source;
+    }
+}
+
+TEST(Parser, HashConsingSharesEqualSubexpressions) {
+    const char* source = "1 * 2 + 3; if (1 * 2 + 3 > 0) { 1 * 2 + 3; }";
+    auto interner = std::make_shared<frontend::ast::ExpressionInterner>();
+    frontend::Parser plain(frontend::Scanner(source).scan_tokens());
+    frontend::Parser hash_consed(frontend::Scanner(source).scan_tokens(),
+                                 {.interner = interner});
+
+    EXPECT_EQ(hash_consed.parse().to_string(), plain.parse().to_string());
+    // 1, 2, *, 3, + three times, then 0 and >
+    EXPECT_EQ(interner->requested(), 17);
+    EXPECT_EQ(interner->created(), 7);
+}
+
+TEST(Parser, HashConsingCoversParallelAndLazyParses) {
+    std::string source;
+    for (int i = 0; i < 50; ++i) {
+        source += "{ 4 << 1; } 4 << 1;";
+    }
+    auto interner = std::make_shared<frontend::ast::ExpressionInterner>();
+    frontend::ThreadPool pool(3);
+    frontend::Parser parser(frontend::Scanner(source).scan_tokens(),
+                            {.thread_pool = &pool,
+                             .min_parallel_tokens = 0,
+                             .lazy_compound_statements = true,
+                             .interner = interner});
+
+    auto ast = parser.parse();
+    EXPECT_EQ(interner->requested(), 150);
+    ast.to_string();
+
+    EXPECT_EQ(interner->requested(), 300);
+    EXPECT_EQ(interner->created(), 3);
+}
+
+TEST(Parser, StringLiteralsAreDeduplicatedAcrossFiles) {
+    auto strings = std::make_shared<frontend::StringPool>();
+    const auto parse = [&](std::string source) {
+        return frontend::Parser(
+                   frontend::Scanner(std::move(source),
+                                     {.strings = strings.get()})
+                       .scan_tokens(),
+                   {.strings = strings})
+            .parse();
+    };
+
+    const auto first = parse(R"("a\tb"; "c";)");
+    const auto second = parse(R"("c"; "a\tb";)");
+
+    EXPECT_EQ(first.to_string(), "AST(root: CompoundStatement(statements: ["
+                                 "ExpressionStatement(expression: "
+                                 "Literal(value: a\tb)), "
+                                 "ExpressionStatement(expression: "
+                                 "Literal(value: c))]))");
+    EXPECT_EQ(strings->size(), 2);
+    EXPECT_EQ(strings->copied_bytes(), 3);
+}
+
 } // namespace
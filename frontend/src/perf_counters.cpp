@@ -0,0 +1,190 @@
+#include "perf_counters.h"
+
+#include <cmath>
+#include <cstring>
+#include <format>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace frontend {
+
+namespace {
+
+constexpr int CLOSED = -1;
+
+#if defined(__linux__)
+
+perf_event_attr attributes(PerfEvent event) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    constexpr auto read_misses = [](std::uint64_t cache) {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+               (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    };
+    switch (event) {
+        case PerfEvent::CYCLES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PerfEvent::INSTRUCTIONS:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PerfEvent::BRANCH_MISSES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case PerfEvent::L1D_READ_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = read_misses(PERF_COUNT_HW_CACHE_L1D);
+            break;
+        case PerfEvent::LLC_READ_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = read_misses(PERF_COUNT_HW_CACHE_LL);
+            break;
+    }
+    return attr;
+}
+
+int open_counter(PerfEvent event) {
+    auto attr = attributes(event);
+    // this thread, on any CPU
+    const auto fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    return fd < 0 ? CLOSED : static_cast<int>(fd);
+}
+
+std::optional<std::uint64_t> read_counter(int fd) {
+    struct {
+        std::uint64_t value;
+        std::uint64_t time_enabled;
+        std::uint64_t time_running;
+    } data;
+    if (read(fd, &data, sizeof(data)) != sizeof(data) ||
+        data.time_running == 0) {
+        return std::nullopt;
+    }
+    if (data.time_running == data.time_enabled) {
+        return data.value;
+    }
+    // the counter shared the PMU with others for part of the time
+    return static_cast<std::uint64_t>(
+        static_cast<double>(data.value) *
+        static_cast<double>(data.time_enabled) /
+        static_cast<double>(data.time_running));
+}
+
+#endif
+
+std::string format_ratio(std::optional<double> ratio) {
+    if (!ratio) {
+        return "n/a";
+    }
+    const auto rounded = std::round(*ratio * 100) / 100;
+    return std::vformat("{}", std::make_format_args(rounded));
+}
+
+} // namespace
+
+std::optional<double> PerfReading::ipc() const {
+    const auto cycles = (*this)[PerfEvent::CYCLES];
+    const auto instructions = (*this)[PerfEvent::INSTRUCTIONS];
+    if (!cycles || !instructions || *cycles == 0) {
+        return std::nullopt;
+    }
+    return static_cast<double>(*instructions) / static_cast<double>(*cycles);
+}
+
+std::optional<double> PerfReading::per(PerfEvent event,
+                                       std::size_t units) const {
+    const auto count = (*this)[event];
+    if (!count || units == 0) {
+        return std::nullopt;
+    }
+    return static_cast<double>(*count) / static_cast<double>(units);
+}
+
+PerfCounters::PerfCounters() {
+    for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+#if defined(__linux__)
+        fds_[i] = open_counter(static_cast<PerfEvent>(i));
+#else
+        fds_[i] = CLOSED;
+#endif
+    }
+}
+
+PerfCounters::~PerfCounters() {
+#if defined(__linux__)
+    for (const auto fd : fds_) {
+        if (fd != CLOSED) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+bool PerfCounters::available() const {
+    for (const auto fd : fds_) {
+        if (fd != CLOSED) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PerfCounters::start() {
+#if defined(__linux__)
+    for (const auto fd : fds_) {
+        if (fd != CLOSED) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+PerfReading PerfCounters::stop() {
+    PerfReading reading;
+#if defined(__linux__)
+    for (const auto fd : fds_) {
+        if (fd != CLOSED) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+        if (fds_[i] != CLOSED) {
+            reading.counts[i] = read_counter(fds_[i]);
+        }
+    }
+#endif
+    return reading;
+}
+
+std::string to_string(std::string_view phase, const PerfReading& reading,
+                      std::size_t units, std::string_view unit) {
+    const auto ipc = format_ratio(reading.ipc());
+    const auto branch_misses =
+        format_ratio(reading.per(PerfEvent::BRANCH_MISSES, units));
+    const auto l1d_misses =
+        format_ratio(reading.per(PerfEvent::L1D_READ_MISSES, units));
+    const auto llc_misses =
+        format_ratio(reading.per(PerfEvent::LLC_READ_MISSES, units));
+    return std::vformat(
+        "{}: {} IPC, {} branch misses, {} L1D misses, {} LLC misses per {}",
+        std::make_format_args(phase, ipc, branch_misses, l1d_misses,
+                              llc_misses, unit));
+}
+
+} // namespace frontend
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace frontend {
+
+// Hardware events counted by PerfCounters.
+enum class PerfEvent {
+    CYCLES,
+    INSTRUCTIONS,
+    BRANCH_MISSES,
+    L1D_READ_MISSES,
+    LLC_READ_MISSES,
+};
+
+inline constexpr std::size_t PERF_EVENT_COUNT = 5;
+
+// Counts of one measured region, nullopt for events that could not be
+// counted. Counts are scaled up when the kernel multiplexed the counter.
+struct PerfReading {
+    std::array<std::optional<std::uint64_t>, PERF_EVENT_COUNT> counts{};
+
+    std::optional<std::uint64_t> operator[](PerfEvent event) const {
+        return counts[static_cast<std::size_t>(event)];
+    }
+
+    // instructions per cycle
+    std::optional<double> ipc() const;
+    // `event` per unit of work, e.g. per token
+    std::optional<double> per(PerfEvent event, std::size_t units) const;
+};
+
+// Linux perf_event_open counters of the calling thread, in user space only.
+// Events the CPU, the kernel or its perf_event_paranoid setting do not allow
+// are left out rather than reported as errors; with none at all, e.g. in
+// most containers and on other platforms, every reading is empty.
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // whether at least one event is counted
+    bool available() const;
+
+    void start();
+    PerfReading stop();
+
+private:
+    std::array<int, PERF_EVENT_COUNT> fds_;
+};
+
+// One line such as "scan: 1.52 IPC, 0.01 branch misses, 0.12 L1D misses,
+// 0 LLC misses per token", with "n/a" for what was not counted.
+std::string to_string(std::string_view phase, const PerfReading& reading,
+                      std::size_t units, std::string_view unit);
+
+} // namespace frontend
@@ -0,0 +1,60 @@
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include <gtest/gtest.h>
+
+#include "perf_counters.h"
+
+namespace {
+
+using frontend::PerfCounters;
+using frontend::PerfEvent;
+using frontend::PerfReading;
+
+TEST(PerfCounters, ReadsWhatIsAvailable) {
+    PerfCounters counters;
+    counters.start();
+    volatile std::uint64_t sum = 0;
+    for (std::uint64_t i = 0; i < 100000; ++i) {
+        sum = sum + i;
+    }
+    const auto reading = counters.stop();
+
+    if (!counters.available()) {
+        // containers and VMs often have no PMU; nothing must be made up
+        for (const auto& count : reading.counts) {
+            EXPECT_FALSE(count.has_value());
+        }
+        GTEST_SKIP() << "no hardware counters";
+    }
+    if (const auto instructions = reading[PerfEvent::INSTRUCTIONS]) {
+        EXPECT_GT(*instructions, 100000);
+    }
+}
+
+TEST(PerfCounters, Ratios) {
+    PerfReading reading;
+    reading.counts[static_cast<std::size_t>(PerfEvent::CYCLES)] = 400;
+    reading.counts[static_cast<std::size_t>(PerfEvent::INSTRUCTIONS)] = 600;
+    reading.counts[static_cast<std::size_t>(PerfEvent::BRANCH_MISSES)] = 5;
+
+    EXPECT_EQ(reading.ipc(), 1.5);
+    EXPECT_EQ(reading.per(PerfEvent::BRANCH_MISSES, 20), 0.25);
+    EXPECT_EQ(reading.per(PerfEvent::BRANCH_MISSES, 0), std::nullopt);
+    EXPECT_EQ(reading.per(PerfEvent::LLC_READ_MISSES, 20), std::nullopt);
+    EXPECT_EQ(PerfReading().ipc(), std::nullopt);
+}
+
+TEST(PerfCounters, ToString) {
+    PerfReading reading;
+    reading.counts[static_cast<std::size_t>(PerfEvent::CYCLES)] = 300;
+    reading.counts[static_cast<std::size_t>(PerfEvent::INSTRUCTIONS)] = 400;
+    reading.counts[static_cast<std::size_t>(PerfEvent::L1D_READ_MISSES)] = 2;
+
+    EXPECT_EQ(frontend::to_string("scan", reading, 3, "token"),
+              "scan: 1.33 IPC, n/a branch misses, 0.67 L1D misses, n/a LLC "
+              "misses per token");
+}
+
+} // namespace
@@ -0,0 +1,397 @@
+#include "perf_fuzz.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <exception>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <utility>
+
+#include "allocation_stats.h"
+#include "parser.h"
+#include "scanner.h"
+#include "string_pool.h"
+
+namespace frontend {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::array<std::string_view, 5> PART_NAMES = {
+    "prefix", "left", "middle", "right", "suffix"};
+
+std::array<std::string*, 5> parts(PumpPattern& pattern) {
+    return {&pattern.prefix, &pattern.left, &pattern.middle, &pattern.right,
+            &pattern.suffix};
+}
+
+std::array<const std::string*, 5> parts(const PumpPattern& pattern) {
+    return {&pattern.prefix, &pattern.left, &pattern.middle, &pattern.right,
+            &pattern.suffix};
+}
+
+std::string escape(std::string_view text) {
+    std::string escaped;
+    for (const char c : text) {
+        switch (c) {
+            case '\n':
+                escaped += "\\n";
+                break;
+            case '\t':
+                escaped += "\\t";
+                break;
+            case '\r':
+                escaped += "\\r";
+                break;
+            case '\0':
+                escaped += "\\0";
+                break;
+            case '\\':
+            case '"':
+                escaped += '\\';
+                escaped += c;
+                break;
+            default:
+                escaped += c;
+                break;
+        }
+    }
+    return escaped;
+}
+
+// Repetitions for the largest of the compared inputs, 0 if the pattern does
+// not grow.
+std::size_t repetitions_for(const PumpPattern& pattern,
+                            std::size_t target_bytes) {
+    const auto unit = pattern.left.size() + pattern.right.size();
+    if (unit == 0) {
+        return 0;
+    }
+    const auto fixed =
+        pattern.prefix.size() + pattern.middle.size() + pattern.suffix.size();
+    const auto repetitions =
+        target_bytes > fixed ? (target_bytes - fixed) / unit : 0;
+    return std::max<std::size_t>(repetitions, 8);
+}
+
+// Slope of the least-squares line through the (log size, log cost) points.
+// A single sample can be off by up to a factor of two, vectors and strings
+// growing their capacity in steps, which the fit over several sizes evens
+// out.
+double fit_exponent(const std::vector<double>& sizes,
+                    const std::vector<double>& costs) {
+    double sum_x = 0;
+    double sum_y = 0;
+    double sum_xx = 0;
+    double sum_xy = 0;
+    for (std::size_t i = 0; i < sizes.size(); ++i) {
+        if (costs[i] <= 0) {
+            return 0;
+        }
+        const auto x = std::log(sizes[i]);
+        const auto y = std::log(costs[i]);
+        sum_x += x;
+        sum_y += y;
+        sum_xx += x * x;
+        sum_xy += x * y;
+    }
+    const auto n = static_cast<double>(sizes.size());
+    const auto denominator = n * sum_xx - sum_x * sum_x;
+    return denominator > 0 ? (n * sum_xy - sum_x * sum_y) / denominator : 0;
+}
+
+std::chrono::nanoseconds best_time(std::string_view input, std::size_t runs) {
+    auto best = std::chrono::nanoseconds::max();
+    for (std::size_t run = 0; run < std::max<std::size_t>(runs, 1); ++run) {
+        best = std::min(best, measure_cost(input).time);
+    }
+    return best;
+}
+
+// Token-sized pieces the fuzzer builds patterns from.
+constexpr std::array<std::string_view, 25> SNIPPETS = {
+    "1",    "2.5",  "true", "\"s\"", "+",    "-",      "*",
+    "/",    "%",    "<<",   ">>",    "<",    "==",     "!=",
+    "(",    ")",    "{",    "}",     ";",    "if (1)", "else",
+    " ",    "\n",   "// c\n", "\"",
+};
+
+class Fuzzer {
+public:
+    explicit Fuzzer(const PerfFuzzOptions& options)
+        : options_(options), random_(options.seed) {}
+
+    std::vector<PerfFuzzFinding> run() {
+        for (std::size_t i = 0; i < POPULATION; ++i) {
+            add(random_pattern());
+        }
+        for (std::size_t i = 0; i < options_.iterations; ++i) {
+            auto child = population_.empty()
+                             ? random_pattern()
+                             : population_[tournament()].pattern;
+            const auto mutations = 1 + below(3);
+            for (std::uint64_t m = 0; m < mutations; ++m) {
+                mutate(child);
+            }
+            add(std::move(child));
+        }
+        return std::move(findings_);
+    }
+
+private:
+    static constexpr std::size_t POPULATION = 32;
+
+    struct Member {
+        PumpPattern pattern;
+        double fitness = 0;
+    };
+
+    void add(PumpPattern pattern) {
+        if (pattern.left.empty() && pattern.right.empty()) {
+            return;
+        }
+        // the search only looks at allocations, which are deterministic
+        auto search = options_.growth;
+        search.measure_time = false;
+        const auto fitness =
+            measure_growth(pattern, search).allocation_exponent;
+        if (fitness > options_.exponent_limit) {
+            // reported, and kept out of the population so that the search
+            // moves on instead of rediscovering it
+            report(pattern);
+            return;
+        }
+
+        if (population_.size() < POPULATION) {
+            population_.push_back({std::move(pattern), fitness});
+            return;
+        }
+        const auto worst = std::min_element(
+            population_.begin(), population_.end(),
+            [](const Member& a, const Member& b) {
+                return a.fitness < b.fitness;
+            });
+        if (fitness >= worst->fitness) {
+            *worst = {std::move(pattern), fitness};
+        }
+    }
+
+    void report(const PumpPattern& pattern) {
+        auto search = options_.growth;
+        search.measure_time = false;
+        const auto limit = options_.exponent_limit;
+        auto minimal = minimise(pattern, [&](const PumpPattern& candidate) {
+            return measure_growth(candidate, search).allocation_exponent >
+                   limit;
+        });
+        if (!reported_.insert(minimal.serialize()).second) {
+            return;
+        }
+        auto growth = measure_growth(minimal, options_.growth);
+        findings_.push_back({std::move(minimal), growth});
+    }
+
+    std::size_t tournament() {
+        const auto a = below(population_.size());
+        const auto b = below(population_.size());
+        return population_[a].fitness >= population_[b].fitness ? a : b;
+    }
+
+    PumpPattern random_pattern() {
+        PumpPattern pattern;
+        for (auto* part : parts(pattern)) {
+            const auto snippets = below(3);
+            for (std::uint64_t i = 0; i < snippets; ++i) {
+                *part += snippet();
+            }
+        }
+        if (pattern.left.empty()) {
+            pattern.left = snippet();
+        }
+        return pattern;
+    }
+
+    void mutate(PumpPattern& pattern) {
+        auto& part = *parts(pattern)[below(PART_NAMES.size())];
+        switch (below(4)) {
+            case 0:
+                part.insert(below(part.size() + 1), snippet());
+                break;
+            case 1:
+                if (!part.empty()) {
+                    const auto begin = below(part.size());
+                    part.erase(begin, 1 + below(part.size() - begin));
+                }
+                break;
+            case 2:
+                part = snippet();
+                break;
+            default: {
+                if (population_.empty()) {
+                    break;
+                }
+                // crossover with another member
+                const auto& other =
+                    population_[below(population_.size())].pattern;
+                part = *parts(other)[below(PART_NAMES.size())];
+                break;
+            }
+        }
+    }
+
+    std::string_view snippet() {
+        return SNIPPETS[below(SNIPPETS.size())];
+    }
+
+    std::uint64_t below(std::uint64_t bound) {
+        return random_() % bound;
+    }
+
+    const PerfFuzzOptions& options_;
+    std::mt19937_64 random_;
+    std::vector<Member> population_;
+    std::vector<PerfFuzzFinding> findings_;
+    std::set<std::string> reported_;
+};
+
+} // namespace
+
+std::string PumpPattern::pump(std::size_t repetitions) const {
+    std::string input;
+    input.reserve(prefix.size() + middle.size() + suffix.size() +
+                  repetitions * (left.size() + right.size()));
+    input += prefix;
+    for (std::size_t i = 0; i < repetitions; ++i) {
+        input += left;
+    }
+    input += middle;
+    for (std::size_t i = 0; i < repetitions; ++i) {
+        input += right;
+    }
+    input += suffix;
+    return input;
+}
+
+std::string PumpPattern::serialize() const {
+    std::string text;
+    const auto values = parts(*this);
+    for (std::size_t i = 0; i < PART_NAMES.size(); ++i) {
+        text += PART_NAMES[i];
+        text += " \"";
+        text += escape(*values[i]);
+        text += "\"\n";
+    }
+    return text;
+}
+
+PumpPattern PumpPattern::parse(std::string_view text) {
+    PumpPattern pattern;
+    const auto values = parts(pattern);
+    while (!text.empty()) {
+        const auto end = std::min(text.find('\n'), text.size());
+        const auto line = text.substr(0, end);
+        text.remove_prefix(std::min(end + 1, text.size()));
+        if (line.empty() || line.starts_with('#')) {
+            continue;
+        }
+
+        const auto space = line.find(' ');
+        const auto name = line.substr(0, space);
+        const auto part = std::find(PART_NAMES.begin(), PART_NAMES.end(), name);
+        if (space == std::string_view::npos || part == PART_NAMES.end() ||
+            line.size() < space + 3 || line[space + 1] != '"' ||
+            !line.ends_with('"')) {
+            throw std::invalid_argument("Malformed pattern line: " +
+                                        std::string(line));
+        }
+        *values[static_cast<std::size_t>(part - PART_NAMES.begin())] =
+            decode_escapes(line.substr(space + 2, line.size() - space - 3));
+    }
+    return pattern;
+}
+
+InputCost measure_cost(std::string_view input) {
+    InputCost cost{.bytes = input.size()};
+    const AllocationScope scope;
+    const auto start = Clock::now();
+    try {
+        Parser parser(Scanner(std::string(input)).scan_tokens());
+        const auto text = parser.parse().to_string();
+    } catch (const std::exception&) {
+        // errors are inputs like any other
+    }
+    cost.time = Clock::now() - start;
+    const auto stats = scope.stats();
+    cost.allocations = stats.allocations;
+    cost.allocated_bytes = stats.allocated_bytes;
+    return cost;
+}
+
+Growth measure_growth(const PumpPattern& pattern, GrowthOptions options) {
+    const auto largest = repetitions_for(pattern, options.target_bytes);
+    if (largest == 0) {
+        return {};
+    }
+    const auto samples = std::max<std::size_t>(options.samples, 2);
+    std::vector<double> sizes;
+    std::vector<double> allocated_bytes;
+    std::vector<double> times;
+    for (std::size_t i = 0; i < samples; ++i) {
+        // geometric steps from an eighth of the largest input up to it
+        const auto fraction =
+            std::exp2(-3.0 * static_cast<double>(samples - 1 - i) /
+                      static_cast<double>(samples - 1));
+        // even counts, so that a quote or comment in `left` is closed the
+        // same way in every sample
+        const auto repetitions = std::max<std::size_t>(
+            static_cast<std::size_t>(
+                std::llround(static_cast<double>(largest) * fraction / 2)) *
+                2,
+            2);
+        const auto input = pattern.pump(repetitions);
+        sizes.push_back(static_cast<double>(input.size()));
+        allocated_bytes.push_back(
+            static_cast<double>(measure_cost(input).allocated_bytes));
+        if (options.measure_time) {
+            times.push_back(static_cast<double>(
+                best_time(input, options.time_runs).count()));
+        }
+    }
+
+    Growth growth;
+    growth.allocation_exponent = fit_exponent(sizes, allocated_bytes);
+    if (options.measure_time) {
+        growth.time_exponent = fit_exponent(sizes, times);
+    }
+    return growth;
+}
+
+PumpPattern minimise(PumpPattern pattern,
+                     const std::function<bool(const PumpPattern&)>& keep) {
+    for (std::size_t index = 0; index < PART_NAMES.size(); ++index) {
+        for (auto chunk = std::max<std::size_t>(
+                 parts(pattern)[index]->size() / 2, 1);
+             chunk > 0; chunk /= 2) {
+            for (std::size_t begin = 0;
+                 begin < parts(pattern)[index]->size();) {
+                auto candidate = pattern;
+                parts(candidate)[index]->erase(begin, chunk);
+                if (keep(candidate)) {
+                    pattern = std::move(candidate);
+                } else {
+                    begin += chunk;
+                }
+            }
+        }
+    }
+    return pattern;
+}
+
+std::vector<PerfFuzzFinding> run_perf_fuzzer(const PerfFuzzOptions& options) {
+    return Fuzzer(options).run();
+}
+
+} // namespace frontend
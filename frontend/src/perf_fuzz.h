@@ -0,0 +1,89 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace frontend {
+
+// A family of inputs of growing size, prefix left^k middle right^k suffix as
+// in the pumping lemma for context-free languages: an empty `right` makes
+// repetitions such as `1 + 1 + ...`, a non-empty one nestings such as
+// `((...))`.
+struct PumpPattern {
+    std::string prefix{};
+    std::string left{};
+    std::string middle{};
+    std::string right{};
+    std::string suffix{};
+
+    std::string pump(std::size_t repetitions) const;
+
+    // Corpus file format, one `name "escaped text"` line per part.
+    std::string serialize() const;
+    // Throws std::invalid_argument for malformed text.
+    static PumpPattern parse(std::string_view text);
+
+    bool operator==(const PumpPattern&) const = default;
+};
+
+// What Scanner -> Parser -> AbstractSyntaxTree::to_string costs on one
+// input. Inputs that fail to scan or parse are measured up to the error.
+// Allocations are only counted where allocation_hooks.cpp is linked in.
+struct InputCost {
+    std::size_t bytes = 0;
+    std::size_t allocations = 0;
+    std::size_t allocated_bytes = 0;
+    std::chrono::nanoseconds time{};
+};
+
+InputCost measure_cost(std::string_view input);
+
+// How cost grows with input size, cost ~ size^exponent: 1 for linear growth
+// and 2 for quadratic growth.
+struct Growth {
+    double allocation_exponent = 0;
+    double time_exponent = 0;
+};
+
+struct GrowthOptions {
+    // size of the largest pumped input
+    std::size_t target_bytes = 2048;
+    // inputs compared, sized geometrically from target_bytes / 8 up
+    std::size_t samples = 6;
+    // best of this many runs for the times
+    std::size_t time_runs = 3;
+    // also compare times, which are noisy on shared machines
+    bool measure_time = true;
+};
+
+Growth measure_growth(const PumpPattern& pattern, GrowthOptions options = {});
+
+struct PerfFuzzOptions {
+    std::uint64_t seed = 1;
+    std::size_t iterations = 2000;
+    // growth exponents above this are reported
+    double exponent_limit = 1.5;
+    GrowthOptions growth{};
+};
+
+struct PerfFuzzFinding {
+    PumpPattern pattern;
+    Growth growth;
+};
+
+// Shrinks every part of `pattern` by delta debugging for as long as
+// `keep` holds for the smaller pattern.
+PumpPattern minimise(PumpPattern pattern,
+                     const std::function<bool(const PumpPattern&)>& keep);
+
+// Searches for patterns whose cost grows faster than linearly. Mutates a
+// population of patterns, built from token snippets, towards higher
+// allocation growth and reports each super-linear one once, minimised.
+std::vector<PerfFuzzFinding> run_perf_fuzzer(const PerfFuzzOptions& options);
+
+} // namespace frontend
@@ -0,0 +1,124 @@
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "perf_fuzz.h"
+
+namespace {
+
+using frontend::PumpPattern;
+
+TEST(PumpPattern, RepeatsAroundTheMiddle) {
+    const PumpPattern pattern{.prefix = "a",
+                              .left = "(",
+                              .middle = "1",
+                              .right = ")",
+                              .suffix = ";"};
+
+    EXPECT_EQ(pattern.pump(0), "a1;");
+    EXPECT_EQ(pattern.pump(3), "a(((1)));");
+}
+
+TEST(PumpPattern, SerializeRoundTrips) {
+    const PumpPattern pattern{.prefix = "\"s\\n\"",
+                              .left = "// c\n",
+                              .middle = "\t",
+                              .right = "",
+                              .suffix = "\\"};
+
+    EXPECT_EQ(pattern.serialize(), "prefix \"\\\"s\\\\n\\\"\"\n"
+                                   "left \"// c\\n\"\n"
+                                   "middle \"\\t\"\n"
+                                   "right \"\"\n"
+                                   "suffix \"\\\\\"\n");
+    EXPECT_EQ(PumpPattern::parse(pattern.serialize()), pattern);
+}
+
+TEST(PumpPattern, ParseSkipsCommentsAndDefaultsMissingParts) {
+    const auto pattern =
+        PumpPattern::parse("# a comment\n\nleft \" + 1\"\nprefix \"1\"\n");
+
+    EXPECT_EQ(pattern, (PumpPattern{.prefix = "1", .left = " + 1"}));
+}
+
+TEST(PumpPattern, ParseRejectsMalformedLines) {
+    EXPECT_THROW(PumpPattern::parse("left (\n"), std::invalid_argument);
+    EXPECT_THROW(PumpPattern::parse("left \"(\n"), std::invalid_argument);
+    EXPECT_THROW(PumpPattern::parse("centre \"(\"\n"), std::invalid_argument);
+}
+
+TEST(PerfFuzz, MeasuresCostOfInvalidInputs) {
+    const auto valid = frontend::measure_cost("1 + 2;");
+    EXPECT_EQ(valid.bytes, 6);
+    EXPECT_GT(valid.allocations, 0);
+    EXPECT_GT(valid.allocated_bytes, 0);
+
+    const auto invalid = frontend::measure_cost("1 + ;");
+    EXPECT_EQ(invalid.bytes, 5);
+    EXPECT_GT(invalid.allocations, 0);
+}
+
+TEST(PerfFuzz, StatementListsGrowLinearly) {
+    const auto growth = frontend::measure_growth(
+        {.left = "1 + 2;"}, {.target_bytes = 4096, .measure_time = false});
+
+    EXPECT_GT(growth.allocation_exponent, 0.8);
+    EXPECT_LT(growth.allocation_exponent, 1.2);
+    EXPECT_EQ(growth.time_exponent, 0);
+}
+
+TEST(PerfFuzz, PatternsWithoutRepetitionDoNotGrow) {
+    const auto growth = frontend::measure_growth({.middle = "1;"});
+
+    EXPECT_EQ(growth.allocation_exponent, 0);
+    EXPECT_EQ(growth.time_exponent, 0);
+}
+
+TEST(PerfFuzz, MinimiseKeepsWhatThePredicateNeeds) {
+    const PumpPattern pattern{.prefix = "if (1) {",
+                              .left = "1 * (2 + 3);",
+                              .middle = "true;",
+                              .right = "",
+                              .suffix = "}"};
+
+    const auto minimal =
+        frontend::minimise(pattern, [](const PumpPattern& candidate) {
+            return candidate.left.find('*') != std::string::npos &&
+                   candidate.suffix == "}";
+        });
+
+    EXPECT_EQ(minimal, (PumpPattern{.left = "*", .suffix = "}"}));
+}
+
+TEST(PerfFuzz, FindsNothingSuperLinear) {
+    const auto findings =
+        frontend::run_perf_fuzzer({.seed = 3, .iterations = 200});
+
+    for (const auto& finding : findings) {
+        ADD_FAILURE() << finding.pattern.serialize();
+    }
+}
+
+// Allocations only, times under the sanitizer are too noisy to fail on.
+TEST(PerfFuzz, CorpusGrowsLinearly) {
+    std::size_t patterns = 0;
+    for (const auto& entry :
+         std::filesystem::directory_iterator(PERF_CORPUS_DIR)) {
+        std::ifstream file(entry.path(), std::ios::binary);
+        std::ostringstream text;
+        text << file.rdbuf();
+        const auto pattern = PumpPattern::parse(text.str());
+
+        const auto growth =
+            frontend::measure_growth(pattern, {.measure_time = false});
+        EXPECT_LE(growth.allocation_exponent, 1.5) << entry.path();
+        ++patterns;
+    }
+    EXPECT_GT(patterns, 0);
+}
+
+} // namespace
@@ -0,0 +1,164 @@
+// Hunts for inputs on which the frontend scales worse than linearly, and
+// replays the patterns found before as a regression corpus.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "perf_fuzz.h"
+
+namespace {
+
+void print_usage() {
+    std::cerr
+        << "Usage: compiler-frontend-perf-fuzz [--seed N] [--iterations N] "
+           "[--limit EXPONENT]\n"
+           "           [--size BYTES] [--corpus DIR]\n"
+           "       compiler-frontend-perf-fuzz --replay DIR [--limit "
+           "EXPONENT] [--size BYTES]\n"
+           "\n"
+           "Fuzzing prints every pattern whose allocations grow faster than "
+           "size^EXPONENT\nand saves it to DIR. Replaying checks every "
+           "pattern in DIR. Both exit with 1\nif anything grows too fast.\n";
+}
+
+struct Options {
+    frontend::PerfFuzzOptions fuzzer;
+    std::string corpus;
+    std::string replay;
+};
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    auto& fuzzer = options.fuzzer;
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        const auto value = [&]() {
+            if (i + 1 >= args.size()) {
+                throw std::invalid_argument(std::vformat(
+                    "Missing value for {}", std::make_format_args(args[i])));
+            }
+            return std::string(args[++i]);
+        };
+        if (args[i] == "--help") {
+            print_usage();
+            std::exit(0);
+        } else if (args[i] == "--seed") {
+            fuzzer.seed = std::stoull(value());
+        } else if (args[i] == "--iterations") {
+            fuzzer.iterations = std::stoul(value());
+        } else if (args[i] == "--limit") {
+            fuzzer.exponent_limit = std::stod(value());
+        } else if (args[i] == "--size") {
+            fuzzer.growth.target_bytes = std::stoul(value());
+        } else if (args[i] == "--corpus") {
+            options.corpus = value();
+        } else if (args[i] == "--replay") {
+            options.replay = value();
+        } else {
+            throw std::invalid_argument(std::vformat(
+                "Unknown argument: {}", std::make_format_args(args[i])));
+        }
+    }
+    return options;
+}
+
+double rounded(double exponent) {
+    return std::round(exponent * 100) / 100;
+}
+
+std::string describe(const frontend::Growth& growth) {
+    return std::vformat("allocations ~ n^{}, time ~ n^{}",
+                        std::make_format_args(
+                            rounded(growth.allocation_exponent),
+                            rounded(growth.time_exponent)));
+}
+
+// FNV-1a of the pattern, so that a finding always gets the same file name.
+std::string file_name(const frontend::PumpPattern& pattern) {
+    std::uint64_t hash = 0xcbf29ce484222325;
+    for (const char c : pattern.serialize()) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3;
+    }
+    std::string name(16, '0');
+    for (auto digit = name.rbegin(); digit != name.rend(); ++digit) {
+        *digit = "0123456789abcdef"[hash & 0xf];
+        hash >>= 4;
+    }
+    return name + ".pump";
+}
+
+int fuzz(const Options& options) {
+    const auto findings = frontend::run_perf_fuzzer(options.fuzzer);
+    for (const auto& finding : findings) {
+        std::cout << describe(finding.growth) << '\n'
+                  << finding.pattern.serialize() << '\n';
+        if (!options.corpus.empty()) {
+            std::filesystem::create_directories(options.corpus);
+            const auto path = std::filesystem::path(options.corpus) /
+                              file_name(finding.pattern);
+            std::ofstream(path, std::ios::binary)
+                << finding.pattern.serialize();
+        }
+    }
+    std::cerr << findings.size() << " super-linear patterns found\n";
+    return findings.empty() ? 0 : 1;
+}
+
+int replay(const Options& options) {
+    std::vector<std::filesystem::path> paths;
+    for (const auto& entry :
+         std::filesystem::directory_iterator(options.replay)) {
+        if (entry.path().extension() == ".pump") {
+            paths.push_back(entry.path());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+
+    // allocations only, times are too noisy to fail on
+    auto growth_options = options.fuzzer.growth;
+    growth_options.measure_time = false;
+    std::size_t failures = 0;
+    for (const auto& path : paths) {
+        std::ifstream file(path, std::ios::binary);
+        std::ostringstream text;
+        text << file.rdbuf();
+        const auto pattern = frontend::PumpPattern::parse(text.str());
+        const auto growth = frontend::measure_growth(pattern, growth_options);
+        const auto failed =
+            growth.allocation_exponent > options.fuzzer.exponent_limit;
+        failures += failed ? 1 : 0;
+        std::cout << (failed ? "FAIL " : "ok   ") << path.filename().string()
+                  << ": allocations ~ n^" << rounded(growth.allocation_exponent)
+                  << '\n';
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const auto options = parse_options(argc, argv);
+        return options.replay.empty() ? fuzz(options) : replay(options);
+    } catch (const std::invalid_argument& error) {
+        std::cerr << error.what() << '\n';
+        print_usage();
+        return 2;
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,31 @@
+#include "pipeline.h"
+
+#include <thread>
+#include <utility>
+
+#include "parser.h"
+#include "trace.h"
+
+namespace frontend {
+
+ast::AbstractSyntaxTree parse_pipelined(std::string source_code,
+                                        PipelineOptions options) {
+    TokenBatchRing ring(options.ring_capacity);
+    std::jthread scanner_thread(
+        [&ring, batch_size = options.batch_size,
+         scanner = Scanner(std::move(source_code)),
+         file = trace::current_file()]() mutable {
+            trace::FileScope file_scope(file);
+            scanner.scan_tokens(ring, batch_size);
+        });
+
+    try {
+        return Parser(ring).parse();
+    } catch (...) {
+        // unblock the scanner if it is waiting on a full ring
+        ring.close();
+        throw;
+    }
+}
+
+} // namespace frontend
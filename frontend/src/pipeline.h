@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "ast/ast.h"
+#include "scanner.h"
+
+namespace frontend {
+
+struct PipelineOptions {
+    std::size_t batch_size = Scanner::DEFAULT_BATCH_SIZE;
+    // number of in-flight batches between the scanner and the parser
+    std::size_t ring_capacity = 64;
+};
+
+// Scans `source_code` on a background thread while the calling thread parses
+// the tokens as they arrive. Produces the same tree as
+// `Parser(Scanner(source_code).scan_tokens()).parse()`.
+ast::AbstractSyntaxTree parse_pipelined(std::string source_code,
+                                        PipelineOptions options = {});
+
+} // namespace frontend
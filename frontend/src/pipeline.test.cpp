@@ -0,0 +1,44 @@
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "parser.h"
+#include "pipeline.h"
+#include "scanner.h"
+
+namespace {
+
+TEST(Pipeline, MatchesSequentialParse) {
+    std::string source;
+    for (int i = 0; i < 500; ++i) {
+        source += "if (1 < 2) { 3 + 4 * 5; } else 6 << 1;\n";
+    }
+    frontend::Parser parser(frontend::Scanner(source).scan_tokens());
+
+    // small batches and ring force the two threads to interleave
+    auto pipelined = frontend::parse_pipelined(
+        source, {.batch_size = 3, .ring_capacity = 2});
+
+    EXPECT_EQ(pipelined.to_string(), parser.parse().to_string());
+}
+
+TEST(Pipeline, EmptySource) {
+    auto ast = frontend::parse_pipelined("");
+
+    EXPECT_STREQ(ast.to_string().c_str(),
+                 "AST(root: CompoundStatement(statements: []))");
+}
+
+TEST(Pipeline, PropagatesParseErrors) {
+    std::string source = "(1 + 2;";
+    for (int i = 0; i < 1000; ++i) {
+        source += " 1;";
+    }
+
+    EXPECT_THROW(frontend::parse_pipelined(
+                     source, {.batch_size = 1, .ring_capacity = 1}),
+                 std::logic_error);
+}
+
+} // namespace
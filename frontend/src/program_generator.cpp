@@ -0,0 +1,298 @@
+#include "program_generator.h"
+
+#include <array>
+#include <cmath>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace frontend {
+
+namespace {
+
+// binding strength of what an expression produced, as in the parser
+constexpr int EQUALITY = 1;
+constexpr int RELATIONAL = 2;
+constexpr int SHIFT = 3;
+constexpr int ADDITIVE = 4;
+constexpr int MULTIPLICATIVE = 5;
+constexpr int PRIMARY = 6;
+
+constexpr std::array<std::string_view, 16> WORDS = {
+    "alpha", "beta",  "gamma", "delta", "parse", "token", "value", "tree",
+    "node",  "scope", "cache", "batch", "queue", "frame", "chunk", "index",
+};
+
+void indent(std::string& out, std::size_t depth) {
+    out.append(4 * (depth - 1), ' ');
+}
+
+// Appends `operand`, parenthesised if it binds less tightly than `minimum`.
+void append_operand(std::string& out, const std::string& operand,
+                    int precedence, int minimum) {
+    if (precedence < minimum) {
+        out += '(';
+        out += operand;
+        out += ')';
+    } else {
+        out += operand;
+    }
+}
+
+} // namespace
+
+ProgramGenerator::ProgramGenerator(GeneratorOptions options)
+    : options_(options), random_(options.seed) {}
+
+std::string ProgramGenerator::next_statement() {
+    std::string out;
+    comment(out, 1);
+    listed_statement(out, 1);
+    out += '\n';
+    return out;
+}
+
+void ProgramGenerator::listed_statement(std::string& out, std::size_t depth) {
+    // a declaration as a branch of an if could never be used
+    if (constants_.size() < MAX_GENERATED_CONSTANTS &&
+        options_.declaration_ratio > 0 &&
+        chance(options_.declaration_ratio)) {
+        declaration(out);
+    } else {
+        statement(out, depth);
+    }
+}
+
+void ProgramGenerator::statement(std::string& out, std::size_t depth,
+                                 bool allow_if) {
+    const bool can_nest = depth < options_.max_nesting_depth;
+    if (allow_if && can_nest && chance(options_.if_ratio)) {
+        out += "if (";
+        expression(out, Type::BOOL, options_.max_expression_depth);
+        out += ") ";
+        // an if without braces before our else would take the else itself
+        const bool has_else = chance(options_.else_ratio);
+        statement(out, depth + 1, !has_else);
+        if (has_else) {
+            out += " else ";
+            statement(out, depth + 1);
+        }
+    } else if (can_nest && chance(options_.block_ratio)) {
+        block(out, depth);
+    } else {
+        expression_statement(out);
+    }
+}
+
+void ProgramGenerator::block(std::string& out, std::size_t depth) {
+    out += "{\n";
+    const auto outer_constants = constants_.size();
+    const auto statements = 1 + below(3);
+    for (std::uint64_t i = 0; i < statements; ++i) {
+        comment(out, depth + 1);
+        indent(out, depth + 1);
+        listed_statement(out, depth + 1);
+        out += '\n';
+    }
+    constants_.resize(outer_constants);
+    indent(out, depth);
+    out += '}';
+}
+
+void ProgramGenerator::declaration(std::string& out) {
+    const auto type = statement_type();
+    auto name = std::string(WORDS[below(WORDS.size())]);
+    name += std::to_string(declared_++);
+    out += "const ";
+    out += name;
+    out += " = ";
+    // in scope only after its own initializer
+    expression(out, type, options_.max_expression_depth);
+    out += ';';
+    constants_.push_back({.name = std::move(name), .type = type});
+}
+
+void ProgramGenerator::expression_statement(std::string& out) {
+    expression(out, statement_type(), options_.max_expression_depth);
+    out += ';';
+}
+
+ProgramGenerator::Type ProgramGenerator::statement_type() {
+    auto type = Type::INT;
+    if (chance(options_.string_ratio)) {
+        type = Type::STRING;
+    } else {
+        const auto& mix = options_.operators;
+        const auto arithmetic = mix.additive + mix.multiplicative + mix.shift;
+        if (chance(mix.comparison / (arithmetic + mix.comparison))) {
+            type = Type::BOOL;
+        } else if (chance(options_.float_ratio)) {
+            type = Type::DOUBLE;
+        }
+    }
+    return type;
+}
+
+int ProgramGenerator::expression(std::string& out, Type type,
+                                 std::size_t depth) {
+    const auto& mix = options_.operators;
+    // a third of the inner nodes stop early, so that sizes vary
+    if (depth <= 1 || below(3) == 0) {
+        primary(out, type);
+        return PRIMARY;
+    }
+
+    std::string_view op;
+    int precedence = PRIMARY;
+    Type left = type;
+    Type right = type;
+    // divisors and shift counts are positive literals
+    bool literal_right = false;
+    switch (type) {
+        case Type::INT:
+        case Type::DOUBLE: {
+            const auto shift = type == Type::INT ? mix.shift : 0.0;
+            const auto total = mix.additive + mix.multiplicative + shift;
+            if (total <= 0) {
+                primary(out, type);
+                return PRIMARY;
+            }
+            const auto pick = uniform() * total;
+            if (pick < mix.additive) {
+                op = below(2) == 0 ? "+" : "-";
+                precedence = ADDITIVE;
+            } else if (pick < mix.additive + mix.multiplicative) {
+                constexpr std::array<std::string_view, 3> OPS = {"*", "/",
+                                                                 "%"};
+                op = OPS[below(OPS.size())];
+                precedence = MULTIPLICATIVE;
+                literal_right = op != "*";
+            } else {
+                op = below(2) == 0 ? "<<" : ">>";
+                precedence = SHIFT;
+                literal_right = true;
+            }
+            if (type == Type::DOUBLE && below(2) == 0) {
+                right = Type::INT;
+            }
+            break;
+        }
+        case Type::BOOL: {
+            if (mix.comparison <= 0) {
+                primary(out, type);
+                return PRIMARY;
+            }
+            constexpr std::array<std::string_view, 6> OPS = {
+                "<", "<=", ">", ">=", "==", "!="};
+            op = OPS[below(OPS.size())];
+            precedence = op == "==" || op == "!=" ? EQUALITY : RELATIONAL;
+            left = below(2) == 0 ? Type::INT : Type::DOUBLE;
+            right = below(2) == 0 ? Type::INT : Type::DOUBLE;
+            break;
+        }
+        case Type::STRING:
+            op = "+";
+            precedence = ADDITIVE;
+            break;
+    }
+
+    std::string operand;
+    const auto left_precedence = expression(operand, left, depth - 1);
+    // operators associate to the left
+    append_operand(out, operand, left_precedence, precedence);
+    out += ' ';
+    out += op;
+    out += ' ';
+    if (literal_right) {
+        out += std::to_string(precedence == SHIFT ? below(64)
+                                                  : 1 + below(99));
+    } else {
+        operand.clear();
+        const auto right_precedence = expression(operand, right, depth - 1);
+        append_operand(out, operand, right_precedence, precedence + 1);
+    }
+    return precedence;
+}
+
+void ProgramGenerator::primary(std::string& out, Type type) {
+    if (options_.identifier_ratio > 0 && chance(options_.identifier_ratio)) {
+        std::vector<const Constant*> candidates;
+        for (const auto& constant : constants_) {
+            if (constant.type == type) {
+                candidates.push_back(&constant);
+            }
+        }
+        if (!candidates.empty()) {
+            out += candidates[below(candidates.size())]->name;
+            return;
+        }
+    }
+    literal(out, type);
+}
+
+void ProgramGenerator::literal(std::string& out, Type type) {
+    switch (type) {
+        case Type::INT:
+            out += std::to_string(below(1000));
+            break;
+        case Type::DOUBLE:
+            out += std::to_string(below(1000));
+            out += '.';
+            out += std::to_string(1 + below(99));
+            break;
+        case Type::BOOL:
+            out += below(2) == 0 ? "true" : "false";
+            break;
+        case Type::STRING:
+            out += '"';
+            out += WORDS[below(WORDS.size())];
+            if (below(10) == 0) {
+                out += "\\n";
+            }
+            out += '"';
+            break;
+    }
+}
+
+void ProgramGenerator::comment(std::string& out, std::size_t depth) {
+    // whole lines per statement, plus one more with the fractional chance
+    const auto whole = std::floor(options_.comment_ratio);
+    auto lines = static_cast<std::uint64_t>(whole);
+    if (chance(options_.comment_ratio - whole)) {
+        ++lines;
+    }
+    for (std::uint64_t line = 0; line < lines; ++line) {
+        indent(out, depth);
+        out += "//";
+        const auto words = 1 + below(8);
+        for (std::uint64_t i = 0; i < words; ++i) {
+            out += ' ';
+            out += WORDS[below(WORDS.size())];
+        }
+        out += '\n';
+    }
+}
+
+std::uint64_t ProgramGenerator::below(std::uint64_t bound) {
+    return random_() % bound;
+}
+
+double ProgramGenerator::uniform() {
+    return static_cast<double>(random_() >> 11) * 0x1.0p-53;
+}
+
+bool ProgramGenerator::chance(double ratio) {
+    return uniform() < ratio;
+}
+
+std::string generate_program(const GeneratorOptions& options) {
+    ProgramGenerator generator(options);
+    std::string program;
+    program.reserve(options.target_bytes + 256);
+    while (program.size() < options.target_bytes) {
+        program += generator.next_statement();
+    }
+    return program;
+}
+
+} // namespace frontend
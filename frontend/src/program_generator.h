@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace frontend {
+
+// Relative weights of the binary operator families.
+struct OperatorMix {
+    // + -
+    double additive = 4;
+    // * / %
+    double multiplicative = 3;
+    // << >>, integers only
+    double shift = 1;
+    // < <= > >= == !=
+    double comparison = 2;
+};
+
+struct GeneratorOptions {
+    std::uint64_t seed = 1;
+    // generation stops at the first statement boundary past this size
+    std::size_t target_bytes = 64 * 1024;
+    // a literal has depth 1
+    std::size_t max_expression_depth = 6;
+    // of if/else branches and blocks; top-level statements have depth 1
+    std::size_t max_nesting_depth = 3;
+    // share of statements that are if statements, and of those with an else
+    double if_ratio = 0.15;
+    double else_ratio = 0.5;
+    // share of statements that are blocks
+    double block_ratio = 0.05;
+    // share of expression statements working on strings
+    double string_ratio = 0.1;
+    // share of numeric expression statements computing doubles
+    double float_ratio = 0.2;
+    // comment lines per statement
+    double comment_ratio = 0.1;
+    // share of the statements at the top level and in blocks that declare a
+    // constant, while fewer than MAX_GENERATED_CONSTANTS are in scope
+    double declaration_ratio = 0.05;
+    // share of the operands that name a constant of their type in scope
+    // instead of being a literal
+    double identifier_ratio = 0.2;
+    OperatorMix operators{};
+};
+
+// Bounds the constants in scope at once, which the bytecode compiler keeps in
+// registers.
+inline constexpr std::size_t MAX_GENERATED_CONSTANTS = 64;
+
+// Emits random programs in the grammar the parser supports, the same ones
+// for the same options on every platform. Operands are typed so that the
+// programs also run without errors: divisors and shift counts are positive
+// literals, strings only meet strings, and identifiers only name constants of
+// their operand's type declared before them in an enclosing scope. Every
+// constant gets a name of its own, so none shadows another.
+class ProgramGenerator {
+public:
+    explicit ProgramGenerator(GeneratorOptions options = {});
+
+    // One top-level statement, possibly preceded by comment lines, ending in
+    // a newline.
+    std::string next_statement();
+
+private:
+    enum class Type {
+        INT,
+        DOUBLE,
+        BOOL,
+        STRING,
+    };
+
+    struct Constant {
+        std::string name{};
+        Type type{};
+    };
+
+    // A statement of a statement list, possibly a declaration.
+    void listed_statement(std::string& out, std::size_t depth);
+    void statement(std::string& out, std::size_t depth, bool allow_if = true);
+    void block(std::string& out, std::size_t depth);
+    void declaration(std::string& out);
+    void expression_statement(std::string& out);
+    Type statement_type();
+    // Returns the precedence of the operator at the root.
+    int expression(std::string& out, Type type, std::size_t depth);
+    // A constant or a literal.
+    void primary(std::string& out, Type type);
+    void literal(std::string& out, Type type);
+    void comment(std::string& out, std::size_t depth);
+
+    // uniform in [0, bound)
+    std::uint64_t below(std::uint64_t bound);
+    // uniform in [0, 1)
+    double uniform();
+    // true with probability `ratio`
+    bool chance(double ratio);
+
+    GeneratorOptions options_;
+    // fully specified by the standard, unlike the distributions
+    std::mt19937_64 random_;
+    // in scope, innermost last
+    std::vector<Constant> constants_;
+    std::size_t declared_ = 0;
+};
+
+// A whole program of about options.target_bytes bytes.
+std::string generate_program(const GeneratorOptions& options);
+
+} // namespace frontend
@@ -0,0 +1,114 @@
+#include <cstdint>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "parser.h"
+#include "program_generator.h"
+#include "resolver.h"
+#include "scanner.h"
+#include "statistics.h"
+#include "type_checker.h"
+
+namespace {
+
+using frontend::GeneratorOptions;
+using frontend::Token;
+
+frontend::SourceStatistics statistics_of(const std::string& source) {
+    const auto tokens = frontend::Scanner(source).scan_tokens();
+    const auto tree = frontend::Parser(tokens).parse();
+    return frontend::collect_statistics(source, tokens, tree);
+}
+
+TEST(ProgramGenerator, SameSeedSameProgram) {
+    const GeneratorOptions options{.seed = 42, .target_bytes = 4096};
+
+    EXPECT_EQ(frontend::generate_program(options),
+              frontend::generate_program(options));
+    EXPECT_NE(frontend::generate_program(options),
+              frontend::generate_program({.seed = 43, .target_bytes = 4096}));
+}
+
+TEST(ProgramGenerator, StopsAtTheFirstStatementPastTheTarget) {
+    frontend::ProgramGenerator generator({.seed = 7});
+    const auto first = generator.next_statement();
+    EXPECT_TRUE(first.ends_with(";\n") || first.ends_with("}\n")) << first;
+
+    const auto program =
+        frontend::generate_program({.seed = 7, .target_bytes = 1});
+    EXPECT_EQ(program, first);
+}
+
+TEST(ProgramGenerator, ProgramsParseWithinTheRequestedShape) {
+    for (std::uint64_t seed = 1; seed <= 20; ++seed) {
+        const GeneratorOptions options{.seed = seed,
+                                       .target_bytes = 16 * 1024,
+                                       .max_expression_depth = 5,
+                                       .max_nesting_depth = 4,
+                                       .if_ratio = 0.3,
+                                       .block_ratio = 0.1,
+                                       .comment_ratio = 0.5};
+        const auto program = frontend::generate_program(options);
+        ASSERT_GE(program.size(), options.target_bytes);
+
+        const auto statistics = statistics_of(program);
+        EXPECT_LE(statistics.max_expression_depth, 5) << "seed " << seed;
+        EXPECT_LE(statistics.max_nesting_depth, 4) << "seed " << seed;
+        EXPECT_GT(statistics.nodes.at("IfStatement"), 0);
+        EXPECT_GT(statistics.tokens.at(Token::Type::STRING), 0);
+    }
+}
+
+TEST(ProgramGenerator, KnobsShapeThePrograms) {
+    const auto plain = statistics_of(frontend::generate_program(
+        {.target_bytes = 8192,
+         .max_nesting_depth = 1,
+         .string_ratio = 0,
+         .float_ratio = 0,
+         .comment_ratio = 0,
+         .operators = {.multiplicative = 0, .shift = 0, .comparison = 0}}));
+    EXPECT_EQ(plain.max_nesting_depth, 1);
+    EXPECT_FALSE(plain.tokens.contains(Token::Type::STRING));
+    EXPECT_FALSE(plain.tokens.contains(Token::Type::STAR));
+    EXPECT_FALSE(plain.tokens.contains(Token::Type::LESS));
+    EXPECT_GT(plain.tokens.at(Token::Type::PLUS) +
+                  plain.tokens.at(Token::Type::MINUS),
+              0);
+
+    const auto commented =
+        frontend::generate_program({.target_bytes = 8192,
+                                    .comment_ratio = 2});
+    const auto uncommented =
+        frontend::generate_program({.target_bytes = 8192,
+                                    .comment_ratio = 0});
+    EXPECT_NE(commented.find("//"), std::string::npos);
+    EXPECT_EQ(uncommented.find("//"), std::string::npos);
+}
+
+TEST(ProgramGenerator, ConstantsAreDeclaredAndUsed) {
+    for (std::uint64_t seed = 1; seed <= 10; ++seed) {
+        const auto program = frontend::generate_program(
+            {.seed = seed,
+             .target_bytes = 16 * 1024,
+             .block_ratio = 0.2,
+             .declaration_ratio = 0.2,
+             .identifier_ratio = 0.5});
+        const auto tree =
+            frontend::Parser(frontend::Scanner(program).scan_tokens()).parse();
+        EXPECT_NO_THROW(frontend::Resolver().resolve(tree)) << "seed " << seed;
+        EXPECT_FALSE(frontend::type_check(tree).has_errors())
+            << "seed " << seed;
+
+        const auto statistics = statistics_of(program);
+        EXPECT_GT(statistics.nodes.at("ConstDeclaration"), 0);
+        EXPECT_GT(statistics.nodes.at("Identifier"), 0);
+    }
+
+    const auto literals_only = statistics_of(frontend::generate_program(
+        {.target_bytes = 8192, .declaration_ratio = 0}));
+    EXPECT_FALSE(literals_only.nodes.contains("ConstDeclaration"));
+    EXPECT_FALSE(literals_only.nodes.contains("Identifier"));
+}
+
+} // namespace
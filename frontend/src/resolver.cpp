@@ -0,0 +1,124 @@
+#include "resolver.h"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+#include <string_view>
+
+#include "trace.h"
+
+namespace frontend {
+
+Resolution Resolver::resolve(const ast::AbstractSyntaxTree& tree) {
+    return resolve(tree.root());
+}
+
+Resolution Resolver::resolve(const ast::Node& node) {
+    trace::Span span("resolve");
+    // the names of the previous tree may be gone
+    symbols_.clear();
+    depth_ = 0;
+    live_slots_ = 0;
+    resolution_ = {};
+
+    // the root block opens the outermost scope itself
+    node.accept(*this);
+    return resolution_;
+}
+
+void Resolver::enter_scope() {
+    if (depth_ == scopes_.size()) {
+        scopes_.emplace_back();
+    } else {
+        scopes_[depth_].clear();
+    }
+    ++depth_;
+}
+
+void Resolver::leave_scope() {
+    --depth_;
+    live_slots_ -= static_cast<std::uint32_t>(scopes_[depth_].size());
+}
+
+void Resolver::scoped(const ast::Statement& statement) {
+    enter_scope();
+    statement.accept(*this);
+    leave_scope();
+}
+
+void Resolver::visit(const ast::Literal<bool>&) {}
+
+void Resolver::visit(const ast::Literal<std::int64_t>&) {}
+
+void Resolver::visit(const ast::Literal<double>&) {}
+
+void Resolver::visit(const ast::Literal<std::string_view>&) {}
+
+void Resolver::visit(const ast::UnaryExpression& expression) {
+    expression.operand().accept(*this);
+}
+
+void Resolver::visit(const ast::BinaryExpression& expression) {
+    expression.left().accept(*this);
+    expression.right().accept(*this);
+}
+
+void Resolver::visit(const ast::Identifier& identifier) {
+    ++resolution_.uses;
+    const auto symbol = symbols_.intern(identifier.name());
+    for (auto depth = depth_; depth > 0; --depth) {
+        if (const auto slot = scopes_[depth - 1].find(symbol);
+            slot != ScopeTable::NOT_FOUND) {
+            identifier.bind(slot);
+            return;
+        }
+    }
+    const auto name = identifier.name();
+    throw std::logic_error(
+        std::vformat("Undeclared identifier {}", std::make_format_args(name)));
+}
+
+void Resolver::visit(const ast::ExpressionStatement& statement) {
+    if (statement.expression_ != nullptr) {
+        statement.expression_->accept(*this);
+    }
+}
+
+void Resolver::visit(const ast::CompoundStatement& statement) {
+    enter_scope();
+    for (const auto& child : statement.statements()) {
+        child->accept(*this);
+    }
+    leave_scope();
+}
+
+void Resolver::visit(const ast::IfStatement& statement) {
+    statement.condition().accept(*this);
+    scoped(statement.then());
+    if (const auto* else_statement = statement.else_statement();
+        else_statement != nullptr) {
+        scoped(*else_statement);
+    }
+}
+
+void Resolver::visit(const ast::ConstDeclaration& declaration) {
+    if (depth_ == 0) {
+        throw std::logic_error("Declaration outside of a block");
+    }
+    // the name is not in scope in its own initializer
+    declaration.initializer().accept(*this);
+
+    const auto symbol = symbols_.intern(declaration.name());
+    if (!scopes_[depth_ - 1].insert(symbol, live_slots_)) {
+        const auto name = declaration.name();
+        throw std::logic_error(std::vformat(
+            "Redeclaration of {} in the same scope",
+            std::make_format_args(name)));
+    }
+    declaration.bind(live_slots_++);
+    ++resolution_.declarations;
+    resolution_.slot_count =
+        std::max<std::size_t>(resolution_.slot_count, live_slots_);
+}
+
+} // namespace frontend
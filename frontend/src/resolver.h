@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ast/ast.h"
+#include "ast/node.h"
+#include "ast/visitor.h"
+#include "scope_table.h"
+
+namespace frontend {
+
+struct Resolution {
+    std::size_t declarations = 0;
+    std::size_t uses = 0;
+    // slots a frame needs: the most declarations in scope at once
+    std::size_t slot_count = 0;
+};
+
+// Binds every Identifier to the ConstDeclaration it names, innermost scope
+// first, and numbers declarations with frame slots that backends index
+// instead of looking names up. A CompoundStatement, and a branch of an
+// IfStatement, opens a scope; a name is in scope from the statement after
+// its declaration to the end of the block, so `const x = x;` refers to an
+// outer x. Slots are handed out stack-wise, declarations of a finished block
+// giving theirs to the next one, so a slot is also a register number for a
+// backend that keeps locals in registers.
+//
+// Scope tables come from a pool that is kept across blocks and calls, so a
+// Resolver reused over many files allocates next to nothing. Throws
+// std::logic_error for an undeclared name or a name declared twice in one
+// scope.
+class Resolver final : private ast::Visitor {
+public:
+    Resolution resolve(const ast::AbstractSyntaxTree& tree);
+    Resolution resolve(const ast::Node& node);
+
+private:
+    void visit(const ast::Literal<bool>& literal) override;
+    void visit(const ast::Literal<std::int64_t>& literal) override;
+    void visit(const ast::Literal<double>& literal) override;
+    void visit(const ast::Literal<std::string_view>& literal) override;
+    void visit(const ast::UnaryExpression& expression) override;
+    void visit(const ast::BinaryExpression& expression) override;
+    void visit(const ast::Identifier& identifier) override;
+    void visit(const ast::ExpressionStatement& statement) override;
+    void visit(const ast::CompoundStatement& statement) override;
+    void visit(const ast::IfStatement& statement) override;
+    void visit(const ast::ConstDeclaration& declaration) override;
+
+    void enter_scope();
+    void leave_scope();
+    // Resolves `statement` in a scope of its own.
+    void scoped(const ast::Statement& statement);
+
+    SymbolTable symbols_;
+    // scopes_[0, depth_) are open, the rest are kept for reuse
+    std::vector<ScopeTable> scopes_;
+    std::size_t depth_ = 0;
+    // declarations in the open scopes, i.e. the next free slot
+    std::uint32_t live_slots_ = 0;
+    Resolution resolution_;
+};
+
+} // namespace frontend
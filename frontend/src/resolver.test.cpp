@@ -0,0 +1,136 @@
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ast/node.h"
+#include "ast/visitor.h"
+#include "parser.h"
+#include "resolver.h"
+#include "scanner.h"
+
+namespace {
+
+namespace ast = frontend::ast;
+
+frontend::ast::AbstractSyntaxTree parse(const std::string& source) {
+    return frontend::Parser(frontend::Scanner(source).scan_tokens()).parse();
+}
+
+// The slots of the declarations and the uses, in source order.
+class SlotCollector final : public ast::Visitor {
+public:
+    void visit(const ast::Literal<bool>&) override {}
+    void visit(const ast::Literal<std::int64_t>&) override {}
+    void visit(const ast::Literal<double>&) override {}
+    void visit(const ast::Literal<std::string_view>&) override {}
+
+    void visit(const ast::UnaryExpression& expression) override {
+        expression.operand().accept(*this);
+    }
+
+    void visit(const ast::BinaryExpression& expression) override {
+        expression.left().accept(*this);
+        expression.right().accept(*this);
+    }
+
+    void visit(const ast::Identifier& identifier) override {
+        uses.push_back(identifier.slot());
+    }
+
+    void visit(const ast::ExpressionStatement& statement) override {
+        if (statement.expression_ != nullptr) {
+            statement.expression_->accept(*this);
+        }
+    }
+
+    void visit(const ast::CompoundStatement& statement) override {
+        for (const auto& child : statement.statements()) {
+            child->accept(*this);
+        }
+    }
+
+    void visit(const ast::IfStatement& statement) override {
+        statement.condition().accept(*this);
+        statement.then().accept(*this);
+        if (const auto* else_statement = statement.else_statement()) {
+            else_statement->accept(*this);
+        }
+    }
+
+    void visit(const ast::ConstDeclaration& declaration) override {
+        declaration.initializer().accept(*this);
+        declarations.push_back(declaration.slot());
+    }
+
+    std::vector<std::uint32_t> declarations;
+    std::vector<std::uint32_t> uses;
+};
+
+SlotCollector slots(const ast::AbstractSyntaxTree& tree) {
+    SlotCollector collector;
+    tree.root().accept(collector);
+    return collector;
+}
+
+TEST(Resolver, BindsUsesToTheirDeclarations) {
+    const auto tree = parse("const a = 1; const b = a + 2; b * a;");
+
+    const auto resolution = frontend::Resolver().resolve(tree);
+
+    EXPECT_EQ(resolution.declarations, 2);
+    EXPECT_EQ(resolution.uses, 3);
+    EXPECT_EQ(resolution.slot_count, 2);
+    const auto collected = slots(tree);
+    EXPECT_EQ(collected.declarations, (std::vector<std::uint32_t>{0, 1}));
+    EXPECT_EQ(collected.uses, (std::vector<std::uint32_t>{0, 1, 0}));
+}
+
+TEST(Resolver, InnerScopesShadowAndReuseSlots) {
+    const auto tree = parse(R"(
+        const x = 1;
+        { const x = x + 1; const y = x; y; }
+        { const z = 3; x + z; }
+        if (x) const w = x; else { const v = 2; }
+        x;
+    )");
+
+    const auto resolution = frontend::Resolver().resolve(tree);
+
+    EXPECT_EQ(resolution.slot_count, 3);
+    const auto collected = slots(tree);
+    // the blocks and branches reuse slots 1 and 2 in turn
+    EXPECT_EQ(collected.declarations,
+              (std::vector<std::uint32_t>{0, 1, 2, 1, 1, 1}));
+    // `const x = x + 1` reads the outer x
+    EXPECT_EQ(collected.uses,
+              (std::vector<std::uint32_t>{0, 1, 2, 0, 1, 0, 0, 0}));
+}
+
+TEST(Resolver, RejectsUndeclaredAndRedeclaredNames) {
+    for (const auto* source :
+         {"x;", "const x = x;", "x; const x = 1;", "{ const x = 1; } x;",
+          "if (1) const x = 1; else x;", "const x = 1; const x = 2;"}) {
+        const auto tree = parse(source);
+        EXPECT_THROW(frontend::Resolver().resolve(tree), std::logic_error)
+            << source;
+    }
+}
+
+TEST(Resolver, CanBeReusedAcrossTrees) {
+    frontend::Resolver resolver;
+    const auto first = parse("{ { const a = 1; a; } }");
+    const auto second = parse("const b = 2; const a = b; a;");
+    const auto failing = parse("{ { { c; } } }");
+
+    EXPECT_EQ(resolver.resolve(first).slot_count, 1);
+    EXPECT_THROW(resolver.resolve(failing), std::logic_error);
+    const auto resolution = resolver.resolve(second);
+
+    EXPECT_EQ(resolution.declarations, 2);
+    EXPECT_EQ(slots(second).uses, (std::vector<std::uint32_t>{0, 1}));
+}
+
+} // namespace
@@ -1,7 +1,14 @@
 #include "scanner.h"
 
+#include "lexicon.h"
+#include "trace.h"
+#include "utf8.h"
+
+#include <algorithm>
+#include <cstddef>
 #include <format>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -10,51 +17,87 @@
 namespace frontend {
 
 namespace {
-const std::unordered_map<std::string_view, Token::Type> RESERVED_WORDS{
-    {"const", Token::Type::CONST},   {"class", Token::Type::CLASS},
-    {"else", Token::Type::ELSE},     {"false", Token::Type::FALSE},
-    {"fun", Token::Type::FUN},       {"for", Token::Type::FOR},
-    {"if", Token::Type::IF},         {"or", Token::Type::OR},
-    {"return", Token::Type::RETURN}, {"this", Token::Type::THIS},
-    {"true", Token::Type::TRUE},     {"while", Token::Type::WHILE},
-};
+const std::unordered_map<std::string_view, Token::Type> RESERVED_WORD_TYPES(
+    RESERVED_WORDS.begin(), RESERVED_WORDS.end());
 
 }
 
-Scanner::Scanner(std::string source_code)
-    : source_code_(std::move(source_code)) {}
+Scanner::Scanner(std::string source_code, ScannerOptions options)
+    : source_code_(
+          std::make_shared<const std::string>(std::move(source_code))),
+      options_(options), line_(options.first_line) {
+    if (!is_valid_utf8(*source_code_)) {
+        const auto offset = find_invalid_utf8(*source_code_);
+        throw std::logic_error(std::vformat(
+            "Invalid UTF-8 at byte {}", std::make_format_args(offset)));
+    }
+}
 
-std::vector<Token> Scanner::scan_tokens() {
-    std::vector<Token> tokens;
+template <typename Emit>
+void Scanner::scan_all(Emit&& emit) {
     while (!is_at_end()) {
         start_ = current_;
         auto scanned_token = scan_token();
-        if (scanned_token.has_value()) {
-            tokens.push_back(scanned_token.value());
+        if (scanned_token.has_value() && !emit(std::move(*scanned_token))) {
+            return;
         }
     }
-    tokens.emplace_back(line_, Token::Type::END_OF_FILE);
+    emit(Token(line_, Token::Type::END_OF_FILE));
+}
+
+std::vector<Token> Scanner::scan_tokens() {
+    trace::Span span("scan");
+    std::vector<Token> tokens;
+    scan_all([&](Token&& token) {
+        tokens.push_back(std::move(token));
+        return true;
+    });
     return tokens;
 }
 
-constexpr bool Scanner::is_alpha(char c) {
-    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+std::vector<Token> Scanner::scan_tokens(std::vector<std::size_t>& token_ends) {
+    trace::Span span("scan");
+    std::vector<Token> tokens;
+    scan_all([&](Token&& token) {
+        tokens.push_back(std::move(token));
+        token_ends.push_back(current_);
+        return true;
+    });
+    return tokens;
 }
 
-constexpr bool Scanner::is_digit(char c) {
-    return (c >= '0' && c <= '9');
+void Scanner::scan_tokens(TokenBatchRing& ring, std::size_t batch_size) {
+    trace::Span span("scan");
+    std::vector<Token> batch;
+    batch.reserve(batch_size);
+    bool accepted = true;
+    scan_all([&](Token&& token) {
+        const bool last = token.type_ == Token::Type::END_OF_FILE;
+        batch.push_back(std::move(token));
+        if (batch.size() >= batch_size || last) {
+            accepted = ring.push(std::move(batch));
+            batch = {};
+            batch.reserve(batch_size);
+        }
+        return accepted;
+    });
+    ring.close();
 }
 
-constexpr bool Scanner::is_alpha_numeric(char c) {
-    return is_alpha(c) || is_digit(c);
+bool Scanner::is_identifier_start(char c) const {
+    return is_alpha(c) || (options_.unicode_identifiers && is_non_ascii(c));
+}
+
+bool Scanner::is_identifier_character(char c) const {
+    return is_identifier_start(c) || is_digit(c);
 }
 
 bool Scanner::is_at_end() const {
-    return current_ >= source_code_.length();
+    return current_ >= source_code_->length();
 }
 
 char Scanner::advance() {
-    return source_code_.at(current_++);
+    return source_code_->at(current_++);
 }
 
 bool Scanner::match(char expected_character) {
@@ -62,7 +105,7 @@ bool Scanner::match(char expected_character) {
         return false;
     }
 
-    if (source_code_.at(current_) != expected_character) {
+    if (source_code_->at(current_) != expected_character) {
         return false;
     }
 
@@ -74,14 +117,14 @@ char Scanner::peek() const {
     if (is_at_end()) {
         return '\0';
     }
-    return source_code_.at(current_);
+    return source_code_->at(current_);
 }
 
 char Scanner::peek_next() const {
-    if (current_ + 1 >= source_code_.length()) {
+    if (current_ + 1 >= source_code_->length()) {
         return '\0';
     }
-    return source_code_.at(current_ + 1);
+    return source_code_->at(current_ + 1);
 }
 
 Token Scanner::create_simple_token(Token::Type type) {
@@ -89,24 +132,40 @@ Token Scanner::create_simple_token(Token::Type type) {
 }
 
 std::optional<Token> Scanner::scan_string() {
-    while (!is_at_end() && peek() != '"') {
-        if (peek() == '\n') {
-            ++line_;
-        }
-        advance();
+    const std::string_view source = *source_code_;
+    // the closing quote, skipping over escaped characters
+    auto end = find_quote_or_backslash(source, current_);
+    bool escaped = false;
+    while (end != std::string_view::npos && source[end] == '\\') {
+        escaped = true;
+        end = end + 2 < source.size()
+                  ? find_quote_or_backslash(source, end + 2)
+                  : std::string_view::npos;
     }
 
-    if (is_at_end()) {
+    const auto last = end == std::string_view::npos ? source.size() : end;
+    line_ += static_cast<std::size_t>(
+        std::count(source.begin() + static_cast<std::ptrdiff_t>(current_),
+                   source.begin() + static_cast<std::ptrdiff_t>(last), '\n'));
+    if (end == std::string_view::npos) {
+        current_ = source.size();
         // TODO: error("unterminated string")
         return std::nullopt;
     }
 
-    // handles the closing quotes
-    advance();
-
-    // +1 and -2 offsets to trim the surrounding quotes
-    std::string lexeme = source_code_.substr(start_ + 1, current_ - start_ - 2);
-    return Token(line_, Token::Type::STRING, lexeme);
+    const auto raw = source.substr(current_, end - current_);
+    // past the closing quotes
+    current_ = end + 1;
+    if (options_.strings != nullptr) {
+        if (!source_pooled_) {
+            options_.strings->add_source(source_code_);
+            source_pooled_ = true;
+        }
+        return Token::pooled_string(line_,
+                                    options_.strings->intern_literal(raw));
+    }
+    return Token(line_, Token::Type::STRING,
+                 escaped ? decode_escapes(raw) : std::string(raw));
 }
 
 std::optional<Token> Scanner::scan_number() {
@@ -121,20 +180,20 @@ std::optional<Token> Scanner::scan_number() {
         }
     }
 
-    auto lexeme = source_code_.substr(start_, current_ - start_);
+    auto lexeme = source_code_->substr(start_, current_ - start_);
     // TODO: convert to actual number?
     return Token(line_, Token::Type::NUMBER, lexeme);
 }
 
 std::optional<Token> Scanner::scan_identifier() {
-    while (is_alpha_numeric(peek())) {
+    while (is_identifier_character(peek())) {
         advance();
     }
 
-    auto lexeme = source_code_.substr(start_, current_ - start_);
+    auto lexeme = source_code_->substr(start_, current_ - start_);
 
-    if (const auto word = RESERVED_WORDS.find(lexeme);
-        word != RESERVED_WORDS.end()) {
+    if (const auto word = RESERVED_WORD_TYPES.find(lexeme);
+        word != RESERVED_WORD_TYPES.end()) {
         return create_simple_token(word->second);
     }
 
@@ -200,17 +259,25 @@ std::optional<Token> Scanner::scan_token() {
         case '"':
             return scan_string();
             break;
-        default:
+        default: {
             if (is_digit(c)) {
                 return scan_number();
-            } else if (is_alpha(c)) {
+            } else if (is_identifier_start(c)) {
                 return scan_identifier();
             }
+            // report a multi-byte character once
+            while (is_non_ascii(c) &&
+                   (static_cast<unsigned char>(peek()) & 0xc0) == 0x80) {
+                advance();
+            }
             // TODO: log warning/error
+            const auto character =
+                source_code_->substr(start_, current_ - start_);
             std::cerr << std::vformat(
                 "Failed to match the following the following character: {}\n",
-                std::make_format_args(c));
+                std::make_format_args(character));
             break;
+        }
     }
     return std::nullopt;
 }
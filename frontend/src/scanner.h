@@ -1,23 +1,47 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "spsc_ring.h"
+#include "string_pool.h"
 #include "token.h"
 
 namespace frontend {
 
+using TokenBatchRing = SpscRing<std::vector<Token>>;
+
+struct ScannerOptions {
+    std::size_t first_line = 1;
+    // With a pool, STRING tokens are pooled views that must not outlive it;
+    // otherwise they own their decoded text.
+    StringPool* strings = nullptr;
+    // Accept non-ASCII characters in identifiers, like letters.
+    bool unicode_identifiers = false;
+};
+
+// The source must be valid UTF-8, which is checked up front; UTF-8 is
+// accepted in string literals and comments.
 class Scanner {
 public:
-    Scanner(std::string source_code);
+    static constexpr std::size_t DEFAULT_BATCH_SIZE = 256;
+
+    // Throws std::logic_error if `source_code` is not valid UTF-8.
+    Scanner(std::string source_code, ScannerOptions options = {});
     std::vector<Token> scan_tokens();
+    // Also records, for every token, the offset one past its last character.
+    std::vector<Token> scan_tokens(std::vector<std::size_t>& token_ends);
+    // Streams the tokens into `ring` in batches of up to `batch_size`, the
+    // last batch ending with END_OF_FILE, then closes the ring.
+    void scan_tokens(TokenBatchRing& ring,
+                     std::size_t batch_size = DEFAULT_BATCH_SIZE);
 
 private:
-    static constexpr bool is_alpha(char c);
-    static constexpr bool is_digit(char c);
-    static constexpr bool is_alpha_numeric(char c);
+    bool is_identifier_start(char c) const;
+    bool is_identifier_character(char c) const;
     bool is_at_end() const;
     char advance();
     bool match(char expected_character);
@@ -28,9 +52,14 @@ private:
     std::optional<Token> scan_number();
     std::optional<Token> scan_identifier();
     std::optional<Token> scan_token();
+    template <typename Emit>
+    void scan_all(Emit&& emit);
 
-    std::string source_code_;
-    std::size_t line_ = 1;
+    // shared with the string pool once a literal points into it
+    std::shared_ptr<const std::string> source_code_;
+    ScannerOptions options_;
+    bool source_pooled_ = false;
+    std::size_t line_;
     std::size_t start_ = 0;
     std::size_t current_ = 0;
 };
@@ -1,11 +1,13 @@
 #include <cstddef>
 #include <format>
 #include <iostream>
+#include <stdexcept>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include "scanner.h"
+#include "string_pool.h"
 #include "token.h"
 
 namespace {
@@ -63,6 +65,55 @@ TEST(Scanner, Strings) {
     compare_tokens(parsed_tokens, expected_tokens);
 }
 
+TEST(Scanner, StringEscapes) {
+    frontend::Scanner scanner(R"("a\"b" "\\" "x\ny
+z" "\q")");
+    const std::vector<frontend::Token> expected_tokens{
+        Token(1, Token::Type::STRING, "a\"b"),
+        Token(1, Token::Type::STRING, "\\"),
+        Token(2, Token::Type::STRING, "x\ny\nz"),
+        Token(2, Token::Type::STRING, "\\q"),
+        Token(2, Token::Type::END_OF_FILE),
+    };
+
+    const auto parsed_tokens = scanner.scan_tokens();
+
+    compare_tokens(parsed_tokens, expected_tokens);
+}
+
+TEST(Scanner, UnterminatedStringEndsTheInput) {
+    frontend::Scanner scanner(R"(1 "abc\")");
+    const std::vector<frontend::Token> expected_tokens{
+        Token(1, Token::Type::NUMBER, "1"),
+        Token(1, Token::Type::END_OF_FILE),
+    };
+
+    const auto parsed_tokens = scanner.scan_tokens();
+
+    compare_tokens(parsed_tokens, expected_tokens);
+}
+
+TEST(Scanner, PooledStringsPointIntoTheSource) {
+    frontend::StringPool strings;
+    frontend::Scanner scanner(R"("plain" "plain" "esc\t")",
+                              {.strings = &strings});
+    const std::vector<frontend::Token> expected_tokens{
+        Token(1, Token::Type::STRING, "plain"),
+        Token(1, Token::Type::STRING, "plain"),
+        Token(1, Token::Type::STRING, "esc\t"),
+        Token(1, Token::Type::END_OF_FILE),
+    };
+
+    const auto parsed_tokens = scanner.scan_tokens();
+
+    compare_tokens(parsed_tokens, expected_tokens);
+    EXPECT_FALSE(parsed_tokens[0].lexeme_.has_value());
+    EXPECT_EQ(parsed_tokens[0].text().data(), parsed_tokens[1].text().data());
+    EXPECT_EQ(strings.size(), 2);
+    // only the escaped literal is copied
+    EXPECT_EQ(strings.copied_bytes(), 4);
+}
+
 TEST(Scanner, Numbers) {
     frontend::Scanner scanner("[542] [342.024]");
     const std::vector<frontend::Token> expected_tokens{
@@ -139,6 +190,50 @@ TEST(Scanner, ReservedWords) {
     compare_tokens(parsed_tokens, expected_tokens);
 }
 
+TEST(Scanner, Utf8InStringsAndComments) {
+    frontend::Scanner scanner("\"héllo €\" // ünïcode\n1");
+    const std::vector<frontend::Token> expected_tokens{
+        Token(1, Token::Type::STRING, "héllo €"),
+        Token(2, Token::Type::NUMBER, "1"),
+        Token(2, Token::Type::END_OF_FILE),
+    };
+
+    const auto parsed_tokens = scanner.scan_tokens();
+
+    compare_tokens(parsed_tokens, expected_tokens);
+}
+
+TEST(Scanner, UnicodeIdentifiers) {
+    frontend::Scanner scanner("größe1 π", {.unicode_identifiers = true});
+    const std::vector<frontend::Token> expected_tokens{
+        Token(1, Token::Type::IDENTIFIER, "größe1"),
+        Token(1, Token::Type::IDENTIFIER, "π"),
+        Token(1, Token::Type::END_OF_FILE),
+    };
+
+    const auto parsed_tokens = scanner.scan_tokens();
+
+    compare_tokens(parsed_tokens, expected_tokens);
+}
+
+TEST(Scanner, NonAsciiOutsideStringsIsSkippedByDefault) {
+    frontend::Scanner scanner("a€b");
+    const std::vector<frontend::Token> expected_tokens{
+        Token(1, Token::Type::IDENTIFIER, "a"),
+        Token(1, Token::Type::IDENTIFIER, "b"),
+        Token(1, Token::Type::END_OF_FILE),
+    };
+
+    const auto parsed_tokens = scanner.scan_tokens();
+
+    compare_tokens(parsed_tokens, expected_tokens);
+}
+
+TEST(Scanner, RejectsInvalidUtf8) {
+    EXPECT_THROW(frontend::Scanner("\"\xff\""), std::logic_error);
+    EXPECT_THROW(frontend::Scanner("1; \"\xe2\x82"), std::logic_error);
+}
+
 TEST(Scanner, UnexpectedTokens) {
     frontend::Scanner scanner("_|_[|_= !=");
     const std::vector<frontend::Token> expected_tokens{
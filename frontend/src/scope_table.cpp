@@ -0,0 +1,110 @@
+#include "scope_table.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+namespace frontend {
+
+std::uint32_t SymbolTable::intern(std::string_view name) {
+    // at most half full
+    if ((names_.size() + 1) * 2 > buckets_.size()) {
+        grow();
+    }
+    const auto hash = std::hash<std::string_view>{}(name);
+    const auto mask = buckets_.size() - 1;
+    for (auto index = hash & mask;; index = (index + 1) & mask) {
+        const auto bucket = buckets_[index];
+        if (bucket == 0) {
+            const auto symbol = static_cast<std::uint32_t>(names_.size());
+            buckets_[index] = symbol + 1;
+            names_.push_back(name);
+            hashes_.push_back(hash);
+            return symbol;
+        }
+        if (hashes_[bucket - 1] == hash && names_[bucket - 1] == name) {
+            return bucket - 1;
+        }
+    }
+}
+
+void SymbolTable::clear() {
+    std::fill(buckets_.begin(), buckets_.end(), 0);
+    names_.clear();
+    hashes_.clear();
+}
+
+void SymbolTable::grow() {
+    buckets_.assign(std::max<std::size_t>(buckets_.size() * 2, 16), 0);
+    const auto mask = buckets_.size() - 1;
+    for (std::size_t symbol = 0; symbol < names_.size(); ++symbol) {
+        auto index = hashes_[symbol] & mask;
+        while (buckets_[index] != 0) {
+            index = (index + 1) & mask;
+        }
+        buckets_[index] = static_cast<std::uint32_t>(symbol + 1);
+    }
+}
+
+std::uint32_t ScopeTable::find(std::uint32_t symbol) const {
+    if (size_ == 0) {
+        return NOT_FOUND;
+    }
+    const auto mask = entries_.size() - 1;
+    for (auto index = bucket(symbol);; index = (index + 1) & mask) {
+        const auto& entry = entries_[index];
+        if (entry.generation != generation_) {
+            return NOT_FOUND;
+        }
+        if (entry.symbol == symbol) {
+            return entry.slot;
+        }
+    }
+}
+
+bool ScopeTable::insert(std::uint32_t symbol, std::uint32_t slot) {
+    // at most half full
+    if ((size_ + 1) * 2 > entries_.size()) {
+        grow();
+    }
+    const auto mask = entries_.size() - 1;
+    for (auto index = bucket(symbol);; index = (index + 1) & mask) {
+        auto& entry = entries_[index];
+        if (entry.generation != generation_) {
+            entry = {.generation = generation_, .symbol = symbol, .slot = slot};
+            ++size_;
+            return true;
+        }
+        if (entry.symbol == symbol) {
+            return false;
+        }
+    }
+}
+
+void ScopeTable::clear() {
+    size_ = 0;
+    if (++generation_ == 0) {
+        // after 2^32 clears, stale entries would look current again
+        std::fill(entries_.begin(), entries_.end(), Entry{});
+        generation_ = 1;
+    }
+}
+
+void ScopeTable::grow() {
+    auto old = std::exchange(
+        entries_, std::vector<Entry>(
+                      std::max(entries_.size() * 2, INITIAL_CAPACITY)));
+    const auto mask = entries_.size() - 1;
+    for (const auto& entry : old) {
+        if (entry.generation != generation_) {
+            continue;
+        }
+        auto index = bucket(entry.symbol);
+        while (entries_[index].generation == generation_) {
+            index = (index + 1) & mask;
+        }
+        entries_[index] = entry;
+    }
+}
+
+} // namespace frontend
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+namespace frontend {
+
+// Dense IDs for names: equal names get the same ID, counting up from 0.
+// Names are kept as views, so their storage has to outlive the table or its
+// next clear().
+class SymbolTable {
+public:
+    std::uint32_t intern(std::string_view name);
+
+    std::string_view name(std::uint32_t symbol) const {
+        return names_[symbol];
+    }
+
+    std::size_t size() const {
+        return names_.size();
+    }
+
+    // Forgets every name, keeping the memory for the next ones.
+    void clear();
+
+private:
+    void grow();
+
+    // open addressing with linear probing over a power-of-two table; a
+    // bucket holds symbol + 1, 0 when empty
+    std::vector<std::uint32_t> buckets_;
+    std::vector<std::string_view> names_;
+    std::vector<std::size_t> hashes_;
+};
+
+// The names declared in one scope, mapping symbol IDs to slots. A flat
+// open-addressing table of 12-byte entries, so that a lookup touches a
+// cache line or two. Entries carry the generation they were inserted in,
+// which makes clear() O(1): a scope stack keeps one table per depth and
+// reuses it for every block at that depth without freeing or wiping it.
+class ScopeTable {
+public:
+    static constexpr std::uint32_t NOT_FOUND =
+        std::numeric_limits<std::uint32_t>::max();
+
+    // The slot of `symbol`, NOT_FOUND if it is not declared here.
+    std::uint32_t find(std::uint32_t symbol) const;
+
+    // Declares `symbol` in `slot`; false if it is declared here already.
+    bool insert(std::uint32_t symbol, std::uint32_t slot);
+
+    void clear();
+
+    std::size_t size() const {
+        return size_;
+    }
+
+private:
+    struct Entry {
+        std::uint32_t generation = 0;
+        std::uint32_t symbol = 0;
+        std::uint32_t slot = 0;
+    };
+
+    static constexpr std::size_t INITIAL_CAPACITY = 8;
+
+    // symbol IDs are dense, and multiplying by an odd constant is a
+    // bijection modulo the table size, so they spread without collisions
+    std::size_t bucket(std::uint32_t symbol) const {
+        return (symbol * 0x9e3779b9U) & (entries_.size() - 1);
+    }
+
+    void grow();
+
+    std::vector<Entry> entries_;
+    // entries of older generations count as empty
+    std::uint32_t generation_ = 1;
+    std::size_t size_ = 0;
+};
+
+} // namespace frontend
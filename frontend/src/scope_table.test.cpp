@@ -0,0 +1,77 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "scope_table.h"
+
+namespace {
+
+using frontend::ScopeTable;
+using frontend::SymbolTable;
+
+TEST(SymbolTable, GivesEqualNamesEqualDenseIds) {
+    SymbolTable symbols;
+    const std::string x = "x";
+
+    EXPECT_EQ(symbols.intern("x"), 0);
+    EXPECT_EQ(symbols.intern("y"), 1);
+    EXPECT_EQ(symbols.intern(x), 0);
+    EXPECT_EQ(symbols.size(), 2);
+    EXPECT_EQ(symbols.name(1), "y");
+}
+
+TEST(SymbolTable, GrowsAndClears) {
+    std::vector<std::string> names;
+    for (int i = 0; i < 1000; ++i) {
+        names.push_back("name" + std::to_string(i));
+    }
+    SymbolTable symbols;
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        EXPECT_EQ(symbols.intern(names[i]), i);
+    }
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        EXPECT_EQ(symbols.intern(names[i]), i);
+    }
+
+    symbols.clear();
+    EXPECT_EQ(symbols.size(), 0);
+    EXPECT_EQ(symbols.intern(names.back()), 0);
+}
+
+TEST(ScopeTable, MapsSymbolsToSlots) {
+    ScopeTable scope;
+    EXPECT_EQ(scope.find(3), ScopeTable::NOT_FOUND);
+
+    EXPECT_TRUE(scope.insert(3, 0));
+    EXPECT_TRUE(scope.insert(11, 1));
+    EXPECT_FALSE(scope.insert(3, 2));
+
+    EXPECT_EQ(scope.find(3), 0);
+    EXPECT_EQ(scope.find(11), 1);
+    EXPECT_EQ(scope.find(4), ScopeTable::NOT_FOUND);
+    EXPECT_EQ(scope.size(), 2);
+}
+
+TEST(ScopeTable, GrowsAndIsReusableAfterClear) {
+    ScopeTable scope;
+    for (std::uint32_t round = 0; round < 3; ++round) {
+        // different symbols every round, none left over from the last
+        const std::uint32_t first = round * 1000;
+        for (std::uint32_t symbol = first; symbol < first + 500; ++symbol) {
+            ASSERT_TRUE(scope.insert(symbol, symbol - first));
+        }
+        for (std::uint32_t symbol = first; symbol < first + 500; ++symbol) {
+            EXPECT_EQ(scope.find(symbol), symbol - first);
+        }
+        if (round > 0) {
+            EXPECT_EQ(scope.find(first - 1000), ScopeTable::NOT_FOUND);
+        }
+        scope.clear();
+        EXPECT_EQ(scope.size(), 0);
+        EXPECT_EQ(scope.find(first), ScopeTable::NOT_FOUND);
+    }
+}
+
+} // namespace
@@ -0,0 +1,187 @@
+// Local load generator for the compile server: replays one source file over
+// a number of concurrent connections and reports latency percentiles.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "server/protocol.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string socket_path;
+    std::string command = "ast";
+    std::string file;
+    std::size_t requests = 1000;
+    std::size_t connections = 1;
+    // make every request distinct so that the server cache never hits
+    bool unique = false;
+};
+
+void print_usage() {
+    std::cerr << "Usage: compiler-frontend-loadgen --socket PATH "
+                 "[--command tokens|ast|check] [--requests N] "
+                 "[--connections N] [--unique] FILE\n";
+}
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    const std::vector<std::string_view> args(argv + 1, argv + argc);
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        const auto value = [&]() {
+            if (i + 1 >= args.size()) {
+                throw std::invalid_argument(std::vformat(
+                    "Missing value for {}", std::make_format_args(args[i])));
+            }
+            return std::string(args[++i]);
+        };
+        if (args[i] == "--socket") {
+            options.socket_path = value();
+        } else if (args[i] == "--command") {
+            options.command = value();
+        } else if (args[i] == "--requests") {
+            options.requests = std::stoul(value());
+        } else if (args[i] == "--connections") {
+            options.connections = std::max<std::size_t>(std::stoul(value()), 1);
+        } else if (args[i] == "--unique") {
+            options.unique = true;
+        } else {
+            options.file = args[i];
+        }
+    }
+    if (options.socket_path.empty() || options.file.empty()) {
+        throw std::invalid_argument("A socket and a file are required");
+    }
+    return options;
+}
+
+std::string read_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error(
+            std::vformat("Cannot open {}", std::make_format_args(path)));
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+// Latencies in microseconds of the requests sent over one connection.
+std::vector<double> run_connection(const Options& options,
+                                   const std::string& source,
+                                   std::size_t first_request,
+                                   std::size_t request_count) {
+    const int fd = frontend::server::connect_unix_socket(options.socket_path);
+    frontend::server::FrameReader reader(fd);
+    std::vector<double> latencies;
+    latencies.reserve(request_count);
+
+    for (std::size_t i = 0; i < request_count; ++i) {
+        frontend::server::Frame request{options.command, source};
+        if (options.unique) {
+            request.payload += std::vformat(
+                "\n// {}", std::make_format_args(first_request + i));
+        }
+
+        const auto start = Clock::now();
+        frontend::server::write_frame(fd, request);
+        const auto response = reader.read();
+        const auto end = Clock::now();
+
+        if (!response.has_value()) {
+            ::close(fd);
+            throw std::runtime_error("Server closed the connection");
+        }
+        latencies.push_back(
+            std::chrono::duration<double, std::micro>(end - start).count());
+    }
+
+    ::close(fd);
+    return latencies;
+}
+
+double percentile(const std::vector<double>& sorted, double fraction) {
+    const auto index = static_cast<std::size_t>(
+        fraction * static_cast<double>(sorted.size() - 1));
+    return sorted[index];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const auto options = parse_options(argc, argv);
+        const auto source = read_file(options.file);
+
+        std::vector<std::vector<double>> results(options.connections);
+        std::vector<std::exception_ptr> errors(options.connections);
+        const auto start = Clock::now();
+        {
+            std::vector<std::jthread> clients;
+            const auto per_connection = options.requests / options.connections;
+            for (std::size_t c = 0; c < options.connections; ++c) {
+                const auto count =
+                    per_connection +
+                    (c < options.requests % options.connections ? 1 : 0);
+                clients.emplace_back([&, c, count]() {
+                    try {
+                        results[c] = run_connection(
+                            options, source, c * (per_connection + 1), count);
+                    } catch (...) {
+                        errors[c] = std::current_exception();
+                    }
+                });
+            }
+        }
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        std::vector<double> latencies;
+        for (const auto& result : results) {
+            latencies.insert(latencies.end(), result.begin(), result.end());
+        }
+        if (latencies.empty()) {
+            return 0;
+        }
+        std::sort(latencies.begin(), latencies.end());
+
+        const auto throughput =
+            static_cast<double>(latencies.size()) / elapsed.count();
+        std::cout << std::vformat(
+            "requests: {}, connections: {}, throughput: {} req/s\n"
+            "latency (us): p50 {}, p90 {}, p99 {}, p99.9 {}, max {}\n",
+            std::make_format_args(latencies.size(), options.connections,
+                                  throughput, percentile(latencies, 0.5),
+                                  percentile(latencies, 0.9),
+                                  percentile(latencies, 0.99),
+                                  percentile(latencies, 0.999),
+                                  latencies.back()));
+        return 0;
+    } catch (const std::invalid_argument& error) {
+        std::cerr << error.what() << '\n';
+        print_usage();
+        return 2;
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,118 @@
+#include "server/protocol.h"
+
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <format>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace frontend::server {
+
+namespace {
+constexpr std::size_t READ_CHUNK_SIZE = 64 * 1024;
+}
+
+bool FrameReader::fill() {
+    if (position_ > 0) {
+        buffer_.erase(0, position_);
+        position_ = 0;
+    }
+
+    std::array<char, READ_CHUNK_SIZE> chunk;
+    while (true) {
+        const auto count = ::read(fd_, chunk.data(), chunk.size());
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count < 0) {
+            throw std::system_error(errno, std::generic_category(), "read");
+        }
+        buffer_.append(chunk.data(), static_cast<std::size_t>(count));
+        return count > 0;
+    }
+}
+
+std::optional<Frame> FrameReader::read() {
+    auto newline = buffer_.find('\n', position_);
+    while (newline == std::string::npos) {
+        if (!fill()) {
+            if (position_ == buffer_.size()) {
+                return std::nullopt;
+            }
+            throw std::runtime_error("Truncated frame header");
+        }
+        newline = buffer_.find('\n', position_);
+    }
+
+    const std::string_view header(buffer_.data() + position_,
+                                  newline - position_);
+    const auto space = header.rfind(' ');
+    if (space == std::string_view::npos) {
+        throw std::runtime_error("Malformed frame header");
+    }
+    std::size_t length = 0;
+    const auto [end, error] = std::from_chars(
+        header.data() + space + 1, header.data() + header.size(), length);
+    if (error != std::errc() || end != header.data() + header.size()) {
+        throw std::runtime_error("Malformed frame length");
+    }
+
+    Frame frame{std::string(header.substr(0, space)), {}};
+    const auto payload_offset = header.size() + 1;
+    while (buffer_.size() - position_ < payload_offset + length) {
+        if (!fill()) {
+            throw std::runtime_error("Truncated frame payload");
+        }
+    }
+    frame.payload = buffer_.substr(position_ + payload_offset, length);
+    position_ += payload_offset + length;
+    return frame;
+}
+
+void write_frame(int fd, const Frame& frame) {
+    auto message = std::vformat(
+        "{} {}\n", std::make_format_args(frame.kind, frame.payload.size()));
+    message += frame.payload;
+
+    std::size_t written = 0;
+    while (written < message.size()) {
+        const auto count =
+            ::write(fd, message.data() + written, message.size() - written);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count < 0) {
+            throw std::system_error(errno, std::generic_category(), "write");
+        }
+        written += static_cast<std::size_t>(count);
+    }
+}
+
+int connect_unix_socket(const std::string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Socket path is too long");
+    }
+    path.copy(address.sun_path, path.size());
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "socket");
+    }
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address),
+                  sizeof(address)) < 0) {
+        const auto error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "connect");
+    }
+    return fd;
+}
+
+} // namespace frontend::server
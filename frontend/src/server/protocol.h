@@ -0,0 +1,42 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+namespace frontend::server {
+
+// Requests and responses share one framing: a header line
+// "<kind> <payload length>\n" followed by the raw payload bytes. Requests use
+// the command as kind, responses "ok" or "error".
+struct Frame {
+    std::string kind;
+    std::string payload;
+
+    bool operator==(const Frame& other) const = default;
+};
+
+// Buffered reader of frames from a file descriptor.
+class FrameReader {
+public:
+    explicit FrameReader(int fd) : fd_(fd) {}
+
+    // std::nullopt on a clean end of stream; throws std::runtime_error on a
+    // malformed or truncated frame.
+    std::optional<Frame> read();
+
+private:
+    // false on end of stream
+    bool fill();
+
+    int fd_;
+    std::string buffer_;
+    std::size_t position_ = 0;
+};
+
+void write_frame(int fd, const Frame& frame);
+
+// Client side of CompileServer::serve_unix_socket(); returns the connected
+// file descriptor.
+int connect_unix_socket(const std::string& path);
+
+} // namespace frontend::server
@@ -0,0 +1,99 @@
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include "server/protocol.h"
+
+namespace {
+
+using frontend::server::Frame;
+using frontend::server::FrameReader;
+
+class Pipe {
+public:
+    Pipe() {
+        if (::pipe(fds_.data()) != 0) {
+            throw std::runtime_error("pipe");
+        }
+    }
+
+    ~Pipe() {
+        close_write();
+        ::close(fds_[0]);
+    }
+
+    int read_end() const {
+        return fds_[0];
+    }
+
+    int write_end() const {
+        return fds_[1];
+    }
+
+    void write(const std::string& bytes) {
+        ASSERT_EQ(::write(fds_[1], bytes.data(), bytes.size()),
+                  static_cast<ssize_t>(bytes.size()));
+    }
+
+    void close_write() {
+        if (fds_[1] >= 0) {
+            ::close(fds_[1]);
+            fds_[1] = -1;
+        }
+    }
+
+private:
+    std::array<int, 2> fds_{};
+};
+
+TEST(Protocol, RoundTrip) {
+    Pipe pipe;
+    const Frame first{"ast", "1 + 2;\nif (1) 2;"};
+    const Frame second{"check", ""};
+    frontend::server::write_frame(pipe.write_end(), first);
+    frontend::server::write_frame(pipe.write_end(), second);
+    pipe.close_write();
+    FrameReader reader(pipe.read_end());
+
+    EXPECT_EQ(reader.read(), first);
+    EXPECT_EQ(reader.read(), second);
+    EXPECT_EQ(reader.read(), std::nullopt);
+}
+
+TEST(Protocol, PayloadLargerThanReadChunk) {
+    Pipe pipe;
+    const Frame frame{"tokens", std::string(100'000, ';')};
+    FrameReader reader(pipe.read_end());
+
+    // the pipe buffer is smaller than the frame, so write from a thread
+    std::jthread writer([&]() {
+        frontend::server::write_frame(pipe.write_end(), frame);
+        pipe.close_write();
+    });
+
+    EXPECT_EQ(reader.read(), frame);
+}
+
+TEST(Protocol, TruncatedPayload) {
+    Pipe pipe;
+    pipe.write("ast 10\n1;");
+    pipe.close_write();
+    FrameReader reader(pipe.read_end());
+
+    EXPECT_THROW(reader.read(), std::runtime_error);
+}
+
+TEST(Protocol, MalformedLength) {
+    Pipe pipe;
+    pipe.write("ast ten\n");
+    pipe.close_write();
+    FrameReader reader(pipe.read_end());
+
+    EXPECT_THROW(reader.read(), std::runtime_error);
+}
+
+} // namespace
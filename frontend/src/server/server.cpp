@@ -0,0 +1,216 @@
+#include "server/server.h"
+
+#include <format>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "parser.h"
+#include "resolver.h"
+#include "scanner.h"
+#include "statistics.h"
+#include "thread_pool.h"
+#include "type_checker.h"
+
+namespace frontend::server {
+
+namespace {
+
+const Frame OK{"ok", ""};
+
+std::string cache_key(const Frame& request) {
+    std::string key = request.kind;
+    key += '\0';
+    key += request.payload;
+    return key;
+}
+
+} // namespace
+
+Frame CompileServer::compute(const Frame& request) const {
+    try {
+        if (request.kind == "tokens") {
+            std::string output;
+            for (const auto& token : Scanner(request.payload).scan_tokens()) {
+                output += token.to_string();
+                output += '\n';
+            }
+            return {"ok", std::move(output)};
+        }
+        if (request.kind == "ast") {
+            Parser parser(Scanner(request.payload).scan_tokens());
+            return {"ok", parser.parse().to_string()};
+        }
+        if (request.kind == "check") {
+            const auto tree =
+                Parser(Scanner(request.payload).scan_tokens()).parse();
+            Resolver().resolve(tree);
+            const auto result = type_check(tree);
+            std::string diagnostics;
+            for (const auto& diagnostic : result.diagnostics) {
+                diagnostics += to_string(diagnostic);
+                diagnostics += '\n';
+            }
+            return {result.has_errors() ? "error" : "ok",
+                    std::move(diagnostics)};
+        }
+        if (request.kind == "statistics") {
+            const auto tokens = Scanner(request.payload).scan_tokens();
+            const auto tree = Parser(tokens).parse();
+            return {"ok", to_json(collect_statistics(request.payload, tokens,
+                                                     tree))};
+        }
+        return {"error", std::vformat("Unknown command: {}",
+                                      std::make_format_args(request.kind))};
+    } catch (const std::exception& error) {
+        return {"error", error.what()};
+    }
+}
+
+Frame CompileServer::handle(const Frame& request) {
+    if (request.kind == "shutdown") {
+        shut_down_.store(true, std::memory_order_release);
+        if (const auto fd = listen_fd_.load(); fd >= 0) {
+            // wakes up the thread blocked in accept()
+            ::shutdown(fd, SHUT_RDWR);
+        }
+        // idle clients would keep their connections, and with them the
+        // server, alive; reads see the end of stream, while the reply to this
+        // request can still be written
+        std::scoped_lock lock(connections_mutex_);
+        for (const auto connection : connections_) {
+            ::shutdown(connection, SHUT_RD);
+        }
+        return OK;
+    }
+
+    auto key = cache_key(request);
+    {
+        std::scoped_lock lock(cache_mutex_);
+        if (request.kind == "stats") {
+            return {"ok", std::vformat("requests: {}, cache hits: {}\n",
+                                       std::make_format_args(requests_,
+                                                             cache_hits_))};
+        }
+        ++requests_;
+        if (const auto cached = cache_.find(key); cached != cache_.end()) {
+            ++cache_hits_;
+            return cached->second;
+        }
+    }
+
+    auto response = compute(request);
+
+    std::scoped_lock lock(cache_mutex_);
+    if (options_.cache_capacity == 0) {
+        return response;
+    }
+    // another connection may have cached the same request meanwhile
+    if (!cache_.try_emplace(key, response).second) {
+        return response;
+    }
+    cache_order_.push_back(std::move(key));
+    if (cache_.size() > options_.cache_capacity) {
+        cache_.erase(cache_order_.front());
+        cache_order_.pop_front();
+    }
+    return response;
+}
+
+void CompileServer::serve(int in_fd, int out_fd) {
+    FrameReader reader(in_fd);
+    while (!is_shut_down()) {
+        Frame response;
+        try {
+            const auto request = reader.read();
+            if (!request.has_value()) {
+                return;
+            }
+            response = handle(*request);
+        } catch (const std::runtime_error& error) {
+            // the stream cannot be resynchronised after a framing error
+            write_frame(out_fd, {"error", error.what()});
+            return;
+        }
+        write_frame(out_fd, response);
+    }
+}
+
+void CompileServer::serve_unix_socket(const std::string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Socket path is too long");
+    }
+    path.copy(address.sun_path, path.size());
+
+    // a socket left behind by a server that died is replaced; anything else
+    // at the path is not ours to remove
+    struct stat existing{};
+    if (::lstat(path.c_str(), &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode)) {
+            throw std::system_error(EEXIST, std::generic_category(), path);
+        }
+        ::unlink(path.c_str());
+    }
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "socket");
+    }
+    struct stat created{};
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&address),
+               sizeof(address)) < 0 ||
+        ::lstat(path.c_str(), &created) < 0 ||
+        ::listen(fd, SOMAXCONN) < 0) {
+        const auto error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "bind");
+    }
+    listen_fd_.store(fd);
+
+    ThreadPool connections(options_.connection_threads);
+    while (!is_shut_down()) {
+        const int connection = ::accept(fd, nullptr, nullptr);
+        if (connection < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        {
+            std::scoped_lock lock(connections_mutex_);
+            connections_.insert(connection);
+            // a shutdown request may have missed it
+            if (is_shut_down()) {
+                ::shutdown(connection, SHUT_RD);
+            }
+        }
+        connections.submit([this, connection]() {
+            try {
+                serve(connection, connection);
+            } catch (const std::system_error&) {
+                // the client went away
+            }
+            std::scoped_lock lock(connections_mutex_);
+            connections_.erase(connection);
+            ::close(connection);
+        });
+    }
+
+    listen_fd_.store(-1);
+    ::close(fd);
+    // unless another server has replaced the socket in the meantime
+    struct stat current{};
+    if (::lstat(path.c_str(), &current) == 0 &&
+        current.st_dev == created.st_dev && current.st_ino == created.st_ino) {
+        ::unlink(path.c_str());
+    }
+}
+
+} // namespace frontend::server
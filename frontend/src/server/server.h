@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "server/protocol.h"
+
+namespace frontend::server {
+
+struct ServerOptions {
+    // number of responses kept for repeated requests
+    std::size_t cache_capacity = 1024;
+    // connections served concurrently; further ones are not read from until
+    // one of these is closed, however long its client keeps it open
+    std::size_t connection_threads = std::thread::hardware_concurrency();
+};
+
+// Long-lived compile server. Answers framed requests with the payload being
+// source code:
+//   tokens     -> one token per line
+//   ast        -> AbstractSyntaxTree::to_string()
+//   check      -> the type checker's diagnostics, one per line; an "ok"
+//                 frame when none of them is an error
+//   statistics -> to_json() of the source's SourceStatistics
+//   stats      -> request and cache counters (payload ignored)
+//   shutdown   -> stops serving after replying
+// Failures are answered with an "error" frame carrying the message. Responses
+// are cached by request so repeated builds of unchanged files are free.
+class CompileServer {
+public:
+    explicit CompileServer(ServerOptions options = {}) : options_(options) {}
+
+    Frame handle(const Frame& request);
+
+    // Serves requests from `in_fd` until end of stream or shutdown.
+    void serve(int in_fd, int out_fd);
+
+    // Listens on a Unix domain socket at `path` until a shutdown request
+    // arrives, then ends the open connections once their current requests
+    // are answered.
+    void serve_unix_socket(const std::string& path);
+
+    bool is_shut_down() const {
+        return shut_down_.load(std::memory_order_acquire);
+    }
+
+private:
+    Frame compute(const Frame& request) const;
+
+    ServerOptions options_;
+    std::atomic<bool> shut_down_ = false;
+    std::atomic<int> listen_fd_ = -1;
+
+    std::mutex connections_mutex_;
+    // accepted connections not closed yet, for a shutdown to end them
+    std::unordered_set<int> connections_;
+
+    std::mutex cache_mutex_;
+    std::unordered_map<std::string, Frame> cache_;
+    // insertion order, for evicting the oldest entry
+    std::deque<std::string> cache_order_;
+    std::size_t requests_ = 0;
+    std::size_t cache_hits_ = 0;
+};
+
+} // namespace frontend::server
@@ -0,0 +1,212 @@
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <latch>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "server/protocol.h"
+#include "server/server.h"
+
+namespace {
+
+using frontend::server::CompileServer;
+using frontend::server::Frame;
+
+TEST(CompileServer, Tokens) {
+    CompileServer server;
+
+    EXPECT_EQ(server.handle({"tokens", "1;"}),
+              (Frame{"ok", "1: NUMBER (1)\n1: SEMICOLON\n1: END_OF_FILE\n"}));
+}
+
+TEST(CompileServer, Ast) {
+    CompileServer server;
+
+    EXPECT_EQ(server.handle({"ast", "1;"}),
+              (Frame{"ok", "AST(root: CompoundStatement(statements: ["
+                           "ExpressionStatement(expression: "
+                           "Literal(value: 1))]))"}));
+}
+
+TEST(CompileServer, Statistics) {
+    CompileServer server;
+
+    const auto response = server.handle({"statistics", "1 + 2;"});
+    EXPECT_EQ(response.kind, "ok");
+    EXPECT_TRUE(response.payload.starts_with(
+        "{\"source_bytes\":6,\"token_count\":5,\"node_count\":5,"));
+    EXPECT_NE(response.payload.find("\"operators\":{\"ADDITION\":1}"),
+              std::string::npos);
+    EXPECT_EQ(server.handle({"statistics", "(1;"}).kind, "error");
+}
+
+TEST(CompileServer, Diagnostics) {
+    CompileServer server;
+
+    EXPECT_EQ(server.handle({"check", "1;"}), (Frame{"ok", ""}));
+    EXPECT_EQ(server.handle({"check", "(1;"}).kind, "error");
+    EXPECT_EQ(server.handle({"check", "const x = 1; x;"}), (Frame{"ok", ""}));
+    EXPECT_EQ(server.handle({"check", "x;"}),
+              (Frame{"error", "Undeclared identifier x"}));
+    EXPECT_EQ(server.handle({"check", "1; true + 1;"}),
+              (Frame{"error", "statement 1: error: Unsupported operand types "
+                              "for ADDITION: BOOL and INT\n"}));
+    EXPECT_EQ(server.handle({"check", "if (\"s\") 1;"}),
+              (Frame{"ok", "statement 0: warning: Condition of type STRING "
+                           "is tested for truthiness\n"}));
+    EXPECT_EQ(server.handle({"compile", "1;"}).kind, "error");
+}
+
+TEST(CompileServer, RepeatedRequestsAreCached) {
+    CompileServer server({.cache_capacity = 1});
+
+    server.handle({"ast", "1;"});
+    server.handle({"ast", "1;"});
+    server.handle({"ast", "2;"});
+    server.handle({"ast", "1;"});
+
+    EXPECT_EQ(server.handle({"stats", ""}).payload,
+              "requests: 4, cache hits: 1\n");
+}
+
+TEST(CompileServer, ConcurrentMissesEvictNothingElse) {
+    CompileServer server({.cache_capacity = 2});
+    server.handle({"ast", "1;"});
+
+    // most of them miss and compute the same response at once
+    std::string source;
+    for (int n = 0; n < 10000; ++n) {
+        source += "1 + 2;";
+    }
+    std::latch start(8);
+    {
+        std::vector<std::jthread> clients;
+        for (int client = 0; client < 8; ++client) {
+            clients.emplace_back([&]() {
+                start.arrive_and_wait();
+                server.handle({"ast", source});
+            });
+        }
+    }
+    // some of them may have been hits, which is fine
+    const auto stats = server.handle({"stats", ""}).payload;
+    const auto hits = std::stoul(stats.substr(stats.rfind(':') + 1));
+
+    server.handle({"ast", "1;"});
+
+    EXPECT_EQ(server.handle({"stats", ""}).payload,
+              "requests: 10, cache hits: " + std::to_string(hits + 1) + "\n");
+}
+
+TEST(CompileServer, ServeOverStreams) {
+    std::array<int, 2> requests{};
+    std::array<int, 2> responses{};
+    ASSERT_EQ(::pipe(requests.data()), 0);
+    ASSERT_EQ(::pipe(responses.data()), 0);
+    frontend::server::write_frame(requests[1], {"check", "1;"});
+    frontend::server::write_frame(requests[1], {"shutdown", ""});
+    frontend::server::write_frame(requests[1], {"check", "2;"});
+    ::close(requests[1]);
+
+    CompileServer server;
+    server.serve(requests[0], responses[1]);
+    ::close(responses[1]);
+
+    frontend::server::FrameReader reader(responses[0]);
+    EXPECT_EQ(reader.read(), (Frame{"ok", ""}));
+    EXPECT_EQ(reader.read(), (Frame{"ok", ""}));
+    // nothing is served after the shutdown
+    EXPECT_EQ(reader.read(), std::nullopt);
+    ::close(requests[0]);
+    ::close(responses[0]);
+}
+
+TEST(CompileServer, ServeUnixSocket) {
+    const auto path =
+        (std::filesystem::temp_directory_path() /
+         ("compile-server-test-" + std::to_string(::getpid()) + ".sock"))
+            .string();
+    CompileServer server({.connection_threads = 2});
+    std::jthread server_thread([&]() { server.serve_unix_socket(path); });
+
+    int fd = -1;
+    for (int attempt = 0; attempt < 500 && fd < 0; ++attempt) {
+        try {
+            fd = frontend::server::connect_unix_socket(path);
+        } catch (const std::system_error&) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    ASSERT_GE(fd, 0);
+    frontend::server::FrameReader reader(fd);
+
+    frontend::server::write_frame(fd, {"check", "1 + 2;"});
+    EXPECT_EQ(reader.read(), (Frame{"ok", ""}));
+    frontend::server::write_frame(fd, {"shutdown", ""});
+    EXPECT_EQ(reader.read(), (Frame{"ok", ""}));
+    ::close(fd);
+
+    server_thread.join();
+    EXPECT_TRUE(server.is_shut_down());
+    EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST(CompileServer, ShutdownEndsIdleConnections) {
+    const auto path =
+        (std::filesystem::temp_directory_path() /
+         ("compile-server-test-" + std::to_string(::getpid()) + "-idle.sock"))
+            .string();
+    CompileServer server({.connection_threads = 2});
+    std::jthread server_thread([&]() { server.serve_unix_socket(path); });
+
+    int idle = -1;
+    for (int attempt = 0; attempt < 500 && idle < 0; ++attempt) {
+        try {
+            idle = frontend::server::connect_unix_socket(path);
+        } catch (const std::system_error&) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    ASSERT_GE(idle, 0);
+    frontend::server::FrameReader idle_reader(idle);
+    frontend::server::write_frame(idle, {"check", "1;"});
+    EXPECT_EQ(idle_reader.read(), (Frame{"ok", ""}));
+
+    const int fd = frontend::server::connect_unix_socket(path);
+    frontend::server::FrameReader reader(fd);
+    frontend::server::write_frame(fd, {"shutdown", ""});
+    EXPECT_EQ(reader.read(), (Frame{"ok", ""}));
+    ::close(fd);
+
+    // the idle client sees the end of stream without closing its side
+    EXPECT_EQ(idle_reader.read(), std::nullopt);
+    server_thread.join();
+    ::close(idle);
+    EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST(CompileServer, ServeUnixSocketKeepsOtherFiles) {
+    const auto path =
+        (std::filesystem::temp_directory_path() /
+         ("compile-server-test-" + std::to_string(::getpid()) + ".txt"))
+            .string();
+    std::ofstream(path) << "not a socket";
+
+    CompileServer server;
+    EXPECT_THROW(server.serve_unix_socket(path), std::system_error);
+
+    std::string contents;
+    std::getline(std::ifstream(path), contents);
+    EXPECT_EQ(contents, "not a socket");
+    std::filesystem::remove(path);
+}
+
+} // namespace
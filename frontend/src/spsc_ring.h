@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace frontend {
+
+inline constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. The capacity is rounded up to a power of two so that indices can be
+// wrapped with a mask; head and tail live on separate cache lines to avoid
+// false sharing between the two threads.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(std::size_t capacity)
+        : slots_(std::bit_ceil(capacity)), mask_(slots_.size() - 1) {
+        if (capacity == 0) {
+            throw std::logic_error("SpscRing capacity must be non-zero");
+        }
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    std::size_t capacity() const {
+        return slots_.size();
+    }
+
+    // Producer side. Returns false without consuming `value` if the ring is
+    // full.
+    bool try_push(T& value) {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ == slots_.size()) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ == slots_.size()) {
+                return false;
+            }
+        }
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer side. Spins until there is room; returns false if the ring was
+    // closed before `value` could be pushed.
+    bool push(T value) {
+        while (!try_push(value)) {
+            if (closed_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    // Consumer side. Returns false if the ring is currently empty.
+    bool try_pop(T& out) {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return false;
+            }
+        }
+        out = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Spins until a value is available; returns false once the
+    // ring has been closed and drained.
+    bool pop(T& out) {
+        while (!try_pop(out)) {
+            if (closed_.load(std::memory_order_acquire)) {
+                // the producer may have pushed right before closing
+                return try_pop(out);
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    // Either side may close the ring: the producer to signal the end of the
+    // stream, the consumer to make a blocked producer give up.
+    void close() {
+        closed_.store(true, std::memory_order_release);
+    }
+
+private:
+    std::vector<T> slots_;
+    const std::size_t mask_;
+    std::atomic<bool> closed_ = false;
+
+    // consumer-owned
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head_ = 0;
+    std::size_t cached_tail_ = 0;
+
+    // producer-owned
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail_ = 0;
+    std::size_t cached_head_ = 0;
+};
+
+} // namespace frontend
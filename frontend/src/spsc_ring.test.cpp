@@ -0,0 +1,75 @@
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "spsc_ring.h"
+
+namespace {
+
+TEST(SpscRing, RoundsCapacityUpToPowerOfTwo) {
+    frontend::SpscRing<int> ring(5);
+
+    EXPECT_EQ(ring.capacity(), 8);
+}
+
+TEST(SpscRing, TryPushFailsWhenFull) {
+    frontend::SpscRing<int> ring(2);
+    int value = 1;
+
+    EXPECT_TRUE(ring.try_push(value));
+    EXPECT_TRUE(ring.try_push(value));
+    EXPECT_FALSE(ring.try_push(value));
+
+    int popped = 0;
+    EXPECT_TRUE(ring.try_pop(popped));
+    EXPECT_TRUE(ring.try_push(value));
+}
+
+TEST(SpscRing, PopDrainsBeforeReportingClosed) {
+    frontend::SpscRing<int> ring(4);
+    ring.push(1);
+    ring.push(2);
+    ring.close();
+
+    int value = 0;
+    EXPECT_TRUE(ring.pop(value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(ring.pop(value));
+    EXPECT_EQ(value, 2);
+    EXPECT_FALSE(ring.pop(value));
+}
+
+TEST(SpscRing, PushFailsOnceConsumerCloses) {
+    frontend::SpscRing<int> ring(1);
+    ring.push(1);
+    ring.close();
+
+    EXPECT_FALSE(ring.push(2));
+}
+
+TEST(SpscRing, PreservesOrderAcrossThreads) {
+    constexpr int COUNT = 100'000;
+    frontend::SpscRing<int> ring(16);
+
+    std::jthread producer([&] {
+        for (int i = 0; i < COUNT; ++i) {
+            ring.push(i);
+        }
+        ring.close();
+    });
+
+    std::vector<int> received;
+    int value = 0;
+    while (ring.pop(value)) {
+        received.push_back(value);
+    }
+
+    ASSERT_EQ(received.size(), static_cast<std::size_t>(COUNT));
+    for (int i = 0; i < COUNT; ++i) {
+        EXPECT_EQ(received[static_cast<std::size_t>(i)], i);
+    }
+}
+
+} // namespace
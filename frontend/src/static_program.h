@@ -0,0 +1,795 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "ast/ast.h"
+#include "ast/node.h"
+#include "ast/operator.h"
+#include "lexicon.h"
+#include "token.h"
+
+// Scanning and parsing at compile time, for sources embedded in the binary:
+//
+//     static constexpr auto SCRIPT = frontend::parse_static<"1 + 2;">();
+//
+// The tokens and the flat tree are built by the compiler, so embedded
+// scripts cost nothing at startup and syntax errors in them fail the build.
+// The language and the trees are those of Scanner and Parser; what these
+// merely skip or report on stderr, unknown characters and unterminated
+// strings, are errors here too. Sources are bounded by the compiler's
+// constexpr limits, e.g. GCC's -fconstexpr-depth for nesting and
+// -fconstexpr-loop-limit for their length.
+
+namespace frontend {
+
+// A string literal usable as a template argument.
+template <std::size_t N>
+struct FixedString {
+    consteval FixedString(const char (&text)[N]) {
+        std::copy_n(text, N, characters);
+    }
+
+    constexpr std::string_view view() const {
+        return {characters, N - 1};
+    }
+
+    char characters[N]{};
+};
+
+struct StaticToken {
+    Token::Type type{};
+    std::uint32_t line = 0;
+    // offset and length of the lexeme, of the text between the quotes for
+    // a STRING
+    std::uint32_t begin = 0;
+    std::uint32_t length = 0;
+};
+
+// A node of a flat tree, which refers to other nodes by their index.
+struct StaticNode {
+    enum class Kind : std::uint8_t {
+        COMPOUND_STATEMENT,
+        IF_STATEMENT,
+        EXPRESSION_STATEMENT,
+        CONST_DECLARATION,
+        BINARY_EXPRESSION,
+        IDENTIFIER,
+        BOOL_LITERAL,
+        INTEGER_LITERAL,
+        DOUBLE_LITERAL,
+        STRING_LITERAL,
+    };
+
+    static constexpr std::uint32_t NONE =
+        std::numeric_limits<std::uint32_t>::max();
+
+    Kind kind{};
+    ast::Operator::Type op{};
+    // COMPOUND_STATEMENT: its first statement
+    // IF_STATEMENT: condition, then and else
+    // EXPRESSION_STATEMENT: the expression
+    // CONST_DECLARATION: the initializer
+    // BINARY_EXPRESSION: left and right
+    // NONE where there is none
+    std::array<std::uint32_t, 3> children{NONE, NONE, NONE};
+    // the following statement of the same CompoundStatement
+    std::uint32_t next = NONE;
+
+    bool boolean = false;
+    std::int64_t integer = 0;
+    double floating = 0;
+    // the decoded text of a STRING_LITERAL or the name of an IDENTIFIER or
+    // CONST_DECLARATION, in the program's strings
+    std::uint32_t string_begin = 0;
+    std::uint32_t string_length = 0;
+};
+
+namespace detail {
+
+// Deliberately not constexpr: reaching it makes a constant evaluation fail,
+// and the compiler's notes show the message and line.
+[[noreturn]] inline void static_syntax_error(const char* message,
+                                             std::size_t line) {
+    throw std::logic_error(
+        std::vformat("Line {}: {}", std::make_format_args(line, message)));
+}
+
+constexpr std::uint32_t narrow(std::size_t value) {
+    if (value > std::numeric_limits<std::uint32_t>::max()) {
+        static_syntax_error("Source too large", 0);
+    }
+    return static_cast<std::uint32_t>(value);
+}
+
+// Scans `source` like Scanner, handing every token up to and including
+// END_OF_FILE to `emit`.
+template <typename Emit>
+constexpr void scan_source(std::string_view source, Emit&& emit) {
+    std::size_t line = 1;
+    std::size_t current = 0;
+    const auto token = [&](Token::Type type, std::size_t begin,
+                           std::size_t end) {
+        emit(StaticToken{.type = type,
+                         .line = narrow(line),
+                         .begin = narrow(begin),
+                         .length = narrow(end - begin)});
+    };
+    const auto match = [&](char expected) {
+        if (current < source.size() && source[current] == expected) {
+            ++current;
+            return true;
+        }
+        return false;
+    };
+    const auto peek = [&](std::size_t offset) {
+        return current + offset < source.size() ? source[current + offset]
+                                                : '\0';
+    };
+
+    while (current < source.size()) {
+        const auto start = current;
+        const char c = source[current++];
+        const auto simple = [&](Token::Type type) {
+            token(type, start, current);
+        };
+        switch (c) {
+            case '(':
+                simple(Token::Type::LEFT_PAREN);
+                break;
+            case ')':
+                simple(Token::Type::RIGHT_PAREN);
+                break;
+            case '{':
+                simple(Token::Type::LEFT_BRACE);
+                break;
+            case '}':
+                simple(Token::Type::RIGHT_BRACE);
+                break;
+            case '[':
+                simple(Token::Type::LEFT_BRACKET);
+                break;
+            case ']':
+                simple(Token::Type::RIGHT_BRACKET);
+                break;
+            case ';':
+                simple(Token::Type::SEMICOLON);
+                break;
+            case '+':
+                simple(Token::Type::PLUS);
+                break;
+            case '-':
+                simple(Token::Type::MINUS);
+                break;
+            case '*':
+                simple(Token::Type::STAR);
+                break;
+            case '%':
+                simple(Token::Type::PERCENT);
+                break;
+            case '!':
+                simple(match('=') ? Token::Type::BANG_EQUAL
+                                  : Token::Type::BANG);
+                break;
+            case '=':
+                simple(match('=') ? Token::Type::EQUAL_EQUAL
+                                  : Token::Type::EQUAL);
+                break;
+            case '<':
+                simple(match('=')   ? Token::Type::LESS_EQUAL
+                       : match('<') ? Token::Type::LESS_LESS
+                                    : Token::Type::LESS);
+                break;
+            case '>':
+                simple(match('=')   ? Token::Type::GREATER_EQUAL
+                       : match('>') ? Token::Type::GREATER_GREATER
+                                    : Token::Type::GREATER);
+                break;
+            case '/':
+                if (match('/')) {
+                    while (current < source.size() && source[current] != '\n') {
+                        ++current;
+                    }
+                } else {
+                    simple(Token::Type::SLASH);
+                }
+                break;
+            case ' ':
+            case '\r':
+            case '\t':
+                break;
+            case '\n':
+                ++line;
+                break;
+            case '"': {
+                // the closing quote, skipping over escaped characters
+                auto end = current;
+                while (end < source.size() && source[end] != '"') {
+                    end += source[end] == '\\' ? 2U : 1U;
+                }
+                if (end >= source.size()) {
+                    static_syntax_error("Unterminated string", line);
+                }
+                // on the line of the closing quote, as Scanner does
+                line += static_cast<std::size_t>(std::count(
+                    source.begin() + static_cast<std::ptrdiff_t>(current),
+                    source.begin() + static_cast<std::ptrdiff_t>(end), '\n'));
+                token(Token::Type::STRING, current, end);
+                current = end + 1;
+                break;
+            }
+            default:
+                if (is_digit(c)) {
+                    while (is_digit(peek(0))) {
+                        ++current;
+                    }
+                    if (peek(0) == '.' && is_digit(peek(1))) {
+                        ++current;
+                        while (is_digit(peek(0))) {
+                            ++current;
+                        }
+                    }
+                    simple(Token::Type::NUMBER);
+                } else if (is_alpha(c)) {
+                    while (is_alpha_numeric(peek(0))) {
+                        ++current;
+                    }
+                    simple(reserved_word(source.substr(start, current - start))
+                               .value_or(Token::Type::IDENTIFIER));
+                } else {
+                    static_syntax_error("Unexpected character", line);
+                }
+                break;
+        }
+    }
+    token(Token::Type::END_OF_FILE, source.size(), source.size());
+}
+
+constexpr std::size_t count_tokens(std::string_view source) {
+    std::size_t count = 0;
+    scan_source(source, [&](const StaticToken&) { ++count; });
+    return count;
+}
+
+} // namespace detail
+
+// Builds the flat tree of a scanned source into caller-provided storage,
+// following Parser rule by rule. Every node stands for a token of its own,
+// so as many nodes as tokens always suffice, and the decoded strings are
+// never longer than the source.
+class StaticParser {
+public:
+    constexpr StaticParser(std::string_view source,
+                           std::span<const StaticToken> tokens,
+                           std::span<StaticNode> nodes,
+                           std::span<char> strings)
+        : source_(source), tokens_(tokens), nodes_(nodes), strings_(strings) {
+    }
+
+    // Index of the root CompoundStatement.
+    constexpr std::uint32_t parse() {
+        const auto root = add({.kind = StaticNode::Kind::COMPOUND_STATEMENT});
+        auto last = StaticNode::NONE;
+        while (!check(Token::Type::END_OF_FILE)) {
+            append(root, last, statement());
+        }
+        return root;
+    }
+
+    constexpr std::size_t node_count() const {
+        return node_count_;
+    }
+
+    constexpr std::size_t string_bytes() const {
+        return string_bytes_;
+    }
+
+private:
+    constexpr const StaticToken& peek() const {
+        return tokens_[current_];
+    }
+
+    constexpr bool check(Token::Type type) const {
+        return peek().type == type;
+    }
+
+    constexpr bool match(Token::Type type) {
+        if (!check(type) || type == Token::Type::END_OF_FILE) {
+            return false;
+        }
+        ++current_;
+        return true;
+    }
+
+    constexpr void consume(Token::Type type, const char* message) {
+        if (!match(type)) {
+            detail::static_syntax_error(message, peek().line);
+        }
+    }
+
+    constexpr std::uint32_t add(const StaticNode& node) {
+        if (node_count_ == nodes_.size()) {
+            detail::static_syntax_error("Too many nodes", peek().line);
+        }
+        nodes_[node_count_] = node;
+        return detail::narrow(node_count_++);
+    }
+
+    constexpr void append(std::uint32_t compound, std::uint32_t& last,
+                          std::uint32_t statement) {
+        if (last == StaticNode::NONE) {
+            nodes_[compound].children[0] = statement;
+        } else {
+            nodes_[last].next = statement;
+        }
+        last = statement;
+    }
+
+    constexpr std::uint32_t statement() {
+        if (check(Token::Type::CONST)) {
+            return const_declaration();
+        }
+        if (check(Token::Type::IF)) {
+            return selection_statement();
+        }
+        if (check(Token::Type::LEFT_BRACE)) {
+            return compound_statement();
+        }
+        return expression_statement();
+    }
+
+    constexpr std::uint32_t const_declaration() {
+        consume(Token::Type::CONST, "Expected const");
+        consume(Token::Type::IDENTIFIER, "Expected a name after const");
+        const auto& name = previous();
+        consume(Token::Type::EQUAL, "Expected = after the name");
+        const auto initializer = expression();
+        if (initializer == StaticNode::NONE) {
+            detail::static_syntax_error("Missing initializer", name.line);
+        }
+        consume(Token::Type::SEMICOLON, "Expected ;");
+        auto declaration = named(name);
+        declaration.kind = StaticNode::Kind::CONST_DECLARATION;
+        declaration.children[0] = initializer;
+        return add(declaration);
+    }
+
+    // A node carrying the name `token` spells.
+    constexpr StaticNode named(const StaticToken& token) {
+        const auto begin = string_bytes_;
+        for (const char c : text(token)) {
+            strings_[string_bytes_++] = c;
+        }
+        return {.string_begin = detail::narrow(begin),
+                .string_length = detail::narrow(string_bytes_ - begin)};
+    }
+
+    constexpr std::uint32_t selection_statement() {
+        consume(Token::Type::IF, "Expected if");
+        consume(Token::Type::LEFT_PAREN, "Expected ( after if");
+        const auto condition = expression();
+        if (condition == StaticNode::NONE) {
+            detail::static_syntax_error("Expected a condition", peek().line);
+        }
+        consume(Token::Type::RIGHT_PAREN, "Expected ) after the condition");
+        const auto then = statement();
+        auto else_statement = StaticNode::NONE;
+        if (match(Token::Type::ELSE)) {
+            else_statement = statement();
+        }
+        return add({.kind = StaticNode::Kind::IF_STATEMENT,
+                    .children = {condition, then, else_statement}});
+    }
+
+    constexpr std::uint32_t compound_statement() {
+        consume(Token::Type::LEFT_BRACE, "Expected {");
+        const auto compound =
+            add({.kind = StaticNode::Kind::COMPOUND_STATEMENT});
+        auto last = StaticNode::NONE;
+        while (!check(Token::Type::END_OF_FILE) &&
+               !check(Token::Type::RIGHT_BRACE)) {
+            append(compound, last, statement());
+        }
+        consume(Token::Type::RIGHT_BRACE, "Expected }");
+        return compound;
+    }
+
+    constexpr std::uint32_t expression_statement() {
+        const auto expression = this->expression();
+        consume(Token::Type::SEMICOLON, "Expected ;");
+        return add({.kind = StaticNode::Kind::EXPRESSION_STATEMENT,
+                    .children = {expression, StaticNode::NONE,
+                                 StaticNode::NONE}});
+    }
+
+    constexpr std::uint32_t expression() {
+        return equality_expression();
+    }
+
+    constexpr std::uint32_t equality_expression() {
+        auto expression = relational_expression();
+        for (;;) {
+            if (match(Token::Type::EQUAL_EQUAL)) {
+                expression = binary(expression, ast::Operator::Type::EQUAL_TO,
+                                    relational_expression());
+            } else if (match(Token::Type::BANG_EQUAL)) {
+                expression =
+                    binary(expression, ast::Operator::Type::NOT_EQUAL_TO,
+                           relational_expression());
+            } else {
+                return expression;
+            }
+        }
+    }
+
+    constexpr std::uint32_t relational_expression() {
+        auto expression = shift_expression();
+        for (;;) {
+            if (match(Token::Type::LESS)) {
+                expression = binary(expression, ast::Operator::Type::LESS_THAN,
+                                    shift_expression());
+            } else if (match(Token::Type::LESS_EQUAL)) {
+                expression = binary(
+                    expression, ast::Operator::Type::LESS_THAN_OR_EQUAL_TO,
+                    shift_expression());
+            } else if (match(Token::Type::GREATER)) {
+                expression =
+                    binary(expression, ast::Operator::Type::GREATER_THAN,
+                           shift_expression());
+            } else if (match(Token::Type::GREATER_EQUAL)) {
+                expression = binary(
+                    expression, ast::Operator::Type::GREATER_THAN_OR_EQUAL_TO,
+                    shift_expression());
+            } else {
+                return expression;
+            }
+        }
+    }
+
+    constexpr std::uint32_t shift_expression() {
+        auto expression = additive_expression();
+        for (;;) {
+            if (match(Token::Type::GREATER_GREATER)) {
+                expression =
+                    binary(expression, ast::Operator::Type::BITWISE_RIGHT_SHIFT,
+                           additive_expression());
+            } else if (match(Token::Type::LESS_LESS)) {
+                expression =
+                    binary(expression, ast::Operator::Type::BITWISE_LEFT_SHIFT,
+                           additive_expression());
+            } else {
+                return expression;
+            }
+        }
+    }
+
+    constexpr std::uint32_t additive_expression() {
+        auto expression = multiplicative_expression();
+        for (;;) {
+            if (match(Token::Type::PLUS)) {
+                expression = binary(expression, ast::Operator::Type::ADDITION,
+                                    multiplicative_expression());
+            } else if (match(Token::Type::MINUS)) {
+                expression =
+                    binary(expression, ast::Operator::Type::SUBTRACTION,
+                           multiplicative_expression());
+            } else {
+                return expression;
+            }
+        }
+    }
+
+    constexpr std::uint32_t multiplicative_expression() {
+        auto expression = primary_expression();
+        for (;;) {
+            if (match(Token::Type::STAR)) {
+                expression =
+                    binary(expression, ast::Operator::Type::MULTIPLICATION,
+                           primary_expression());
+            } else if (match(Token::Type::SLASH)) {
+                expression = binary(expression, ast::Operator::Type::DIVISION,
+                                    primary_expression());
+            } else if (match(Token::Type::PERCENT)) {
+                expression = binary(expression, ast::Operator::Type::REMAINDER,
+                                    primary_expression());
+            } else {
+                return expression;
+            }
+        }
+    }
+
+    // NONE where Parser has no expression either, e.g. for the empty
+    // statement `;`.
+    constexpr std::uint32_t primary_expression() {
+        if (match(Token::Type::TRUE) || match(Token::Type::FALSE)) {
+            return add({.kind = StaticNode::Kind::BOOL_LITERAL,
+                        .boolean = previous().type == Token::Type::TRUE});
+        }
+        if (match(Token::Type::NUMBER)) {
+            return number_literal(previous());
+        }
+        if (match(Token::Type::STRING)) {
+            return string_literal(previous());
+        }
+        if (match(Token::Type::IDENTIFIER)) {
+            auto identifier = named(previous());
+            identifier.kind = StaticNode::Kind::IDENTIFIER;
+            return add(identifier);
+        }
+        if (match(Token::Type::LEFT_PAREN)) {
+            const auto inner = expression();
+            consume(Token::Type::RIGHT_PAREN, "Expected )");
+            return inner;
+        }
+        return StaticNode::NONE;
+    }
+
+    constexpr const StaticToken& previous() const {
+        return tokens_[current_ - 1];
+    }
+
+    constexpr std::string_view text(const StaticToken& token) const {
+        return source_.substr(token.begin, token.length);
+    }
+
+    constexpr std::uint32_t binary(std::uint32_t left, ast::Operator::Type op,
+                                   std::uint32_t right) {
+        if (left == StaticNode::NONE || right == StaticNode::NONE) {
+            detail::static_syntax_error("Missing operand", previous().line);
+        }
+        return add({.kind = StaticNode::Kind::BINARY_EXPRESSION,
+                    .op = op,
+                    .children = {left, right, StaticNode::NONE}});
+    }
+
+    // Integers without a fractional part, doubles otherwise or when they do
+    // not fit into 64 bits, as in Parser. Doubles are only converted where
+    // a single rounding step gives the correctly rounded value, as
+    // std::from_chars does: integers up to 2^64, and fractions whose digits
+    // make an exact double.
+    constexpr std::uint32_t number_literal(const StaticToken& token) {
+        auto lexeme = text(token);
+        const auto point = lexeme.find('.');
+        // trailing zeros of the fraction do not change the value
+        if (point != std::string_view::npos) {
+            while (lexeme.ends_with('0')) {
+                lexeme.remove_suffix(1);
+            }
+        }
+
+        const auto fraction_digits =
+            point == std::string_view::npos ? 0 : lexeme.size() - point - 1;
+        std::uint64_t mantissa = 0;
+        for (const char digit : lexeme) {
+            if (digit == '.') {
+                continue;
+            }
+            const auto value = static_cast<std::uint64_t>(digit - '0');
+            if (mantissa >
+                (std::numeric_limits<std::uint64_t>::max() - value) / 10) {
+                imprecise_number(token);
+            }
+            mantissa = mantissa * 10 + value;
+        }
+
+        if (point == std::string_view::npos &&
+            mantissa <= std::numeric_limits<std::int64_t>::max()) {
+            return add({.kind = StaticNode::Kind::INTEGER_LITERAL,
+                        .integer = static_cast<std::int64_t>(mantissa)});
+        }
+        // both the digits and 10^n up to 10^22 are exact doubles, and the
+        // quotient of two exact values is correctly rounded
+        if (fraction_digits > 0 &&
+            (mantissa > MAX_EXACT_MANTISSA || fraction_digits > 22)) {
+            imprecise_number(token);
+        }
+        double scale = 1;
+        for (std::size_t i = 0; i < fraction_digits; ++i) {
+            scale *= 10;
+        }
+        return add({.kind = StaticNode::Kind::DOUBLE_LITERAL,
+                    .floating = static_cast<double>(mantissa) / scale});
+    }
+
+    [[noreturn]] static void imprecise_number(const StaticToken& token) {
+        detail::static_syntax_error(
+            "Number literal too precise to convert at compile time",
+            token.line);
+    }
+
+    // Decodes the escapes as decode_escapes does.
+    constexpr std::uint32_t string_literal(const StaticToken& token) {
+        const auto raw = text(token);
+        const auto begin = string_bytes_;
+        for (std::size_t i = 0; i < raw.size(); ++i) {
+            auto c = raw[i];
+            if (c == '\\' && i + 1 < raw.size()) {
+                switch (raw[i + 1]) {
+                    case 'n':
+                        c = '\n';
+                        break;
+                    case 't':
+                        c = '\t';
+                        break;
+                    case 'r':
+                        c = '\r';
+                        break;
+                    case '0':
+                        c = '\0';
+                        break;
+                    case '\\':
+                    case '"':
+                        c = raw[i + 1];
+                        break;
+                    default:
+                        // kept with its backslash
+                        strings_[string_bytes_++] = '\\';
+                        c = raw[i + 1];
+                        break;
+                }
+                ++i;
+            }
+            strings_[string_bytes_++] = c;
+        }
+        return add({.kind = StaticNode::Kind::STRING_LITERAL,
+                    .string_begin = detail::narrow(begin),
+                    .string_length = detail::narrow(string_bytes_ - begin)});
+    }
+
+    static constexpr std::uint64_t MAX_EXACT_MANTISSA = std::uint64_t{1}
+                                                        << 53;
+
+    std::string_view source_;
+    std::span<const StaticToken> tokens_;
+    std::span<StaticNode> nodes_;
+    std::span<char> strings_;
+    std::size_t current_ = 0;
+    std::size_t node_count_ = 0;
+    std::size_t string_bytes_ = 0;
+};
+
+namespace detail {
+
+// Builds the runtime tree of a flat one.
+class StaticTreeBuilder {
+public:
+    StaticTreeBuilder(std::span<const StaticNode> nodes,
+                      std::string_view strings)
+        : nodes_(nodes), strings_(strings) {}
+
+    std::unique_ptr<ast::Statement> statement(std::uint32_t index) const {
+        if (index == StaticNode::NONE) {
+            return nullptr;
+        }
+        const auto& node = nodes_[index];
+        switch (node.kind) {
+            case StaticNode::Kind::COMPOUND_STATEMENT: {
+                ast::CompoundStatement::Statements statements;
+                for (auto child = node.children[0]; child != StaticNode::NONE;
+                     child = nodes_[child].next) {
+                    statements.push_back(statement(child));
+                }
+                return std::make_unique<ast::CompoundStatement>(
+                    std::move(statements));
+            }
+            case StaticNode::Kind::IF_STATEMENT:
+                return std::make_unique<ast::IfStatement>(
+                    expression(node.children[0]), statement(node.children[1]),
+                    statement(node.children[2]));
+            case StaticNode::Kind::EXPRESSION_STATEMENT:
+                return std::make_unique<ast::ExpressionStatement>(
+                    expression(node.children[0]));
+            case StaticNode::Kind::CONST_DECLARATION:
+                return std::make_unique<ast::ConstDeclaration>(
+                    text(node), expression(node.children[0]));
+            default:
+                throw std::logic_error("Expected a statement");
+        }
+    }
+
+    ast::ExpressionPtr expression(std::uint32_t index) const {
+        if (index == StaticNode::NONE) {
+            return nullptr;
+        }
+        const auto& node = nodes_[index];
+        switch (node.kind) {
+            case StaticNode::Kind::BINARY_EXPRESSION:
+                return std::make_shared<ast::BinaryExpression>(
+                    expression(node.children[0]), node.op,
+                    expression(node.children[1]));
+            case StaticNode::Kind::BOOL_LITERAL:
+                return std::make_shared<ast::Literal<bool>>(node.boolean);
+            case StaticNode::Kind::INTEGER_LITERAL:
+                return std::make_shared<ast::Literal<std::int64_t>>(
+                    node.integer);
+            case StaticNode::Kind::DOUBLE_LITERAL:
+                return std::make_shared<ast::Literal<double>>(node.floating);
+            case StaticNode::Kind::STRING_LITERAL:
+                return std::make_shared<ast::Literal<std::string_view>>(
+                    text(node));
+            case StaticNode::Kind::IDENTIFIER:
+                return std::make_shared<ast::Identifier>(text(node));
+            default:
+                throw std::logic_error("Expected an expression");
+        }
+    }
+
+private:
+    std::string_view text(const StaticNode& node) const {
+        return strings_.substr(node.string_begin, node.string_length);
+    }
+
+    std::span<const StaticNode> nodes_;
+    std::string_view strings_;
+};
+
+} // namespace detail
+
+// The flat tree of an embedded source, see parse_static().
+template <std::size_t NODES, std::size_t STRING_BYTES>
+struct StaticProgram {
+    std::array<StaticNode, NODES> nodes{};
+    std::array<char, STRING_BYTES> strings{};
+    std::uint32_t root = 0;
+
+    constexpr const StaticNode& operator[](std::uint32_t index) const {
+        return nodes[index];
+    }
+
+    constexpr const StaticNode& root_node() const {
+        return nodes[root];
+    }
+
+    constexpr std::string_view string(const StaticNode& literal) const {
+        return std::string_view(strings.data(), strings.size())
+            .substr(literal.string_begin, literal.string_length);
+    }
+
+    // The equivalent of what Parser builds. String literals are views into
+    // this program, which has to outlive the tree, as static ones do.
+    ast::AbstractSyntaxTree to_tree() const {
+        const detail::StaticTreeBuilder builder(
+            nodes, std::string_view(strings.data(), strings.size()));
+        return ast::AbstractSyntaxTree(builder.statement(root));
+    }
+
+    std::string to_string() const {
+        return to_tree().to_string();
+    }
+};
+
+// The tokens of `Source`, END_OF_FILE included.
+template <FixedString Source>
+consteval auto scan_static() {
+    std::array<StaticToken, detail::count_tokens(Source.view())> tokens{};
+    std::size_t count = 0;
+    detail::scan_source(Source.view(), [&](const StaticToken& token) {
+        tokens[count++] = token;
+    });
+    return tokens;
+}
+
+// The flat tree of `Source`, sized to fit; a compile error for sources
+// Parser would reject.
+template <FixedString Source>
+consteval auto parse_static() {
+    constexpr auto tokens = scan_static<Source>();
+    StaticProgram<tokens.size(), Source.view().size()> program;
+    program.root =
+        StaticParser(Source.view(), tokens, program.nodes, program.strings)
+            .parse();
+    return program;
+}
+
+} // namespace frontend
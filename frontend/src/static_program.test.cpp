@@ -0,0 +1,135 @@
+#include <array>
+#include <span>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+#include "parser.h"
+#include "scanner.h"
+#include "static_program.h"
+
+namespace {
+
+using frontend::StaticNode;
+
+// Checked by the compiler.
+constexpr auto ADDITION = frontend::parse_static<"1 + 2 * 3;">();
+static_assert(ADDITION.root_node().kind ==
+              StaticNode::Kind::COMPOUND_STATEMENT);
+static_assert(ADDITION[ADDITION.root_node().children[0]].kind ==
+              StaticNode::Kind::EXPRESSION_STATEMENT);
+static_assert(frontend::scan_static<"if (x) {}">().size() == 7);
+constexpr auto TAB = frontend::parse_static<"\"a\\tb\";">();
+static_assert(TAB[1].kind == StaticNode::Kind::STRING_LITERAL);
+static_assert(TAB.string(TAB[1]) == "a\tb");
+
+// Sources with everything the parser knows; each must come out as the
+// parser's own tree.
+static constexpr auto LITERALS =
+    frontend::parse_static<"true; false; 0; 42; 9223372036854775807; "
+                           "9223372036854775808; 43.3242; 4.395; 0.1; "
+                           "986.345000; 123456789.012345;">();
+static constexpr auto STRINGS = frontend::parse_static<
+    "\"plain\"; \"tab\\tnew\\nline\\\\ \\\"quoted\\\" \\q\"; \"\"; "
+    "\"two\nlines\";">();
+static constexpr auto OPERATORS = frontend::parse_static<
+    "1 + 2 * 3 - 4 / 5 % 6; 1 << 2 >> 3 < 4 <= 5 > 6 >= 7 == 8 != 9; "
+    "(1 + 2) * (3);">();
+static constexpr auto STATEMENTS = frontend::parse_static<R"(
+// a comment
+if (1 < 2) {
+    "then";
+    { 4 >= 3; }
+} else if (false) 3; else {}
+;
+();
+{}
+const answer = 6 * 7;
+{ const inner = answer; inner + answer; }
+)">();
+
+std::string parse(std::string_view source) {
+    frontend::Scanner scanner{std::string(source)};
+    return frontend::Parser(scanner.scan_tokens()).parse().to_string();
+}
+
+TEST(StaticProgram, MatchesTheParser) {
+    EXPECT_EQ(LITERALS.to_string(),
+              parse("true; false; 0; 42; 9223372036854775807; "
+                    "9223372036854775808; 43.3242; 4.395; 0.1; "
+                    "986.345000; 123456789.012345;"));
+    EXPECT_EQ(STRINGS.to_string(),
+              parse("\"plain\"; \"tab\\tnew\\nline\\\\ \\\"quoted\\\" \\q\"; "
+                    "\"\"; \"two\nlines\";"));
+    EXPECT_EQ(OPERATORS.to_string(),
+              parse("1 + 2 * 3 - 4 / 5 % 6; "
+                    "1 << 2 >> 3 < 4 <= 5 > 6 >= 7 == 8 != 9; "
+                    "(1 + 2) * (3);"));
+    EXPECT_EQ(STATEMENTS.to_string(), parse(R"(
+// a comment
+if (1 < 2) {
+    "then";
+    { 4 >= 3; }
+} else if (false) 3; else {}
+;
+();
+{}
+const answer = 6 * 7;
+{ const inner = answer; inner + answer; }
+)"));
+}
+
+TEST(StaticProgram, DecodesStrings) {
+    const auto& statement = STRINGS[STRINGS.root_node().children[0]];
+    const auto& second = STRINGS[STRINGS[statement.next].children[0]];
+    EXPECT_EQ(second.kind, StaticNode::Kind::STRING_LITERAL);
+    EXPECT_EQ(STRINGS.string(second), "tab\tnew\nline\\ \"quoted\" \\q");
+}
+
+TEST(StaticProgram, ScansLikeTheScanner) {
+    static constexpr std::string_view SOURCE =
+        "if (a <= 1) {\n  \"x\ny\" >> 2.5; } else // c\n !b != c;";
+    constexpr auto tokens = frontend::scan_static<
+        "if (a <= 1) {\n  \"x\ny\" >> 2.5; } else // c\n !b != c;">();
+
+    const auto expected = frontend::Scanner{std::string(SOURCE)}.scan_tokens();
+    ASSERT_EQ(tokens.size(), expected.size());
+    for (std::size_t i = 0; i < tokens.size(); ++i) {
+        EXPECT_EQ(tokens[i].type, expected[i].type_) << i;
+        EXPECT_EQ(tokens[i].line, expected[i].line_) << i;
+        if (expected[i].has_text()) {
+            EXPECT_EQ(SOURCE.substr(tokens[i].begin, tokens[i].length),
+                      expected[i].text())
+                << i;
+        }
+    }
+}
+
+// What would be compile errors in parse_static() are exceptions when the
+// same code runs at runtime. Unlike Scanner, unknown characters and
+// unterminated strings are errors too.
+TEST(StaticProgram, RejectsInvalidSources) {
+    for (const std::string_view source :
+         {"1 +;", "1", "if () 1;", "(1;", "{ 1;", "const x 1;", "\"open;",
+          "1 # 2;", "1.0000000000000001;", "18446744073709551616;"}) {
+        const auto parse_at_runtime = [&]() {
+            std::array<frontend::StaticToken, 16> tokens{};
+            std::size_t count = 0;
+            frontend::detail::scan_source(
+                source, [&](const frontend::StaticToken& token) {
+                    tokens.at(count++) = token;
+                });
+            std::array<StaticNode, 16> nodes{};
+            std::array<char, 16> strings{};
+            frontend::StaticParser(source, std::span(tokens.data(), count),
+                                   nodes, strings)
+                .parse();
+        };
+        EXPECT_THROW(parse_at_runtime(), std::logic_error) << source;
+    }
+}
+
+} // namespace
@@ -0,0 +1,217 @@
+#include "statistics.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <format>
+#include <numeric>
+#include <unordered_set>
+
+#include "ast/node.h"
+#include "ast/visitor.h"
+
+namespace frontend {
+
+namespace {
+
+class StatisticsVisitor final : public ast::Visitor {
+public:
+    explicit StatisticsVisitor(SourceStatistics& statistics)
+        : statistics_(statistics) {}
+
+    void visit(const ast::Literal<bool>& literal) override {
+        visit_literal(literal);
+    }
+
+    void visit(const ast::Literal<std::int64_t>& literal) override {
+        visit_literal(literal);
+    }
+
+    void visit(const ast::Literal<double>& literal) override {
+        visit_literal(literal);
+    }
+
+    void visit(const ast::Literal<std::string_view>& literal) override {
+        visit_literal(literal);
+    }
+
+    void visit(const ast::UnaryExpression& expression) override {
+        enter_expression(expression, "UnaryExpression");
+        ++statistics_.operators[expression.op()];
+        expression.operand().accept(*this);
+        leave_expression();
+    }
+
+    void visit(const ast::BinaryExpression& expression) override {
+        enter_expression(expression, "BinaryExpression");
+        ++statistics_.operators[expression.op()];
+        expression.left().accept(*this);
+        expression.right().accept(*this);
+        leave_expression();
+    }
+
+    void visit(const ast::Identifier& identifier) override {
+        enter_expression(identifier, "Identifier");
+        leave_expression();
+    }
+
+    void visit(const ast::ExpressionStatement& statement) override {
+        count_statement(statement, "ExpressionStatement");
+        if (statement.expression_ != nullptr) {
+            statement.expression_->accept(*this);
+        }
+    }
+
+    void visit(const ast::CompoundStatement& statement) override {
+        count_statement(statement, "CompoundStatement");
+        const auto& statements = statement.statements();
+        statistics_.ast_bytes +=
+            statements.capacity() *
+            sizeof(ast::CompoundStatement::Statements::value_type);
+        visit_nested(statements);
+    }
+
+    void visit(const ast::IfStatement& statement) override {
+        count_statement(statement, "IfStatement");
+        statement.condition().accept(*this);
+        ++nesting_depth_;
+        statement.then().accept(*this);
+        if (const auto* else_statement = statement.else_statement()) {
+            else_statement->accept(*this);
+        }
+        --nesting_depth_;
+    }
+
+    void visit(const ast::ConstDeclaration& declaration) override {
+        count_statement(declaration, "ConstDeclaration");
+        declaration.initializer().accept(*this);
+    }
+
+private:
+    template <typename T>
+    void visit_literal(const ast::Literal<T>& literal) {
+        enter_expression(literal, "Literal");
+        leave_expression();
+    }
+
+    template <typename Expression>
+    void enter_expression(const Expression& expression,
+                          std::string_view kind) {
+        ++statistics_.nodes[kind];
+        if (seen_.insert(&expression).second) {
+            statistics_.ast_bytes += sizeof(expression);
+        }
+        ++expression_depth_;
+        statistics_.max_expression_depth =
+            std::max(statistics_.max_expression_depth, expression_depth_);
+    }
+
+    void leave_expression() {
+        --expression_depth_;
+    }
+
+    template <typename Statement>
+    void count_statement(const Statement& statement, std::string_view kind) {
+        ++statistics_.nodes[kind];
+        statistics_.ast_bytes += sizeof(statement);
+        statistics_.max_nesting_depth =
+            std::max(statistics_.max_nesting_depth, nesting_depth_);
+    }
+
+    void visit_nested(const ast::CompoundStatement::Statements& statements) {
+        ++nesting_depth_;
+        for (const auto& nested : statements) {
+            nested->accept(*this);
+        }
+        --nesting_depth_;
+    }
+
+    SourceStatistics& statistics_;
+    std::size_t expression_depth_ = 0;
+    std::size_t nesting_depth_ = 0;
+    std::unordered_set<const ast::Expression*> seen_;
+};
+
+template <typename Key>
+void append_histogram(std::string& json, std::string_view name,
+                      const std::map<Key, std::size_t>& histogram) {
+    json += std::vformat("\"{}\":{{", std::make_format_args(name));
+    bool first = true;
+    for (const auto& [key, count] : histogram) {
+        json += first ? "" : ",";
+        first = false;
+        json += std::vformat("\"{}\":{}", std::make_format_args(key, count));
+    }
+    json += '}';
+}
+
+double ratio(std::size_t numerator, std::size_t denominator) {
+    return denominator == 0 ? 0.0
+                            : static_cast<double>(numerator) /
+                                  static_cast<double>(denominator);
+}
+
+std::size_t total(const auto& histogram) {
+    return std::accumulate(
+        histogram.begin(), histogram.end(), std::size_t{0},
+        [](std::size_t sum, const auto& entry) { return sum + entry.second; });
+}
+
+} // namespace
+
+std::size_t SourceStatistics::token_count() const {
+    return total(tokens);
+}
+
+std::size_t SourceStatistics::node_count() const {
+    return total(nodes);
+}
+
+double SourceStatistics::bytes_per_token() const {
+    return ratio(source_bytes, token_count());
+}
+
+double SourceStatistics::ast_bytes_per_source_byte() const {
+    return ratio(ast_bytes, source_bytes);
+}
+
+SourceStatistics collect_statistics(std::string_view source,
+                                    std::span<const Token> tokens,
+                                    const ast::AbstractSyntaxTree& tree) {
+    SourceStatistics statistics{.source_bytes = source.size()};
+    for (const auto& token : tokens) {
+        ++statistics.tokens[token.type_];
+    }
+    // the root block is at depth 0, so top-level statements are at 1
+    StatisticsVisitor visitor(statistics);
+    tree.root().accept(visitor);
+    return statistics;
+}
+
+std::string to_json(const SourceStatistics& statistics) {
+    const auto token_count = statistics.token_count();
+    const auto node_count = statistics.node_count();
+    const auto bytes_per_token = statistics.bytes_per_token();
+    const auto ast_bytes_per_source_byte =
+        statistics.ast_bytes_per_source_byte();
+
+    std::string json = std::vformat(
+        "{{\"source_bytes\":{},\"token_count\":{},\"node_count\":{},",
+        std::make_format_args(statistics.source_bytes, token_count,
+                              node_count));
+    append_histogram(json, "tokens", statistics.tokens);
+    json += ',';
+    append_histogram(json, "nodes", statistics.nodes);
+    json += ',';
+    append_histogram(json, "operators", statistics.operators);
+    json += std::vformat(
+        ",\"max_expression_depth\":{},\"max_nesting_depth\":{},"
+        "\"bytes_per_token\":{},\"ast_bytes\":{},"
+        "\"ast_bytes_per_source_byte\":{}}}",
+        std::make_format_args(statistics.max_expression_depth,
+                              statistics.max_nesting_depth, bytes_per_token,
+                              statistics.ast_bytes,
+                              ast_bytes_per_source_byte));
+    return json;
+}
+
+} // namespace frontend
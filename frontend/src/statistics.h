@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "ast/ast.h"
+#include "ast/operator.h"
+#include "token.h"
+
+namespace frontend {
+
+// The shape of one source file, for correlating slow files with what they
+// contain. Histograms are ordered so that their JSON is deterministic.
+struct SourceStatistics {
+    std::size_t source_bytes = 0;
+    std::map<Token::Type, std::size_t> tokens{};
+    // keyed by node class name, e.g. "BinaryExpression"
+    std::map<std::string_view, std::size_t> nodes{};
+    std::map<ast::Operator::Type, std::size_t> operators{};
+    // a literal has depth 1
+    std::size_t max_expression_depth = 0;
+    // top-level statements have depth 1
+    std::size_t max_nesting_depth = 0;
+    // shallow size of the nodes plus their statement lists; subtrees shared
+    // by hash-consing count once, pooled string text not at all
+    std::size_t ast_bytes = 0;
+
+    std::size_t token_count() const;
+    std::size_t node_count() const;
+    double bytes_per_token() const;
+    double ast_bytes_per_source_byte() const;
+};
+
+// Walks `tree` once, loading lazy statement bodies on the way. `tokens` are
+// the tokens the tree was parsed from.
+SourceStatistics collect_statistics(std::string_view source,
+                                    std::span<const Token> tokens,
+                                    const ast::AbstractSyntaxTree& tree);
+
+// A single JSON object, the histograms keyed by enumerator names.
+std::string to_json(const SourceStatistics& statistics);
+
+} // namespace frontend
@@ -0,0 +1,93 @@
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "ast/interner.h"
+#include "parser.h"
+#include "scanner.h"
+#include "statistics.h"
+
+namespace {
+
+using frontend::SourceStatistics;
+using frontend::Token;
+using frontend::ast::Operator;
+
+SourceStatistics statistics_of(const std::string& source,
+                               frontend::ParserOptions options = {}) {
+    const auto tokens = frontend::Scanner(source).scan_tokens();
+    const auto tree = frontend::Parser(tokens, std::move(options)).parse();
+    return frontend::collect_statistics(source, tokens, tree);
+}
+
+TEST(Statistics, CountsTokensNodesAndOperators) {
+    const auto statistics = statistics_of("1 + 2 * 3; 4 < 5;");
+
+    EXPECT_EQ(statistics.source_bytes, 17);
+    EXPECT_EQ(statistics.token_count(), 11);
+    EXPECT_EQ(statistics.tokens.at(Token::Type::NUMBER), 5);
+    EXPECT_EQ(statistics.tokens.at(Token::Type::SEMICOLON), 2);
+    EXPECT_EQ(statistics.tokens.at(Token::Type::END_OF_FILE), 1);
+
+    EXPECT_EQ(statistics.nodes.at("Literal"), 5);
+    EXPECT_EQ(statistics.nodes.at("BinaryExpression"), 3);
+    EXPECT_EQ(statistics.nodes.at("ExpressionStatement"), 2);
+    EXPECT_EQ(statistics.nodes.at("CompoundStatement"), 1);
+    EXPECT_EQ(statistics.node_count(), 11);
+
+    EXPECT_EQ(statistics.operators.at(Operator::Type::ADDITION), 1);
+    EXPECT_EQ(statistics.operators.at(Operator::Type::MULTIPLICATION), 1);
+    EXPECT_EQ(statistics.operators.at(Operator::Type::LESS_THAN), 1);
+    EXPECT_EQ(statistics.operators.size(), 3);
+    EXPECT_DOUBLE_EQ(statistics.bytes_per_token(), 17.0 / 11);
+}
+
+TEST(Statistics, MeasuresDepths) {
+    const auto flat = statistics_of("1;");
+    EXPECT_EQ(flat.max_expression_depth, 1);
+    EXPECT_EQ(flat.max_nesting_depth, 1);
+
+    const auto nested = statistics_of(
+        "if (true) { if (false) { ((1 + 2) * 3) - 4; } } else { 5; }");
+    EXPECT_EQ(nested.max_expression_depth, 4);
+    // if, block, if, block, statement
+    EXPECT_EQ(nested.max_nesting_depth, 5);
+}
+
+TEST(Statistics, SharedSubtreesAddTheirBytesOnce) {
+    const std::string source = "(1 + 2) * (1 + 2); (1 + 2) * (1 + 2);";
+    const auto tree = statistics_of(source);
+    const auto dag = statistics_of(
+        source,
+        {.interner = std::make_shared<frontend::ast::ExpressionInterner>()});
+
+    EXPECT_EQ(dag.nodes, tree.nodes);
+    EXPECT_LT(dag.ast_bytes, tree.ast_bytes);
+    EXPECT_GT(dag.ast_bytes_per_source_byte(), 0.0);
+}
+
+TEST(Statistics, ToJson) {
+    const SourceStatistics statistics{
+        .source_bytes = 6,
+        .tokens = {{Token::Type::PLUS, 1},
+                   {Token::Type::NUMBER, 2},
+                   {Token::Type::END_OF_FILE, 1}},
+        .nodes = {{"Literal", 2}, {"BinaryExpression", 1}},
+        .operators = {{Operator::Type::ADDITION, 1}},
+        .max_expression_depth = 2,
+        .max_nesting_depth = 1,
+        .ast_bytes = 9,
+    };
+
+    EXPECT_EQ(frontend::to_json(statistics),
+              "{\"source_bytes\":6,\"token_count\":4,\"node_count\":3,"
+              "\"tokens\":{\"PLUS\":1,\"NUMBER\":2,\"END_OF_FILE\":1},"
+              "\"nodes\":{\"BinaryExpression\":1,\"Literal\":2},"
+              "\"operators\":{\"ADDITION\":1},\"max_expression_depth\":2,"
+              "\"max_nesting_depth\":1,\"bytes_per_token\":1.5,"
+              "\"ast_bytes\":9,\"ast_bytes_per_source_byte\":1.5}");
+}
+
+} // namespace
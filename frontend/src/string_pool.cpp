@@ -0,0 +1,114 @@
+#include "string_pool.h"
+
+#include <bit>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace frontend {
+
+std::size_t find_quote_or_backslash(std::string_view text, std::size_t from) {
+    const char* data = text.data();
+    auto index = from;
+#if defined(__SSE2__)
+    const auto quotes = _mm_set1_epi8('"');
+    const auto backslashes = _mm_set1_epi8('\\');
+    for (; index + 16 <= text.size(); index += 16) {
+        const auto chunk =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + index));
+        const auto hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, quotes),
+                                       _mm_cmpeq_epi8(chunk, backslashes));
+        if (const auto mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+            mask != 0) {
+            return index + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+#endif
+    for (; index < text.size(); ++index) {
+        if (data[index] == '"' || data[index] == '\\') {
+            return index;
+        }
+    }
+    return std::string_view::npos;
+}
+
+std::string decode_escapes(std::string_view raw) {
+    std::string decoded;
+    decoded.reserve(raw.size());
+    std::size_t begin = 0;
+    for (auto escape = raw.find('\\'); escape != std::string_view::npos;
+         escape = raw.find('\\', begin)) {
+        decoded.append(raw.substr(begin, escape - begin));
+        if (escape + 1 == raw.size()) {
+            begin = escape;
+            break;
+        }
+        switch (const char c = raw[escape + 1]) {
+            case 'n':
+                decoded.push_back('\n');
+                break;
+            case 't':
+                decoded.push_back('\t');
+                break;
+            case 'r':
+                decoded.push_back('\r');
+                break;
+            case '0':
+                decoded.push_back('\0');
+                break;
+            case '\\':
+            case '"':
+                decoded.push_back(c);
+                break;
+            default:
+                decoded.push_back('\\');
+                decoded.push_back(c);
+                break;
+        }
+        begin = escape + 2;
+    }
+    decoded.append(raw.substr(begin));
+    return decoded;
+}
+
+void StringPool::add_source(std::shared_ptr<const std::string> source) {
+    std::lock_guard lock(mutex_);
+    sources_.push_back(std::move(source));
+}
+
+std::string_view StringPool::intern_literal(std::string_view raw) {
+    if (raw.find('\\') != std::string_view::npos) {
+        return intern(decode_escapes(raw));
+    }
+    std::lock_guard lock(mutex_);
+    return *strings_.insert(raw).first;
+}
+
+std::string_view StringPool::intern(std::string_view text) {
+    std::lock_guard lock(mutex_);
+    if (const auto it = strings_.find(text); it != strings_.end()) {
+        return *it;
+    }
+    return insert_copy(text);
+}
+
+std::size_t StringPool::size() const {
+    std::lock_guard lock(mutex_);
+    return strings_.size();
+}
+
+std::size_t StringPool::copied_bytes() const {
+    std::lock_guard lock(mutex_);
+    return copied_bytes_;
+}
+
+std::string_view StringPool::insert_copy(std::string_view text) {
+    const std::string_view copy = copies_.emplace_back(text);
+    copied_bytes_ += text.size();
+    strings_.insert(copy);
+    return copy;
+}
+
+} // namespace frontend
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace frontend {
+
+// Index of the first `"` or `\` in `text` at or after `from`, npos if there is
+// none. Looks at 16 bytes at a time where SSE2 is available.
+std::size_t find_quote_or_backslash(std::string_view text,
+                                    std::size_t from = 0);
+
+// Decodes the escape sequences \n, \t, \r, \0, \\ and \" in the body of a
+// string literal. Any other escaped character is kept with its backslash.
+std::string decode_escapes(std::string_view raw);
+
+// Stores every distinct string literal of a batch of files once. Literals
+// without escapes are views into the source buffers, which the pool keeps
+// alive; only decoded literals and strings from other sources are copied.
+// Views returned by the pool stay valid for its lifetime. Safe to use from
+// several threads at once.
+class StringPool {
+public:
+    // Makes views into `source` valid for as long as the pool lives.
+    void add_source(std::shared_ptr<const std::string> source);
+
+    // `raw` is the text between the quotes of a literal, within a source
+    // added before. Returns the decoded literal.
+    std::string_view intern_literal(std::string_view raw);
+
+    // Returns the pooled copy of `text`, copying it on first sight.
+    std::string_view intern(std::string_view text);
+
+    // distinct strings
+    std::size_t size() const;
+    // bytes stored outside of the sources
+    std::size_t copied_bytes() const;
+
+private:
+    std::string_view insert_copy(std::string_view text);
+
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<const std::string>> sources_;
+    // a deque never moves its elements, so views into them stay valid
+    std::deque<std::string> copies_;
+    std::unordered_set<std::string_view> strings_;
+    std::size_t copied_bytes_ = 0;
+};
+
+} // namespace frontend
@@ -0,0 +1,97 @@
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+#include "string_pool.h"
+
+namespace {
+
+using frontend::StringPool;
+
+TEST(FindQuoteOrBackslash, FindsTheFirstMatch) {
+    EXPECT_EQ(frontend::find_quote_or_backslash("abc\"def"), 3);
+    EXPECT_EQ(frontend::find_quote_or_backslash("abc\\def\""), 3);
+    EXPECT_EQ(frontend::find_quote_or_backslash("abc\"def\"", 4), 7);
+    EXPECT_EQ(frontend::find_quote_or_backslash("abcdef"),
+              std::string_view::npos);
+    EXPECT_EQ(frontend::find_quote_or_backslash(""), std::string_view::npos);
+}
+
+TEST(FindQuoteOrBackslash, MatchesAScalarSearchAtEveryOffset) {
+    // long enough to cover whole vectors and a tail
+    std::string text(70, 'x');
+    for (std::size_t position = 0; position < text.size(); ++position) {
+        for (const char c : {'"', '\\'}) {
+            text[position] = c;
+            for (std::size_t from = 0; from <= text.size(); ++from) {
+                const auto expected =
+                    from <= position ? position : std::string_view::npos;
+                EXPECT_EQ(frontend::find_quote_or_backslash(text, from),
+                          expected);
+            }
+            text[position] = 'x';
+        }
+    }
+}
+
+TEST(DecodeEscapes, DecodesKnownEscapes) {
+    EXPECT_EQ(frontend::decode_escapes(R"(a\nb\tc\rd\\e\"f)"),
+              "a\nb\tc\rd\\e\"f");
+    EXPECT_EQ(frontend::decode_escapes(R"(\0)"), std::string(1, '\0'));
+    EXPECT_EQ(frontend::decode_escapes("plain"), "plain");
+}
+
+TEST(DecodeEscapes, KeepsUnknownEscapes) {
+    EXPECT_EQ(frontend::decode_escapes(R"(\q\)"), R"(\q\)");
+}
+
+TEST(StringPool, LiteralsWithoutEscapesAreNotCopied) {
+    StringPool pool;
+    const auto source = std::make_shared<const std::string>("\"abc\" \"abc\"");
+    pool.add_source(source);
+
+    const std::string_view text = *source;
+
+    const auto first = pool.intern_literal(text.substr(1, 3));
+    const auto second = pool.intern_literal(text.substr(7, 3));
+
+    EXPECT_EQ(first, "abc");
+    EXPECT_EQ(first.data(), source->data() + 1);
+    EXPECT_EQ(second.data(), first.data());
+    EXPECT_EQ(pool.size(), 1);
+    EXPECT_EQ(pool.copied_bytes(), 0);
+}
+
+TEST(StringPool, DeduplicatesAcrossSources) {
+    StringPool pool;
+    const auto first_source = std::make_shared<const std::string>("x\\ty");
+    const auto second_source = std::make_shared<const std::string>("x\\ty");
+    pool.add_source(first_source);
+    pool.add_source(second_source);
+
+    const auto first = pool.intern_literal(*first_source);
+    const auto second = pool.intern_literal(*second_source);
+
+    EXPECT_EQ(first, "x\ty");
+    EXPECT_EQ(first.data(), second.data());
+    EXPECT_EQ(pool.intern("x\ty").data(), first.data());
+    EXPECT_EQ(pool.size(), 1);
+    EXPECT_EQ(pool.copied_bytes(), 3);
+}
+
+TEST(StringPool, ViewsSurviveTheirSource) {
+    StringPool pool;
+    std::string_view view;
+    {
+        auto source = std::make_shared<const std::string>(100, 'a');
+        pool.add_source(source);
+        view = pool.intern_literal(*source);
+    }
+
+    EXPECT_EQ(view, std::string(100, 'a'));
+}
+
+} // namespace
@@ -0,0 +1,40 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace frontend {
+
+ThreadPool::ThreadPool(std::size_t thread_count) {
+    // hardware_concurrency() may report 0 when it cannot tell
+    thread_count = std::max<std::size_t>(thread_count, 1);
+    workers_.reserve(thread_count);
+    for (std::size_t i = 0; i < thread_count; ++i) {
+        workers_.emplace_back(
+            [this](std::stop_token stop_token) { run(stop_token); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    for (auto& worker : workers_) {
+        worker.request_stop();
+    }
+    condition_.notify_all();
+}
+
+void ThreadPool::run(std::stop_token stop_token) {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(mutex_);
+            if (!condition_.wait(lock, stop_token,
+                                 [this] { return !tasks_.empty(); })) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop();
+        }
+        task();
+    }
+}
+
+} // namespace frontend
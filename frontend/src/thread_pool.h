@@ -0,0 +1,54 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace frontend {
+
+// Fixed-size pool of worker threads consuming a shared FIFO of tasks.
+class ThreadPool {
+public:
+    explicit ThreadPool(
+        std::size_t thread_count = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::size_t size() const {
+        return workers_.size();
+    }
+
+    template <typename Function>
+    std::future<std::invoke_result_t<Function>> submit(Function&& function) {
+        using Result = std::invoke_result_t<Function>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(
+            std::forward<Function>(function));
+        auto future = task->get_future();
+        {
+            std::scoped_lock lock(mutex_);
+            tasks_.emplace([task = std::move(task)]() { (*task)(); });
+        }
+        condition_.notify_one();
+        return future;
+    }
+
+private:
+    void run(std::stop_token stop_token);
+
+    std::mutex mutex_;
+    std::condition_variable_any condition_;
+    std::queue<std::function<void()>> tasks_;
+    std::vector<std::jthread> workers_;
+};
+
+} // namespace frontend
@@ -0,0 +1,45 @@
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "thread_pool.h"
+
+namespace {
+
+TEST(ThreadPool, RunsSubmittedTasks) {
+    frontend::ThreadPool pool(4);
+    std::vector<std::future<int>> results;
+
+    for (int i = 0; i < 100; ++i) {
+        results.push_back(pool.submit([i] { return i * i; }));
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(results[static_cast<std::size_t>(i)].get(), i * i);
+    }
+}
+
+TEST(ThreadPool, PropagatesExceptions) {
+    frontend::ThreadPool pool(1);
+
+    auto result = pool.submit([]() -> int { throw std::runtime_error("x"); });
+
+    EXPECT_THROW(result.get(), std::runtime_error);
+}
+
+TEST(ThreadPool, DrainsQueueOnDestruction) {
+    std::atomic<int> completed = 0;
+    {
+        frontend::ThreadPool pool(2);
+        for (int i = 0; i < 50; ++i) {
+            pool.submit([&completed] { ++completed; });
+        }
+    }
+
+    EXPECT_EQ(completed, 50);
+}
+
+} // namespace
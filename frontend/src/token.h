@@ -2,7 +2,9 @@
 
 #include <cstddef>
 #include <format>
+#include <optional>
 #include <string>
+#include <string_view>
 
 namespace frontend {
 
@@ -29,12 +31,32 @@ struct Token {
 
     Token(std::size_t line, Type type) : Token(line, type, std::nullopt) {}
 
-    bool operator==(const Token& other) const = default;
+    // A STRING token whose decoded text is owned by a StringPool.
+    static Token pooled_string(std::size_t line, std::string_view text) {
+        Token token(line, Type::STRING);
+        token.pooled_ = text;
+        return token;
+    }
+
+    bool operator==(const Token& other) const {
+        return line_ == other.line_ && type_ == other.type_ &&
+               has_text() == other.has_text() && text() == other.text();
+    }
+
+    bool has_text() const {
+        return lexeme_.has_value() || type_ == Type::STRING;
+    }
+
+    // The lexeme, or the decoded text of a STRING token.
+    std::string_view text() const {
+        return lexeme_.has_value() ? std::string_view(*lexeme_) : pooled_;
+    }
 
     std::string to_string() const {
-        if (lexeme_.has_value()) {
-            return std::vformat("{}: {} ({})",
-                                std::make_format_args(line_, type_, *lexeme_));
+        if (has_text()) {
+            const auto token_text = text();
+            return std::vformat(
+                "{}: {} ({})", std::make_format_args(line_, type_, token_text));
         }
         return std::vformat("{}: {}", std::make_format_args(line_, type_));
     }
@@ -42,6 +64,8 @@ struct Token {
     std::size_t line_;
     Type type_;
     std::optional<std::string> lexeme_;
+    // text of pooled STRING tokens, which have no lexeme_
+    std::string_view pooled_;
 };
 
 } // namespace frontend
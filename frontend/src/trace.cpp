@@ -0,0 +1,241 @@
+#include "trace.h"
+
+#include <array>
+#include <cstddef>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace frontend::trace {
+
+namespace {
+
+struct Event {
+    std::string_view name;
+    std::string_view category;
+    FileId file = 0;
+    std::int64_t start = 0;
+    std::int64_t duration = 0;
+};
+
+// Events are appended by the owning thread only and published through
+// `size`, so readers never take a lock and never see a half-written event.
+struct Chunk {
+    static constexpr std::size_t CAPACITY = 1024;
+
+    std::array<Event, CAPACITY> events;
+    std::atomic<std::size_t> size{0};
+    std::atomic<Chunk*> next{nullptr};
+};
+
+struct ThreadBuffer {
+    explicit ThreadBuffer(std::uint32_t id) : thread_id(id) {}
+
+    ~ThreadBuffer() {
+        drop_chunks();
+    }
+
+    void drop_chunks() {
+        auto* chunk = head.next.exchange(nullptr);
+        while (chunk != nullptr) {
+            delete std::exchange(chunk, chunk->next.load());
+        }
+        head.size.store(0);
+        tail = &head;
+    }
+
+    void append(const Event& event) {
+        auto size = tail->size.load(std::memory_order_relaxed);
+        if (size == Chunk::CAPACITY) {
+            auto* chunk = new Chunk;
+            tail->next.store(chunk, std::memory_order_release);
+            tail = chunk;
+            size = 0;
+        }
+        tail->events[size] = event;
+        tail->size.store(size + 1, std::memory_order_release);
+    }
+
+    const std::uint32_t thread_id;
+    Chunk head;
+    Chunk* tail = &head;
+};
+
+struct Registry {
+    std::mutex mutex;
+    // buffers outlive their threads so that their spans can be written out
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::vector<std::string> files;
+};
+
+// never destroyed, threads may still record during static destruction
+Registry& registry() {
+    static auto* instance = new Registry;
+    return *instance;
+}
+
+const auto EPOCH = std::chrono::steady_clock::now();
+
+thread_local ThreadBuffer* buffer = nullptr;
+thread_local FileId file = 0;
+
+ThreadBuffer& thread_buffer() {
+    if (buffer == nullptr) {
+        auto& shared = registry();
+        std::lock_guard lock(shared.mutex);
+        const auto id = static_cast<std::uint32_t>(shared.buffers.size() + 1);
+        buffer =
+            shared.buffers.emplace_back(std::make_unique<ThreadBuffer>(id))
+                .get();
+    }
+    return *buffer;
+}
+
+void append_json_string(std::string& json, std::string_view text) {
+    json += '"';
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            json += '\\';
+            json += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            constexpr std::string_view DIGITS = "0123456789abcdef";
+            json += "\\u00";
+            json += DIGITS[static_cast<unsigned char>(c) >> 4];
+            json += DIGITS[static_cast<unsigned char>(c) & 0xf];
+        } else {
+            json += c;
+        }
+    }
+    json += '"';
+}
+
+// Chrome traces count in microseconds.
+void append_microseconds(std::string& json, std::int64_t nanoseconds) {
+    json += std::to_string(nanoseconds / 1000);
+    const auto fraction = std::to_string(1000 + nanoseconds % 1000);
+    // drops the leading 1, keeping the zero padding
+    json += '.';
+    json += std::string_view(fraction).substr(1);
+}
+
+} // namespace
+
+namespace detail {
+
+std::int64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - EPOCH)
+        .count();
+}
+
+void record(std::string_view name, std::string_view category,
+            std::int64_t start) {
+    thread_buffer().append({.name = name,
+                            .category = category,
+                            .file = file,
+                            .start = start,
+                            .duration = now() - start});
+}
+
+} // namespace detail
+
+void start() {
+    detail::enabled.store(true, std::memory_order_relaxed);
+}
+
+void stop() {
+    detail::enabled.store(false, std::memory_order_relaxed);
+}
+
+void clear() {
+    auto& shared = registry();
+    std::lock_guard lock(shared.mutex);
+    for (const auto& thread : shared.buffers) {
+        thread->drop_chunks();
+    }
+    shared.files.clear();
+}
+
+FileId current_file() {
+    return file;
+}
+
+FileScope::FileScope(std::string_view path) : previous_(file) {
+    if (!enabled()) {
+        return;
+    }
+    auto& shared = registry();
+    std::lock_guard lock(shared.mutex);
+    shared.files.emplace_back(path);
+    file = static_cast<FileId>(shared.files.size());
+}
+
+FileScope::FileScope(FileId id) : previous_(file) {
+    file = id;
+}
+
+FileScope::~FileScope() {
+    file = previous_;
+}
+
+std::string to_chrome_json() {
+    auto& shared = registry();
+    std::lock_guard lock(shared.mutex);
+
+    std::string json = R"({"displayTimeUnit":"ns","traceEvents":[)";
+    bool first = true;
+    const auto open_event = [&]() {
+        json += first ? "\n" : ",\n";
+        first = false;
+    };
+    for (const auto& thread : shared.buffers) {
+        const auto thread_id = thread->thread_id;
+        open_event();
+        json += std::vformat(
+            R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},)"
+            R"("args":{{"name":"thread {}"}}}})",
+            std::make_format_args(thread_id, thread_id));
+
+        for (const Chunk* chunk = &thread->head; chunk != nullptr;
+             chunk = chunk->next.load(std::memory_order_acquire)) {
+            const auto size = chunk->size.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < size; ++i) {
+                const auto& event = chunk->events[i];
+                open_event();
+                json += R"({"name":)";
+                append_json_string(json, event.name);
+                json += R"(,"cat":)";
+                append_json_string(json, event.category);
+                json += R"(,"ph":"X","ts":)";
+                append_microseconds(json, event.start);
+                json += R"(,"dur":)";
+                append_microseconds(json, event.duration);
+                json += std::vformat(R"(,"pid":1,"tid":{})",
+                                     std::make_format_args(thread_id));
+                if (event.file != 0 && event.file <= shared.files.size()) {
+                    json += R"(,"args":{"file":)";
+                    append_json_string(json, shared.files[event.file - 1]);
+                    json += '}';
+                }
+                json += '}';
+            }
+        }
+    }
+    json += "\n]}\n";
+    return json;
+}
+
+void write_chrome_json(const std::string& path) {
+    const auto json = to_chrome_json();
+    std::ofstream file(path, std::ios::binary);
+    file.write(json.data(), static_cast<std::streamsize>(json.size()));
+    if (!file) {
+        throw std::runtime_error("Cannot write " + path);
+    }
+}
+
+} // namespace frontend::trace
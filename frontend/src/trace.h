@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace frontend::trace {
+
+// Identifies an input file in the trace, 0 standing for none.
+using FileId = std::uint32_t;
+
+namespace detail {
+
+inline std::atomic<bool> enabled{false};
+
+std::int64_t now();
+void record(std::string_view name, std::string_view category,
+            std::int64_t start);
+
+} // namespace detail
+
+inline bool enabled() {
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+// Spans are only recorded between start() and stop().
+void start();
+void stop();
+
+// Drops everything recorded so far. No thread may be recording meanwhile.
+void clear();
+
+// The file spans opened by this thread are attributed to.
+FileId current_file();
+
+// Attributes the spans this thread opens while it lives to a file, either a
+// new one or, for work handed to another thread, one already known.
+class FileScope {
+public:
+    explicit FileScope(std::string_view path);
+    explicit FileScope(FileId file);
+    ~FileScope();
+
+    FileScope(const FileScope&) = delete;
+    FileScope& operator=(const FileScope&) = delete;
+
+private:
+    FileId previous_;
+};
+
+// Records the time between its construction and destruction on the calling
+// thread's buffer. While tracing is stopped it costs one relaxed load. The
+// name and category are kept as views, so they should be string literals.
+class Span {
+public:
+    explicit Span(std::string_view name,
+                  std::string_view category = "frontend") {
+        if (enabled()) {
+            name_ = name;
+            category_ = category;
+            start_ = detail::now();
+        }
+    }
+
+    ~Span() {
+        if (start_ >= 0) {
+            detail::record(name_, category_, start_);
+        }
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+private:
+    std::string_view name_;
+    std::string_view category_;
+    std::int64_t start_ = -1;
+};
+
+// Everything recorded, by all threads, as a Chrome trace-event document that
+// chrome://tracing and Perfetto load. Safe to call while other threads
+// record; their latest spans may be missing.
+std::string to_chrome_json();
+
+// Writes to_chrome_json() to `path`, throwing std::runtime_error on failure.
+void write_chrome_json(const std::string& path);
+
+} // namespace frontend::trace
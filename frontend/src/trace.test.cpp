@@ -0,0 +1,96 @@
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "scanner.h"
+#include "trace.h"
+
+namespace {
+
+namespace trace = frontend::trace;
+
+std::size_t count(std::string_view text, std::string_view pattern) {
+    std::size_t matches = 0;
+    for (auto at = text.find(pattern); at != std::string_view::npos;
+         at = text.find(pattern, at + 1)) {
+        ++matches;
+    }
+    return matches;
+}
+
+class TraceTest : public testing::Test {
+protected:
+    void SetUp() override {
+        trace::clear();
+        trace::start();
+    }
+
+    void TearDown() override {
+        trace::stop();
+        trace::clear();
+    }
+};
+
+TEST_F(TraceTest, StoppedTracingRecordsNothing) {
+    trace::stop();
+    {
+        trace::FileScope file("a.txt");
+        trace::Span span("ignored");
+    }
+
+    const auto json = trace::to_chrome_json();
+    EXPECT_EQ(count(json, "ignored"), 0);
+    EXPECT_EQ(count(json, "a.txt"), 0);
+}
+
+TEST_F(TraceTest, SpansCarryTheirFileAndThread) {
+    {
+        trace::FileScope file(R"(dir/"quoted".txt)");
+        trace::Span span("outer", "test");
+        std::jthread([file = trace::current_file()]() {
+            trace::FileScope file_scope(file);
+            trace::Span worker("worker", "test");
+        }).join();
+    }
+    trace::stop();
+
+    const auto json = trace::to_chrome_json();
+    EXPECT_TRUE(json.starts_with(R"({"displayTimeUnit":"ns","traceEvents":[)"));
+    EXPECT_EQ(count(json, R"("name":"outer","cat":"test","ph":"X")"), 1);
+    EXPECT_EQ(count(json, R"("name":"worker","cat":"test","ph":"X")"), 1);
+    EXPECT_EQ(count(json, R"("args":{"file":"dir/\"quoted\".txt"})"), 2);
+
+    const auto outer = json.find(R"("name":"outer")");
+    const auto worker = json.find(R"("name":"worker")");
+    const auto thread_of = [&](std::size_t at) {
+        const auto tid = json.find(R"("tid":)", at);
+        return json.substr(tid, json.find_first_of(",}", tid) - tid);
+    };
+    EXPECT_NE(thread_of(outer), thread_of(worker));
+}
+
+TEST_F(TraceTest, BuffersGrowPastOneChunk) {
+    for (int i = 0; i < 3000; ++i) {
+        trace::Span span("tiny");
+    }
+    trace::stop();
+
+    EXPECT_EQ(count(trace::to_chrome_json(), R"("name":"tiny")"), 3000);
+}
+
+TEST_F(TraceTest, ScanningIsTraced) {
+    {
+        trace::FileScope file("input.txt");
+        frontend::Scanner("1 + 2;").scan_tokens();
+    }
+    trace::stop();
+
+    EXPECT_EQ(count(trace::to_chrome_json(),
+                    R"("name":"scan","cat":"frontend","ph":"X")"),
+              1);
+}
+
+} // namespace
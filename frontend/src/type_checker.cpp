@@ -0,0 +1,356 @@
+#include "type_checker.h"
+
+#include <algorithm>
+#include <format>
+#include <future>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "ast/node.h"
+#include "ast/operator.h"
+#include "ast/visitor.h"
+#include "trace.h"
+#include "types.h"
+
+namespace frontend {
+
+namespace {
+
+using Operator = ast::Operator;
+
+const Type* const BOOL = type(Type::Kind::BOOL);
+const Type* const INT = type(Type::Kind::INT);
+const Type* const DOUBLE = type(Type::Kind::DOUBLE);
+const Type* const STRING = type(Type::Kind::STRING);
+const Type* const ERROR = type(Type::Kind::ERROR);
+
+// The result of `left op right`, nullptr where the operation fails for every
+// pair of values of these types. Mirrors backend::apply_binary().
+const Type* binary_type(Operator::Type op, const Type* left,
+                        const Type* right) {
+    if (left == INT && right == INT) {
+        switch (op) {
+            case Operator::Type::ADDITION:
+            case Operator::Type::SUBTRACTION:
+            case Operator::Type::MULTIPLICATION:
+            case Operator::Type::DIVISION:
+            case Operator::Type::REMAINDER:
+            case Operator::Type::BITWISE_AND:
+            case Operator::Type::BITWISE_OR:
+            case Operator::Type::BITWISE_XOR:
+            case Operator::Type::BITWISE_LEFT_SHIFT:
+            case Operator::Type::BITWISE_RIGHT_SHIFT:
+                return INT;
+            case Operator::Type::LOGICAL_AND:
+            case Operator::Type::LOGICAL_OR:
+            case Operator::Type::EQUAL_TO:
+            case Operator::Type::NOT_EQUAL_TO:
+            case Operator::Type::LESS_THAN:
+            case Operator::Type::LESS_THAN_OR_EQUAL_TO:
+            case Operator::Type::GREATER_THAN:
+            case Operator::Type::GREATER_THAN_OR_EQUAL_TO:
+                return BOOL;
+            default:
+                return nullptr;
+        }
+    }
+
+    const bool numbers = left->is_number() && right->is_number();
+    const bool strings = left == STRING && right == STRING;
+    switch (op) {
+        case Operator::Type::ADDITION:
+            return strings ? STRING : (numbers ? DOUBLE : nullptr);
+        case Operator::Type::SUBTRACTION:
+        case Operator::Type::MULTIPLICATION:
+        case Operator::Type::DIVISION:
+        case Operator::Type::REMAINDER:
+            return numbers ? DOUBLE : nullptr;
+        case Operator::Type::LOGICAL_AND:
+        case Operator::Type::LOGICAL_OR:
+        case Operator::Type::EQUAL_TO:
+        case Operator::Type::NOT_EQUAL_TO:
+            return BOOL;
+        case Operator::Type::LESS_THAN:
+        case Operator::Type::LESS_THAN_OR_EQUAL_TO:
+        case Operator::Type::GREATER_THAN:
+        case Operator::Type::GREATER_THAN_OR_EQUAL_TO:
+            return numbers || strings ? BOOL : nullptr;
+        default:
+            return nullptr;
+    }
+}
+
+// Mirrors backend::apply_unary().
+const Type* unary_type(Operator::Type op, const Type* operand) {
+    switch (op) {
+        case Operator::Type::UNARY_PLUS:
+        case Operator::Type::UNARY_MINUS:
+            return operand->is_number() ? operand : nullptr;
+        case Operator::Type::BITWISE_NOT:
+            return operand == INT ? INT : nullptr;
+        case Operator::Type::LOGICAL_NOT:
+            return BOOL;
+        default:
+            return nullptr;
+    }
+}
+
+// Checks one top-level statement at a time. The constants declared at the
+// top level before it are read from `globals`, indexed by slot; the ones
+// declared within it take the slots after those.
+class StatementChecker final : private ast::Visitor {
+public:
+    explicit StatementChecker(std::vector<Diagnostic>& diagnostics)
+        : diagnostics_(diagnostics) {}
+
+    // The type of the constant `statement` declares, if it does.
+    const Type* check(const ast::Statement& statement, std::size_t index,
+                      std::span<const Type* const> globals) {
+        index_ = index;
+        globals_ = globals;
+        locals_.clear();
+        declared_ = nullptr;
+        statement.accept(*this);
+        return declared_;
+    }
+
+private:
+    const Type* type_of(const ast::Expression& expression) {
+        expression.accept(*this);
+        return type_;
+    }
+
+    void report(Diagnostic::Severity severity, std::string message) {
+        diagnostics_.push_back({.severity = severity,
+                                .statement = index_,
+                                .message = std::move(message)});
+    }
+
+    static void check_resolved(std::uint32_t slot, std::string_view name) {
+        if (slot == ast::UNRESOLVED_SLOT) {
+            throw std::logic_error(std::vformat(
+                "Unresolved identifier {}", std::make_format_args(name)));
+        }
+    }
+
+    // Resolver slots from the end of the globals on are local.
+    const Type* lookup(std::uint32_t slot, std::string_view name) const {
+        check_resolved(slot, name);
+        if (slot < globals_.size()) {
+            return globals_[slot];
+        }
+        const auto local = slot - globals_.size();
+        return local < locals_.size() ? locals_[local] : ERROR;
+    }
+
+    void declare(std::uint32_t slot, std::string_view name,
+                 const Type* type) {
+        check_resolved(slot, name);
+        if (slot < globals_.size()) {
+            throw std::logic_error(std::vformat(
+                "Redeclaration of global {}", std::make_format_args(name)));
+        }
+        const auto local = slot - globals_.size();
+        if (local >= locals_.size()) {
+            locals_.resize(local + 1, ERROR);
+        }
+        locals_[local] = type;
+    }
+
+    void visit(const ast::Literal<bool>&) override {
+        type_ = BOOL;
+    }
+
+    void visit(const ast::Literal<std::int64_t>&) override {
+        type_ = INT;
+    }
+
+    void visit(const ast::Literal<double>&) override {
+        type_ = DOUBLE;
+    }
+
+    void visit(const ast::Literal<std::string_view>&) override {
+        type_ = STRING;
+    }
+
+    void visit(const ast::UnaryExpression& expression) override {
+        const auto* operand = type_of(expression.operand());
+        if (operand == ERROR) {
+            return;
+        }
+        type_ = unary_type(expression.op(), operand);
+        if (type_ == nullptr) {
+            // as the evaluator words it, the missing right operand included
+            const auto op = expression.op();
+            report(Diagnostic::Severity::ERROR,
+                   std::vformat("Unsupported operand types for {}: {} and NONE",
+                                std::make_format_args(op, operand->name)));
+            type_ = ERROR;
+        }
+    }
+
+    void visit(const ast::BinaryExpression& expression) override {
+        const auto* left = type_of(expression.left());
+        const auto* right = type_of(expression.right());
+        if (left == ERROR || right == ERROR) {
+            type_ = ERROR;
+            return;
+        }
+        type_ = binary_type(expression.op(), left, right);
+        if (type_ == nullptr) {
+            const auto op = expression.op();
+            report(Diagnostic::Severity::ERROR,
+                   std::vformat("Unsupported operand types for {}: {} and {}",
+                                std::make_format_args(op, left->name,
+                                                      right->name)));
+            type_ = ERROR;
+        }
+    }
+
+    void visit(const ast::Identifier& identifier) override {
+        type_ = lookup(identifier.slot(), identifier.name());
+    }
+
+    void visit(const ast::ExpressionStatement& statement) override {
+        if (statement.expression_ != nullptr) {
+            statement.expression_->accept(*this);
+        }
+    }
+
+    void visit(const ast::CompoundStatement& statement) override {
+        for (const auto& child : statement.statements()) {
+            child->accept(*this);
+        }
+    }
+
+    void visit(const ast::IfStatement& statement) override {
+        if (const auto* condition = type_of(statement.condition());
+            condition == DOUBLE || condition == STRING) {
+            report(Diagnostic::Severity::WARNING,
+                   std::vformat("Condition of type {} is tested for "
+                                "truthiness",
+                                std::make_format_args(condition->name)));
+        }
+        statement.then().accept(*this);
+        if (const auto* else_statement = statement.else_statement();
+            else_statement != nullptr) {
+            else_statement->accept(*this);
+        }
+    }
+
+    void visit(const ast::ConstDeclaration& declaration) override {
+        declared_ = type_of(declaration.initializer());
+        declare(declaration.slot(), declaration.name(), declared_);
+    }
+
+    std::vector<Diagnostic>& diagnostics_;
+    std::size_t index_ = 0;
+    std::span<const Type* const> globals_;
+    std::vector<const Type*> locals_;
+    // type of the expression visited last
+    const Type* type_ = ERROR;
+    // type of the constant declared last
+    const Type* declared_ = nullptr;
+};
+
+// a few chunks per worker keep the load balanced, as in the parser
+constexpr std::size_t CHUNKS_PER_WORKER = 4;
+
+} // namespace
+
+std::string to_string(const Diagnostic& diagnostic) {
+    const std::string_view severity =
+        diagnostic.severity == Diagnostic::Severity::ERROR ? "error"
+                                                           : "warning";
+    return std::vformat("statement {}: {}: {}",
+                        std::make_format_args(diagnostic.statement, severity,
+                                              diagnostic.message));
+}
+
+bool TypeCheckResult::has_errors() const {
+    return std::any_of(
+        diagnostics.begin(), diagnostics.end(), [](const Diagnostic& d) {
+            return d.severity == Diagnostic::Severity::ERROR;
+        });
+}
+
+TypeCheckResult type_check(const ast::AbstractSyntaxTree& tree,
+                           TypeCheckOptions options) {
+    trace::Span span("type-check");
+    std::vector<const ast::Statement*> statements;
+    if (const auto* root =
+            dynamic_cast<const ast::CompoundStatement*>(&tree.root())) {
+        for (const auto& statement : root->statements()) {
+            statements.push_back(statement.get());
+        }
+    } else {
+        statements.push_back(&dynamic_cast<const ast::Statement&>(tree.root()));
+    }
+
+    // top-level declarations in order, recording how many precede each
+    // statement, i.e. the globals it sees
+    std::vector<std::vector<Diagnostic>> diagnostics(statements.size());
+    std::vector<const Type*> globals;
+    std::vector<std::size_t> visible(statements.size());
+    std::vector<std::size_t> others;
+    for (std::size_t i = 0; i < statements.size(); ++i) {
+        visible[i] = globals.size();
+        if (dynamic_cast<const ast::ConstDeclaration*>(statements[i]) !=
+            nullptr) {
+            globals.push_back(StatementChecker(diagnostics[i])
+                                  .check(*statements[i], i, globals));
+        } else {
+            others.push_back(i);
+        }
+    }
+
+    // each statement writes its own diagnostics only
+    const auto check_range = [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            const auto statement = others[i];
+            StatementChecker(diagnostics[statement])
+                .check(*statements[statement], statement,
+                       std::span(globals.data(), visible[statement]));
+        }
+    };
+    auto* pool = options.thread_pool;
+    if (pool == nullptr || others.size() < options.min_parallel_statements) {
+        check_range(0, others.size());
+    } else {
+        const auto chunk_count =
+            std::min(others.size(), pool->size() * CHUNKS_PER_WORKER);
+        std::vector<std::future<void>> chunks;
+        for (std::size_t chunk = 0; chunk < chunk_count; ++chunk) {
+            chunks.push_back(pool->submit(
+                [&, begin = others.size() * chunk / chunk_count,
+                 end = others.size() * (chunk + 1) / chunk_count,
+                 file = trace::current_file()]() {
+                    trace::FileScope file_scope(file);
+                    trace::Span chunk_span("type-check-chunk");
+                    check_range(begin, end);
+                }));
+        }
+        // every chunk refers to the locals here, so all of them have to
+        // finish before an error can leave
+        for (auto& chunk : chunks) {
+            chunk.wait();
+        }
+        for (auto& chunk : chunks) {
+            chunk.get();
+        }
+    }
+
+    TypeCheckResult result;
+    for (auto& statement_diagnostics : diagnostics) {
+        result.diagnostics.insert(
+            result.diagnostics.end(),
+            std::make_move_iterator(statement_diagnostics.begin()),
+            std::make_move_iterator(statement_diagnostics.end()));
+    }
+    return result;
+}
+
+} // namespace frontend
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ast/ast.h"
+#include "thread_pool.h"
+
+namespace frontend {
+
+struct Diagnostic {
+    enum class Severity : std::uint8_t {
+        WARNING,
+        ERROR,
+    };
+
+    Severity severity{};
+    // index of the top-level statement it is about
+    std::size_t statement = 0;
+    std::string message{};
+
+    bool operator==(const Diagnostic& other) const = default;
+};
+
+// "statement 3: error: Unsupported operand types for ADDITION: BOOL and INT"
+std::string to_string(const Diagnostic& diagnostic);
+
+struct TypeCheckOptions {
+    // When set, the top-level statements are checked concurrently on this
+    // pool.
+    ThreadPool* thread_pool = nullptr;
+    std::size_t min_parallel_statements = 256;
+};
+
+struct TypeCheckResult {
+    // ordered by statement, and within a statement in evaluation order, so
+    // the same for any number of threads
+    std::vector<Diagnostic> diagnostics{};
+
+    bool has_errors() const;
+};
+
+// Infers the type of every expression and reports what the backends would
+// reject when they ran it: operators applied to operand types the operator
+// does not support, in the message backend::apply_binary() and
+// apply_unary() would throw, types spelled as backend::Value::Type. Conditions
+// of `if` may be of any type, as they are tested for truthiness, but a
+// DOUBLE or STRING condition gets a warning. The tree
+// must have been through frontend::Resolver, whose slots carry the types of
+// the constants.
+//
+// The declarations at the top level are checked in order first, since
+// later statements see them; everything else only depends on those, so the
+// remaining top-level statements are checked independently, in parallel
+// with a pool.
+TypeCheckResult type_check(const ast::AbstractSyntaxTree& tree,
+                           TypeCheckOptions options = {});
+
+} // namespace frontend
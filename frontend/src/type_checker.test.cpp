@@ -0,0 +1,206 @@
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ast/node.h"
+#include "parser.h"
+#include "program_generator.h"
+#include "resolver.h"
+#include "scanner.h"
+#include "thread_pool.h"
+#include "type_checker.h"
+#include "types.h"
+
+namespace {
+
+namespace ast = frontend::ast;
+
+using frontend::Diagnostic;
+using Operator = frontend::ast::Operator::Type;
+using frontend::Type;
+using frontend::TypeCheckOptions;
+
+frontend::ast::AbstractSyntaxTree parse(const std::string& source) {
+    auto tree =
+        frontend::Parser(frontend::Scanner(source).scan_tokens()).parse();
+    frontend::Resolver().resolve(tree);
+    return tree;
+}
+
+std::vector<Diagnostic> check(const std::string& source,
+                              TypeCheckOptions options = {}) {
+    return frontend::type_check(parse(source), options).diagnostics;
+}
+
+// for the operators the parser has no syntax for
+std::vector<Diagnostic> check(ast::ExpressionPtr expression) {
+    return frontend::type_check(
+               ast::AbstractSyntaxTree(
+                   std::make_unique<ast::ExpressionStatement>(
+                       std::move(expression))))
+        .diagnostics;
+}
+
+ast::ExpressionPtr unary(Operator op, ast::ExpressionPtr operand) {
+    return std::make_shared<ast::UnaryExpression>(op, std::move(operand));
+}
+
+ast::ExpressionPtr binary(ast::ExpressionPtr left, Operator op,
+                          ast::ExpressionPtr right) {
+    return std::make_shared<ast::BinaryExpression>(std::move(left), op,
+                                                   std::move(right));
+}
+
+template <typename T>
+ast::ExpressionPtr literal(T value) {
+    return std::make_shared<ast::Literal<T>>(value);
+}
+
+Diagnostic error(std::size_t statement, std::string message) {
+    return {.severity = Diagnostic::Severity::ERROR,
+            .statement = statement,
+            .message = std::move(message)};
+}
+
+Diagnostic warning(std::size_t statement, std::string message) {
+    return {.severity = Diagnostic::Severity::WARNING,
+            .statement = statement,
+            .message = std::move(message)};
+}
+
+TEST(Types, AreInterned) {
+    EXPECT_EQ(frontend::type(Type::Kind::INT), frontend::type(Type::Kind::INT));
+    EXPECT_NE(frontend::type(Type::Kind::INT),
+              frontend::type(Type::Kind::DOUBLE));
+    EXPECT_EQ(frontend::type(Type::Kind::STRING)->name, "STRING");
+    EXPECT_TRUE(frontend::type(Type::Kind::DOUBLE)->is_number());
+    EXPECT_FALSE(frontend::type(Type::Kind::BOOL)->is_number());
+}
+
+TEST(TypeChecker, AcceptsWhatTheBackendsRun) {
+    for (const auto* source : {
+             "1 + 2 * 3 - 4 / 5 % 6;",
+             "1 << 2 >> 3 < 4;",
+             "1 + 2.5; 2.5 % 1; 3 / 2.5;",
+             "\"a\" + \"b\"; \"a\" < \"b\";",
+             "1 < 2.5; true == 1; \"a\" != 2; 1 == 2 != false;",
+             "if (1 < 2) 1; else if (true) 2;",
+             "",
+         }) {
+        EXPECT_EQ(check(source), std::vector<Diagnostic>{}) << source;
+    }
+    for (auto expression : {
+             unary(Operator::UNARY_MINUS, literal(2.5)),
+             unary(Operator::UNARY_PLUS, literal(std::int64_t{1})),
+             unary(Operator::BITWISE_NOT, literal(std::int64_t{1})),
+             unary(Operator::LOGICAL_NOT, literal(std::string_view("a"))),
+             binary(literal(std::int64_t{1}), Operator::BITWISE_XOR,
+                    literal(std::int64_t{2})),
+             binary(literal(true), Operator::LOGICAL_AND, literal(1.5)),
+         }) {
+        EXPECT_EQ(check(expression), std::vector<Diagnostic>{})
+            << expression->to_string();
+    }
+}
+
+TEST(TypeChecker, GeneratedProgramsHaveNoErrors) {
+    const auto tree = parse(frontend::generate_program(
+        {.seed = 7, .target_bytes = 16 * 1024, .if_ratio = 0}));
+    EXPECT_EQ(frontend::type_check(tree).diagnostics,
+              std::vector<Diagnostic>{});
+}
+
+TEST(TypeChecker, UnsupportedOperands) {
+    EXPECT_EQ(check("true + 1;"),
+              (std::vector{error(0, "Unsupported operand types for ADDITION: "
+                                    "BOOL and INT")}));
+    EXPECT_EQ(check("1; 1.5 << 2;"),
+              (std::vector{error(1, "Unsupported operand types for "
+                                    "BITWISE_LEFT_SHIFT: DOUBLE and INT")}));
+    EXPECT_EQ(check("\"a\" + 1;"),
+              (std::vector{error(0, "Unsupported operand types for ADDITION: "
+                                    "STRING and INT")}));
+    EXPECT_EQ(check("\"a\" < 1;"),
+              (std::vector{error(0, "Unsupported operand types for "
+                                    "LESS_THAN: STRING and INT")}));
+    EXPECT_EQ(check(unary(Operator::UNARY_MINUS,
+                          literal(std::string_view("a")))),
+              (std::vector{error(0, "Unsupported operand types for "
+                                    "UNARY_MINUS: STRING and NONE")}));
+    EXPECT_EQ(check(unary(Operator::BITWISE_NOT, literal(1.5))),
+              (std::vector{error(0, "Unsupported operand types for "
+                                    "BITWISE_NOT: DOUBLE and NONE")}));
+    EXPECT_EQ(check(binary(literal(true), Operator::BITWISE_AND,
+                           literal(std::int64_t{1}))),
+              (std::vector{error(0, "Unsupported operand types for "
+                                    "BITWISE_AND: BOOL and INT")}));
+}
+
+TEST(TypeChecker, ErrorsAreReportedOnce) {
+    // the enclosing operations see the error type and stay quiet
+    EXPECT_EQ(check("(true + 1) * 2 + 3 < 4;"),
+              (std::vector{error(0, "Unsupported operand types for ADDITION: "
+                                    "BOOL and INT")}));
+    EXPECT_EQ(check("(true + 1) + (false - 1);").size(), 2);
+}
+
+TEST(TypeChecker, ConditionsTestedForTruthiness) {
+    EXPECT_EQ(
+        check("if (1.5) 1; if (\"s\") 2; if (1) 3; if (true) 4;"),
+        (std::vector{
+            warning(0, "Condition of type DOUBLE is tested for truthiness"),
+            warning(1, "Condition of type STRING is tested for truthiness"),
+        }));
+    const auto result = frontend::type_check(parse("if (1.5) 1;"));
+    EXPECT_FALSE(result.has_errors());
+    EXPECT_EQ(to_string(result.diagnostics[0]),
+              "statement 0: warning: Condition of type DOUBLE is tested for "
+              "truthiness");
+}
+
+TEST(TypeChecker, ConstantsHaveTheTypesOfTheirInitializers) {
+    EXPECT_EQ(check("const s = \"a\"; const n = 1.5; s + n;"),
+              (std::vector{error(2, "Unsupported operand types for ADDITION: "
+                                    "STRING and DOUBLE")}));
+    EXPECT_EQ(check("const a = 1; { const b = 1.5; a << b; } "
+                    "{ const c = 2; a << c; }"),
+              (std::vector{error(1, "Unsupported operand types for "
+                                    "BITWISE_LEFT_SHIFT: INT and DOUBLE")}));
+    EXPECT_EQ(check("const a = 1; if (a) { const b = \"s\"; if (b) 1; }"),
+              (std::vector{warning(1, "Condition of type STRING is tested "
+                                      "for truthiness")}));
+    // a constant with an error in its initializer is not reported again
+    EXPECT_EQ(check("const e = true + 1; e + 1; e < \"s\";").size(), 1);
+}
+
+TEST(TypeChecker, UnresolvedTreesAreRejected) {
+    const auto tree = frontend::Parser(
+                          frontend::Scanner("const a = 1; a;").scan_tokens())
+                          .parse();
+    EXPECT_THROW(frontend::type_check(tree), std::logic_error);
+}
+
+TEST(TypeChecker, ParallelMatchesSequential) {
+    std::string source = "const i = 1; const s = \"s\";";
+    for (int n = 0; n < 500; ++n) {
+        source += "i + 1; s - i; if (s) { const d = 1.5; d << i; } ";
+        source += n % 7 == 0 ? "{ const b = true; b * 2; }" : "s << 1;";
+    }
+    const auto tree = parse(source);
+    const auto sequential = frontend::type_check(tree);
+
+    frontend::ThreadPool pool(3);
+    const auto parallel = frontend::type_check(
+        tree, {.thread_pool = &pool, .min_parallel_statements = 0});
+
+    EXPECT_EQ(parallel.diagnostics, sequential.diagnostics);
+    EXPECT_EQ(sequential.diagnostics.size(), 500 * 4);
+}
+
+} // namespace
@@ -0,0 +1,24 @@
+#include "types.h"
+
+#include <array>
+#include <cstddef>
+
+namespace frontend {
+
+namespace {
+
+constexpr std::array<Type, 5> TYPES = {{
+    {.kind = Type::Kind::BOOL, .name = "BOOL"},
+    {.kind = Type::Kind::INT, .name = "INT"},
+    {.kind = Type::Kind::DOUBLE, .name = "DOUBLE"},
+    {.kind = Type::Kind::STRING, .name = "STRING"},
+    {.kind = Type::Kind::ERROR, .name = "ERROR"},
+}};
+
+} // namespace
+
+const Type* type(Type::Kind kind) {
+    return &TYPES[static_cast<std::size_t>(kind)];
+}
+
+} // namespace frontend
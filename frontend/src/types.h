@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace frontend {
+
+// A type of the language. Every type exists once, see type(), so types are
+// equal exactly when their addresses are and checking compares pointers.
+struct Type {
+    enum class Kind : std::uint8_t {
+        BOOL,
+        INT,
+        DOUBLE,
+        STRING,
+        // of an expression that was reported already; accepted everywhere so
+        // that one mistake is reported once
+        ERROR,
+    };
+
+    Kind kind;
+    std::string_view name;
+
+    bool is_number() const {
+        return kind == Kind::INT || kind == Kind::DOUBLE;
+    }
+};
+
+// The interned instance of the type of `kind`. The language only has
+// primitive types so far, which makes the table one instance per kind.
+const Type* type(Type::Kind kind);
+
+} // namespace frontend
@@ -0,0 +1,272 @@
+#include "utf8.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace frontend {
+
+namespace {
+
+bool is_continuation(unsigned char c) {
+    return (c & 0xc0) == 0x80;
+}
+
+// Length of the well-formed sequence starting at `index`, 0 if there is none.
+std::size_t sequence_length(std::string_view text, std::size_t index) {
+    const auto byte = [&](std::size_t offset) {
+        return static_cast<unsigned char>(text[index + offset]);
+    };
+    const auto lead = byte(0);
+    std::size_t length = 0;
+    // the second byte is the one that rules out overlong encodings,
+    // surrogates and code points above U+10FFFF
+    unsigned char min_second = 0x80;
+    unsigned char max_second = 0xbf;
+    if (lead < 0x80) {
+        return 1;
+    } else if (lead < 0xc2) {
+        return 0;
+    } else if (lead < 0xe0) {
+        length = 2;
+    } else if (lead < 0xf0) {
+        length = 3;
+        min_second = lead == 0xe0 ? 0xa0 : min_second;
+        max_second = lead == 0xed ? 0x9f : max_second;
+    } else if (lead < 0xf5) {
+        length = 4;
+        min_second = lead == 0xf0 ? 0x90 : min_second;
+        max_second = lead == 0xf4 ? 0x8f : max_second;
+    } else {
+        return 0;
+    }
+
+    if (text.size() - index < length || byte(1) < min_second ||
+        byte(1) > max_second) {
+        return 0;
+    }
+    for (std::size_t offset = 2; offset < length; ++offset) {
+        if (!is_continuation(byte(offset))) {
+            return 0;
+        }
+    }
+    return length;
+}
+
+// Index of the first non-ASCII byte at or after `index`, eight at a time.
+std::size_t skip_ascii(std::string_view text, std::size_t index) {
+    constexpr std::uint64_t HIGH_BITS = 0x8080808080808080;
+    for (; index + 8 <= text.size(); index += 8) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, text.data() + index, sizeof(word));
+        if ((word & HIGH_BITS) != 0) {
+            break;
+        }
+    }
+    while (index < text.size() &&
+           static_cast<unsigned char>(text[index]) < 0x80) {
+        ++index;
+    }
+    return index;
+}
+
+#if defined(__x86_64__)
+
+// Error classes of a pair of consecutive bytes, see Keiser and Lemire,
+// "Validating UTF-8 In Less Than One Instruction Per Byte". Each table maps
+// a nibble of the pair to the classes it is compatible with; a pair is
+// invalid if all three nibbles agree on a class.
+constexpr std::uint8_t TOO_SHORT = 1 << 0;
+constexpr std::uint8_t TOO_LONG = 1 << 1;
+constexpr std::uint8_t OVERLONG_3 = 1 << 2;
+constexpr std::uint8_t TOO_LARGE = 1 << 3;
+constexpr std::uint8_t SURROGATE = 1 << 4;
+constexpr std::uint8_t OVERLONG_2 = 1 << 5;
+constexpr std::uint8_t TOO_LARGE_1000 = 1 << 6;
+constexpr std::uint8_t OVERLONG_4 = 1 << 6;
+constexpr std::uint8_t TWO_CONTINUATIONS = 1 << 7;
+constexpr std::uint8_t CARRY = TOO_SHORT | TOO_LONG | TWO_CONTINUATIONS;
+
+using Table = std::array<std::uint8_t, 16>;
+
+// indexed by the high nibble of the first byte
+constexpr Table FIRST_HIGH = {
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TWO_CONTINUATIONS,
+    TWO_CONTINUATIONS,
+    TWO_CONTINUATIONS,
+    TWO_CONTINUATIONS,
+    TOO_SHORT | OVERLONG_2,
+    TOO_SHORT,
+    TOO_SHORT | OVERLONG_3 | SURROGATE,
+    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4,
+};
+
+// indexed by the low nibble of the first byte
+constexpr Table FIRST_LOW = {
+    CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+    CARRY | OVERLONG_2,
+    CARRY,
+    CARRY,
+    CARRY | TOO_LARGE,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+};
+
+// indexed by the high nibble of the second byte
+constexpr Table SECOND_HIGH = {
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_LONG | OVERLONG_2 | TWO_CONTINUATIONS | OVERLONG_3 | TOO_LARGE_1000 |
+        OVERLONG_4,
+    TOO_LONG | OVERLONG_2 | TWO_CONTINUATIONS | OVERLONG_3 | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTINUATIONS | SURROGATE | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTINUATIONS | SURROGATE | TOO_LARGE,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+};
+
+// Bytes above these limits in the last three positions of a block start a
+// sequence that continues into the next block.
+constexpr Table INCOMPLETE_LIMITS = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xf0 - 1, 0xe0 - 1, 0xc0 - 1,
+};
+
+[[gnu::target("ssse3")]] __m128i load(const void* bytes) {
+    return _mm_loadu_si128(static_cast<const __m128i*>(bytes));
+}
+
+[[gnu::target("ssse3")]] __m128i broadcast(std::uint8_t byte) {
+    return _mm_set1_epi8(static_cast<char>(byte));
+}
+
+[[gnu::target("ssse3")]] __m128i lookup(const Table& table,
+                                        __m128i nibbles) {
+    return _mm_shuffle_epi8(load(table.data()), nibbles);
+}
+
+[[gnu::target("ssse3")]] __m128i high_nibbles(__m128i bytes) {
+    return _mm_and_si128(_mm_srli_epi16(bytes, 4), broadcast(0x0f));
+}
+
+// Error bits for the 16 bytes of `input`, `previous` being the block before.
+[[gnu::target("ssse3")]] __m128i check_block(__m128i input,
+                                             __m128i previous) {
+    const auto previous1 = _mm_alignr_epi8(input, previous, 15);
+    const auto special_cases = _mm_and_si128(
+        _mm_and_si128(
+            lookup(FIRST_HIGH, high_nibbles(previous1)),
+            lookup(FIRST_LOW, _mm_and_si128(previous1, broadcast(0x0f)))),
+        lookup(SECOND_HIGH, high_nibbles(input)));
+
+    // the third and fourth bytes of a sequence must be continuations, and
+    // continuations must not appear anywhere else
+    const auto previous2 = _mm_alignr_epi8(input, previous, 14);
+    const auto previous3 = _mm_alignr_epi8(input, previous, 13);
+    const auto is_third_byte =
+        _mm_subs_epu8(previous2, broadcast(0xe0 - 0x80));
+    const auto is_fourth_byte =
+        _mm_subs_epu8(previous3, broadcast(0xf0 - 0x80));
+    const auto must_be_continuation = _mm_and_si128(
+        _mm_or_si128(is_third_byte, is_fourth_byte), broadcast(0x80));
+    return _mm_xor_si128(must_be_continuation, special_cases);
+}
+
+struct Validator {
+    __m128i error = _mm_setzero_si128();
+    __m128i previous = _mm_setzero_si128();
+    __m128i previous_incomplete = _mm_setzero_si128();
+};
+
+[[gnu::target("ssse3")]] void validate_block(Validator& validator,
+                                             __m128i input) {
+    if (_mm_movemask_epi8(input) == 0) {
+        // ASCII, which is only wrong after a truncated sequence
+        validator.error =
+            _mm_or_si128(validator.error, validator.previous_incomplete);
+    } else {
+        validator.error = _mm_or_si128(validator.error,
+                                       check_block(input, validator.previous));
+        validator.previous_incomplete =
+            _mm_subs_epu8(input, load(INCOMPLETE_LIMITS.data()));
+    }
+    validator.previous = input;
+}
+
+[[gnu::target("ssse3")]] bool is_valid_utf8_ssse3(std::string_view text) {
+    Validator validator;
+    std::size_t index = 0;
+    for (; index + 16 <= text.size(); index += 16) {
+        validate_block(validator, load(text.data() + index));
+    }
+    // the tail padded with NULs, which also reveal a sequence truncated by
+    // the end of the input
+    std::array<char, 16> tail{};
+    if (index < text.size()) {
+        std::memcpy(tail.data(), text.data() + index, text.size() - index);
+    }
+    validate_block(validator, load(tail.data()));
+    validator.error =
+        _mm_or_si128(validator.error, validator.previous_incomplete);
+
+    return _mm_movemask_epi8(
+               _mm_cmpeq_epi8(validator.error, _mm_setzero_si128())) ==
+           0xffff;
+}
+
+#endif
+
+} // namespace
+
+bool is_valid_utf8(std::string_view text) {
+#if defined(__x86_64__)
+    static const bool has_ssse3 = __builtin_cpu_supports("ssse3");
+    if (has_ssse3) {
+        return is_valid_utf8_ssse3(text);
+    }
+#endif
+    return find_invalid_utf8(text) == std::string_view::npos;
+}
+
+std::size_t find_invalid_utf8(std::string_view text) {
+    for (auto index = skip_ascii(text, 0); index < text.size();
+         index = skip_ascii(text, index)) {
+        const auto length = sequence_length(text, index);
+        if (length == 0) {
+            return index;
+        }
+        index += length;
+    }
+    return std::string_view::npos;
+}
+
+} // namespace frontend
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace frontend {
+
+// Whether `text` is well-formed UTF-8: no overlong encodings, surrogates,
+// code points above U+10FFFF or truncated sequences. Validates 16 bytes at a
+// time with the lookup-table algorithm of Keiser and Lemire where SSSE3 is
+// available, skipping pure-ASCII blocks after a single test.
+bool is_valid_utf8(std::string_view text);
+
+// Offset of the first byte that does not start a well-formed sequence, npos
+// for valid text. Scalar, meant for reporting errors.
+std::size_t find_invalid_utf8(std::string_view text);
+
+} // namespace frontend
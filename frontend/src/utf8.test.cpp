@@ -0,0 +1,87 @@
+#include <cstddef>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+#include "utf8.h"
+
+namespace {
+
+using frontend::find_invalid_utf8;
+using frontend::is_valid_utf8;
+
+constexpr auto VALID = std::string_view::npos;
+
+TEST(Utf8, AcceptsWellFormedText) {
+    EXPECT_TRUE(is_valid_utf8(""));
+    EXPECT_TRUE(is_valid_utf8("plain ASCII"));
+    EXPECT_TRUE(is_valid_utf8("é€\U0001f600 mixed ÿ"));
+    EXPECT_TRUE(is_valid_utf8("\U0010ffff퟿"));
+    EXPECT_EQ(find_invalid_utf8("aéb\U0001f600"), VALID);
+}
+
+TEST(Utf8, RejectsMalformedSequences) {
+    // stray continuation, overlong 2/3/4-byte encodings, surrogate, beyond
+    // U+10FFFF, invalid lead byte
+    for (const std::string bad :
+         {"\x80", "\xc0\xaf", "\xc1\xbf", "\xe0\x9f\xbf", "\xf0\x8f\xbf\xbf",
+          "\xed\xa0\x80", "\xf4\x90\x80\x80", "\xf5\x80\x80\x80", "\xff"}) {
+        EXPECT_FALSE(is_valid_utf8("abc" + bad)) << bad;
+        EXPECT_EQ(find_invalid_utf8("abc" + bad), 3) << bad;
+    }
+}
+
+TEST(Utf8, RejectsTruncatedSequences) {
+    for (const std::string bad : {"\xc3", "\xe2\x82", "\xf0\x9f\x98"}) {
+        EXPECT_FALSE(is_valid_utf8(bad));
+        EXPECT_FALSE(is_valid_utf8(bad + "x"));
+        // at the end of a 16-byte block, then followed by ASCII
+        const auto padded = std::string(16 - bad.size(), 'a') + bad;
+        EXPECT_FALSE(is_valid_utf8(padded));
+        EXPECT_FALSE(is_valid_utf8(padded + std::string(16, 'b')));
+        EXPECT_EQ(find_invalid_utf8(padded), padded.size() - bad.size());
+    }
+}
+
+TEST(Utf8, AgreesWithTheScalarCheckOnEveryBytePair) {
+    // each pair straddles a 16-byte block boundary once
+    std::string text(32, 'x');
+    constexpr std::size_t POSITIONS[] = {3, 15};
+    for (int first = 0; first < 256; ++first) {
+        for (int second = 0; second < 256; ++second) {
+            for (const auto position : POSITIONS) {
+                text[position] = static_cast<char>(first);
+                text[position + 1] = static_cast<char>(second);
+                EXPECT_EQ(is_valid_utf8(text), find_invalid_utf8(text) == VALID)
+                    << first << ' ' << second << " at " << position;
+                text[position] = 'x';
+                text[position + 1] = 'x';
+            }
+        }
+    }
+}
+
+TEST(Utf8, AgreesWithTheScalarCheckOnRandomText) {
+    // mostly well-formed pieces so that errors are rare and varied
+    const std::string_view pieces[] = {
+        "a", "  ", "é", "€", "\U0001f600", "\U0010ffff",
+        "\x80", "\xe0\xa0", "\xed\xa0\x80", "\xf4\x90", "\xc2"};
+    std::mt19937 random(42);
+    std::uniform_int_distribution<std::size_t> piece(0, std::size(pieces) - 1);
+    std::uniform_int_distribution<int> length(0, 40);
+    std::uniform_int_distribution<int> valid_only(0, 3);
+    for (int round = 0; round < 20000; ++round) {
+        std::string text;
+        const auto limit = valid_only(random) == 0 ? std::size(pieces) - 5
+                                                   : std::size(pieces);
+        for (auto count = length(random); count > 0; --count) {
+            text += pieces[piece(random) % limit];
+        }
+        EXPECT_EQ(is_valid_utf8(text), find_invalid_utf8(text) == VALID)
+            << text;
+    }
+}
+
+} // namespace
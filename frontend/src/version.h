@@ -0,0 +1,11 @@
+#pragma once
+
+#include <string_view>
+
+namespace frontend {
+
+// Bumped whenever the tokens or the AST produced for some source can change,
+// which invalidates everything derived from them and cached on disk.
+inline constexpr std::string_view FRONTEND_VERSION = "0.2.0";
+
+} // namespace frontend